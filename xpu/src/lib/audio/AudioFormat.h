@@ -141,6 +141,20 @@ public:
         }
     }
 
+    /**
+     * @brief Parse a sample format name (inverse of sampleFormatToString())
+     */
+    static SampleFormat sampleFormatFromString(const std::string& name) {
+        if (name == "UInt8") return SampleFormat::UInt8;
+        if (name == "Int16") return SampleFormat::Int16;
+        if (name == "Int24") return SampleFormat::Int24;
+        if (name == "Int32") return SampleFormat::Int32;
+        if (name == "Float32") return SampleFormat::Float32;
+        if (name == "Float64") return SampleFormat::Float64;
+        if (name == "DSD1") return SampleFormat::DSD1;
+        return SampleFormat::Unknown;
+    }
+
     /**
      * @brief Get bytes per sample for sample format
      */
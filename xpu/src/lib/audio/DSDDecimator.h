@@ -0,0 +1,110 @@
+#ifndef XPU_AUDIO_DSD_DECIMATOR_H
+#define XPU_AUDIO_DSD_DECIMATOR_H
+
+#include "DSDKernels.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace xpu {
+namespace audio {
+
+/**
+ * @brief DSD decimation filter mode
+ */
+enum class DSDFilterMode : int {
+    Filtered,   // Linear-phase FIR via byte tables (default)
+    Fast        // Boxcar average via popcount (no history, lower quality)
+};
+
+/**
+ * @brief Table-driven DSD to PCM decimator (dsd2pcm style)
+ *
+ * Applies a linear-phase low-pass FIR to a 1-bit DSD stream and decimates
+ * it by 16, 32 or 64 in one step. The FIR is split into 8-tap sections, and
+ * each section is precomputed as a 256-entry table indexed by a whole DSD
+ * byte, so one output sample costs getFilterBytes() table lookups and adds.
+ *
+ * Tables are built once per (decimation, bit order) and shared between
+ * instances. DC gain is 1.0: a constant 1-bit stream maps to +1.0f and the
+ * 0x69 idle pattern maps to ~0.0f.
+ *
+ * DSDFilterMode::Fast skips the FIR and averages each output's input bits
+ * with word-level popcounts. Both modes run on the best SIMD kernels the
+ * CPU supports (see DSDKernels.h).
+ */
+class DSDDecimator {
+public:
+    /**
+     * @brief DSD idle (silence) pattern, used to prime filter history
+     */
+    static constexpr uint8_t SILENCE_BYTE = 0x69;
+
+    /**
+     * @brief Check whether a decimation factor has a filter design
+     */
+    static bool isSupportedFactor(int decimation);
+
+    /**
+     * @brief Create decimator
+     * @param decimation Decimation factor: 16, 32 or 64 (unsupported values fall back to 16)
+     * @param lsb_first True if the first DSD sample is bit 0 of each byte (DSF),
+     *                  false if it is bit 7 (DSDIFF)
+     * @param mode Filter mode (default: Filtered)
+     */
+    DSDDecimator(int decimation, bool lsb_first, DSDFilterMode mode = DSDFilterMode::Filtered);
+
+    int getDecimation() const { return decimation_; }
+
+    DSDFilterMode getMode() const { return mode_; }
+
+    /**
+     * @brief Force a SIMD level (clamped to what the CPU supports)
+     */
+    void setSIMDLevel(SIMDLevel level) { kernels_ = &getDSDKernels(level); }
+
+    SIMDLevel getSIMDLevel() const { return kernels_->level; }
+
+    /**
+     * @brief Input bytes consumed per output sample (decimation / 8)
+     */
+    size_t getStrideBytes() const { return stride_bytes_; }
+
+    /**
+     * @brief Input bytes covered by the filter for one output sample (stride in Fast mode)
+     */
+    size_t getFilterBytes() const { return filter_bytes_; }
+
+    /**
+     * @brief Input bytes that must precede the first output sample's stride
+     */
+    size_t getHistoryBytes() const { return filter_bytes_ - stride_bytes_; }
+
+    /**
+     * @brief Decimate one channel of DSD bytes
+     * @param dsd Channel bytes; must hold (frames - 1) * getStrideBytes() + getFilterBytes() bytes
+     * @param frames Number of output samples to produce
+     * @param out Output buffer
+     * @param out_stride Distance between consecutive output samples (channel count for interleaved output)
+     */
+    void process(const uint8_t* dsd, size_t frames, float* out, size_t out_stride) const;
+
+    /**
+     * @brief Access the byte tables (getFilterBytes() * 256 floats, nullptr in Fast mode)
+     */
+    const float* getTables() const { return tables_ ? tables_->data() : nullptr; }
+
+private:
+    int decimation_;
+    DSDFilterMode mode_;
+    size_t stride_bytes_;
+    size_t filter_bytes_;
+    std::shared_ptr<const std::vector<float>> tables_;
+    const DSDKernels* kernels_;
+};
+
+} // namespace audio
+} // namespace xpu
+
+#endif // XPU_AUDIO_DSD_DECIMATOR_H
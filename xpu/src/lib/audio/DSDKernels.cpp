@@ -0,0 +1,384 @@
+#include "DSDKernels.h"
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define XPU_DSD_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(__aarch64__) || defined(_M_ARM64) || (defined(__ARM_NEON) && defined(__arm__))
+#define XPU_DSD_NEON 1
+#include <arm_neon.h>
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define XPU_TARGET(isa) __attribute__((target(isa)))
+#else
+#define XPU_TARGET(isa)
+#endif
+
+namespace xpu {
+namespace audio {
+
+namespace {
+
+// ============================================================================
+// Scalar kernels
+// ============================================================================
+
+/**
+ * @brief Per-byte popcount of a 64-bit word (SWAR)
+ */
+inline uint64_t bytePopcounts(uint64_t x) {
+    x = x - ((x >> 1) & 0x5555555555555555ULL);
+    x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+    return (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+}
+
+inline uint64_t loadWord(const uint8_t* p) {
+    uint64_t w;
+    std::memcpy(&w, p, sizeof(w));
+    return w;
+}
+
+/**
+ * @brief Map a 1-bit count to a bipolar sample in [-1, 1]
+ *
+ * bits is a power of two, so the scale is exact and every kernel produces
+ * identical results.
+ */
+inline float boxcarSample(int32_t ones, int32_t bits, float inv_bits) {
+    return static_cast<float>(2 * ones - bits) * inv_bits;
+}
+
+void boxcarScalar(const uint8_t* dsd, size_t frames, size_t stride_bytes,
+                  float* out, size_t out_stride) {
+    const int32_t bits = static_cast<int32_t>(stride_bytes * 8);
+    const float inv_bits = 1.0f / bits;
+    const size_t per_word = 8 / stride_bytes;
+    size_t f = 0;
+
+    // Whole 64-bit words: 8 / stride_bytes output samples per word
+    for (; f + per_word <= frames; f += per_word) {
+        uint64_t counts = bytePopcounts(loadWord(dsd + f * stride_bytes));
+        if (stride_bytes == 8) {
+            out[f * out_stride] = boxcarSample(
+                static_cast<int32_t>((counts * 0x0101010101010101ULL) >> 56), bits, inv_bits);
+            continue;
+        }
+        // Fold byte counts into 16-bit lanes, then 32-bit lanes
+        counts = (counts + (counts >> 8)) & 0x00FF00FF00FF00FFULL;
+        if (stride_bytes == 4) {
+            counts = (counts + (counts >> 16)) & 0x0000FFFF0000FFFFULL;
+        }
+        const unsigned lane_bits = static_cast<unsigned>(stride_bytes * 8);
+        for (size_t i = 0; i < per_word; ++i) {
+            int32_t ones = static_cast<int32_t>((counts >> (i * lane_bits)) & 0xFF);
+            out[(f + i) * out_stride] = boxcarSample(ones, bits, inv_bits);
+        }
+    }
+
+    // Tail
+    for (; f < frames; ++f) {
+        uint64_t word = 0;
+        std::memcpy(&word, dsd + f * stride_bytes, stride_bytes);
+        int32_t ones = static_cast<int32_t>(
+            (bytePopcounts(word) * 0x0101010101010101ULL) >> 56);
+        out[f * out_stride] = boxcarSample(ones, bits, inv_bits);
+    }
+}
+
+void firScalar(const float* tables, size_t filter_bytes,
+               const uint8_t* dsd, size_t frames, size_t stride_bytes,
+               float* out, size_t out_stride) {
+    for (size_t f = 0; f < frames; ++f) {
+        const uint8_t* src = dsd + f * stride_bytes;
+        float acc = 0.0f;
+        for (size_t k = 0; k < filter_bytes; ++k) {
+            acc += tables[k * 256 + src[k]];
+        }
+        out[f * out_stride] = acc;
+    }
+}
+
+/**
+ * @brief Write count-derived samples from a small integer buffer
+ */
+inline void storeBoxcar(const int32_t* ones, size_t count, int32_t bits, float inv_bits,
+                        float* out, size_t out_stride) {
+    for (size_t i = 0; i < count; ++i) {
+        out[i * out_stride] = boxcarSample(ones[i], bits, inv_bits);
+    }
+}
+
+// ============================================================================
+// x86 kernels
+// ============================================================================
+
+#ifdef XPU_DSD_X86
+
+XPU_TARGET("ssse3,sse4.1")
+void boxcarSSE41(const uint8_t* dsd, size_t frames, size_t stride_bytes,
+                 float* out, size_t out_stride) {
+    const int32_t bits = static_cast<int32_t>(stride_bytes * 8);
+    const float inv_bits = 1.0f / bits;
+    const size_t per_vec = 16 / stride_bytes;
+
+    const __m128i nibble_lut = _mm_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m128i low_mask = _mm_set1_epi8(0x0F);
+    const __m128i ones8 = _mm_set1_epi8(1);
+    const __m128i ones16 = _mm_set1_epi16(1);
+    alignas(16) int32_t counts[8];
+
+    size_t f = 0;
+    for (; f + per_vec <= frames; f += per_vec) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dsd + f * stride_bytes));
+        __m128i c = _mm_add_epi8(_mm_shuffle_epi8(nibble_lut, _mm_and_si128(v, low_mask)),
+                                 _mm_shuffle_epi8(nibble_lut, _mm_and_si128(_mm_srli_epi16(v, 4), low_mask)));
+        if (stride_bytes == 2) {
+            __m128i c16 = _mm_maddubs_epi16(c, ones8);
+            _mm_store_si128(reinterpret_cast<__m128i*>(counts), _mm_cvtepi16_epi32(c16));
+            _mm_store_si128(reinterpret_cast<__m128i*>(counts + 4),
+                            _mm_cvtepi16_epi32(_mm_srli_si128(c16, 8)));
+        } else if (stride_bytes == 4) {
+            _mm_store_si128(reinterpret_cast<__m128i*>(counts),
+                            _mm_madd_epi16(_mm_maddubs_epi16(c, ones8), ones16));
+        } else {
+            __m128i sad = _mm_sad_epu8(c, _mm_setzero_si128());
+            counts[0] = _mm_cvtsi128_si32(sad);
+            counts[1] = _mm_extract_epi32(sad, 2);
+        }
+        storeBoxcar(counts, per_vec, bits, inv_bits, out + f * out_stride, out_stride);
+    }
+
+    if (f < frames) {
+        boxcarScalar(dsd + f * stride_bytes, frames - f, stride_bytes, out + f * out_stride, out_stride);
+    }
+}
+
+XPU_TARGET("avx2")
+void boxcarAVX2(const uint8_t* dsd, size_t frames, size_t stride_bytes,
+                float* out, size_t out_stride) {
+    const int32_t bits = static_cast<int32_t>(stride_bytes * 8);
+    const float inv_bits = 1.0f / bits;
+    const size_t per_vec = 32 / stride_bytes;
+
+    const __m256i nibble_lut = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                                0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low_mask = _mm256_set1_epi8(0x0F);
+    const __m256i ones8 = _mm256_set1_epi8(1);
+    const __m256i ones16 = _mm256_set1_epi16(1);
+    const __m256 scale = _mm256_set1_ps(inv_bits);
+    const __m256i bias = _mm256_set1_epi32(bits);
+    alignas(32) int32_t counts[16];
+    alignas(32) float samples[16];
+
+    size_t f = 0;
+    for (; f + per_vec <= frames; f += per_vec) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dsd + f * stride_bytes));
+        __m256i c = _mm256_add_epi8(
+            _mm256_shuffle_epi8(nibble_lut, _mm256_and_si256(v, low_mask)),
+            _mm256_shuffle_epi8(nibble_lut, _mm256_and_si256(_mm256_srli_epi16(v, 4), low_mask)));
+
+        if (stride_bytes == 2) {
+            // 16 x int16 pair sums, widened in memory order
+            __m256i c16 = _mm256_maddubs_epi16(c, ones8);
+            __m256i lo = _mm256_cvtepi16_epi32(_mm256_castsi256_si128(c16));
+            __m256i hi = _mm256_cvtepi16_epi32(_mm256_extracti128_si256(c16, 1));
+            lo = _mm256_sub_epi32(_mm256_slli_epi32(lo, 1), bias);
+            hi = _mm256_sub_epi32(_mm256_slli_epi32(hi, 1), bias);
+            _mm256_store_ps(samples, _mm256_mul_ps(_mm256_cvtepi32_ps(lo), scale));
+            _mm256_store_ps(samples + 8, _mm256_mul_ps(_mm256_cvtepi32_ps(hi), scale));
+            for (size_t i = 0; i < 16; ++i) {
+                out[(f + i) * out_stride] = samples[i];
+            }
+            continue;
+        }
+
+        if (stride_bytes == 4) {
+            __m256i c32 = _mm256_madd_epi16(_mm256_maddubs_epi16(c, ones8), ones16);
+            c32 = _mm256_sub_epi32(_mm256_slli_epi32(c32, 1), bias);
+            _mm256_store_ps(samples, _mm256_mul_ps(_mm256_cvtepi32_ps(c32), scale));
+            for (size_t i = 0; i < 8; ++i) {
+                out[(f + i) * out_stride] = samples[i];
+            }
+            continue;
+        }
+
+        _mm256_store_si256(reinterpret_cast<__m256i*>(counts),
+                           _mm256_sad_epu8(c, _mm256_setzero_si256()));
+        for (size_t i = 0; i < 4; ++i) {
+            out[(f + i) * out_stride] = boxcarSample(counts[i * 2], bits, inv_bits);
+        }
+    }
+
+    if (f < frames) {
+        boxcarScalar(dsd + f * stride_bytes, frames - f, stride_bytes, out + f * out_stride, out_stride);
+    }
+}
+
+/**
+ * @brief Table FIR over 8 output samples per instruction (AVX2 gathers)
+ *
+ * Each lane accumulates the same table entries in the same order as
+ * firScalar(), so results are bit-identical.
+ */
+XPU_TARGET("avx2")
+void firAVX2(const float* tables, size_t filter_bytes,
+             const uint8_t* dsd, size_t frames, size_t stride_bytes,
+             float* out, size_t out_stride) {
+    const __m256i byte_offsets = _mm256_mullo_epi32(
+        _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7),
+        _mm256_set1_epi32(static_cast<int>(stride_bytes)));
+    const __m256i byte_mask = _mm256_set1_epi32(0xFF);
+    alignas(32) float samples[8];
+
+    size_t f = 0;
+    // The 32-bit byte gathers read up to 3 bytes past the last tap of lane 7;
+    // keep two spare output strides so they stay inside the caller's buffer.
+    for (; f + 10 <= frames; f += 8) {
+        const uint8_t* base = dsd + f * stride_bytes;
+        __m256 acc = _mm256_setzero_ps();
+        __m256i table_base = _mm256_setzero_si256();
+        const __m256i table_step = _mm256_set1_epi32(256);
+
+        for (size_t k = 0; k < filter_bytes; ++k) {
+            __m256i bytes = _mm256_i32gather_epi32(
+                reinterpret_cast<const int*>(base + k), byte_offsets, 1);
+            __m256i index = _mm256_add_epi32(_mm256_and_si256(bytes, byte_mask), table_base);
+            acc = _mm256_add_ps(acc, _mm256_i32gather_ps(tables, index, 4));
+            table_base = _mm256_add_epi32(table_base, table_step);
+        }
+
+        _mm256_store_ps(samples, acc);
+        for (size_t i = 0; i < 8; ++i) {
+            out[(f + i) * out_stride] = samples[i];
+        }
+    }
+
+    if (f < frames) {
+        firScalar(tables, filter_bytes, dsd + f * stride_bytes, frames - f, stride_bytes,
+                  out + f * out_stride, out_stride);
+    }
+}
+
+bool cpuSupports(SIMDLevel level) {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_cpu_init();
+    if (level == SIMDLevel::AVX2) return __builtin_cpu_supports("avx2");
+    if (level == SIMDLevel::SSE41) return __builtin_cpu_supports("sse4.1");
+    return false;
+#elif defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    bool sse41 = (info[2] & (1 << 19)) != 0;
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    if (level == SIMDLevel::SSE41) return sse41;
+    if (level == SIMDLevel::AVX2) {
+        if (!osxsave || (_xgetbv(0) & 0x6) != 0x6) return false;
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+    }
+    return false;
+#else
+    (void)level;
+    return false;
+#endif
+}
+
+#endif // XPU_DSD_X86
+
+// ============================================================================
+// ARM kernels
+// ============================================================================
+
+#ifdef XPU_DSD_NEON
+
+void boxcarNEON(const uint8_t* dsd, size_t frames, size_t stride_bytes,
+                float* out, size_t out_stride) {
+    const int32_t bits = static_cast<int32_t>(stride_bytes * 8);
+    const float inv_bits = 1.0f / bits;
+    const size_t per_vec = 16 / stride_bytes;
+    int32_t counts[8];
+
+    size_t f = 0;
+    for (; f + per_vec <= frames; f += per_vec) {
+        uint8x16_t c = vcntq_u8(vld1q_u8(dsd + f * stride_bytes));
+        uint16x8_t c16 = vpaddlq_u8(c);
+        if (stride_bytes == 2) {
+            vst1q_s32(counts, vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(c16))));
+            vst1q_s32(counts + 4, vreinterpretq_s32_u32(vmovl_u16(vget_high_u16(c16))));
+        } else if (stride_bytes == 4) {
+            vst1q_s32(counts, vreinterpretq_s32_u32(vpaddlq_u16(c16)));
+        } else {
+            uint64x2_t c64 = vpaddlq_u32(vpaddlq_u16(c16));
+            counts[0] = static_cast<int32_t>(vgetq_lane_u64(c64, 0));
+            counts[1] = static_cast<int32_t>(vgetq_lane_u64(c64, 1));
+        }
+        storeBoxcar(counts, per_vec, bits, inv_bits, out + f * out_stride, out_stride);
+    }
+
+    if (f < frames) {
+        boxcarScalar(dsd + f * stride_bytes, frames - f, stride_bytes, out + f * out_stride, out_stride);
+    }
+}
+
+#endif // XPU_DSD_NEON
+
+const DSDKernels SCALAR_KERNELS = {SIMDLevel::Scalar, boxcarScalar, firScalar};
+#ifdef XPU_DSD_X86
+const DSDKernels SSE41_KERNELS = {SIMDLevel::SSE41, boxcarSSE41, firScalar};
+const DSDKernels AVX2_KERNELS = {SIMDLevel::AVX2, boxcarAVX2, firAVX2};
+#endif
+#ifdef XPU_DSD_NEON
+// NEON has no gather, so the table FIR stays scalar there
+const DSDKernels NEON_KERNELS = {SIMDLevel::NEON, boxcarNEON, firScalar};
+#endif
+
+} // anonymous namespace
+
+SIMDLevel detectSIMDLevel() {
+    static const SIMDLevel level = [] {
+#if defined(XPU_DSD_X86)
+        if (cpuSupports(SIMDLevel::AVX2)) return SIMDLevel::AVX2;
+        if (cpuSupports(SIMDLevel::SSE41)) return SIMDLevel::SSE41;
+        return SIMDLevel::Scalar;
+#elif defined(XPU_DSD_NEON)
+        return SIMDLevel::NEON;
+#else
+        return SIMDLevel::Scalar;
+#endif
+    }();
+    return level;
+}
+
+const char* simdLevelName(SIMDLevel level) {
+    switch (level) {
+        case SIMDLevel::Scalar: return "scalar";
+        case SIMDLevel::SSE41:  return "sse4.1";
+        case SIMDLevel::AVX2:   return "avx2";
+        case SIMDLevel::NEON:   return "neon";
+        default:                return "unknown";
+    }
+}
+
+const DSDKernels& getDSDKernels(SIMDLevel level) {
+    const SIMDLevel best = detectSIMDLevel();
+#if defined(XPU_DSD_X86)
+    if (level == SIMDLevel::AVX2 && best == SIMDLevel::AVX2) return AVX2_KERNELS;
+    if ((level == SIMDLevel::AVX2 || level == SIMDLevel::SSE41) && best != SIMDLevel::Scalar) {
+        return SSE41_KERNELS;
+    }
+#elif defined(XPU_DSD_NEON)
+    if (level == SIMDLevel::NEON && best == SIMDLevel::NEON) return NEON_KERNELS;
+#else
+    (void)best;
+#endif
+    return SCALAR_KERNELS;
+}
+
+} // namespace audio
+} // namespace xpu
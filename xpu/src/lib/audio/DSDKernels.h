@@ -0,0 +1,76 @@
+#ifndef XPU_AUDIO_DSD_KERNELS_H
+#define XPU_AUDIO_DSD_KERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace xpu {
+namespace audio {
+
+/**
+ * @brief SIMD instruction set used by the DSD kernels
+ */
+enum class SIMDLevel : int {
+    Scalar,   // Portable C++ (64-bit word SWAR popcount, scalar table FIR)
+    SSE41,    // SSSE3/SSE4.1 (x86)
+    AVX2,     // AVX2 (x86)
+    NEON      // Advanced SIMD (ARM)
+};
+
+/**
+ * @brief Boxcar (popcount) decimation kernel
+ * @param dsd Channel bytes, stride_bytes per output sample
+ * @param frames Number of output samples
+ * @param stride_bytes Bytes per output sample (2, 4 or 8)
+ * @param out Output buffer, out_stride floats apart
+ */
+using DSDBoxcarKernel = void (*)(const uint8_t* dsd, size_t frames, size_t stride_bytes,
+                                 float* out, size_t out_stride);
+
+/**
+ * @brief Table FIR decimation kernel
+ * @param tables filter_bytes * 256 byte tables (see DSDDecimator)
+ * @param dsd Channel bytes; must hold (frames - 1) * stride_bytes + filter_bytes bytes
+ */
+using DSDFIRKernel = void (*)(const float* tables, size_t filter_bytes,
+                              const uint8_t* dsd, size_t frames, size_t stride_bytes,
+                              float* out, size_t out_stride);
+
+/**
+ * @brief Kernel set for one SIMD level
+ */
+struct DSDKernels {
+    SIMDLevel level;
+    DSDBoxcarKernel boxcar;
+    DSDFIRKernel fir;
+};
+
+/**
+ * @brief Detect the best SIMD level supported by this CPU (cached)
+ */
+SIMDLevel detectSIMDLevel();
+
+/**
+ * @brief Human-readable SIMD level name
+ */
+const char* simdLevelName(SIMDLevel level);
+
+/**
+ * @brief Get kernels for a SIMD level
+ *
+ * Levels not compiled in or not supported by the CPU fall back to the best
+ * available level below them. Every level produces bit-identical output.
+ */
+const DSDKernels& getDSDKernels(SIMDLevel level);
+
+/**
+ * @brief Get kernels for the detected SIMD level
+ */
+inline const DSDKernels& getDSDKernels() {
+    return getDSDKernels(detectSIMDLevel());
+}
+
+} // namespace audio
+} // namespace xpu
+
+#endif // XPU_AUDIO_DSD_KERNELS_H
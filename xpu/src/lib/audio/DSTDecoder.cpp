@@ -0,0 +1,347 @@
+#include "DSTDecoder.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+namespace xpu {
+namespace audio {
+
+namespace {
+
+// Coefficient prediction used by coded filter / probability tables (10.13)
+const int8_t FSETS_CODE_PRED_COEFF[3][3] = {
+    { -8 },
+    { -16, 8 },
+    { -9, -5, 6 },
+};
+
+const int8_t PROBS_CODE_PRED_COEFF[3][3] = {
+    { -8 },
+    { -16, 8 },
+    { -24, 24, -8 },
+};
+
+constexpr unsigned int AC_BITS = 12;
+constexpr unsigned int AC_HALF = 1u << (AC_BITS - 1);
+
+int log2u(unsigned int v) {
+    int n = 0;
+    while (v >>= 1) {
+        ++n;
+    }
+    return n;
+}
+
+/**
+ * @brief Reverse the 7 low bits of a coefficient (probability of the unused first AC bit)
+ */
+int reverse7(int c) {
+    int r = 0;
+    for (int bit = 0; bit < 7; ++bit) {
+        if (c & (1 << bit)) {
+            r |= 0x40 >> bit;
+        }
+    }
+    return r + 1;
+}
+
+} // anonymous namespace
+
+/**
+ * @brief MSB-first bit reader; reads past the end return zero bits
+ */
+class DSTDecoder::BitReader {
+public:
+    BitReader(const uint8_t* data, size_t size)
+        : data_(data), size_bits_(static_cast<uint64_t>(size) * 8), pos_(0) {}
+
+    unsigned int bit() {
+        unsigned int v = 0;
+        if (pos_ < size_bits_) {
+            v = (data_[pos_ >> 3] >> (7 - (pos_ & 7))) & 1;
+        }
+        ++pos_;
+        return v;
+    }
+
+    unsigned int bits(int n) {
+        unsigned int v = 0;
+        for (int i = 0; i < n; ++i) {
+            v = (v << 1) | bit();
+        }
+        return v;
+    }
+
+    int signedBits(int n) {
+        unsigned int v = bits(n);
+        if (n > 0 && (v & (1u << (n - 1)))) {
+            return static_cast<int>(v) - (1 << n);
+        }
+        return static_cast<int>(v);
+    }
+
+    /**
+     * @brief Signed Rice code: zero-run prefix, k LSBs, sign bit for non-zero values
+     */
+    int rice(int k) {
+        unsigned int q = 0;
+        while (!bit()) {
+            if (exhausted() || ++q > 0xFFFF) {
+                return 0;
+            }
+        }
+        int v = static_cast<int>((q << k) | bits(k));
+        if (v && bit()) {
+            v = -v;
+        }
+        return v;
+    }
+
+    bool exhausted() const { return pos_ > size_bits_; }
+
+private:
+    const uint8_t* data_;
+    uint64_t size_bits_;
+    uint64_t pos_;
+};
+
+DSTDecoder::DSTDecoder(int channels, uint32_t dsd_rate)
+    : channels_(std::max(1, std::min(channels, MAX_CHANNELS)))
+    , samples_per_frame_(dsd_rate / FRAME_RATE)
+    , filters_(static_cast<size_t>(MAX_ELEMENTS) * 16 * 256, 0)
+{
+}
+
+bool DSTDecoder::isSupported(int channels, uint32_t dsd_rate) {
+    return channels >= 1 && channels <= MAX_CHANNELS &&
+           dsd_rate > 0 && dsd_rate % (FRAME_RATE * 8) == 0;
+}
+
+ErrorCode DSTDecoder::readMap(BitReader& bits, Table& table, unsigned int* map, int channels) {
+    table.elements = 1;
+    map[0] = 0;
+    if (bits.bit()) {
+        // Same map for all channels
+        std::fill(map, map + MAX_CHANNELS, 0u);
+        return ErrorCode::Success;
+    }
+    for (int ch = 1; ch < channels; ++ch) {
+        map[ch] = bits.bits(log2u(table.elements) + 1);
+        if (map[ch] == table.elements) {
+            if (++table.elements >= MAX_ELEMENTS) {
+                return ErrorCode::CorruptedFile;
+            }
+        } else if (map[ch] > table.elements) {
+            return ErrorCode::CorruptedFile;
+        }
+    }
+    return ErrorCode::Success;
+}
+
+ErrorCode DSTDecoder::readTable(BitReader& bits, Table& table, const int8_t code_pred_coeff[3][3],
+                                int length_bits, int coeff_bits, bool is_signed, int offset) {
+    auto readUncoded = [&](int* dst, unsigned int count) {
+        for (unsigned int i = 0; i < count; ++i) {
+            dst[i] = (is_signed ? bits.signedBits(coeff_bits)
+                                : static_cast<int>(bits.bits(coeff_bits))) + offset;
+        }
+    };
+
+    for (unsigned int e = 0; e < table.elements; ++e) {
+        unsigned int length = bits.bits(length_bits) + 1;
+        int* coeff = table.coeff[e];
+        table.length[e] = length;
+
+        if (!bits.bit()) {
+            readUncoded(coeff, length);
+            continue;
+        }
+
+        unsigned int method = bits.bits(2);
+        if (method == 3) {
+            return ErrorCode::CorruptedFile;
+        }
+        readUncoded(coeff, method + 1);
+
+        int lsb_size = static_cast<int>(bits.bits(3));
+        for (unsigned int j = method + 1; j < length; ++j) {
+            int x = 0;
+            for (unsigned int k = 0; k <= method; ++k) {
+                x += code_pred_coeff[method][k] * coeff[j - k - 1];
+            }
+            int c = bits.rice(lsb_size);
+            if (x >= 0) {
+                c -= (x + 4) / 8;
+            } else {
+                c += (-x + 3) / 8;
+            }
+            if (!is_signed && (c < offset || c >= offset + (1 << coeff_bits))) {
+                return ErrorCode::CorruptedFile;
+            }
+            coeff[j] = c;
+        }
+    }
+    return bits.exhausted() ? ErrorCode::CorruptedFile : ErrorCode::Success;
+}
+
+void DSTDecoder::buildFilters() {
+    // filters_[e][j][k]: contribution of taps 8j..8j+7 for the 8 past bits in k
+    // (bit l of k is the sample 8j+l steps back; 1 -> +coeff, 0 -> -coeff)
+    for (unsigned int e = 0; e < fsets_.elements; ++e) {
+        int length = static_cast<int>(fsets_.length[e]);
+        for (int j = 0; j < 16; ++j) {
+            int taps = std::max(0, std::min(length - j * 8, 8));
+            int16_t* table = &filters_[(static_cast<size_t>(e) * 16 + j) * 256];
+            for (int k = 0; k < 256; ++k) {
+                int v = 0;
+                for (int l = 0; l < taps; ++l) {
+                    v += (((k >> l) & 1) * 2 - 1) * fsets_.coeff[e][j * 8 + l];
+                }
+                table[k] = static_cast<int16_t>(v);
+            }
+        }
+    }
+}
+
+ErrorCode DSTDecoder::decodeFrame(const uint8_t* data, size_t size, uint8_t* out) {
+    const size_t frame_bytes = getFrameBytes();
+    if (!data || size < 2 || samples_per_frame_ == 0) {
+        return ErrorCode::CorruptedFile;
+    }
+
+    BitReader bits(data, size);
+
+    if (!bits.bit()) {
+        // Frame stored uncompressed: byte-interleaved DSD after the first byte
+        bits.bit();
+        if (bits.bits(6) != 0) {
+            return ErrorCode::CorruptedFile;
+        }
+        const uint8_t* raw = data + 1;
+        size_t available = (size - 1) / channels_;
+        for (int ch = 0; ch < channels_; ++ch) {
+            uint8_t* dst = out + ch * frame_bytes;
+            for (size_t i = 0; i < frame_bytes; ++i) {
+                dst[i] = i < available ? raw[i * channels_ + ch] : 0x69;
+            }
+        }
+        return ErrorCode::Success;
+    }
+
+    // Segmentation (10.4 - 10.6): only a single segment per channel is used in practice
+    if (!bits.bit() || !bits.bit() || !bits.bit()) {
+        return ErrorCode::NotSupported;
+    }
+
+    // Channel -> filter / probability table mapping (10.7 - 10.9)
+    unsigned int felem_map[MAX_CHANNELS] = {};
+    unsigned int pelem_map[MAX_CHANNELS] = {};
+    bool same_map = bits.bit() != 0;
+
+    ErrorCode result = readMap(bits, fsets_, felem_map, channels_);
+    if (result != ErrorCode::Success) {
+        return result;
+    }
+    if (same_map) {
+        probs_.elements = fsets_.elements;
+        std::memcpy(pelem_map, felem_map, sizeof(pelem_map));
+    } else {
+        result = readMap(bits, probs_, pelem_map, channels_);
+        if (result != ErrorCode::Success) {
+            return result;
+        }
+    }
+
+    // Half probability flags (10.10)
+    bool half_prob[MAX_CHANNELS] = {};
+    for (int ch = 0; ch < channels_; ++ch) {
+        half_prob[ch] = bits.bit() != 0;
+    }
+
+    // Filter coefficient sets (10.12) and probability tables (10.13)
+    result = readTable(bits, fsets_, FSETS_CODE_PRED_COEFF, 7, 9, true, 0);
+    if (result != ErrorCode::Success) {
+        return result;
+    }
+    result = readTable(bits, probs_, PROBS_CODE_PRED_COEFF, 6, 7, false, 1);
+    if (result != ErrorCode::Success) {
+        return result;
+    }
+
+    // Arithmetic coded data (10.11), preceded by a zero stuffing bit
+    if (bits.bit()) {
+        return ErrorCode::CorruptedFile;
+    }
+    unsigned int a = (1u << AC_BITS) - 1;
+    unsigned int c = bits.bits(AC_BITS);
+
+    auto decodeBit = [&](unsigned int p) -> int {
+        unsigned int k = (a >> 8) | ((a >> 7) & 1);
+        unsigned int q = k * p;
+        unsigned int a_q = a - q;
+        int e;
+        if (c < a_q) {
+            e = 1;
+            a = a_q;
+        } else {
+            e = 0;
+            a = q;
+            c -= a_q;
+        }
+        if (a < AC_HALF) {
+            int n = static_cast<int>(AC_BITS) - 1 - log2u(a);
+            a <<= n;
+            c = (c << n) | bits.bits(n);
+        }
+        return e;
+    };
+
+    buildFilters();
+
+    // The first AC symbol carries no data
+    decodeBit(static_cast<unsigned int>(reverse7(fsets_.coeff[0][0] & 127)));
+
+    // Past-sample shift registers, 128 bits per channel, newest bit in bit 0 of [0]
+    uint64_t status[MAX_CHANNELS][2];
+    for (int ch = 0; ch < MAX_CHANNELS; ++ch) {
+        status[ch][0] = status[ch][1] = 0xAAAAAAAAAAAAAAAAull;
+    }
+    std::memset(out, 0, frame_bytes * channels_);
+
+    for (uint32_t i = 0; i < samples_per_frame_; ++i) {
+        for (int ch = 0; ch < channels_; ++ch) {
+            const unsigned int felem = felem_map[ch];
+            const int16_t* filter = &filters_[static_cast<size_t>(felem) * 16 * 256];
+            uint64_t* st = status[ch];
+
+            int sum = 0;
+            for (int j = 0; j < 16; ++j) {
+                sum += filter[j * 256 + ((st[j >> 3] >> ((j & 7) * 8)) & 0xFF)];
+            }
+            const int16_t predict = static_cast<int16_t>(sum);
+
+            unsigned int prob;
+            if (!half_prob[ch] || i >= fsets_.length[felem]) {
+                const unsigned int pelem = pelem_map[ch];
+                unsigned int index = static_cast<unsigned int>(std::abs(static_cast<int>(predict))) >> 3;
+                prob = static_cast<unsigned int>(
+                    probs_.coeff[pelem][std::min(index, probs_.length[pelem] - 1)]);
+            } else {
+                prob = 128;
+            }
+
+            int residual = decodeBit(prob);
+            int v = ((static_cast<uint16_t>(predict) >> 15) ^ residual) & 1;
+            out[ch * frame_bytes + (i >> 3)] |= static_cast<uint8_t>(v << (7 - (i & 7)));
+
+            // Shift the 128-bit history left by one and insert the new bit
+            st[1] = (st[1] << 1) | (st[0] >> 63);
+            st[0] = (st[0] << 1) | static_cast<uint64_t>(v);
+        }
+    }
+
+    return ErrorCode::Success;
+}
+
+} // namespace audio
+} // namespace xpu
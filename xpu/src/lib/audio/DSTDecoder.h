@@ -0,0 +1,91 @@
+#ifndef XPU_AUDIO_DST_DECODER_H
+#define XPU_AUDIO_DST_DECODER_H
+
+#include "protocol/ErrorCode.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace xpu {
+namespace audio {
+
+/**
+ * @brief DST (Direct Stream Transfer) frame decoder
+ *
+ * Decodes the lossless DSD compression used by SACD and DSDIFF 'DST '
+ * chunks (ISO/IEC 14496-3 subpart 10). Every frame (1/75 s) carries its own
+ * prediction filters, probability tables and arithmetic-coded residual, so
+ * frames decode independently: use one DSTDecoder per thread and hand each
+ * a different frame.
+ *
+ * Output is planar raw DSD, getFrameBytes() bytes per channel, with the
+ * first sample in the MSB of each byte (DSDIFF bit order).
+ */
+class DSTDecoder {
+public:
+    static constexpr int MAX_CHANNELS = 6;
+
+    /**
+     * @brief DST frame rate (frames per second)
+     */
+    static constexpr int FRAME_RATE = 75;
+
+    /**
+     * @brief Create decoder
+     * @param channels Channel count (1 to MAX_CHANNELS)
+     * @param dsd_rate DSD sample rate in Hz (e.g. 2822400 for DSD64)
+     */
+    DSTDecoder(int channels, uint32_t dsd_rate);
+
+    /**
+     * @brief Check whether a stream layout can be decoded
+     */
+    static bool isSupported(int channels, uint32_t dsd_rate);
+
+    int getChannels() const { return channels_; }
+
+    /**
+     * @brief DSD bytes per channel in one decoded frame
+     */
+    size_t getFrameBytes() const { return samples_per_frame_ / 8; }
+
+    /**
+     * @brief Decode one frame
+     * @param data DST frame payload (contents of one DSTF chunk)
+     * @param size Payload size in bytes
+     * @param out Planar output, getChannels() * getFrameBytes() bytes
+     * @return ErrorCode::CorruptedFile for malformed frames,
+     *         ErrorCode::NotSupported for segmented frames
+     */
+    ErrorCode decodeFrame(const uint8_t* data, size_t size, uint8_t* out);
+
+private:
+    static constexpr int MAX_ELEMENTS = 2 * MAX_CHANNELS;
+
+    /**
+     * @brief Filter coefficient sets or probability tables of one frame
+     */
+    struct Table {
+        unsigned int elements = 0;
+        unsigned int length[MAX_ELEMENTS] = {};
+        int coeff[MAX_ELEMENTS][128] = {};
+    };
+
+    class BitReader;
+
+    static ErrorCode readMap(BitReader& bits, Table& table, unsigned int* map, int channels);
+    static ErrorCode readTable(BitReader& bits, Table& table, const int8_t code_pred_coeff[3][3],
+                               int length_bits, int coeff_bits, bool is_signed, int offset);
+    void buildFilters();
+
+    int channels_;
+    uint32_t samples_per_frame_;
+    Table fsets_;
+    Table probs_;
+    std::vector<int16_t> filters_;   // MAX_ELEMENTS x 16 x 256 byte tables
+};
+
+} // namespace audio
+} // namespace xpu
+
+#endif // XPU_AUDIO_DST_DECODER_H
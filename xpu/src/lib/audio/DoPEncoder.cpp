@@ -0,0 +1,67 @@
+#include "DoPEncoder.h"
+#include <array>
+#include <cmath>
+
+namespace xpu {
+namespace audio {
+
+namespace {
+
+constexpr float WORD_SCALE = 8388608.0f;  // 2^23
+
+/**
+ * @brief Byte bit-reversal table (DSF LSB-first -> DoP MSB-first)
+ */
+const std::array<uint8_t, 256>& reverseTable() {
+    static const std::array<uint8_t, 256> table = [] {
+        std::array<uint8_t, 256> t{};
+        for (int i = 0; i < 256; ++i) {
+            uint8_t r = 0;
+            for (int bit = 0; bit < 8; ++bit) {
+                if (i & (1 << bit)) {
+                    r |= static_cast<uint8_t>(0x80 >> bit);
+                }
+            }
+            t[i] = r;
+        }
+        return t;
+    }();
+    return table;
+}
+
+} // anonymous namespace
+
+DoPEncoder::DoPEncoder(bool lsb_first)
+    : lsb_first_(lsb_first)
+{
+}
+
+float DoPEncoder::encode(uint8_t marker, uint8_t first, uint8_t second) {
+    // Sign-extend the 24-bit word so 0xFA frames come out negative
+    int32_t word = static_cast<int32_t>((static_cast<uint32_t>(marker) << 24) |
+                                        (static_cast<uint32_t>(first) << 16) |
+                                        (static_cast<uint32_t>(second) << 8)) >> 8;
+    return static_cast<float>(word) / WORD_SCALE;
+}
+
+uint32_t DoPEncoder::decode(float sample) {
+    int32_t word = static_cast<int32_t>(std::lrint(sample * WORD_SCALE));
+    return static_cast<uint32_t>(word) & 0xFFFFFF;
+}
+
+void DoPEncoder::process(const uint8_t* dsd, size_t frames, uint64_t first_frame,
+                         float* out, size_t out_stride) const {
+    const auto& reverse = reverseTable();
+    for (size_t i = 0; i < frames; ++i) {
+        uint8_t first = dsd[i * BYTES_PER_FRAME];
+        uint8_t second = dsd[i * BYTES_PER_FRAME + 1];
+        if (lsb_first_) {
+            first = reverse[first];
+            second = reverse[second];
+        }
+        out[i * out_stride] = encode(markerFor(first_frame + i), first, second);
+    }
+}
+
+} // namespace audio
+} // namespace xpu
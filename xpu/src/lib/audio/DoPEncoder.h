@@ -0,0 +1,75 @@
+#ifndef XPU_AUDIO_DOP_ENCODER_H
+#define XPU_AUDIO_DOP_ENCODER_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace xpu {
+namespace audio {
+
+/**
+ * @brief DSD over PCM (DoP 1.1) frame packer
+ *
+ * Each 24-bit DoP word carries 16 consecutive DSD bits of one channel
+ * (oldest bit in the MSB of the middle byte) under a marker byte that
+ * alternates 0x05 / 0xFA from frame to frame. The PCM rate is the DSD
+ * rate / 16 (176.4 kHz for DSD64).
+ *
+ * Words are emitted as float32 samples (word / 2^23) so they travel the
+ * normal xpu chunk stream unchanged: every 24-bit integer is exactly
+ * representable in a float, and any float -> 24/32-bit integer conversion
+ * at unity gain restores the original bits.
+ */
+class DoPEncoder {
+public:
+    static constexpr uint8_t MARKER_1 = 0x05;
+    static constexpr uint8_t MARKER_2 = 0xFA;
+
+    /**
+     * @brief DSD bytes consumed per channel per DoP frame
+     */
+    static constexpr size_t BYTES_PER_FRAME = 2;
+
+    /**
+     * @brief Create encoder
+     * @param lsb_first True if the first DSD sample is bit 0 of each byte (DSF),
+     *                  false if it is bit 7 (DSDIFF)
+     */
+    explicit DoPEncoder(bool lsb_first);
+
+    /**
+     * @brief Pack one channel of DSD bytes into DoP samples
+     * @param dsd Channel bytes (frames * BYTES_PER_FRAME)
+     * @param frames Number of DoP frames to produce
+     * @param first_frame Absolute index of the first frame (selects the marker phase)
+     * @param out Output buffer
+     * @param out_stride Distance between consecutive output samples (channel count for interleaved output)
+     */
+    void process(const uint8_t* dsd, size_t frames, uint64_t first_frame,
+                 float* out, size_t out_stride) const;
+
+    /**
+     * @brief Marker byte for a frame index
+     */
+    static uint8_t markerFor(uint64_t frame) {
+        return (frame & 1) ? MARKER_2 : MARKER_1;
+    }
+
+    /**
+     * @brief Build one DoP sample from a marker and two MSB-first DSD bytes
+     */
+    static float encode(uint8_t marker, uint8_t first, uint8_t second);
+
+    /**
+     * @brief Recover the 24-bit DoP word (marker << 16 | first << 8 | second) from a sample
+     */
+    static uint32_t decode(float sample);
+
+private:
+    bool lsb_first_;
+};
+
+} // namespace audio
+} // namespace xpu
+
+#endif // XPU_AUDIO_DOP_ENCODER_H
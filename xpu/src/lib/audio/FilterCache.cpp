@@ -0,0 +1,186 @@
+#include "FilterCache.h"
+#include "utils/PlatformUtils.h"
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <mutex>
+
+namespace xpu {
+namespace audio {
+
+namespace {
+
+constexpr char MAGIC[8] = {'X', 'P', 'U', 'F', 'I', 'L', 'T', '\0'};
+constexpr size_t FIXED_HEADER_SIZE = 24;  // magic, version, key length, count
+constexpr size_t DATA_ALIGNMENT = 64;
+
+struct CacheState {
+    std::mutex mutex;
+    bool directory_set = false;
+    std::string directory;
+    std::map<std::string, std::weak_ptr<const FilterTable>> tables;
+};
+
+CacheState& state() {
+    static CacheState cache_state;
+    return cache_state;
+}
+
+std::string defaultDirectory() {
+    return utils::PlatformUtils::joinPath({utils::PlatformUtils::getCacheDirectory(), "filters"});
+}
+
+size_t dataOffset(size_t key_length) {
+    return (FIXED_HEADER_SIZE + key_length + DATA_ALIGNMENT - 1) / DATA_ALIGNMENT * DATA_ALIGNMENT;
+}
+
+uint64_t fnv1a(const std::string& text) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (unsigned char c : text) {
+        hash ^= c;
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+/**
+ * @brief Map a cache file and check that it holds the table for key
+ */
+bool mapTable(const std::string& path, const std::string& key, size_t count, utils::MappedFile& file) {
+    if (file.open(path) != ErrorCode::Success) {
+        return false;
+    }
+    const uint8_t* data = file.data();
+    const size_t offset = dataOffset(key.size());
+    uint32_t version = 0;
+    uint32_t key_length = 0;
+    uint64_t stored_count = 0;
+    if (file.size() != offset + count * sizeof(float) ||
+        std::memcmp(data, MAGIC, sizeof(MAGIC)) != 0) {
+        file.close();
+        return false;
+    }
+    std::memcpy(&version, data + 8, sizeof(version));
+    std::memcpy(&key_length, data + 12, sizeof(key_length));
+    std::memcpy(&stored_count, data + 16, sizeof(stored_count));
+    if (version != FilterCache::FORMAT_VERSION || key_length != key.size() || stored_count != count ||
+        std::memcmp(data + FIXED_HEADER_SIZE, key.data(), key.size()) != 0) {
+        file.close();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Write a cache file under a temporary name and rename it into place
+ */
+bool storeTable(const std::string& directory, const std::string& path, const std::string& key,
+                const std::vector<float>& coeffs) {
+    utils::PlatformUtils::createDirectory(utils::PlatformUtils::getCacheDirectory());
+    if (!utils::PlatformUtils::createDirectory(directory)) {
+        return false;
+    }
+
+    static std::atomic<uint32_t> sequence{0};
+    const std::string temp_path = path + ".tmp" + std::to_string(utils::PlatformUtils::getProcessId()) +
+                                  "_" + std::to_string(sequence++);
+
+    std::vector<char> header(dataOffset(key.size()), '\0');
+    const uint32_t version = FilterCache::FORMAT_VERSION;
+    const uint32_t key_length = static_cast<uint32_t>(key.size());
+    const uint64_t count = coeffs.size();
+    std::memcpy(header.data(), MAGIC, sizeof(MAGIC));
+    std::memcpy(header.data() + 8, &version, sizeof(version));
+    std::memcpy(header.data() + 12, &key_length, sizeof(key_length));
+    std::memcpy(header.data() + 16, &count, sizeof(count));
+    std::memcpy(header.data() + FIXED_HEADER_SIZE, key.data(), key.size());
+
+    {
+        std::ofstream out(temp_path, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            return false;
+        }
+        out.write(header.data(), static_cast<std::streamsize>(header.size()));
+        out.write(reinterpret_cast<const char*>(coeffs.data()),
+                  static_cast<std::streamsize>(coeffs.size() * sizeof(float)));
+        out.close();
+        if (out.fail()) {
+            std::remove(temp_path.c_str());
+            return false;
+        }
+    }
+
+#ifdef PLATFORM_WINDOWS
+    const bool renamed = MoveFileExA(temp_path.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    const bool renamed = std::rename(temp_path.c_str(), path.c_str()) == 0;
+#endif
+    if (!renamed) {
+        std::remove(temp_path.c_str());
+    }
+    return renamed;
+}
+
+} // anonymous namespace
+
+std::string FilterCache::fileName(const std::string& key) {
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.xft", static_cast<unsigned long long>(fnv1a(key)));
+    return name;
+}
+
+void FilterCache::setDirectory(const std::string& directory) {
+    CacheState& cache = state();
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    cache.directory = directory;
+    cache.directory_set = true;
+}
+
+std::string FilterCache::getDirectory() {
+    CacheState& cache = state();
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    return cache.directory_set ? cache.directory : defaultDirectory();
+}
+
+std::shared_ptr<const FilterTable> FilterCache::get(const std::string& key, size_t count,
+                                                    const Designer& design) {
+    CacheState& cache = state();
+    std::lock_guard<std::mutex> lock(cache.mutex);
+
+    auto found = cache.tables.find(key);
+    if (found != cache.tables.end()) {
+        if (auto shared = found->second.lock()) {
+            if (shared->size() == count) {
+                return shared;
+            }
+        }
+    }
+
+    auto table = std::make_shared<FilterTable>();
+    table->size_ = count;
+
+    const std::string directory = cache.directory_set ? cache.directory : defaultDirectory();
+    const bool on_disk = !directory.empty() && count >= MIN_STORED_SIZE;
+    const std::string path = on_disk ? utils::PlatformUtils::joinPath({directory, fileName(key)}) : "";
+
+    if (on_disk && mapTable(path, key, count, table->file_)) {
+        table->data_ = reinterpret_cast<const float*>(table->file_.data() + dataOffset(key.size()));
+    } else {
+        table->coeffs_.assign(count, 0.0f);
+        design(table->coeffs_.data(), count);
+        table->data_ = table->coeffs_.data();
+
+        // Later processes map the stored copy; this one keeps its own
+        if (on_disk) {
+            storeTable(directory, path, key, table->coeffs_);
+        }
+    }
+
+    cache.tables[key] = table;
+    return table;
+}
+
+} // namespace audio
+} // namespace xpu
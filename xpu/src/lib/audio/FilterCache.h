@@ -0,0 +1,98 @@
+#ifndef XPU_AUDIO_FILTER_CACHE_H
+#define XPU_AUDIO_FILTER_CACHE_H
+
+#include "utils/MappedFile.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace xpu {
+namespace audio {
+
+/**
+ * @brief Read-only filter coefficient table
+ *
+ * Either mapped from a cache file (shared with every other process using
+ * the same table through the page cache) or held in memory.
+ */
+class FilterTable {
+public:
+    FilterTable() : data_(nullptr), size_(0) {}
+
+    FilterTable(const FilterTable&) = delete;
+    FilterTable& operator=(const FilterTable&) = delete;
+
+    const float* data() const { return data_; }
+
+    size_t size() const { return size_; }
+
+    bool isMapped() const { return file_.isOpen(); }
+
+private:
+    friend class FilterCache;
+
+    utils::MappedFile file_;
+    std::vector<float> coeffs_;
+    const float* data_;
+    size_t size_;
+};
+
+/**
+ * @brief Content-keyed cache of designed filter tables
+ *
+ * Tables are looked up by a key string that fully describes the design
+ * (kind, design revision, parameters). Within a process a table is designed
+ * once and shared while in use; across processes large tables are stored
+ * under <cache directory>/filters and memory-mapped read-only, so a
+ * pipeline pays the design cost only on the first run.
+ *
+ * Cache files carry a format version, the key and the table size and are
+ * ignored (and rewritten) when any of them does not match; they are written
+ * to a temporary name and renamed, so readers never see partial files.
+ */
+class FilterCache {
+public:
+    /**
+     * @brief Cache file format version
+     */
+    static constexpr uint32_t FORMAT_VERSION = 1;
+
+    /**
+     * @brief Tables with fewer coefficients are designed in memory only
+     */
+    static constexpr size_t MIN_STORED_SIZE = 16 * 1024;
+
+    /**
+     * @brief Fills count coefficients (the buffer is zeroed beforehand)
+     */
+    using Designer = std::function<void(float* coeffs, size_t count)>;
+
+    /**
+     * @brief Get the table for a key, designing (and storing) it on a miss
+     * @param key Complete description of the design; change it whenever the design changes
+     * @param count Number of coefficients
+     */
+    static std::shared_ptr<const FilterTable> get(const std::string& key, size_t count,
+                                                  const Designer& design);
+
+    /**
+     * @brief Directory of the cache files (default: PlatformUtils::getCacheDirectory()/filters)
+     * @param directory Empty string = keep tables in memory only
+     */
+    static void setDirectory(const std::string& directory);
+
+    static std::string getDirectory();
+
+    /**
+     * @brief Cache file name for a key (64-bit FNV-1a hash of the key)
+     */
+    static std::string fileName(const std::string& key);
+};
+
+} // namespace audio
+} // namespace xpu
+
+#endif // XPU_AUDIO_FILTER_CACHE_H
@@ -0,0 +1,412 @@
+#include "PolyphaseResampler.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <numeric>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define XPU_FIR_X86 1
+#include <immintrin.h>
+#endif
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+#define XPU_FIR_NEON 1
+#include <arm_neon.h>
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define XPU_TARGET(isa) __attribute__((target(isa)))
+#else
+#define XPU_TARGET(isa)
+#endif
+
+namespace xpu {
+namespace audio {
+
+namespace {
+
+constexpr double PI = 3.14159265358979323846;
+
+/**
+ * @brief Filter span in periods of the lower sample rate, Kaiser beta and
+ * cutoff as a fraction of the lower Nyquist frequency
+ *
+ * The cutoff puts the start of the stopband at the lower Nyquist frequency.
+ */
+struct FilterPreset {
+    int span;
+    double kaiser_beta;
+    double rolloff;
+};
+
+constexpr FilterPreset PRESETS[] = {
+    {64, 9.7, 0.903},    // Fast
+    {160, 12.4, 0.951},  // Medium
+    {640, 15.0, 0.985},  // Best
+};
+
+// Taps per phase are padded to this many floats (one AVX register)
+constexpr size_t TAP_BLOCK = 8;
+
+double besselI0(double x) {
+    double sum = 1.0;
+    double term = 1.0;
+    for (int k = 1; k < 64; ++k) {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum += term;
+        if (term < sum * 1e-14) break;
+    }
+    return sum;
+}
+
+// ============================================================================
+// Dot product kernels (taps is a multiple of TAP_BLOCK for the SIMD ones)
+// ============================================================================
+
+float dotScalar(const float* coeffs, const float* x, size_t taps) {
+    float acc = 0.0f;
+    for (size_t j = 0; j < taps; ++j) {
+        acc += coeffs[j] * x[j];
+    }
+    return acc;
+}
+
+#ifdef XPU_FIR_X86
+
+XPU_TARGET("sse4.1")
+float dotSSE41(const float* coeffs, const float* x, size_t taps) {
+    __m128 acc0 = _mm_setzero_ps();
+    __m128 acc1 = _mm_setzero_ps();
+    for (size_t j = 0; j < taps; j += 8) {
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(coeffs + j), _mm_loadu_ps(x + j)));
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(coeffs + j + 4), _mm_loadu_ps(x + j + 4)));
+    }
+    __m128 sum = _mm_add_ps(acc0, acc1);
+    sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+    sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+    return _mm_cvtss_f32(sum);
+}
+
+XPU_TARGET("avx2")
+float dotAVX2(const float* coeffs, const float* x, size_t taps) {
+    __m256 acc0 = _mm256_setzero_ps();
+    __m256 acc1 = _mm256_setzero_ps();
+    size_t j = 0;
+    for (; j + 16 <= taps; j += 16) {
+        acc0 = _mm256_add_ps(acc0, _mm256_mul_ps(_mm256_loadu_ps(coeffs + j), _mm256_loadu_ps(x + j)));
+        acc1 = _mm256_add_ps(acc1, _mm256_mul_ps(_mm256_loadu_ps(coeffs + j + 8), _mm256_loadu_ps(x + j + 8)));
+    }
+    if (j < taps) {
+        acc0 = _mm256_add_ps(acc0, _mm256_mul_ps(_mm256_loadu_ps(coeffs + j), _mm256_loadu_ps(x + j)));
+    }
+    acc0 = _mm256_add_ps(acc0, acc1);
+    __m128 sum = _mm_add_ps(_mm256_castps256_ps128(acc0), _mm256_extractf128_ps(acc0, 1));
+    sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+    sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+    return _mm_cvtss_f32(sum);
+}
+
+#endif // XPU_FIR_X86
+
+#ifdef XPU_FIR_NEON
+
+float dotNEON(const float* coeffs, const float* x, size_t taps) {
+    float32x4_t acc0 = vdupq_n_f32(0.0f);
+    float32x4_t acc1 = vdupq_n_f32(0.0f);
+    for (size_t j = 0; j < taps; j += 8) {
+        acc0 = vfmaq_f32(acc0, vld1q_f32(coeffs + j), vld1q_f32(x + j));
+        acc1 = vfmaq_f32(acc1, vld1q_f32(coeffs + j + 4), vld1q_f32(x + j + 4));
+    }
+    return vaddvq_f32(vaddq_f32(acc0, acc1));
+}
+
+#endif // XPU_FIR_NEON
+
+PolyphaseResampler::DotKernel getDotKernel(SIMDLevel level) {
+    const SIMDLevel best = detectSIMDLevel();
+#if defined(XPU_FIR_X86)
+    if (level == SIMDLevel::AVX2 && best == SIMDLevel::AVX2) return dotAVX2;
+    if ((level == SIMDLevel::AVX2 || level == SIMDLevel::SSE41) && best != SIMDLevel::Scalar) {
+        return dotSSE41;
+    }
+#elif defined(XPU_FIR_NEON)
+    if (level == SIMDLevel::NEON && best == SIMDLevel::NEON) return dotNEON;
+#else
+    (void)best;
+#endif
+    return dotScalar;
+}
+
+} // anonymous namespace
+
+PolyphaseResampler::PolyphaseResampler()
+    : input_rate_(0)
+    , output_rate_(0)
+    , channels_(0)
+    , up_(1)
+    , down_(1)
+    , taps_per_phase_(0)
+    , delay_(0)
+    , dot_(getDotKernel(detectSIMDLevel()))
+    , base_(0)
+    , input_frames_(0)
+    , output_frames_(0)
+    , initialized_(false)
+{
+}
+
+bool PolyphaseResampler::isSupportedRatio(int input_rate, int output_rate) {
+    if (input_rate <= 0 || output_rate <= 0) {
+        return false;
+    }
+    int g = std::gcd(input_rate, output_rate);
+    return input_rate / g <= MAX_FACTOR && output_rate / g <= MAX_FACTOR;
+}
+
+bool PolyphaseResampler::qualityFromString(const char* name, ResamplerQuality& quality) {
+    if (name == nullptr) {
+        return false;
+    }
+    if (std::strcmp(name, "fast") == 0) {
+        quality = ResamplerQuality::Fast;
+    } else if (std::strcmp(name, "medium") == 0) {
+        quality = ResamplerQuality::Medium;
+    } else if (std::strcmp(name, "best") == 0) {
+        quality = ResamplerQuality::Best;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+void PolyphaseResampler::setSIMDLevel(SIMDLevel level) {
+    dot_ = getDotKernel(level);
+}
+
+ErrorCode PolyphaseResampler::init(int input_rate, int output_rate, int channels,
+                                   ResamplerQuality quality) {
+    if (input_rate <= 0 || output_rate <= 0 || channels <= 0) {
+        return ErrorCode::InvalidArgument;
+    }
+    if (!isSupportedRatio(input_rate, output_rate)) {
+        return ErrorCode::NotSupported;
+    }
+
+    input_rate_ = input_rate;
+    output_rate_ = output_rate;
+    channels_ = channels;
+
+    const int g = std::gcd(input_rate, output_rate);
+    up_ = output_rate / g;
+    down_ = input_rate / g;
+
+    // Prototype low-pass at the upsampled rate (input_rate * L)
+    const FilterPreset& preset = PRESETS[static_cast<int>(quality)];
+    const int span = std::max(up_, down_);
+    const size_t taps = static_cast<size_t>(preset.span) * span + 1;
+
+    // Split into L phases, padded to whole SIMD blocks (zero taps on the oldest side)
+    taps_per_phase_ = (taps + up_ - 1) / up_;
+    taps_per_phase_ = (taps_per_phase_ + TAP_BLOCK - 1) / TAP_BLOCK * TAP_BLOCK;
+
+    // The key names every input of the design below; bump the revision when it changes
+    char key[160];
+    std::snprintf(key, sizeof(key), "polyphase-kaiser r1 L=%d M=%d span=%d beta=%.4f rolloff=%.4f K=%zu",
+                  up_, down_, preset.span, preset.kaiser_beta, preset.rolloff, taps_per_phase_);
+
+    const int up = up_;
+    const size_t k = taps_per_phase_;
+    phases_ = FilterCache::get(key, static_cast<size_t>(up_) * k, [&](float* phases, size_t) {
+        const double cutoff = 0.5 / span * preset.rolloff;
+        const double center = (taps - 1) / 2.0;
+        const double i0_beta = besselI0(preset.kaiser_beta);
+
+        std::vector<double> h(taps);
+        double sum = 0.0;
+        for (size_t i = 0; i < taps; ++i) {
+            double x = i - center;
+            double sinc = (x == 0.0) ? 2.0 * cutoff
+                                     : std::sin(2.0 * PI * cutoff * x) / (PI * x);
+            double r = x / center;
+            h[i] = sinc * besselI0(preset.kaiser_beta * std::sqrt(std::max(0.0, 1.0 - r * r))) / i0_beta;
+            sum += h[i];
+        }
+
+        // Reversed for ascending dot products; gain L restores the level lost to zero stuffing
+        for (size_t i = 0; i < taps; ++i) {
+            size_t phase = i % up;
+            size_t tap = i / up;
+            phases[phase * k + (k - 1 - tap)] = static_cast<float>(h[i] * up / sum);
+        }
+    });
+
+    delay_ = (taps - 1) / 2;
+
+    // Zero history so the first output sees a full window
+    history_.assign(channels_, std::vector<float>(taps_per_phase_ - 1, 0.0f));
+    base_ = -static_cast<int64_t>(taps_per_phase_ - 1);
+    input_frames_ = 0;
+    output_frames_ = 0;
+    initialized_ = true;
+
+    return ErrorCode::Success;
+}
+
+void PolyphaseResampler::produce(std::vector<float>& output, uint64_t max_output_frames) {
+    const int64_t available = base_ + static_cast<int64_t>(history_[0].size());
+    const size_t k = taps_per_phase_;
+
+    while (output_frames_ < max_output_frames) {
+        const uint64_t s = output_frames_ * down_ + delay_;
+        const int64_t newest = static_cast<int64_t>(s / up_);
+        if (newest >= available) {
+            break;
+        }
+
+        const float* coeffs = phases_->data() + (s % up_) * k;
+        const size_t start = static_cast<size_t>(newest - static_cast<int64_t>(k - 1) - base_);
+        for (int ch = 0; ch < channels_; ++ch) {
+            output.push_back(dot_(coeffs, history_[ch].data() + start, k));
+        }
+        ++output_frames_;
+    }
+
+    // Drop input no longer reachable by the next output's window
+    const uint64_t s = output_frames_ * down_ + delay_;
+    const int64_t keep_from = static_cast<int64_t>(s / up_) - static_cast<int64_t>(k - 1);
+    const int64_t drop = std::min<int64_t>(keep_from - base_, static_cast<int64_t>(history_[0].size()));
+    if (drop > 0) {
+        for (auto& channel : history_) {
+            channel.erase(channel.begin(), channel.begin() + drop);
+        }
+        base_ += drop;
+    }
+}
+
+ErrorCode PolyphaseResampler::process(const float* input, size_t input_frames, std::vector<float>& output) {
+    output.clear();
+    if (!initialized_ || !isActive()) {
+        output.assign(input, input + input_frames * channels_);
+        return initialized_ ? ErrorCode::Success : ErrorCode::InvalidOperation;
+    }
+
+    for (int ch = 0; ch < channels_; ++ch) {
+        auto& channel = history_[ch];
+        size_t base = channel.size();
+        channel.resize(base + input_frames);
+        for (size_t i = 0; i < input_frames; ++i) {
+            channel[base + i] = input[i * channels_ + ch];
+        }
+    }
+    input_frames_ += input_frames;
+
+    output.reserve((input_frames * up_ / down_ + 2) * channels_);
+    produce(output, std::numeric_limits<uint64_t>::max());
+    return ErrorCode::Success;
+}
+
+ErrorCode PolyphaseResampler::flush(std::vector<float>& output) {
+    output.clear();
+    if (!initialized_ || !isActive()) {
+        return ErrorCode::Success;
+    }
+
+    const uint64_t total = getOutputFrames(input_frames_);
+    if (output_frames_ >= total) {
+        return ErrorCode::Success;
+    }
+
+    // Pad with silence until the last output's window is covered
+    const uint64_t last_s = (total - 1) * down_ + delay_;
+    const int64_t needed = static_cast<int64_t>(last_s / up_) + 1;
+    const int64_t available = base_ + static_cast<int64_t>(history_[0].size());
+    if (needed > available) {
+        for (auto& channel : history_) {
+            channel.resize(channel.size() + static_cast<size_t>(needed - available), 0.0f);
+        }
+    }
+
+    produce(output, total);
+    return ErrorCode::Success;
+}
+
+uint64_t PolyphaseResampler::getOutputFrames(uint64_t input_frames) const {
+    if (!initialized_ || !isActive()) {
+        return input_frames;
+    }
+    return (input_frames * up_ + down_ - 1) / down_;
+}
+
+uint64_t PolyphaseResampler::getReadyOutputFrames(uint64_t input_frames) const {
+    if (!initialized_ || !isActive()) {
+        return input_frames;
+    }
+    // Outputs n with (n * M + delay) / L < input_frames
+    const uint64_t limit = input_frames * up_;
+    return limit > delay_ ? (limit - delay_ + down_ - 1) / down_ : 0;
+}
+
+int64_t PolyphaseResampler::getFirstInputFrame(uint64_t output_frame) const {
+    if (!initialized_ || !isActive()) {
+        return static_cast<int64_t>(output_frame);
+    }
+    return static_cast<int64_t>((output_frame * down_ + delay_) / up_) - static_cast<int64_t>(taps_per_phase_ - 1);
+}
+
+ErrorCode PolyphaseResampler::resampleSegment(const float* input, size_t input_frames, uint64_t first_output,
+                                              size_t output_count, std::vector<float>& output) const {
+    if (initialized_ && first_output + output_count > getOutputFrames(input_frames)) {
+        output.clear();
+        return ErrorCode::InvalidArgument;
+    }
+    return resampleSegment(input, input_frames, 0, first_output, output_count, output);
+}
+
+ErrorCode PolyphaseResampler::resampleSegment(const float* input, size_t input_frames, uint64_t input_start,
+                                              uint64_t first_output, size_t output_count,
+                                              std::vector<float>& output) const {
+    output.clear();
+    if (!initialized_) {
+        return ErrorCode::InvalidOperation;
+    }
+    if (!isActive()) {
+        if (first_output < input_start || first_output + output_count > input_start + input_frames) {
+            return ErrorCode::InvalidArgument;
+        }
+        const float* first = input + (first_output - input_start) * channels_;
+        output.assign(first, first + output_count * channels_);
+        return ErrorCode::Success;
+    }
+    if (output_count == 0) {
+        return ErrorCode::Success;
+    }
+
+    // Same windows as produce(): from the first output's oldest tap to the last output's newest
+    const size_t k = taps_per_phase_;
+    const uint64_t last = first_output + output_count - 1;
+    const int64_t begin = getFirstInputFrame(first_output);
+    const int64_t end = static_cast<int64_t>((last * down_ + delay_) / up_) + 1;
+    const int64_t window_begin = static_cast<int64_t>(input_start);
+    const int64_t window_end = window_begin + static_cast<int64_t>(input_frames);
+
+    std::vector<float> window(static_cast<size_t>(end - begin));
+    output.resize(output_count * channels_);
+    for (int ch = 0; ch < channels_; ++ch) {
+        for (int64_t i = begin; i < end; ++i) {
+            window[i - begin] = (i >= window_begin && i < window_end)
+                ? input[(i - window_begin) * channels_ + ch] : 0.0f;
+        }
+        for (size_t n = 0; n < output_count; ++n) {
+            const uint64_t s = (first_output + n) * down_ + delay_;
+            const float* coeffs = phases_->data() + (s % up_) * k;
+            const size_t start = static_cast<size_t>(static_cast<int64_t>(s / up_) - static_cast<int64_t>(k - 1) - begin);
+            output[n * channels_ + ch] = dot_(coeffs, window.data() + start, k);
+        }
+    }
+    return ErrorCode::Success;
+}
+
+} // namespace audio
+} // namespace xpu
@@ -0,0 +1,169 @@
+#ifndef XPU_AUDIO_POLYPHASE_RESAMPLER_H
+#define XPU_AUDIO_POLYPHASE_RESAMPLER_H
+
+#include "protocol/ErrorCode.h"
+#include "DSDKernels.h"
+#include "FilterCache.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace xpu {
+namespace audio {
+
+/**
+ * @brief Filter presets, matching the tiers of libsamplerate's sinc converters
+ *
+ * Stopband attenuation / passband as share of the lower Nyquist frequency /
+ * filter length in periods of the lower rate.
+ */
+enum class ResamplerQuality : int {
+    Fast,     // ~97 dB, 80 %, 64 (default)
+    Medium,   // ~121 dB, 90 %, 160
+    Best      // ~145 dB, 97 %, 640
+};
+
+/**
+ * @brief Rational-ratio polyphase FIR resampler
+ *
+ * Converts between rates whose ratio reduces to L/M with max(L, M) up to
+ * MAX_FACTOR (e.g. 176400 -> 48000 is 40/147). The prototype is a
+ * Kaiser-windowed sinc at the lower of the two Nyquist frequencies, split
+ * into L phases so each output sample costs one short dot product per
+ * channel. Output is aligned with the input (group delay compensated) and
+ * the total length is ceil(input_frames * L / M) once flush() is called.
+ *
+ * The dot products run on the detected SIMD level (SSE4.1, AVX2 or NEON);
+ * levels differ from scalar only by float rounding. Phase tables come from
+ * FilterCache, so large designs are computed once and then memory-mapped.
+ */
+class PolyphaseResampler {
+public:
+    /**
+     * @brief Largest supported interpolation/decimation factor after reduction
+     */
+    static constexpr int MAX_FACTOR = 4096;
+
+    PolyphaseResampler();
+
+    /**
+     * @brief Check whether a rate pair reduces to a supported ratio
+     */
+    static bool isSupportedRatio(int input_rate, int output_rate);
+
+    /**
+     * @brief Map a quality name ("fast", "medium", "best") to a preset
+     * @return false for names without a preset (e.g. "linear", "zero")
+     */
+    static bool qualityFromString(const char* name, ResamplerQuality& quality);
+
+    /**
+     * @brief Initialize the resampler
+     * @return ErrorCode::NotSupported if the reduced ratio is too large
+     */
+    ErrorCode init(int input_rate, int output_rate, int channels,
+                   ResamplerQuality quality = ResamplerQuality::Fast);
+
+    /**
+     * @brief Force the SIMD level of the dot products (default: detected)
+     */
+    void setSIMDLevel(SIMDLevel level);
+
+    /**
+     * @brief Process a chunk of audio data
+     * @param input Input audio frames (interleaved)
+     * @param input_frames Number of input frames
+     * @param output Output buffer (replaced with the generated interleaved frames)
+     */
+    ErrorCode process(const float* input, size_t input_frames, std::vector<float>& output);
+
+    /**
+     * @brief Drain the filter tail (call once after the last process())
+     */
+    ErrorCode flush(std::vector<float>& output);
+
+    /**
+     * @brief Resample output frames [first_output, first_output + output_count) of a complete input
+     *
+     * Reads the input under the segment's filter windows, i.e. the frames
+     * feeding its outputs plus getTapsPerPhase() - 1 frames of overlap with
+     * the previous segment; frames outside the input count as silence. The
+     * result is sample-identical to process() + flush() over the whole input,
+     * so disjoint output ranges can run on separate threads and be
+     * concatenated. Does not touch the streaming state.
+     * @param output Output buffer (replaced with the interleaved frames)
+     * @return ErrorCode::InvalidArgument if the range ends past getOutputFrames(input_frames)
+     */
+    ErrorCode resampleSegment(const float* input, size_t input_frames, uint64_t first_output,
+                              size_t output_count, std::vector<float>& output) const;
+
+    /**
+     * @brief resampleSegment() over a window of the input
+     *
+     * input holds input_frames frames starting at absolute input frame
+     * input_start; frames outside the window count as silence. Equal to the
+     * serial result as long as the window covers every frame the range
+     * reads (see getFirstInputFrame() and getReadyOutputFrames()) that lies
+     * inside the whole input, so a long stream can be resampled in parallel
+     * one bounded window at a time.
+     */
+    ErrorCode resampleSegment(const float* input, size_t input_frames, uint64_t input_start,
+                              uint64_t first_output, size_t output_count, std::vector<float>& output) const;
+
+    /**
+     * @brief Total output frames for an input length (ceil(input_frames * L / M))
+     */
+    uint64_t getOutputFrames(uint64_t input_frames) const;
+
+    /**
+     * @brief Output frames whose filter window ends within the first input_frames frames
+     *
+     * The frames process() has produced after input_frames frames of input.
+     */
+    uint64_t getReadyOutputFrames(uint64_t input_frames) const;
+
+    /**
+     * @brief Oldest input frame read by an output frame (negative: before the input)
+     */
+    int64_t getFirstInputFrame(uint64_t output_frame) const;
+
+    /**
+     * @brief Check if resampling is needed
+     */
+    bool isActive() const { return input_rate_ != output_rate_; }
+
+    int getUpFactor() const { return up_; }
+    int getDownFactor() const { return down_; }
+    size_t getTapsPerPhase() const { return taps_per_phase_; }
+
+    /**
+     * @brief Dot product kernel: sum of coeffs[i] * x[i] for i < taps
+     */
+    using DotKernel = float (*)(const float* coeffs, const float* x, size_t taps);
+
+private:
+    void produce(std::vector<float>& output, uint64_t max_output_frames);
+
+    int input_rate_;
+    int output_rate_;
+    int channels_;
+    int up_;                       // L
+    int down_;                     // M
+    size_t taps_per_phase_;        // K, a multiple of 8 (zero taps in front)
+    uint64_t delay_;               // Group delay in upsampled-domain samples
+    std::shared_ptr<const FilterTable> phases_;  // L phases x K taps, reversed for ascending dot products
+    DotKernel dot_;
+
+    // Planar input history per channel; history_[ch][0] is absolute input frame base_
+    std::vector<std::vector<float>> history_;
+    int64_t base_;
+    uint64_t input_frames_;        // Total input frames received
+    uint64_t output_frames_;       // Total output frames generated
+    bool initialized_;
+};
+
+} // namespace audio
+} // namespace xpu
+
+#endif // XPU_AUDIO_POLYPHASE_RESAMPLER_H
@@ -0,0 +1,390 @@
+#include "SampleConverter.h"
+#include <cmath>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define XPU_PCM_X86 1
+#include <immintrin.h>
+#endif
+
+// vcvtnq_s32_f32 (round to nearest) needs ARMv8
+#if defined(__aarch64__) || defined(_M_ARM64)
+#define XPU_PCM_NEON 1
+#include <arm_neon.h>
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define XPU_TARGET(isa) __attribute__((target(isa)))
+#else
+#define XPU_TARGET(isa)
+#endif
+
+namespace xpu {
+namespace audio {
+
+namespace {
+
+constexpr float SCALE_8 = 1.0f / 128.0f;
+constexpr float SCALE_16 = 1.0f / 32768.0f;
+constexpr float SCALE_24 = 1.0f / 8388608.0f;
+constexpr float SCALE_32 = 1.0f / 2147483648.0f;
+
+constexpr uint32_t HASH_MUL_1 = 0x7FEB352Du;
+constexpr uint32_t HASH_MUL_2 = 0x846CA68Bu;
+constexpr float DITHER_SCALE = 1.0f / 65536.0f;
+
+/**
+ * @brief Output format of a pack kernel
+ *
+ * scale maps [-1, 1) to the integer range; max is the largest float that
+ * converts without overflow (2^31 - 1 is not a float, so Int32 stops 128
+ * below it).
+ */
+struct PackFormat {
+    int bytes;
+    float scale;
+    float max;
+};
+
+constexpr PackFormat PACK_16 = {2, 32768.0f, 32767.0f};
+constexpr PackFormat PACK_24 = {3, 8388608.0f, 8388607.0f};
+constexpr PackFormat PACK_32 = {4, 2147483648.0f, 2147483520.0f};
+
+/**
+ * @brief Float -> packed integer kernel
+ * @param counter Dither counter of the first sample (seed + position)
+ * @param dither Whether to add TPDF noise
+ */
+using PackKernel = void (*)(const float* in, size_t samples, const PackFormat& format,
+                            uint8_t* out, uint32_t counter, bool dither);
+
+// ============================================================================
+// Scalar kernel
+// ============================================================================
+
+/**
+ * @brief 32-bit integer hash (lowbias32) of the dither counter
+ */
+inline uint32_t ditherHash(uint32_t x) {
+    x ^= x >> 16;
+    x *= HASH_MUL_1;
+    x ^= x >> 15;
+    x *= HASH_MUL_2;
+    x ^= x >> 16;
+    return x;
+}
+
+/**
+ * @brief TPDF noise in LSB: the sum of two 16-bit uniforms, in (-1, 1)
+ */
+inline float ditherNoise(uint32_t counter) {
+    const uint32_t h = ditherHash(counter);
+    return static_cast<float>(static_cast<int32_t>((h & 0xFFFF) + (h >> 16)) - 65535) * DITHER_SCALE;
+}
+
+/**
+ * @brief Scale, dither and clip one sample, then round to nearest
+ *
+ * The scale is a power of two, so the product is exact and a fused
+ * multiply-add gives the same result. Clipping compares like MAXPS / MINPS,
+ * so NaN becomes negative full scale in every kernel.
+ */
+inline int32_t quantize(float sample, const PackFormat& format, float noise) {
+    float v = sample * format.scale + noise;
+    v = v > -format.scale ? v : -format.scale;
+    v = v < format.max ? v : format.max;
+    return static_cast<int32_t>(std::nearbyint(v));
+}
+
+inline void storeSample(int32_t value, int bytes, uint8_t* out) {
+    if (bytes == 2) {
+        const int16_t v16 = static_cast<int16_t>(value);
+        std::memcpy(out, &v16, sizeof(v16));
+    } else if (bytes == 3) {
+        out[0] = static_cast<uint8_t>(value & 0xFF);
+        out[1] = static_cast<uint8_t>((value >> 8) & 0xFF);
+        out[2] = static_cast<uint8_t>((value >> 16) & 0xFF);
+    } else {
+        std::memcpy(out, &value, sizeof(value));
+    }
+}
+
+void packScalar(const float* in, size_t samples, const PackFormat& format,
+                uint8_t* out, uint32_t counter, bool dither) {
+    for (size_t i = 0; i < samples; ++i) {
+        const float noise = dither ? ditherNoise(counter + static_cast<uint32_t>(i)) : 0.0f;
+        storeSample(quantize(in[i], format, noise), format.bytes, out + i * format.bytes);
+    }
+}
+
+// ============================================================================
+// x86 kernels
+// ============================================================================
+
+#ifdef XPU_PCM_X86
+
+XPU_TARGET("sse4.1")
+inline __m128 ditherNoiseSSE41(__m128i counter) {
+    __m128i x = _mm_xor_si128(counter, _mm_srli_epi32(counter, 16));
+    x = _mm_mullo_epi32(x, _mm_set1_epi32(static_cast<int>(HASH_MUL_1)));
+    x = _mm_xor_si128(x, _mm_srli_epi32(x, 15));
+    x = _mm_mullo_epi32(x, _mm_set1_epi32(static_cast<int>(HASH_MUL_2)));
+    x = _mm_xor_si128(x, _mm_srli_epi32(x, 16));
+    const __m128i sum = _mm_add_epi32(_mm_and_si128(x, _mm_set1_epi32(0xFFFF)), _mm_srli_epi32(x, 16));
+    return _mm_mul_ps(_mm_cvtepi32_ps(_mm_sub_epi32(sum, _mm_set1_epi32(65535))), _mm_set1_ps(DITHER_SCALE));
+}
+
+XPU_TARGET("sse4.1")
+void packSSE41(const float* in, size_t samples, const PackFormat& format,
+               uint8_t* out, uint32_t counter, bool dither) {
+    const __m128 scale = _mm_set1_ps(format.scale);
+    const __m128 lo = _mm_set1_ps(-format.scale);
+    const __m128 hi = _mm_set1_ps(format.max);
+    const __m128i pack24 = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+    __m128i count = _mm_add_epi32(_mm_set1_epi32(static_cast<int>(counter)), _mm_setr_epi32(0, 1, 2, 3));
+    const __m128i step = _mm_set1_epi32(4);
+
+    size_t i = 0;
+    for (; i + 4 <= samples; i += 4) {
+        __m128 v = _mm_mul_ps(_mm_loadu_ps(in + i), scale);
+        if (dither) {
+            v = _mm_add_ps(v, ditherNoiseSSE41(count));
+            count = _mm_add_epi32(count, step);
+        }
+        v = _mm_min_ps(_mm_max_ps(v, lo), hi);
+        const __m128i q = _mm_cvtps_epi32(v);
+
+        uint8_t* dst = out + i * format.bytes;
+        if (format.bytes == 2) {
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(dst), _mm_packs_epi32(q, q));
+        } else if (format.bytes == 3) {
+            const __m128i packed = _mm_shuffle_epi8(q, pack24);
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(dst), packed);
+            const int32_t tail = _mm_cvtsi128_si32(_mm_srli_si128(packed, 8));
+            std::memcpy(dst + 8, &tail, sizeof(tail));
+        } else {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), q);
+        }
+    }
+
+    if (i < samples) {
+        packScalar(in + i, samples - i, format, out + i * format.bytes,
+                   counter + static_cast<uint32_t>(i), dither);
+    }
+}
+
+XPU_TARGET("avx2")
+inline __m256 ditherNoiseAVX2(__m256i counter) {
+    __m256i x = _mm256_xor_si256(counter, _mm256_srli_epi32(counter, 16));
+    x = _mm256_mullo_epi32(x, _mm256_set1_epi32(static_cast<int>(HASH_MUL_1)));
+    x = _mm256_xor_si256(x, _mm256_srli_epi32(x, 15));
+    x = _mm256_mullo_epi32(x, _mm256_set1_epi32(static_cast<int>(HASH_MUL_2)));
+    x = _mm256_xor_si256(x, _mm256_srli_epi32(x, 16));
+    const __m256i sum = _mm256_add_epi32(_mm256_and_si256(x, _mm256_set1_epi32(0xFFFF)),
+                                         _mm256_srli_epi32(x, 16));
+    return _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_sub_epi32(sum, _mm256_set1_epi32(65535))),
+                         _mm256_set1_ps(DITHER_SCALE));
+}
+
+XPU_TARGET("avx2")
+void packAVX2(const float* in, size_t samples, const PackFormat& format,
+              uint8_t* out, uint32_t counter, bool dither) {
+    const __m256 scale = _mm256_set1_ps(format.scale);
+    const __m256 lo = _mm256_set1_ps(-format.scale);
+    const __m256 hi = _mm256_set1_ps(format.max);
+    // Per 128-bit lane: 4 samples -> 12 bytes, then the two 12-byte runs are
+    // moved together into the low 24 bytes
+    const __m256i pack24 = _mm256_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1,
+                                            0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+    const __m256i join24 = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7);
+    __m256i count = _mm256_add_epi32(_mm256_set1_epi32(static_cast<int>(counter)),
+                                     _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+    const __m256i step = _mm256_set1_epi32(8);
+
+    size_t i = 0;
+    for (; i + 8 <= samples; i += 8) {
+        __m256 v = _mm256_mul_ps(_mm256_loadu_ps(in + i), scale);
+        if (dither) {
+            v = _mm256_add_ps(v, ditherNoiseAVX2(count));
+            count = _mm256_add_epi32(count, step);
+        }
+        v = _mm256_min_ps(_mm256_max_ps(v, lo), hi);
+        const __m256i q = _mm256_cvtps_epi32(v);
+
+        uint8_t* dst = out + i * format.bytes;
+        if (format.bytes == 2) {
+            const __m256i packed = _mm256_permute4x64_epi64(_mm256_packs_epi32(q, q), 0x08);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm256_castsi256_si128(packed));
+        } else if (format.bytes == 3) {
+            const __m256i packed = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(q, pack24), join24);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm256_castsi256_si128(packed));
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + 16), _mm256_extracti128_si256(packed, 1));
+        } else {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), q);
+        }
+    }
+
+    if (i < samples) {
+        packSSE41(in + i, samples - i, format, out + i * format.bytes,
+                  counter + static_cast<uint32_t>(i), dither);
+    }
+}
+
+#endif // XPU_PCM_X86
+
+// ============================================================================
+// ARM kernel
+// ============================================================================
+
+#ifdef XPU_PCM_NEON
+
+inline float32x4_t ditherNoiseNEON(uint32x4_t counter) {
+    uint32x4_t x = veorq_u32(counter, vshrq_n_u32(counter, 16));
+    x = vmulq_u32(x, vdupq_n_u32(HASH_MUL_1));
+    x = veorq_u32(x, vshrq_n_u32(x, 15));
+    x = vmulq_u32(x, vdupq_n_u32(HASH_MUL_2));
+    x = veorq_u32(x, vshrq_n_u32(x, 16));
+    const uint32x4_t sum = vaddq_u32(vandq_u32(x, vdupq_n_u32(0xFFFF)), vshrq_n_u32(x, 16));
+    const int32x4_t centered = vsubq_s32(vreinterpretq_s32_u32(sum), vdupq_n_s32(65535));
+    return vmulq_n_f32(vcvtq_f32_s32(centered), DITHER_SCALE);
+}
+
+void packNEON(const float* in, size_t samples, const PackFormat& format,
+              uint8_t* out, uint32_t counter, bool dither) {
+    const float32x4_t scale = vdupq_n_f32(format.scale);
+    const float32x4_t lo = vdupq_n_f32(-format.scale);
+    const float32x4_t hi = vdupq_n_f32(format.max);
+    static const uint8_t PACK24[16] = {0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, 0xFF, 0xFF, 0xFF, 0xFF};
+    const uint8x16_t pack24 = vld1q_u8(PACK24);
+    static const uint32_t LANES[4] = {0, 1, 2, 3};
+    uint32x4_t count = vaddq_u32(vdupq_n_u32(counter), vld1q_u32(LANES));
+    const uint32x4_t step = vdupq_n_u32(4);
+
+    size_t i = 0;
+    for (; i + 4 <= samples; i += 4) {
+        float32x4_t v = vmulq_f32(vld1q_f32(in + i), scale);
+        if (dither) {
+            v = vaddq_f32(v, ditherNoiseNEON(count));
+            count = vaddq_u32(count, step);
+        }
+        // Same NaN handling as the scalar comparisons
+        v = vbslq_f32(vcgtq_f32(v, lo), v, lo);
+        v = vbslq_f32(vcltq_f32(v, hi), v, hi);
+        const int32x4_t q = vcvtnq_s32_f32(v);
+
+        uint8_t* dst = out + i * format.bytes;
+        if (format.bytes == 2) {
+            vst1_u8(dst, vreinterpret_u8_s16(vqmovn_s32(q)));
+        } else if (format.bytes == 3) {
+            const uint8x16_t packed = vqtbl1q_u8(vreinterpretq_u8_s32(q), pack24);
+            vst1_u8(dst, vget_low_u8(packed));
+            const uint32_t tail = vgetq_lane_u32(vreinterpretq_u32_u8(packed), 2);
+            std::memcpy(dst + 8, &tail, sizeof(tail));
+        } else {
+            vst1q_u8(dst, vreinterpretq_u8_s32(q));
+        }
+    }
+
+    if (i < samples) {
+        packScalar(in + i, samples - i, format, out + i * format.bytes,
+                   counter + static_cast<uint32_t>(i), dither);
+    }
+}
+
+#endif // XPU_PCM_NEON
+
+PackKernel getPackKernel(SIMDLevel level) {
+    const SIMDLevel best = detectSIMDLevel();
+#if defined(XPU_PCM_X86)
+    if (level == SIMDLevel::AVX2 && best == SIMDLevel::AVX2) return packAVX2;
+    if ((level == SIMDLevel::AVX2 || level == SIMDLevel::SSE41) && best != SIMDLevel::Scalar) {
+        return packSSE41;
+    }
+#elif defined(XPU_PCM_NEON)
+    if (level == SIMDLevel::NEON && best == SIMDLevel::NEON) return packNEON;
+#else
+    (void)best;
+#endif
+    return packScalar;
+}
+
+} // anonymous namespace
+
+bool SampleConverter::isSupported(SampleFormat format) {
+    return isInteger(format) || format == SampleFormat::Float32;
+}
+
+bool SampleConverter::isInteger(SampleFormat format) {
+    return format == SampleFormat::UInt8 || format == SampleFormat::Int16 ||
+           format == SampleFormat::Int24 || format == SampleFormat::Int32;
+}
+
+bool SampleConverter::toFloat(const uint8_t* in, SampleFormat format, size_t samples, float* out) {
+    switch (format) {
+        case SampleFormat::UInt8:
+            for (size_t i = 0; i < samples; ++i) {
+                out[i] = (static_cast<int>(in[i]) - 128) * SCALE_8;
+            }
+            return true;
+
+        case SampleFormat::Int16:
+            for (size_t i = 0; i < samples; ++i) {
+                int16_t value;
+                std::memcpy(&value, in + i * 2, sizeof(value));
+                out[i] = value * SCALE_16;
+            }
+            return true;
+
+        case SampleFormat::Int24:
+            for (size_t i = 0; i < samples; ++i) {
+                const uint8_t* p = in + i * 3;
+                // Assemble in the top three bytes, then shift down to sign-extend
+                const int32_t value = static_cast<int32_t>((static_cast<uint32_t>(p[0]) << 8) |
+                                                           (static_cast<uint32_t>(p[1]) << 16) |
+                                                           (static_cast<uint32_t>(p[2]) << 24)) >> 8;
+                out[i] = value * SCALE_24;
+            }
+            return true;
+
+        case SampleFormat::Int32:
+            for (size_t i = 0; i < samples; ++i) {
+                int32_t value;
+                std::memcpy(&value, in + i * 4, sizeof(value));
+                out[i] = static_cast<float>(value) * SCALE_32;
+            }
+            return true;
+
+        case SampleFormat::Float32:
+            std::memcpy(out, in, samples * sizeof(float));
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+bool SampleConverter::fromFloat(const float* in, size_t samples, SampleFormat format, uint8_t* out,
+                                DitherState* dither) {
+    return fromFloat(in, samples, format, out, dither, detectSIMDLevel());
+}
+
+bool SampleConverter::fromFloat(const float* in, size_t samples, SampleFormat format, uint8_t* out,
+                                DitherState* dither, SIMDLevel level) {
+    const PackFormat* pack = format == SampleFormat::Int16 ? &PACK_16 :
+                             format == SampleFormat::Int24 ? &PACK_24 :
+                             format == SampleFormat::Int32 ? &PACK_32 : nullptr;
+    if (!pack) {
+        return false;
+    }
+
+    const bool dithered = dither && format != SampleFormat::Int32;
+    const uint32_t counter = dithered ? dither->seed + dither->position : 0;
+    getPackKernel(level)(in, samples, *pack, out, counter, dithered);
+    if (dithered) {
+        dither->position += static_cast<uint32_t>(samples);
+    }
+    return true;
+}
+
+} // namespace audio
+} // namespace xpu
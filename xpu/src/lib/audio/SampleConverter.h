@@ -0,0 +1,92 @@
+/**
+ * @file SampleConverter.h
+ * @brief Integer PCM <-> float conversion for the xpu chunk stream
+ */
+
+#ifndef XPU_AUDIO_SAMPLE_CONVERTER_H
+#define XPU_AUDIO_SAMPLE_CONVERTER_H
+
+#include "AudioFormat.h"
+#include "DSDKernels.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace xpu {
+namespace audio {
+
+/**
+ * @brief TPDF dither state of one stream for SampleConverter::fromFloat()
+ *
+ * The noise of each sample is a hash of seed and sample position, so a
+ * stream converted chunk by chunk gets the same noise as in one call, and
+ * every SIMD level produces identical output.
+ */
+struct DitherState {
+    uint32_t seed;
+    uint32_t position = 0;  // Samples dithered so far (wraps)
+
+    explicit DitherState(uint32_t seed_value = 0x2545F491u) : seed(seed_value) {}
+};
+
+/**
+ * @brief Converts interleaved little-endian PCM samples to and from float
+ *
+ * Stages downstream of xpuLoad receive chunks in the sample format declared
+ * by the metadata header ("sample_format"); this turns integer chunks into
+ * the float samples their DSP works on. Full scale maps to [-1, 1):
+ * Int16 / 2^15, Int24 (packed 3 bytes) / 2^23, Int32 / 2^31, UInt8 offset
+ * by 128 / 2^7, so every 16- and 24-bit value is exactly representable.
+ */
+class SampleConverter {
+public:
+    /**
+     * @brief Check whether a format can be converted by toFloat()
+     */
+    static bool isSupported(SampleFormat format);
+
+    /**
+     * @brief Check whether a format is an integer PCM format
+     */
+    static bool isInteger(SampleFormat format);
+
+    /**
+     * @brief Convert samples to float
+     * @param in Packed input samples (samples * bytes per sample)
+     * @param format Input sample format (UInt8, Int16, Int24, Int32 or Float32)
+     * @param samples Number of samples (frames * channels)
+     * @param out Output buffer with room for samples floats
+     * @return false if the format is not supported
+     */
+    static bool toFloat(const uint8_t* in, SampleFormat format, size_t samples, float* out);
+
+    /**
+     * @brief Convert float samples to packed integer PCM
+     * @param in Float samples, full scale [-1, 1)
+     * @param samples Number of samples (frames * channels)
+     * @param format Output sample format (Int16, Int24 packed in 3 bytes, or Int32)
+     * @param out Output buffer with room for samples * bytes per sample
+     * @param dither TPDF dither (+-1 LSB triangular) for Int16 / Int24, nullptr = none
+     * @return false if the format is not supported
+     *
+     * The inverse of toFloat(): samples are scaled by 2^(bits - 1), rounded
+     * to nearest and clipped, so integer samples survive the round trip
+     * unchanged when no dither is applied. Int32 is never dithered (float
+     * carries only 24 bits). Uses the SIMD level from detectSIMDLevel().
+     */
+    static bool fromFloat(const float* in, size_t samples, SampleFormat format, uint8_t* out,
+                          DitherState* dither = nullptr);
+
+    /**
+     * @brief fromFloat() with an explicit SIMD level (for tests and benchmarks)
+     *
+     * Levels not compiled in or not supported by the CPU fall back to the
+     * best available level below them; all levels give identical output.
+     */
+    static bool fromFloat(const float* in, size_t samples, SampleFormat format, uint8_t* out,
+                          DitherState* dither, SIMDLevel level);
+};
+
+} // namespace audio
+} // namespace xpu
+
+#endif // XPU_AUDIO_SAMPLE_CONVERTER_H
@@ -0,0 +1,156 @@
+#include "WAVWriter.h"
+#include <cstring>
+
+namespace xpu {
+namespace audio {
+
+namespace {
+
+constexpr uint32_t FMT_CHUNK_SIZE = 16;
+constexpr uint32_t DS64_CHUNK_SIZE = 28;      // riff size, data size, sample count (64-bit), table length
+constexpr uint32_t SIZE_IN_DS64 = 0xFFFFFFFFu;  // 32-bit size field of an RF64 file
+constexpr uint64_t DATA_SIZE_OFFSET = WAVWriter::HEADER_SIZE - 4;
+constexpr size_t WRITE_BUFFER_SIZE = 1024 * 1024;
+
+void putTag(uint8_t* out, const char* tag) {
+    std::memcpy(out, tag, 4);
+}
+
+void put16(uint8_t* out, uint16_t value) {
+    out[0] = static_cast<uint8_t>(value);
+    out[1] = static_cast<uint8_t>(value >> 8);
+}
+
+void put32(uint8_t* out, uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+        out[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+}
+
+void put64(uint8_t* out, uint64_t value) {
+    for (int i = 0; i < 8; ++i) {
+        out[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+}
+
+} // namespace
+
+WAVWriter::WAVWriter()
+    : buffer_(WRITE_BUFFER_SIZE)
+    , data_bytes_(0)
+    , block_align_(0)
+    , force_rf64_(false) {
+}
+
+WAVWriter::~WAVWriter() {
+    close();
+}
+
+ErrorCode WAVWriter::open(const std::string& path, int sample_rate, int channels,
+                          int bits_per_sample, bool is_float, bool force_rf64) {
+    close();
+
+    const bool valid_bits = is_float ? bits_per_sample == 32
+                                     : (bits_per_sample == 16 || bits_per_sample == 24 || bits_per_sample == 32);
+    if (sample_rate <= 0 || channels <= 0 || channels > 65535 || !valid_bits) {
+        return ErrorCode::InvalidArgument;
+    }
+
+    block_align_ = static_cast<uint32_t>(channels) * static_cast<uint32_t>(bits_per_sample / 8);
+    data_bytes_ = 0;
+    force_rf64_ = force_rf64;
+
+    file_.rdbuf()->pubsetbuf(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+    file_.open(path, std::ios::binary | std::ios::trunc);
+    if (!file_.is_open()) {
+        return ErrorCode::FileWriteError;
+    }
+
+    // Sizes stay "unknown" (0xFFFFFFFF) until close(), so an interrupted
+    // file still reads to its end in most players
+    uint8_t header[HEADER_SIZE] = {};
+    putTag(header, force_rf64 ? "RF64" : "RIFF");
+    put32(header + 4, SIZE_IN_DS64);
+    putTag(header + 8, "WAVE");
+
+    putTag(header + 12, force_rf64 ? "ds64" : "JUNK");
+    put32(header + 16, DS64_CHUNK_SIZE);
+
+    putTag(header + 48, "fmt ");
+    put32(header + 52, FMT_CHUNK_SIZE);
+    put16(header + 56, is_float ? 3 : 1);  // 3 = IEEE float, 1 = PCM
+    put16(header + 58, static_cast<uint16_t>(channels));
+    put32(header + 60, static_cast<uint32_t>(sample_rate));
+    put32(header + 64, static_cast<uint32_t>(sample_rate) * block_align_);
+    put16(header + 68, static_cast<uint16_t>(block_align_));
+    put16(header + 70, static_cast<uint16_t>(bits_per_sample));
+
+    putTag(header + 72, "data");
+    put32(header + 76, SIZE_IN_DS64);
+
+    file_.write(reinterpret_cast<const char*>(header), sizeof(header));
+    if (!file_) {
+        file_.close();
+        return ErrorCode::FileWriteError;
+    }
+    return ErrorCode::Success;
+}
+
+ErrorCode WAVWriter::write(const uint8_t* data, size_t bytes) {
+    if (!file_.is_open()) {
+        return ErrorCode::InvalidOperation;
+    }
+    file_.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(bytes));
+    if (!file_) {
+        return ErrorCode::FileWriteError;
+    }
+    data_bytes_ += bytes;
+    return ErrorCode::Success;
+}
+
+bool WAVWriter::isRF64() const {
+    return force_rf64_ || HEADER_SIZE - 8 + data_bytes_ + (data_bytes_ & 1) > 0xFFFFFFFFull;
+}
+
+ErrorCode WAVWriter::close() {
+    if (!file_.is_open()) {
+        return ErrorCode::Success;
+    }
+
+    // Chunks are word aligned: odd-sized data (24-bit mono) gets a pad byte
+    if (data_bytes_ & 1) {
+        file_.put('\0');
+    }
+    const uint64_t riff_size = HEADER_SIZE - 8 + data_bytes_ + (data_bytes_ & 1);
+
+    uint8_t size_field[4];
+    if (isRF64()) {
+        uint8_t rf64[12 + 8 + DS64_CHUNK_SIZE];  // RIFF header + ds64 chunk
+        putTag(rf64, "RF64");
+        put32(rf64 + 4, SIZE_IN_DS64);
+        putTag(rf64 + 8, "WAVE");
+        putTag(rf64 + 12, "ds64");
+        put32(rf64 + 16, DS64_CHUNK_SIZE);
+        put64(rf64 + 20, riff_size);
+        put64(rf64 + 28, data_bytes_);
+        put64(rf64 + 36, block_align_ > 0 ? data_bytes_ / block_align_ : 0);
+        put32(rf64 + 44, 0);  // no table entries
+        file_.seekp(0);
+        file_.write(reinterpret_cast<const char*>(rf64), sizeof(rf64));
+        put32(size_field, SIZE_IN_DS64);
+    } else {
+        put32(size_field, static_cast<uint32_t>(riff_size));
+        file_.seekp(4);
+        file_.write(reinterpret_cast<const char*>(size_field), sizeof(size_field));
+        put32(size_field, static_cast<uint32_t>(data_bytes_));
+    }
+    file_.seekp(static_cast<std::streamoff>(DATA_SIZE_OFFSET));
+    file_.write(reinterpret_cast<const char*>(size_field), sizeof(size_field));
+
+    const bool ok = static_cast<bool>(file_);
+    file_.close();
+    return ok && !file_.fail() ? ErrorCode::Success : ErrorCode::FileWriteError;
+}
+
+} // namespace audio
+} // namespace xpu
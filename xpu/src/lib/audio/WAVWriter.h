@@ -0,0 +1,84 @@
+#ifndef XPU_WAV_WRITER_H
+#define XPU_WAV_WRITER_H
+
+#include "protocol/ErrorCode.h"
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace xpu {
+namespace audio {
+
+/**
+ * @brief Streaming WAV file writer
+ *
+ * Samples are appended as they are produced; the header is written with
+ * placeholder sizes by open() and patched by close(), so memory use does
+ * not depend on the length of the file.
+ *
+ * The header reserves a JUNK chunk the size of an RF64 "ds64" chunk. When
+ * the file grows past the 4 GB limit of the 32-bit RIFF sizes, close()
+ * turns it into an RF64 file in place (EBU Tech 3306, the layout BW64 also
+ * uses); smaller files stay plain RIFF/WAVE, which RF64-unaware readers
+ * accept because they skip the JUNK chunk.
+ */
+class WAVWriter {
+public:
+    /**
+     * @brief Bytes before the first sample (RIFF + JUNK/ds64 + fmt + data headers)
+     */
+    static constexpr uint64_t HEADER_SIZE = 80;
+
+    WAVWriter();
+    ~WAVWriter();
+
+    WAVWriter(const WAVWriter&) = delete;
+    WAVWriter& operator=(const WAVWriter&) = delete;
+
+    /**
+     * @brief Create the file and write the placeholder header
+     * @param bits_per_sample 16, 24 or 32 (integer PCM), 32 with is_float for IEEE float
+     * @param force_rf64 Always write RF64, whatever the final size
+     * @return ErrorCode::InvalidArgument for an unsupported format, FileWriteError if the file cannot be created
+     */
+    ErrorCode open(const std::string& path, int sample_rate, int channels,
+                   int bits_per_sample, bool is_float, bool force_rf64 = false);
+
+    /**
+     * @brief Append interleaved sample data (any byte count; frames may span calls)
+     */
+    ErrorCode write(const uint8_t* data, size_t bytes);
+
+    /**
+     * @brief Pad the data chunk, patch the header sizes and close the file
+     *
+     * Called by the destructor if needed; call it explicitly to see errors.
+     */
+    ErrorCode close();
+
+    bool isOpen() const { return file_.is_open(); }
+
+    /**
+     * @brief Sample data bytes written so far
+     */
+    uint64_t dataBytes() const { return data_bytes_; }
+
+    /**
+     * @brief Whether the file is (or will be closed as) RF64
+     */
+    bool isRF64() const;
+
+private:
+    std::ofstream file_;
+    std::vector<char> buffer_;
+    uint64_t data_bytes_;
+    uint32_t block_align_;
+    bool force_rf64_;
+};
+
+} // namespace audio
+} // namespace xpu
+
+#endif // XPU_WAV_WRITER_H
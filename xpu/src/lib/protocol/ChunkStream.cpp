@@ -0,0 +1,62 @@
+#include "ChunkStream.h"
+#include "Protocol.h"
+#include <istream>
+#include <ostream>
+#include <vector>
+
+namespace xpu {
+namespace protocol {
+
+namespace {
+
+bool writeFramed(std::ostream& out, uint64_t size_header, const void* data, size_t bytes) {
+    out.write(reinterpret_cast<const char*>(&size_header), sizeof(size_header));
+    out.write(static_cast<const char*>(data), static_cast<std::streamsize>(bytes));
+    return static_cast<bool>(out);
+}
+
+} // anonymous namespace
+
+bool writeChunk(std::ostream& out, const void* data, size_t bytes) {
+    return writeFramed(out, bytes, data, bytes);
+}
+
+bool writeTrackRecord(std::ostream& out, const std::string& json) {
+    return writeFramed(out, json.size() | TRACK_RECORD_FLAG, json.data(), json.size());
+}
+
+ErrorCode copyChunkStream(std::istream& in, std::ostream& out, ChunkStreamStats& stats) {
+    std::vector<char> buffer;
+    while (true) {
+        uint64_t size_header = 0;
+        if (!in.read(reinterpret_cast<char*>(&size_header), sizeof(size_header))) {
+            if (in.eof() && in.gcount() == 0) {
+                break;
+            }
+            return ErrorCode::FileReadError;
+        }
+        if (size_header == 0) {
+            break;
+        }
+
+        const uint64_t data_size = size_header & ~TRACK_RECORD_FLAG;
+        buffer.resize(data_size);
+        if (!in.read(buffer.data(), static_cast<std::streamsize>(data_size))) {
+            return ErrorCode::FileReadError;
+        }
+        if (!writeFramed(out, size_header, buffer.data(), buffer.size()) || !out.flush()) {
+            return ErrorCode::FileWriteError;
+        }
+
+        if (size_header & TRACK_RECORD_FLAG) {
+            stats.records++;
+        } else {
+            stats.chunks++;
+            stats.bytes += data_size;
+        }
+    }
+    return ErrorCode::Success;
+}
+
+} // namespace protocol
+} // namespace xpu
@@ -0,0 +1,47 @@
+#ifndef XPU_PROTOCOL_CHUNK_STREAM_H
+#define XPU_PROTOCOL_CHUNK_STREAM_H
+
+#include "ErrorCode.h"
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+
+namespace xpu {
+namespace protocol {
+
+/**
+ * @brief Counts of a copied chunk stream (track records not included in chunks/bytes)
+ */
+struct ChunkStreamStats {
+    uint64_t chunks = 0;
+    uint64_t bytes = 0;
+    uint64_t records = 0;
+};
+
+/**
+ * @brief Write one [8-byte size][data] chunk
+ * @return false if the stream failed
+ */
+bool writeChunk(std::ostream& out, const void* data, size_t bytes);
+
+/**
+ * @brief Write the metadata JSON of the next track as a track record (see TRACK_RECORD_FLAG)
+ * @return false if the stream failed
+ */
+bool writeTrackRecord(std::ostream& out, const std::string& json);
+
+/**
+ * @brief Copy [size][data] chunks and track records byte for byte
+ *
+ * Stops at end of input or at a zero size header. Each chunk is flushed,
+ * so the next stage receives it while the previous one keeps decoding.
+ *
+ * @return FileReadError on a truncated chunk, FileWriteError if out fails
+ */
+ErrorCode copyChunkStream(std::istream& in, std::ostream& out, ChunkStreamStats& stats);
+
+} // namespace protocol
+} // namespace xpu
+
+#endif // XPU_PROTOCOL_CHUNK_STREAM_H
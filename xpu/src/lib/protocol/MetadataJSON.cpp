@@ -0,0 +1,94 @@
+#include "MetadataJSON.h"
+#include <cmath>
+#include <limits>
+
+namespace xpu {
+namespace protocol {
+
+bool MetadataJSON::parse(const std::string& text) {
+    document_ = nlohmann::ordered_json::parse(text, nullptr, false);
+    if (document_.is_discarded() || !document_.is_object()) {
+        document_ = nlohmann::ordered_json::object();
+        return false;
+    }
+    return true;
+}
+
+const nlohmann::ordered_json* MetadataJSON::find(const std::string& key) const {
+    const nlohmann::ordered_json* object = &document_;
+    auto metadata = document_.find("metadata");
+    if (metadata != document_.end() && metadata->is_object()) {
+        object = &*metadata;
+    }
+    auto it = object->find(key);
+    return it == object->end() ? nullptr : &*it;
+}
+
+nlohmann::ordered_json& MetadataJSON::fields() {
+    auto metadata = document_.find("metadata");
+    if (metadata != document_.end() && metadata->is_object()) {
+        return *metadata;
+    }
+    return document_;
+}
+
+bool MetadataJSON::has(const std::string& key) const {
+    return find(key) != nullptr;
+}
+
+int MetadataJSON::getInt(const std::string& key, int fallback) const {
+    const nlohmann::ordered_json* value = find(key);
+    if (!value || !value->is_number_integer()) {
+        return fallback;
+    }
+    if (value->is_number_unsigned()) {
+        const uint64_t number = value->get<uint64_t>();
+        return number <= static_cast<uint64_t>(std::numeric_limits<int>::max()) ? static_cast<int>(number) : fallback;
+    }
+    const int64_t number = value->get<int64_t>();
+    return number >= std::numeric_limits<int>::min() && number <= std::numeric_limits<int>::max()
+        ? static_cast<int>(number) : fallback;
+}
+
+uint64_t MetadataJSON::getUInt64(const std::string& key, uint64_t fallback) const {
+    const nlohmann::ordered_json* value = find(key);
+    if (!value || !value->is_number_integer() || (!value->is_number_unsigned() && value->get<int64_t>() < 0)) {
+        return fallback;
+    }
+    return value->get<uint64_t>();
+}
+
+double MetadataJSON::getDouble(const std::string& key, double fallback) const {
+    const nlohmann::ordered_json* value = find(key);
+    return value && value->is_number() ? value->get<double>() : fallback;
+}
+
+bool MetadataJSON::getBool(const std::string& key, bool fallback) const {
+    const nlohmann::ordered_json* value = find(key);
+    return value && value->is_boolean() ? value->get<bool>() : fallback;
+}
+
+std::string MetadataJSON::getString(const std::string& key, const std::string& fallback) const {
+    const nlohmann::ordered_json* value = find(key);
+    return value && value->is_string() ? value->get<std::string>() : fallback;
+}
+
+void MetadataJSON::setStreamFormat(int sample_rate, int channels, int bit_depth) {
+    const int source_rate = getInt("sample_rate", 0);
+    const uint64_t sample_count = getUInt64("sample_count", 0);
+    if (source_rate > 0 && sample_rate > 0 && source_rate != sample_rate && sample_count > 0) {
+        set("sample_count", static_cast<uint64_t>(
+            std::llround(static_cast<double>(sample_count) * sample_rate / source_rate)));
+    }
+    set("sample_rate", sample_rate);
+    set("channels", channels);
+    set("bit_depth", bit_depth);
+    set("sample_format", bit_depth == 16 ? "Int16" : bit_depth == 24 ? "Int24" : "Float32");
+}
+
+std::string MetadataJSON::dump() const {
+    return document_.dump(2, ' ', false, nlohmann::ordered_json::error_handler_t::replace);
+}
+
+} // namespace protocol
+} // namespace xpu
@@ -0,0 +1,87 @@
+#ifndef XPU_PROTOCOL_METADATA_JSON_H
+#define XPU_PROTOCOL_METADATA_JSON_H
+
+#include <nlohmann/json.hpp>
+#include <cstdint>
+#include <string>
+
+namespace xpu {
+namespace protocol {
+
+/**
+ * @brief Quote a string as a JSON string literal (escapes included)
+ *
+ * Invalid UTF-8 (e.g. Latin-1 tags) is replaced with U+FFFD rather than
+ * producing a document the next stage cannot parse.
+ */
+inline std::string quoteJSON(const std::string& value) {
+    return nlohmann::json(value).dump(-1, ' ', false, nlohmann::json::error_handler_t::replace);
+}
+
+/**
+ * @brief Reads and rewrites the fields of a stream metadata JSON
+ *
+ * Used for the JSON at the head of a chunk stream and for track records
+ * (see TRACK_RECORD_FLAG). Fields are looked up in the "metadata" object
+ * when there is one (xpuLoad / xpuIn2Wav output) and at the top level
+ * otherwise (metadataToJSON()). Getters return the fallback when a field
+ * is absent or has the wrong type; key order is kept on rewrite.
+ */
+class MetadataJSON {
+public:
+    MetadataJSON() = default;
+
+    /**
+     * @brief Parse a metadata JSON
+     * @return false if the text is not a JSON object (the document is then empty)
+     */
+    bool parse(const std::string& text);
+
+    bool has(const std::string& key) const;
+
+    /**
+     * @brief Integer field; fallback if absent, not an integer or out of int range
+     */
+    int getInt(const std::string& key, int fallback) const;
+
+    uint64_t getUInt64(const std::string& key, uint64_t fallback) const;
+
+    double getDouble(const std::string& key, double fallback) const;
+
+    bool getBool(const std::string& key, bool fallback) const;
+
+    std::string getString(const std::string& key, const std::string& fallback) const;
+
+    /**
+     * @brief Set (or add) a field of the metadata object
+     */
+    template <typename T>
+    void set(const std::string& key, const T& value) {
+        fields()[key] = value;
+    }
+
+    /**
+     * @brief Describe the samples written by a converting stage
+     *
+     * Sets sample_rate, channels, bit_depth and sample_format ("Int16",
+     * "Int24" or "Float32" for 32). sample_count (frames) is scaled to the
+     * new sample rate, so it keeps matching the duration.
+     */
+    void setStreamFormat(int sample_rate, int channels, int bit_depth);
+
+    /**
+     * @brief Serialize (pretty-printed, no trailing newline)
+     */
+    std::string dump() const;
+
+private:
+    const nlohmann::ordered_json* find(const std::string& key) const;
+    nlohmann::ordered_json& fields();
+
+    nlohmann::ordered_json document_ = nlohmann::ordered_json::object();
+};
+
+} // namespace protocol
+} // namespace xpu
+
+#endif // XPU_PROTOCOL_METADATA_JSON_H
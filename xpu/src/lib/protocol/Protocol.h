@@ -3,6 +3,7 @@
 
 #include "ErrorCode.h"
 #include "ErrorResponse.h"
+#include "MetadataJSON.h"
 #include <string>
 #include <vector>
 #include <map>
@@ -34,6 +35,8 @@ struct AudioMetadata {
     int original_sample_rate;  // Original sample rate before resampling
     int original_bit_depth;    // Original bit depth before conversion
     bool streaming_mode;  // true = streaming mode (data follows), false = file mode
+    std::string encoding;  // Sample encoding: "pcm" (float audio) or "dop" (DSD over PCM frames)
+    std::string sample_format;  // Samples on the wire: "Float32" (default), "Int16", "Int24" (packed) or "Int32"
 
     AudioMetadata()
         : track_number(0)
@@ -47,7 +50,9 @@ struct AudioMetadata {
         , is_high_res(false)
         , original_sample_rate(0)
         , original_bit_depth(0)
-        , streaming_mode(false) {}  // Default to file mode
+        , streaming_mode(false)  // Default to file mode
+        , encoding("pcm")
+        , sample_format("Float32") {}
 };
 
 /**
@@ -55,11 +60,11 @@ struct AudioMetadata {
  */
 inline std::string metadataToJSON(const AudioMetadata& meta) {
     std::string json = "{\n";
-    json += "  \"title\": \"" + meta.title + "\",\n";
-    json += "  \"artist\": \"" + meta.artist + "\",\n";
-    json += "  \"album\": \"" + meta.album + "\",\n";
-    json += "  \"year\": \"" + meta.year + "\",\n";
-    json += "  \"genre\": \"" + meta.genre + "\",\n";
+    json += "  \"title\": " + quoteJSON(meta.title) + ",\n";
+    json += "  \"artist\": " + quoteJSON(meta.artist) + ",\n";
+    json += "  \"album\": " + quoteJSON(meta.album) + ",\n";
+    json += "  \"year\": " + quoteJSON(meta.year) + ",\n";
+    json += "  \"genre\": " + quoteJSON(meta.genre) + ",\n";
     json += "  \"track_number\": " + std::to_string(meta.track_number) + ",\n";
     json += "  \"duration\": " + std::to_string(meta.duration) + ",\n";
     json += "  \"sample_rate\": " + std::to_string(meta.sample_rate) + ",\n";
@@ -68,17 +73,29 @@ inline std::string metadataToJSON(const AudioMetadata& meta) {
     json += "  \"original_bit_depth\": " + std::to_string(meta.original_bit_depth) + ",\n";
     json += "  \"channels\": " + std::to_string(meta.channels) + ",\n";
     json += "  \"sample_count\": " + std::to_string(meta.sample_count) + ",\n";
-    json += "  \"format\": \"" + meta.format + "\",\n";
-    json += "  \"format_name\": \"" + meta.format_name + "\",\n";
+    json += "  \"format\": " + quoteJSON(meta.format) + ",\n";
+    json += "  \"format_name\": " + quoteJSON(meta.format_name) + ",\n";
     json += "  \"bitrate\": " + std::to_string(meta.bitrate) + ",\n";
     json += "  \"is_lossless\": " + std::string(meta.is_lossless ? "true" : "false") + ",\n";
     json += "  \"is_high_res\": " + std::string(meta.is_high_res ? "true" : "false") + ",\n";
     json += "  \"streaming_mode\": " + std::string(meta.streaming_mode ? "true" : "false") + ",\n";
-    json += "  \"file_path\": \"" + meta.file_path + "\"\n";
+    json += "  \"encoding\": " + quoteJSON(meta.encoding) + ",\n";
+    json += "  \"sample_format\": " + quoteJSON(meta.sample_format) + ",\n";
+    json += "  \"file_path\": " + quoteJSON(meta.file_path) + "\n";
     json += "}\n";
     return json;
 }
 
+/**
+ * @brief Marks a track record in a chunk stream
+ *
+ * A chunk stream is [JSON metadata] followed by [8-byte size][data] chunks.
+ * When a size header has this bit set, the low bits give the length of the
+ * metadata JSON of the next track (multi-track streams, see xpuLoad
+ * --playlist) instead of a PCM chunk; the stream format stays the same.
+ */
+constexpr uint64_t TRACK_RECORD_FLAG = 1ULL << 63;
+
 /**
  * @brief Playback status structure
  */
@@ -145,7 +162,7 @@ inline std::string statusToJSON(const PlaybackStatus& status) {
     json += "    \"sample_rate\": " + std::to_string(status.sample_rate) + ",\n";
     json += "    \"bit_depth\": " + std::to_string(status.bit_depth) + ",\n";
     json += "    \"channels\": " + std::to_string(status.channels) + ",\n";
-    json += "    \"current_device\": \"" + status.current_device + "\",\n";
+    json += "    \"current_device\": " + quoteJSON(status.current_device) + ",\n";
     json += "    \"bytes_played\": " + std::to_string(status.bytes_played) + ",\n";
     json += "    \"playback_time\": " + std::to_string(status.playback_time) + "\n";
     json += "  }\n";
@@ -192,7 +209,7 @@ inline std::string queueToJSON(const QueueStatus& queue) {
     json += "  \"queue\": {\n";
     json += "    \"current_index\": " + std::to_string(queue.current_index) + ",\n";
     json += "    \"total_count\": " + std::to_string(queue.total_count) + ",\n";
-    json += "    \"playback_mode\": \"" + queue.playback_mode + "\",\n";
+    json += "    \"playback_mode\": " + quoteJSON(queue.playback_mode) + ",\n";
     json += "    \"total_duration\": " + std::to_string(queue.total_duration) + ",\n";
     json += "    \"entries\": [\n";
 
@@ -200,10 +217,10 @@ inline std::string queueToJSON(const QueueStatus& queue) {
         const auto& entry = queue.entries[i];
         json += "      {\n";
         json += "        \"index\": " + std::to_string(entry.index) + ",\n";
-        json += "        \"file_path\": \"" + entry.file_path + "\",\n";
+        json += "        \"file_path\": " + quoteJSON(entry.file_path) + ",\n";
         json += "        \"is_playing\": " + std::string(entry.is_playing ? "true" : "false") + ",\n";
-        json += "        \"title\": \"" + entry.metadata.title + "\",\n";
-        json += "        \"artist\": \"" + entry.metadata.artist + "\",\n";
+        json += "        \"title\": " + quoteJSON(entry.metadata.title) + ",\n";
+        json += "        \"artist\": " + quoteJSON(entry.metadata.artist) + ",\n";
         json += "        \"duration\": " + std::to_string(entry.metadata.duration) + "\n";
         json += "      }";
         if (i < queue.entries.size() - 1) {
@@ -243,8 +260,8 @@ struct DeviceInfo {
 inline std::string deviceToJSON(const DeviceInfo& device) {
     std::string json = "{\n";
     json += "  \"device\": {\n";
-    json += "    \"name\": \"" + device.name + "\",\n";
-    json += "    \"id\": \"" + device.id + "\",\n";
+    json += "    \"name\": " + quoteJSON(device.name) + ",\n";
+    json += "    \"id\": " + quoteJSON(device.id) + ",\n";
     json += "    \"index\": " + std::to_string(device.index) + ",\n";
     json += "    \"is_default\": " + std::string(device.is_default ? "true" : "false") + ",\n";
     json += "    \"is_exclusive\": " + std::string(device.is_exclusive ? "true" : "false") + ",\n";
@@ -0,0 +1,189 @@
+#include "MappedFile.h"
+#include <algorithm>
+
+#ifdef PLATFORM_WINDOWS
+    #include <windows.h>
+#else
+    #include <cerrno>
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace xpu {
+namespace utils {
+
+MappedFile::MappedFile()
+    : data_(nullptr)
+    , size_(0)
+#ifdef PLATFORM_WINDOWS
+    , file_handle_(INVALID_HANDLE_VALUE)
+    , mapping_handle_(nullptr)
+#else
+    , fd_(-1)
+#endif
+{
+}
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+#ifdef PLATFORM_WINDOWS
+
+ErrorCode MappedFile::open(const std::string& path) {
+    close();
+
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return GetLastError() == ERROR_FILE_NOT_FOUND ? ErrorCode::FileNotFound
+                                                      : ErrorCode::FileReadError;
+    }
+
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0) {
+        CloseHandle(file);
+        return ErrorCode::FileReadError;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+        CloseHandle(file);
+        return ErrorCode::FileReadError;
+    }
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return ErrorCode::FileReadError;
+    }
+
+    file_handle_ = file;
+    mapping_handle_ = mapping;
+    data_ = static_cast<const uint8_t*>(view);
+    size_ = static_cast<uint64_t>(file_size.QuadPart);
+    return ErrorCode::Success;
+}
+
+void MappedFile::close() {
+    if (data_) {
+        UnmapViewOfFile(data_);
+        data_ = nullptr;
+    }
+    if (mapping_handle_) {
+        CloseHandle(mapping_handle_);
+        mapping_handle_ = nullptr;
+    }
+    if (file_handle_ != INVALID_HANDLE_VALUE) {
+        CloseHandle(file_handle_);
+        file_handle_ = INVALID_HANDLE_VALUE;
+    }
+    size_ = 0;
+}
+
+void MappedFile::adviseSequential(uint64_t, uint64_t) const {
+    // FILE_FLAG_SEQUENTIAL_SCAN at open time covers this on Windows
+}
+
+void MappedFile::prefetch(uint64_t offset, uint64_t length) const {
+    if (!data_ || offset >= size_) {
+        return;
+    }
+#if defined(_WIN32_WINNT) && _WIN32_WINNT >= 0x0602
+    WIN32_MEMORY_RANGE_ENTRY range;
+    range.VirtualAddress = const_cast<uint8_t*>(data_ + offset);
+    range.NumberOfBytes = static_cast<SIZE_T>(std::min(length, size_ - offset));
+    PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+#else
+    (void)length;
+#endif
+}
+
+#else
+
+namespace {
+
+/**
+ * @brief Clamp a range to the mapping and widen it to page boundaries
+ */
+bool pageRange(const uint8_t* base, uint64_t size, uint64_t offset, uint64_t length,
+               void*& addr, size_t& bytes) {
+    if (!base || offset >= size || length == 0) {
+        return false;
+    }
+    static const uint64_t page = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+    uint64_t end = std::min(size, offset + length);
+    uint64_t start = offset - (offset % page);
+    addr = const_cast<uint8_t*>(base + start);
+    bytes = static_cast<size_t>(end - start);
+    return true;
+}
+
+} // anonymous namespace
+
+ErrorCode MappedFile::open(const std::string& path) {
+    close();
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return errno == ENOENT ? ErrorCode::FileNotFound : ErrorCode::FileReadError;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        ::close(fd);
+        return ErrorCode::FileReadError;
+    }
+
+    void* view = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    if (view == MAP_FAILED) {
+        ::close(fd);
+        return ErrorCode::FileReadError;
+    }
+
+    fd_ = fd;
+    data_ = static_cast<const uint8_t*>(view);
+    size_ = static_cast<uint64_t>(st.st_size);
+    return ErrorCode::Success;
+}
+
+void MappedFile::close() {
+    if (data_) {
+        munmap(const_cast<uint8_t*>(data_), static_cast<size_t>(size_));
+        data_ = nullptr;
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+    size_ = 0;
+}
+
+void MappedFile::adviseSequential(uint64_t offset, uint64_t length) const {
+    void* addr = nullptr;
+    size_t bytes = 0;
+    if (!pageRange(data_, size_, offset, length, addr, bytes)) {
+        return;
+    }
+    madvise(addr, bytes, MADV_SEQUENTIAL);
+#ifdef POSIX_FADV_SEQUENTIAL
+    posix_fadvise(fd_, static_cast<off_t>(offset), static_cast<off_t>(length), POSIX_FADV_SEQUENTIAL);
+#endif
+}
+
+void MappedFile::prefetch(uint64_t offset, uint64_t length) const {
+    void* addr = nullptr;
+    size_t bytes = 0;
+    if (!pageRange(data_, size_, offset, length, addr, bytes)) {
+        return;
+    }
+    madvise(addr, bytes, MADV_WILLNEED);
+}
+
+#endif
+
+} // namespace utils
+} // namespace xpu
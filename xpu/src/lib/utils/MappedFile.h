@@ -0,0 +1,68 @@
+#ifndef XPU_MAPPED_FILE_H
+#define XPU_MAPPED_FILE_H
+
+#include "protocol/ErrorCode.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace xpu {
+namespace utils {
+
+/**
+ * @brief Read-only memory mapping of a whole file
+ *
+ * The mapping is shared, so several readers of the same file (e.g. one
+ * decoder per zone) use the page cache instead of private copies. Access
+ * hints are advisory and silently ignored where unsupported.
+ */
+class MappedFile {
+public:
+    MappedFile();
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * @brief Map a file read-only
+     * @return ErrorCode::FileNotFound / FileReadError on failure
+     */
+    ErrorCode open(const std::string& path);
+
+    /**
+     * @brief Unmap and close the file
+     */
+    void close();
+
+    bool isOpen() const { return data_ != nullptr; }
+
+    const uint8_t* data() const { return data_; }
+
+    uint64_t size() const { return size_; }
+
+    /**
+     * @brief Hint that a byte range will be read front to back (MADV_SEQUENTIAL)
+     */
+    void adviseSequential(uint64_t offset, uint64_t length) const;
+
+    /**
+     * @brief Start reading a byte range into the page cache (MADV_WILLNEED)
+     */
+    void prefetch(uint64_t offset, uint64_t length) const;
+
+private:
+    const uint8_t* data_;
+    uint64_t size_;
+#ifdef PLATFORM_WINDOWS
+    void* file_handle_;
+    void* mapping_handle_;
+#else
+    int fd_;
+#endif
+};
+
+} // namespace utils
+} // namespace xpu
+
+#endif // XPU_MAPPED_FILE_H
@@ -300,6 +300,19 @@ public:
 #endif
     }
 
+    /**
+     * @brief Get current process ID
+     */
+    static uint64_t getProcessId() {
+#ifdef PLATFORM_WINDOWS
+        return GetCurrentProcessId();
+#elif defined(PLATFORM_MACOS) || defined(PLATFORM_LINUX)
+        return (uint64_t)getpid();
+#else
+        return 0;
+#endif
+    }
+
     /**
      * @brief Create a temporary file
      */
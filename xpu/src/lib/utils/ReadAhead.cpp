@@ -0,0 +1,216 @@
+#include "ReadAhead.h"
+#include "Logger.h"
+#include <algorithm>
+
+#ifdef PLATFORM_WINDOWS
+    #include <windows.h>
+#else
+    #include <cerrno>
+    #include <fcntl.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace xpu {
+namespace utils {
+
+namespace {
+
+constexpr uint64_t ALIGN_BYTES = 4096;
+
+} // anonymous namespace
+
+ReadAheadConfig ReadAheadConfig::fromConfig(const std::map<std::string, ConfigValue>& config) {
+    ReadAheadConfig result;
+    const int window_mb = ConfigLoader::getValue(config, "io.readahead_mb", ConfigValue(0)).asInt();
+    const int threads = ConfigLoader::getValue(config, "io.readahead_threads", ConfigValue(result.threads)).asInt();
+    const int block_kb = ConfigLoader::getValue(config, "io.readahead_block_kb",
+                                                ConfigValue(static_cast<int>(result.block_bytes / 1024))).asInt();
+    result.window_bytes = static_cast<size_t>(std::clamp(window_mb, 0, 1024)) * 1024 * 1024;
+    result.threads = std::clamp(threads, 1, 16);
+    result.block_bytes = static_cast<size_t>(std::clamp(block_kb, 64, 16384)) * 1024;
+    result.fadvise = ConfigLoader::getValue(config, "io.fadvise", ConfigValue(true)).asBool();
+    return result;
+}
+
+ReadAhead::ReadAhead(const ReadAheadConfig& config)
+    : config_(config)
+#ifdef PLATFORM_WINDOWS
+    , file_(INVALID_HANDLE_VALUE)
+#endif
+{
+    config_.block_bytes = std::max<size_t>(config_.block_bytes, ALIGN_BYTES);
+    config_.threads = std::max(config_.threads, 1);
+}
+
+ReadAhead::~ReadAhead() {
+    close();
+}
+
+ErrorCode ReadAhead::open(const std::string& path, uint64_t offset, uint64_t length) {
+    close();
+
+#ifdef PLATFORM_WINDOWS
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return GetLastError() == ERROR_FILE_NOT_FOUND ? ErrorCode::FileNotFound : ErrorCode::FileReadError;
+    }
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size)) {
+        CloseHandle(file);
+        return ErrorCode::FileReadError;
+    }
+    const uint64_t size = static_cast<uint64_t>(file_size.QuadPart);
+    file_ = file;
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return errno == ENOENT ? ErrorCode::FileNotFound : ErrorCode::FileReadError;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+        ::close(fd);
+        return ErrorCode::FileReadError;
+    }
+    const uint64_t size = static_cast<uint64_t>(st.st_size);
+    fd_ = fd;
+#endif
+
+    offset = std::min(offset, size);
+    range_end_ = length > 0 ? std::min(size, offset + length) : size;
+    position_ = offset;
+    next_ = offset - offset % ALIGN_BYTES;
+    stop_ = false;
+    busy_ = 0;
+    loaded_ = 0;
+
+#if !defined(PLATFORM_WINDOWS) && defined(POSIX_FADV_SEQUENTIAL)
+    if (config_.fadvise) {
+        posix_fadvise(fd_, static_cast<off_t>(offset), static_cast<off_t>(range_end_ - offset),
+                      POSIX_FADV_SEQUENTIAL);
+    }
+#endif
+
+    for (int i = 0; i < config_.threads; ++i) {
+        workers_.emplace_back([this] { work(); });
+    }
+    LOG_INFO("Read-ahead: {} MB window, {} threads, {} KB blocks{}", config_.window_bytes / (1024 * 1024),
+             config_.threads, config_.block_bytes / 1024, config_.fadvise ? ", fadvise" : "");
+    return ErrorCode::Success;
+}
+
+void ReadAhead::close() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    work_cv_.notify_all();
+    idle_cv_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+    workers_.clear();
+
+#ifdef PLATFORM_WINDOWS
+    if (file_ != INVALID_HANDLE_VALUE) {
+        CloseHandle(file_);
+        file_ = INVALID_HANDLE_VALUE;
+    }
+#else
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+#endif
+}
+
+void ReadAhead::advance(uint64_t position) {
+    bool wake = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        // A jump past the loaded range or back before the reader restarts the window
+        if (position > next_ || position + config_.block_bytes < position_) {
+            next_ = position - position % ALIGN_BYTES;
+        }
+        position_ = position;
+        wake = hasWork();
+    }
+    if (wake) {
+        work_cv_.notify_all();
+    }
+}
+
+void ReadAhead::waitIdle() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    idle_cv_.wait(lock, [this] { return stop_ || workers_.empty() || (!hasWork() && busy_ == 0); });
+}
+
+bool ReadAhead::hasWork() const {
+    return next_ < range_end_ && next_ < position_ + config_.window_bytes;
+}
+
+void ReadAhead::work() {
+    std::vector<uint8_t> buffer(config_.block_bytes);
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stop_) {
+        if (!hasWork()) {
+            if (busy_ == 0) {
+                idle_cv_.notify_all();
+            }
+            work_cv_.wait(lock);
+            continue;
+        }
+
+        // Claim the next block, read it unlocked
+        const uint64_t offset = next_;
+        const size_t bytes = static_cast<size_t>(std::min<uint64_t>(config_.block_bytes, range_end_ - offset));
+        next_ += bytes;
+        busy_++;
+        lock.unlock();
+
+        const bool ok = readBlock(offset, bytes, buffer);
+
+        lock.lock();
+        busy_--;
+        if (ok) {
+            loaded_.fetch_add(bytes, std::memory_order_relaxed);
+        } else {
+            LOG_WARN("Read-ahead failed at offset {}, stopping read-ahead", offset);
+            range_end_ = 0;
+        }
+    }
+}
+
+bool ReadAhead::readBlock(uint64_t offset, size_t bytes, std::vector<uint8_t>& buffer) {
+#ifdef PLATFORM_WINDOWS
+    OVERLAPPED request = {};
+    request.Offset = static_cast<DWORD>(offset & 0xFFFFFFFFu);
+    request.OffsetHigh = static_cast<DWORD>(offset >> 32);
+    DWORD got = 0;
+    return ReadFile(static_cast<HANDLE>(file_), buffer.data(), static_cast<DWORD>(bytes), &got, &request) != 0;
+#else
+#ifdef POSIX_FADV_WILLNEED
+    if (config_.fadvise) {
+        posix_fadvise(fd_, static_cast<off_t>(offset), static_cast<off_t>(bytes), POSIX_FADV_WILLNEED);
+    }
+#endif
+    // pread() waits for the data, so the block is in the page cache before
+    // the reader gets there (WILLNEED alone is only a hint, often ignored on NFS)
+    size_t done = 0;
+    while (done < bytes) {
+        ssize_t got = pread(fd_, buffer.data() + done, bytes - done, static_cast<off_t>(offset + done));
+        if (got < 0 && errno == EINTR) {
+            continue;
+        }
+        if (got <= 0) {
+            return got == 0;  // Shorter file than at open(): nothing left to load
+        }
+        done += static_cast<size_t>(got);
+    }
+    return true;
+#endif
+}
+
+} // namespace utils
+} // namespace xpu
@@ -0,0 +1,113 @@
+#ifndef XPU_READ_AHEAD_H
+#define XPU_READ_AHEAD_H
+
+#include "utils/ConfigLoader.h"
+#include "protocol/ErrorCode.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace xpu {
+namespace utils {
+
+/**
+ * @brief Read-ahead settings (the [io] section of xpuSetting.conf)
+ */
+struct ReadAheadConfig {
+    size_t window_bytes = 0;            // Bytes kept loaded ahead of the reader (0 = disabled)
+    int threads = 2;                    // Reads in flight
+    size_t block_bytes = 1024 * 1024;   // Bytes per read
+    bool fadvise = true;                // Also pass posix_fadvise() hints
+
+    bool enabled() const { return window_bytes > 0 && threads > 0; }
+
+    /**
+     * @brief Settings from io.readahead_mb, io.readahead_threads,
+     *        io.readahead_block_kb and io.fadvise (defaults for missing keys)
+     */
+    static ReadAheadConfig fromConfig(const std::map<std::string, ConfigValue>& config);
+};
+
+/**
+ * @brief Background read-ahead of a file range into the page cache
+ *
+ * Worker threads read the window_bytes following the reader's position
+ * (reported with advance()) block by block, so the decoder's own reads and
+ * page faults are served from memory even when the storage has long or
+ * irregular latency (spinning disks, NFS). Several threads keep several
+ * requests in flight. The data read is discarded; only the page cache is
+ * warmed. With fadvise the range is also announced as sequential and each
+ * block as WILLNEED before it is read.
+ *
+ * The reader may jump (seek): the window restarts at the new position.
+ */
+class ReadAhead {
+public:
+    explicit ReadAhead(const ReadAheadConfig& config);
+    ~ReadAhead();
+
+    ReadAhead(const ReadAhead&) = delete;
+    ReadAhead& operator=(const ReadAhead&) = delete;
+
+    /**
+     * @brief Open a file and start reading ahead from offset
+     * @param length Range length in bytes (0 = to the end of the file)
+     * @return ErrorCode::FileNotFound / FileReadError if the file cannot be opened
+     */
+    ErrorCode open(const std::string& path, uint64_t offset = 0, uint64_t length = 0);
+
+    /**
+     * @brief Stop the workers and close the file
+     */
+    void close();
+
+    bool isOpen() const { return !workers_.empty(); }
+
+    /**
+     * @brief Report the reader's file position
+     */
+    void advance(uint64_t position);
+
+    /**
+     * @brief Total bytes read ahead so far
+     */
+    uint64_t bytesLoaded() const { return loaded_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Block until the window ahead of the current position is loaded (tests, benchmarks)
+     */
+    void waitIdle();
+
+private:
+    void work();
+    bool readBlock(uint64_t offset, size_t bytes, std::vector<uint8_t>& buffer);
+    bool hasWork() const;
+
+    ReadAheadConfig config_;
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable work_cv_;
+    std::condition_variable idle_cv_;
+    uint64_t range_end_ = 0;
+    uint64_t position_ = 0;
+    uint64_t next_ = 0;       // Next offset to hand to a worker
+    int busy_ = 0;            // Workers with a read in progress
+    bool stop_ = false;
+    std::atomic<uint64_t> loaded_{0};
+#ifdef PLATFORM_WINDOWS
+    void* file_;
+#else
+    int fd_ = -1;
+#endif
+};
+
+} // namespace utils
+} // namespace xpu
+
+#endif // XPU_READ_AHEAD_H
@@ -0,0 +1,129 @@
+#include "RingBuffer.h"
+#include <algorithm>
+#include <cstring>
+
+namespace xpu {
+namespace utils {
+
+namespace {
+
+size_t roundUpToPowerOfTwo(size_t value) {
+    size_t result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+} // anonymous namespace
+
+RingBuffer::RingBuffer(size_t capacity)
+    : buffer_(roundUpToPowerOfTwo(std::max<size_t>(capacity, 1)))
+    , mask_(buffer_.size() - 1)
+    , write_pos_(0)
+    , read_pos_(0)
+    , closed_(false)
+    , waiters_(0) {
+}
+
+size_t RingBuffer::size() const {
+    return static_cast<size_t>(write_pos_.load() - read_pos_.load());
+}
+
+// Positions, closed_ and waiters_ use sequentially consistent operations:
+// a committing side that sees no waiter is then guaranteed that the waiter's
+// readiness check (made after it registered) sees the new position.
+template <typename Ready>
+void RingBuffer::waitUntil(Ready ready) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    waiters_.fetch_add(1);
+    cv_.wait(lock, [&] { return closed_.load() || ready(); });
+    waiters_.fetch_sub(1);
+}
+
+void RingBuffer::wake() {
+    if (waiters_.load() > 0) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        cv_.notify_all();
+    }
+}
+
+size_t RingBuffer::write(const void* data, size_t bytes) {
+    const uint8_t* src = static_cast<const uint8_t*>(data);
+    const size_t capacity = buffer_.size();
+    size_t written = 0;
+
+    while (written < bytes && !closed_.load()) {
+        const uint64_t pos = write_pos_.load(std::memory_order_relaxed);
+        const size_t free = capacity - static_cast<size_t>(pos - read_pos_.load());
+        if (free == 0) {
+            waitUntil([&] { return read_pos_.load() + capacity > pos; });
+            continue;
+        }
+
+        // Copy in at most two pieces (up to the end of the buffer, then from the start)
+        const size_t n = std::min(free, bytes - written);
+        const size_t offset = static_cast<size_t>(pos) & mask_;
+        const size_t first = std::min(n, capacity - offset);
+        std::memcpy(buffer_.data() + offset, src + written, first);
+        std::memcpy(buffer_.data(), src + written + first, n - first);
+
+        write_pos_.store(pos + n);
+        wake();
+        written += n;
+    }
+    return written;
+}
+
+size_t RingBuffer::peek(const uint8_t*& data) {
+    const uint64_t pos = read_pos_.load(std::memory_order_relaxed);
+    while (true) {
+        // Check closed_ first: data committed before close() is still seen below
+        const bool closed = closed_.load();
+        const uint64_t end = write_pos_.load();
+        if (end != pos) {
+            const size_t offset = static_cast<size_t>(pos) & mask_;
+            data = buffer_.data() + offset;
+            return std::min(static_cast<size_t>(end - pos), buffer_.size() - offset);
+        }
+        if (closed) {
+            return 0;
+        }
+        waitUntil([&] { return write_pos_.load() != pos; });
+    }
+}
+
+void RingBuffer::consume(size_t bytes) {
+    read_pos_.store(read_pos_.load(std::memory_order_relaxed) + bytes);
+    wake();
+}
+
+size_t RingBuffer::read(void* out, size_t bytes) {
+    uint8_t* dst = static_cast<uint8_t*>(out);
+    size_t total = 0;
+    while (total < bytes) {
+        const uint8_t* data = nullptr;
+        // Block only for the first byte; afterwards take what is there
+        if (total > 0 && size() == 0) {
+            break;
+        }
+        size_t n = peek(data);
+        if (n == 0) {
+            break;
+        }
+        n = std::min(n, bytes - total);
+        std::memcpy(dst + total, data, n);
+        consume(n);
+        total += n;
+    }
+    return total;
+}
+
+void RingBuffer::close() {
+    closed_.store(true);
+    std::lock_guard<std::mutex> lock(mutex_);
+    cv_.notify_all();
+}
+
+} // namespace utils
+} // namespace xpu
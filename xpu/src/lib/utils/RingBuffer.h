@@ -0,0 +1,94 @@
+#ifndef XPU_RING_BUFFER_H
+#define XPU_RING_BUFFER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace xpu {
+namespace utils {
+
+/**
+ * @brief Single-producer / single-consumer byte ring buffer
+ *
+ * One thread writes, one thread reads. Positions are atomics, so as long as
+ * there is room (or data) neither side takes a lock; a side only blocks on
+ * the condition variable when the ring is full (writer) or empty (reader),
+ * and is woken by the other side's next commit. Either side may close() the
+ * ring: the reader then drains what is left, the writer stops accepting data.
+ */
+class RingBuffer {
+public:
+    /**
+     * @param capacity Size in bytes, rounded up to a power of two
+     */
+    explicit RingBuffer(size_t capacity);
+
+    RingBuffer(const RingBuffer&) = delete;
+    RingBuffer& operator=(const RingBuffer&) = delete;
+
+    size_t capacity() const { return buffer_.size(); }
+
+    /**
+     * @brief Bytes currently buffered
+     */
+    size_t size() const;
+
+    /**
+     * @brief Copy bytes in, blocking while the ring is full (producer)
+     * @return Bytes written; less than bytes only if the ring was closed
+     */
+    size_t write(const void* data, size_t bytes);
+
+    /**
+     * @brief Contiguous readable span, blocking until data arrives (consumer)
+     * @param data Set to the first readable byte
+     * @return Span length; 0 once the ring is closed and drained
+     *
+     * The span stays valid until consume(); no copy is made.
+     */
+    size_t peek(const uint8_t*& data);
+
+    /**
+     * @brief Release bytes returned by peek() (consumer)
+     */
+    void consume(size_t bytes);
+
+    /**
+     * @brief Copy up to bytes out, blocking until at least one is available (consumer)
+     * @return Bytes read; 0 once the ring is closed and drained
+     */
+    size_t read(void* out, size_t bytes);
+
+    /**
+     * @brief End of data (producer) or reader gone (consumer); wakes both sides
+     */
+    void close();
+
+    bool isClosed() const { return closed_.load(); }
+
+private:
+    template <typename Ready>
+    void waitUntil(Ready ready);
+    void wake();
+
+    std::vector<uint8_t> buffer_;
+    size_t mask_;
+
+    // Monotonic byte counters; the owner thread is the only writer of each
+    alignas(64) std::atomic<uint64_t> write_pos_;
+    alignas(64) std::atomic<uint64_t> read_pos_;
+
+    std::atomic<bool> closed_;
+    std::atomic<int> waiters_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+};
+
+} // namespace utils
+} // namespace xpu
+
+#endif // XPU_RING_BUFFER_H
@@ -0,0 +1,1712 @@
+/**
+ * @file FormatConverter.cpp
+ * @brief Format conversion implementation
+ */
+
+#include "FormatConverter.h"
+#include "../xpuLoad/AudioFileLoader.h"
+#include "../xpuLoad/DSDDecoder.h"
+#include "audio/SampleConverter.h"
+#include "audio/WAVWriter.h"
+#include "protocol/ChunkStream.h"
+#include "protocol/MetadataJSON.h"
+#include "protocol/Protocol.h"
+#include "utils/Logger.h"
+#include <fstream>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+#include <cstdint>
+#include <thread>
+
+#ifdef PLATFORM_WINDOWS
+#include <io.h>
+#include <fcntl.h>
+#endif
+
+extern "C" {
+#include <samplerate.h>
+}
+
+using namespace xpu;
+
+namespace xpu {
+namespace in2wav {
+
+/**
+ * @brief Smallest share of output frames worth a resampling thread
+ */
+constexpr uint64_t MIN_RESAMPLE_SEGMENT_FRAMES = 256 * 1024;
+
+/**
+ * @brief Convert quality string to libsamplerate converter type
+ */
+static int getConverterType(const char* quality) {
+    if (strcmp(quality, "best") == 0) {
+        return SRC_SINC_BEST_QUALITY;
+    } else if (strcmp(quality, "medium") == 0) {
+        return SRC_SINC_MEDIUM_QUALITY;
+    } else if (strcmp(quality, "fast") == 0) {
+        return SRC_SINC_FASTEST;
+    } else if (strcmp(quality, "linear") == 0) {
+        return SRC_LINEAR;
+    } else if (strcmp(quality, "zero") == 0) {
+        return SRC_ZERO_ORDER_HOLD;
+    }
+    // Default to medium quality for better performance
+    return SRC_SINC_MEDIUM_QUALITY;
+}
+
+/**
+ * @brief Resample output frames [first, last) in segments on separate threads
+ *
+ * input holds input_frames frames starting at input frame input_start and
+ * must cover the filter windows of the range. Each segment reads the input
+ * under its own windows (overlapping its neighbours by the filter length),
+ * so the joins are identical to a serial run. Appends to output.
+ */
+static ErrorCode resampleSegments(const audio::PolyphaseResampler& polyphase, const float* input,
+                                  size_t input_frames, uint64_t input_start, uint64_t first, uint64_t last,
+                                  size_t segments, std::vector<float>& output) {
+    const uint64_t total = last - first;
+    std::vector<std::vector<float>> parts(segments);
+    std::vector<ErrorCode> results(segments, ErrorCode::Success);
+    auto resampleSegment = [&](size_t index) {
+        const uint64_t begin = first + total * index / segments;
+        const uint64_t end = first + total * (index + 1) / segments;
+        results[index] = polyphase.resampleSegment(input, input_frames, input_start, begin,
+                                                   static_cast<size_t>(end - begin), parts[index]);
+    };
+
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < segments; ++i) {
+        threads.emplace_back(resampleSegment, i);
+    }
+    resampleSegment(0);
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    size_t samples = output.size();
+    for (size_t i = 0; i < segments; ++i) {
+        if (results[i] != ErrorCode::Success) {
+            LOG_ERROR("Polyphase resampling failed in segment {}: {}", i, static_cast<int>(results[i]));
+            return results[i];
+        }
+        samples += parts[i].size();
+    }
+    output.reserve(samples);
+    for (size_t i = 0; i < segments; ++i) {
+        output.insert(output.end(), parts[i].begin(), parts[i].end());
+        std::vector<float>().swap(parts[i]);
+    }
+    return ErrorCode::Success;
+}
+
+// ============================================================================
+// Streaming Resampler Implementation
+// ============================================================================
+
+StreamingResampler::StreamingResampler()
+    : input_rate_(0)
+    , output_rate_(0)
+    , channels_(0)
+    , ratio_(1.0)
+    , src_state_(nullptr)
+    , initialized_(false)
+    , threads_(1)
+    , pending_start_(0)
+    , input_frames_(0)
+    , output_frames_(0)
+{
+}
+
+StreamingResampler::~StreamingResampler() {
+    if (src_state_) {
+        src_delete(static_cast<SRC_STATE*>(src_state_));
+        src_state_ = nullptr;
+    }
+}
+
+ErrorCode StreamingResampler::init(int input_rate, int output_rate, int channels, const char* quality) {
+    input_rate_ = input_rate;
+    output_rate_ = output_rate;
+    channels_ = channels;
+    ratio_ = static_cast<double>(output_rate) / static_cast<double>(input_rate);
+
+    if (input_rate == output_rate) {
+        // No resampling needed
+        return ErrorCode::Success;
+    }
+
+    // Fixed rational ratio: precomputed polyphase filter bank
+    audio::ResamplerQuality preset;
+    if (audio::PolyphaseResampler::qualityFromString(quality, preset) &&
+        audio::PolyphaseResampler::isSupportedRatio(input_rate, output_rate)) {
+        polyphase_ = std::make_unique<audio::PolyphaseResampler>();
+        ErrorCode ret = polyphase_->init(input_rate, output_rate, channels, preset);
+        if (ret != ErrorCode::Success) {
+            polyphase_.reset();
+            return ret;
+        }
+        initialized_ = true;
+        LOG_INFO("Streaming resampler initialized: {} Hz -> {} Hz (polyphase {}/{}, {} taps/phase, quality={}, {})",
+                 input_rate_, output_rate_, polyphase_->getUpFactor(), polyphase_->getDownFactor(),
+                 polyphase_->getTapsPerPhase(), quality, audio::simdLevelName(audio::detectSIMDLevel()));
+        return ErrorCode::Success;
+    }
+
+    int converter_type = getConverterType(quality);
+    int error = 0;
+
+    src_state_ = src_new(converter_type, channels_, &error);
+    if (error) {
+        LOG_ERROR("libsamplerate initialization error: {}", src_strerror(error));
+        return ErrorCode::AudioDecodeError;
+    }
+
+    initialized_ = true;
+    LOG_INFO("Streaming resampler initialized: {} Hz -> {} Hz (ratio={}, quality={})",
+             input_rate_, output_rate_, ratio_, quality);
+
+    return ErrorCode::Success;
+}
+
+ErrorCode StreamingResampler::process(const float* input, int input_frames, std::vector<float>& output) {
+    if (!initialized_ || input_rate_ == output_rate_) {
+        // No resampling, just copy
+        output.assign(input, input + input_frames * channels_);
+        return ErrorCode::Success;
+    }
+
+    if (polyphase_ && threads_ > 1) {
+        // Collect input until every thread has a full share of output
+        pending_.insert(pending_.end(), input, input + static_cast<size_t>(input_frames) * channels_);
+        input_frames_ += static_cast<uint64_t>(input_frames);
+        output.clear();
+        const uint64_t ready = polyphase_->getReadyOutputFrames(input_frames_);
+        if (ready - output_frames_ < static_cast<uint64_t>(threads_) * MIN_RESAMPLE_SEGMENT_FRAMES) {
+            return ErrorCode::Success;
+        }
+        return processPending(ready, output);
+    }
+
+    if (polyphase_) {
+        return polyphase_->process(input, static_cast<size_t>(input_frames), output);
+    }
+
+    // Calculate output buffer size (with some headroom)
+    int output_frames = static_cast<int>(input_frames * ratio_) + 256;
+    output.resize(output_frames * channels_);
+
+    SRC_DATA src_data;
+    std::memset(&src_data, 0, sizeof(SRC_DATA));
+
+    src_data.data_in = const_cast<float*>(input);
+    src_data.input_frames = input_frames;
+    src_data.data_out = output.data();
+    src_data.output_frames = output_frames;
+    src_data.src_ratio = ratio_;
+
+    int error = src_process(static_cast<SRC_STATE*>(src_state_), &src_data);
+    if (error) {
+        LOG_ERROR("libsamplerate error: {}", src_strerror(error));
+        return ErrorCode::AudioDecodeError;
+    }
+
+    // Resize to actual output
+    output.resize(src_data.output_frames_gen * channels_);
+
+    return ErrorCode::Success;
+}
+
+ErrorCode StreamingResampler::flush(std::vector<float>& output) {
+    if (!initialized_) {
+        output.clear();
+        return ErrorCode::Success;
+    }
+
+    if (polyphase_ && threads_ > 1) {
+        output.clear();
+        return processPending(polyphase_->getOutputFrames(input_frames_), output);
+    }
+
+    if (polyphase_) {
+        return polyphase_->flush(output);
+    }
+
+    // Flush the resampler
+    std::vector<float> dummy_input(1);
+    SRC_DATA src_data;
+    std::memset(&src_data, 0, sizeof(SRC_DATA));
+
+    src_data.data_in = dummy_input.data();
+    src_data.input_frames = 0;
+    src_data.end_of_input = 1;  // Signal end of input
+
+    // Allocate output buffer
+    int max_output = 4096;
+    output.resize(max_output * channels_);
+
+    src_data.data_out = output.data();
+    src_data.output_frames = max_output;
+    src_data.src_ratio = ratio_;
+
+    int error = src_process(static_cast<SRC_STATE*>(src_state_), &src_data);
+    if (error) {
+        LOG_ERROR("libsamplerate flush error: {}", src_strerror(error));
+        return ErrorCode::AudioDecodeError;
+    }
+
+    // Resize to actual output
+    output.resize(src_data.output_frames_gen * channels_);
+
+    return ErrorCode::Success;
+}
+
+ErrorCode StreamingResampler::processPending(uint64_t last_output, std::vector<float>& output) {
+    if (last_output <= output_frames_) {
+        return ErrorCode::Success;
+    }
+    const size_t segments = static_cast<size_t>(std::max<uint64_t>(1,
+        std::min<uint64_t>(threads_, (last_output - output_frames_) / MIN_RESAMPLE_SEGMENT_FRAMES)));
+    ErrorCode ret = resampleSegments(*polyphase_, pending_.data(), pending_.size() / channels_, pending_start_,
+                                     output_frames_, last_output, segments, output);
+    if (ret != ErrorCode::Success) {
+        return ret;
+    }
+    output_frames_ = last_output;
+
+    // Drop the input older than the next output's filter window
+    const int64_t keep = std::min<int64_t>(polyphase_->getFirstInputFrame(output_frames_),
+                                           static_cast<int64_t>(input_frames_));
+    if (keep > static_cast<int64_t>(pending_start_)) {
+        pending_.erase(pending_.begin(),
+                       pending_.begin() + static_cast<size_t>(keep - static_cast<int64_t>(pending_start_)) * channels_);
+        pending_start_ = static_cast<uint64_t>(keep);
+    }
+    return ErrorCode::Success;
+}
+
+/**
+ * @brief Read line from stdin
+ */
+static std::string readStdinLine() {
+    std::string line;
+    std::getline(std::cin, line);
+    return line;
+}
+
+/**
+ * @brief Parse JSON metadata from xpuLoad output
+ */
+static bool parseMetadataFromStdin(protocol::AudioMetadata& metadata) {
+    // Read JSON metadata character by character until we hit the binary size header
+    std::string json_str;
+    char c;
+
+    // Read until we find the end of JSON (closing brace)
+    bool in_json = false;
+    int brace_count = 0;
+
+    while (std::cin.get(c)) {
+        json_str += c;
+
+        if (c == '{') {
+            in_json = true;
+            brace_count++;
+        } else if (c == '}') {
+            brace_count--;
+            if (in_json && brace_count == 0) {
+                // Found end of JSON
+                break;
+            }
+        }
+    }
+
+    // For now, we'll skip the JSON parsing and use the binary size header
+    // In a full implementation, we would parse the JSON here
+    LOG_INFO("Received metadata from xpuLoad ({} bytes)", json_str.size());
+
+    return true;
+}
+
+/**
+ * @brief Sample format of the incoming chunks ("sample_format"; Float32 if absent)
+ */
+static audio::SampleFormat parseSampleFormat(const protocol::MetadataJSON& metadata) {
+    return audio::AudioFormatUtils::sampleFormatFromString(metadata.getString("sample_format", "Float32"));
+}
+
+/**
+ * @brief Positive integer field of the stream metadata (fallback if absent or not positive)
+ */
+static int positiveInt(const protocol::MetadataJSON& metadata, const std::string& key, int fallback) {
+    const int value = metadata.getInt(key, fallback);
+    return value > 0 ? value : fallback;
+}
+
+/**
+ * @brief Sample format name written for an output bit depth (32 = float)
+ */
+static const char* outputSampleFormat(int bit_depth) {
+    return bit_depth == 16 ? "Int16" : bit_depth == 24 ? "Int24" : "Float32";
+}
+
+/**
+ * @brief Convert one chunk of input samples to float
+ */
+static ErrorCode samplesToFloat(const std::vector<uint8_t>& pcm_data, audio::SampleFormat format,
+                                std::vector<float>& output) {
+    if (!audio::SampleConverter::isSupported(format)) {
+        LOG_ERROR("Unsupported input sample format: {}", audio::AudioFormatUtils::sampleFormatToString(format));
+        return ErrorCode::UnsupportedFormat;
+    }
+    output.resize(pcm_data.size() / audio::AudioFormatUtils::getBytesPerSample(format));
+    audio::SampleConverter::toFloat(pcm_data.data(), format, output.size(), output.data());
+    return ErrorCode::Success;
+}
+
+/**
+ * @brief Copy [size][data] chunks from stdin to stdout byte for byte
+ *
+ * Track records of a multi-track stream are copied like chunks; the stream
+ * format does not change.
+ */
+static ErrorCode copyChunkStream(const char* stream_name) {
+    protocol::ChunkStreamStats stats;
+    ErrorCode ret = protocol::copyChunkStream(std::cin, std::cout, stats);
+    if (ret != ErrorCode::Success) {
+        LOG_ERROR("{} passthrough failed after {} chunks: {}", stream_name, stats.chunks,
+                  ret == ErrorCode::FileReadError ? "truncated input" : "cannot write to stdout");
+        return ret;
+    }
+
+    #ifdef PLATFORM_WINDOWS
+    _flushall();
+    #else
+    fflush(nullptr);
+    #endif
+
+    LOG_INFO("{} passthrough complete: {} chunks, {} bytes, {} track records",
+             stream_name, stats.chunks, stats.bytes, stats.records);
+    return ErrorCode::Success;
+}
+
+/**
+ * @brief Copy integer PCM chunks that already have the requested format
+ *
+ * Going through float and back is bit-exact only without dither, and costs
+ * two conversions per sample, so matching input is forwarded untouched.
+ */
+static ErrorCode passThroughIntegerStream(int input_sample_rate, int input_channels,
+                                          int bit_depth, audio::SampleFormat format) {
+    std::ostringstream json;
+    json << "{\n";
+    json << "  \"success\": true,\n";
+    json << "  \"metadata\": {\n";
+    json << "    \"file_path\": \"stdin\",\n";
+    json << "    \"format\": \"PCM\",\n";
+    json << "    \"sample_rate\": " << input_sample_rate << ",\n";
+    json << "    \"original_sample_rate\": " << input_sample_rate << ",\n";
+    json << "    \"channels\": " << input_channels << ",\n";
+    json << "    \"bit_depth\": " << bit_depth << ",\n";
+    json << "    \"original_bit_depth\": " << bit_depth << ",\n";
+    json << "    \"is_lossless\": true,\n";
+    json << "    \"sample_format\": \"" << audio::AudioFormatUtils::sampleFormatToString(format) << "\"\n";
+    json << "  }\n";
+    json << "}\n";
+
+    std::cout << json.str();
+    std::cout.flush();
+
+    return copyChunkStream("PCM");
+}
+
+/**
+ * @brief Copy DoP chunks from stdin to stdout byte for byte
+ *
+ * DoP words only survive untouched bits, so resampling, channel mapping and
+ * bit depth conversion are all skipped.
+ */
+static ErrorCode passThroughDoPStream(int input_sample_rate, int input_channels) {
+    std::ostringstream json;
+    json << "{\n";
+    json << "  \"success\": true,\n";
+    json << "  \"metadata\": {\n";
+    json << "    \"file_path\": \"stdin\",\n";
+    json << "    \"format\": \"DoP\",\n";
+    json << "    \"sample_rate\": " << input_sample_rate << ",\n";
+    json << "    \"original_sample_rate\": " << input_sample_rate << ",\n";
+    json << "    \"channels\": " << input_channels << ",\n";
+    json << "    \"bit_depth\": 24,\n";
+    json << "    \"original_bit_depth\": 1,\n";
+    json << "    \"is_lossless\": true,\n";
+    json << "    \"encoding\": \"dop\"\n";
+    json << "  }\n";
+    json << "}\n";
+
+    std::cout << json.str();
+    std::cout.flush();
+
+    return copyChunkStream("DoP");
+}
+
+/**
+ * @brief Remix interleaved frames (downmix keeps the first N channels, upmix repeats channel 0)
+ */
+static void remixChannels(const std::vector<float>& input, int input_channels,
+                          int output_channels, std::vector<float>& output) {
+    const size_t frames = input.size() / input_channels;
+    output.resize(frames * output_channels);
+    for (size_t i = 0; i < frames; ++i) {
+        for (int ch = 0; ch < output_channels; ++ch) {
+            int src_ch = (ch < input_channels) ? ch : 0;
+            output[i * output_channels + ch] = input[i * input_channels + src_ch];
+        }
+    }
+}
+
+/**
+ * @brief Chunked float -> WAV file pipeline (resample, remix, bit depth, write)
+ *
+ * Keeps one chunk in memory at a time; the resampler and the dither
+ * sequence carry over from chunk to chunk. The WAV header is patched when
+ * the sink is finished and switches to RF64 past 4 GB.
+ */
+class WAVFileSink {
+public:
+    ErrorCode open(const std::string& output_file, int input_rate, int input_channels,
+                   int output_rate, int output_channels, int bit_depth,
+                   const char* quality, bool dither) {
+        input_channels_ = input_channels;
+        output_channels_ = output_channels;
+        bit_depth_ = bit_depth;
+        dither_ = dither;
+        resampling_ = input_rate != output_rate;
+
+        if (resampling_) {
+            resampler_.setThreads(static_cast<int>(std::thread::hardware_concurrency()));
+            ErrorCode ret = resampler_.init(input_rate, output_rate, input_channels, quality);
+            if (ret != ErrorCode::Success) {
+                LOG_ERROR("Failed to initialize resampler: {} Hz -> {} Hz", input_rate, output_rate);
+                return ret;
+            }
+            LOG_INFO("Resampling from {} Hz to {} Hz (quality={})", input_rate, output_rate, quality);
+        }
+        if (output_channels != input_channels) {
+            LOG_INFO("Converting channels: {} -> {}", input_channels, output_channels);
+        }
+
+        ErrorCode ret = writer_.open(output_file, output_rate, output_channels, bit_depth, bit_depth == 32);
+        if (ret != ErrorCode::Success) {
+            LOG_ERROR("Failed to create output file: {}", output_file);
+        }
+        return ret;
+    }
+
+    /**
+     * @brief Process one chunk of interleaved float samples in the input format
+     */
+    ErrorCode write(const float* samples, size_t sample_count) {
+        if (resampling_) {
+            ErrorCode ret = resampler_.process(samples, static_cast<int>(sample_count / input_channels_), resampled_);
+            if (ret != ErrorCode::Success) {
+                LOG_ERROR("Resampling failed");
+                return ret;
+            }
+        } else {
+            resampled_.assign(samples, samples + sample_count);
+        }
+        return writeResampled();
+    }
+
+    /**
+     * @brief Write sample data that is already in the output format
+     */
+    ErrorCode writeRaw(const uint8_t* data, size_t bytes) {
+        return writer_.write(data, bytes);
+    }
+
+    /**
+     * @brief Flush the resampler and patch the WAV header
+     */
+    ErrorCode finish() {
+        if (resampling_) {
+            ErrorCode ret = resampler_.flush(resampled_);
+            if (ret == ErrorCode::Success) {
+                ret = writeResampled();
+            }
+            if (ret != ErrorCode::Success) {
+                LOG_ERROR("Resampler flush failed");
+                return ret;
+            }
+        }
+        const bool rf64 = writer_.isRF64();
+        const uint64_t data_bytes = writer_.dataBytes();
+        ErrorCode ret = writer_.close();
+        if (ret != ErrorCode::Success) {
+            LOG_ERROR("Failed to finalize WAV header");
+            return ret;
+        }
+        LOG_INFO("  Size: {} bytes{}", data_bytes + audio::WAVWriter::HEADER_SIZE, rf64 ? " (RF64)" : "");
+        return ErrorCode::Success;
+    }
+
+private:
+    ErrorCode writeResampled() {
+        if (resampled_.empty()) {
+            return ErrorCode::Success;
+        }
+        if (output_channels_ != input_channels_) {
+            remixChannels(resampled_, input_channels_, output_channels_, remixed_);
+            resampled_.swap(remixed_);
+        }
+        ErrorCode ret = FormatConverter::convertBitDepth(resampled_, 32, bit_depth_, packed_,
+                                                         dither_ ? &dither_state_ : nullptr);
+        if (ret != ErrorCode::Success) {
+            LOG_ERROR("Bit depth conversion failed: {}", static_cast<int>(ret));
+            return ret;
+        }
+        ret = writer_.write(packed_.data(), packed_.size());
+        if (ret != ErrorCode::Success) {
+            LOG_ERROR("Failed to write WAV data");
+        }
+        return ret;
+    }
+
+    audio::WAVWriter writer_;
+    StreamingResampler resampler_;
+    audio::DitherState dither_state_;
+    std::vector<float> resampled_;
+    std::vector<float> remixed_;
+    std::vector<uint8_t> packed_;
+    int input_channels_ = 2;
+    int output_channels_ = 2;
+    int bit_depth_ = 32;
+    bool dither_ = false;
+    bool resampling_ = false;
+};
+
+ErrorCode FormatConverter::convertStdinToWAV(const std::string& output_file,
+                                            int sample_rate,
+                                            int bit_depth,
+                                            int channels,
+                                            const char* quality,
+                                            bool dither) {
+    LOG_INFO("Converting stdin to WAV");
+    LOG_INFO("  Target sample rate: {}", sample_rate);
+    LOG_INFO("  Quality: {}", quality);
+    LOG_INFO("  Target bit depth: {}", bit_depth);
+    LOG_INFO("  Target channels: {}", channels);
+
+    // Set stdin to binary mode
+    #ifdef PLATFORM_WINDOWS
+        _setmode(_fileno(stdin), _O_BINARY);
+        _setmode(_fileno(stdout), _O_BINARY);
+    #endif
+
+    // Read and skip JSON metadata
+    // xpuLoad outputs: [JSON metadata][8-byte size header][PCM data]...
+    // JSON metadata ends with "}\n", then immediately followed by 8-byte size header
+
+    std::string json_str;
+    char c;
+    bool json_complete = false;
+
+    // Read until we find the end of JSON (closing brace + newline)
+    int brace_count = 0;
+    bool in_json = false;
+    int max_json_size = 100000;  // Safety limit
+    int json_bytes = 0;
+
+    while (std::cin.get(c) && json_bytes < max_json_size) {
+        json_str += c;
+        json_bytes++;
+
+        if (c == '{') {
+            in_json = true;
+            brace_count++;
+        } else if (c == '}') {
+            brace_count--;
+            if (in_json && brace_count == 0) {
+                // Found end of JSON object
+                // Check if next character is newline
+                int next_char = std::cin.peek();
+                if (next_char == '\n' || next_char == '\r') {
+                    std::cin.get(c);  // Consume the newline
+                    // Check for CRLF
+                    if (c == '\r' && std::cin.peek() == '\n') {
+                        std::cin.get(c);  // Consume the LF
+                    }
+                    json_complete = true;
+                    break;
+                }
+            }
+        }
+    }
+
+    if (!json_complete) {
+        LOG_ERROR("Failed to read complete JSON metadata from stdin (read {} bytes)", json_bytes);
+        LOG_ERROR("JSON content so far: {}", json_str);
+        return ErrorCode::InvalidOperation;
+    }
+
+    LOG_INFO("JSON metadata received: {} bytes", json_str.size());
+
+    protocol::MetadataJSON metadata;
+    if (!metadata.parse(json_str)) {
+        LOG_ERROR("Invalid JSON metadata from stdin");
+        return ErrorCode::InvalidArgument;
+    }
+    const int input_sample_rate = positiveInt(metadata, "sample_rate", 48000);
+    const int input_channels = positiveInt(metadata, "channels", 2);
+    const audio::SampleFormat input_format = parseSampleFormat(metadata);
+    if (!audio::SampleConverter::isSupported(input_format)) {
+        LOG_ERROR("Unsupported input sample format: {}", audio::AudioFormatUtils::sampleFormatToString(input_format));
+        return ErrorCode::UnsupportedFormat;
+    }
+    LOG_INFO("Input format: {} Hz, {} channels, {}", input_sample_rate, input_channels,
+             audio::AudioFormatUtils::sampleFormatToString(input_format));
+
+    int output_sample_rate = sample_rate > 0 ? sample_rate : input_sample_rate;
+    int output_channels = channels > 0 ? channels : input_channels;
+
+    // DoP words only survive untouched bits: a 24-bit WAV at the input rate
+    // and channel count, converted at unity gain without dither
+    if (metadata.getString("encoding", "") == "dop") {
+        if (output_sample_rate != input_sample_rate || output_channels != input_channels || bit_depth != 24) {
+            LOG_WARN("DoP input: ignoring sample rate/bit depth/channel conversion, writing 24-bit DoP WAV");
+        }
+        output_sample_rate = input_sample_rate;
+        output_channels = input_channels;
+        bit_depth = 24;
+        dither = false;
+        LOG_INFO("DoP stream detected, writing frames untouched");
+    }
+
+    // Integer input already in the requested format is written bit-exactly
+    const bool pass_through = output_sample_rate == input_sample_rate && output_channels == input_channels &&
+        ((input_format == audio::SampleFormat::Int16 && bit_depth == 16) ||
+         (input_format == audio::SampleFormat::Int24 && bit_depth == 24));
+
+    WAVFileSink sink;
+    ErrorCode ret = sink.open(output_file, input_sample_rate, input_channels,
+                              output_sample_rate, output_channels, bit_depth, quality, dither);
+    if (ret != ErrorCode::Success) {
+        return ret;
+    }
+
+    // Chunks are converted and written one at a time: [8-byte size][data]...
+    std::vector<uint8_t> pcm_data;
+    std::vector<float> audio_buffer;
+    uint64_t total_bytes = 0;
+
+    while (true) {
+        uint64_t data_size = 0;
+        if (!std::cin.read(reinterpret_cast<char*>(&data_size), sizeof(data_size))) {
+            if (std::cin.eof() && std::cin.gcount() == 0) {
+                break;
+            }
+            LOG_ERROR("Failed to read size header from stdin");
+            return ErrorCode::InvalidOperation;
+        }
+        if (data_size == 0) {
+            break;
+        }
+
+        // Later tracks of a multi-track stream keep the format: join them
+        if (data_size & protocol::TRACK_RECORD_FLAG) {
+            std::string record(data_size & ~protocol::TRACK_RECORD_FLAG, '\0');
+            if (!std::cin.read(&record[0], static_cast<std::streamsize>(record.size()))) {
+                LOG_ERROR("Failed to read track record ({} bytes)", record.size());
+                return ErrorCode::FileReadError;
+            }
+            LOG_INFO("Next track record: {} bytes, appending to the same file", record.size());
+            continue;
+        }
+
+        pcm_data.resize(data_size);
+        if (!std::cin.read(reinterpret_cast<char*>(pcm_data.data()), static_cast<std::streamsize>(data_size))) {
+            LOG_ERROR("Failed to read PCM data from stdin");
+            return ErrorCode::InvalidOperation;
+        }
+        total_bytes += data_size;
+
+        if (pass_through) {
+            ret = sink.writeRaw(pcm_data.data(), pcm_data.size());
+        } else {
+            ret = samplesToFloat(pcm_data, input_format, audio_buffer);
+            if (ret == ErrorCode::Success) {
+                ret = sink.write(audio_buffer.data(), audio_buffer.size());
+            }
+        }
+        if (ret != ErrorCode::Success) {
+            return ret;
+        }
+    }
+
+    if (total_bytes == 0) {
+        LOG_ERROR("No PCM data received from stdin");
+        return ErrorCode::InvalidOperation;
+    }
+    LOG_INFO("PCM data read from stdin: {} bytes", total_bytes);
+
+    ret = sink.finish();
+    if (ret != ErrorCode::Success) {
+        return ret;
+    }
+
+    LOG_INFO("WAV file created: {}", output_file);
+
+    return ErrorCode::Success;
+}
+
+ErrorCode FormatConverter::convertToWAV(const std::string& input_file,
+                                          const std::string& output_file,
+                                          int sample_rate,
+                                          int bit_depth,
+                                          int channels,
+                                          const char* quality,
+                                          bool dither) {
+    LOG_INFO("Converting {} to WAV", input_file);
+    LOG_INFO("  Target sample rate: {}", sample_rate);
+    LOG_INFO("  Target bit depth: {}", bit_depth);
+    LOG_INFO("  Target channels: {}", channels);
+    LOG_INFO("  Quality: {}", quality);
+
+    // Load audio file
+    bool is_dsd = false;
+    if (input_file.size() > 4) {
+        std::string ext = input_file.substr(input_file.size() - 4);
+        if (ext == ".dsf" || ext == ".dff") {
+            is_dsd = true;
+        }
+    }
+
+    // Whatever rate the decoder delivers is resampled chunk by chunk on the
+    // way to the file, polyphase ratios on all cores
+    WAVFileSink sink;
+    ErrorCode sink_ret = ErrorCode::Success;
+    auto openSink = [&](const protocol::AudioMetadata& metadata) {
+        LOG_INFO("Decoded format: {} Hz, {} channels", metadata.sample_rate, metadata.channels);
+        return sink.open(output_file, metadata.sample_rate, metadata.channels,
+                         sample_rate > 0 ? sample_rate : metadata.sample_rate,
+                         channels > 0 ? channels : metadata.channels,
+                         bit_depth, quality, dither);
+    };
+    auto writeChunk = [&](const float* chunk_data, size_t chunk_samples) {
+        sink_ret = sink.write(chunk_data, chunk_samples);
+        return sink_ret == ErrorCode::Success;
+    };
+
+    ErrorCode ret;
+    if (is_dsd) {
+        load::DSDDecoder decoder;
+        decoder.setTargetSampleRate(sample_rate > 0 ? sample_rate : 0);  // 0 = keep original
+        ret = decoder.prepareStreaming(input_file);
+        if (ret == ErrorCode::Success) {
+            ret = openSink(decoder.getMetadata());
+            if (ret == ErrorCode::Success) {
+                ret = decoder.streamPCM(writeChunk);
+            }
+        }
+    } else {
+        load::AudioFileLoader loader;
+        // Decode at the source rate (don't convert to 48000); the sink does
+        // any requested conversion with the --quality resampler
+        loader.setTargetSampleRate(0);
+        // Files that split into independent segments are decoded on all cores
+        loader.setLoadSegments(0);
+        ret = loader.prepareStreaming(input_file);
+        if (ret == ErrorCode::Success) {
+            ret = openSink(loader.getMetadata());
+            if (ret == ErrorCode::Success) {
+                ret = loader.streamPCM(writeChunk);
+            }
+        }
+    }
+
+    if (sink_ret != ErrorCode::Success) {
+        return sink_ret;
+    }
+    if (ret != ErrorCode::Success) {
+        LOG_ERROR("Failed to decode input file: {}", static_cast<int>(ret));
+        return ret;
+    }
+
+    ret = sink.finish();
+    if (ret != ErrorCode::Success) {
+        return ret;
+    }
+
+    LOG_INFO("WAV file created: {}", output_file);
+
+    return ErrorCode::Success;
+}
+
+ErrorCode FormatConverter::resample(const std::vector<float>& input,
+                                     int input_rate,
+                                     int output_rate,
+                                     int channels,
+                                     std::vector<float>& output,
+                                     const char* quality) {
+    if (input_rate == output_rate) {
+        output = input;
+        return ErrorCode::Success;
+    }
+
+    size_t input_frames = input.size() / channels;
+
+    // Fixed rational ratio: precomputed polyphase filter bank
+    audio::ResamplerQuality preset;
+    if (audio::PolyphaseResampler::qualityFromString(quality, preset) &&
+        audio::PolyphaseResampler::isSupportedRatio(input_rate, output_rate)) {
+        audio::PolyphaseResampler polyphase;
+        ErrorCode ret = polyphase.init(input_rate, output_rate, channels, preset);
+        if (ret != ErrorCode::Success) {
+            LOG_ERROR("Polyphase resampling failed: {}", static_cast<int>(ret));
+            return ret;
+        }
+
+        // Disjoint output ranges on separate threads
+        const uint64_t total = polyphase.getOutputFrames(input_frames);
+        const uint64_t hardware = std::max(1u, std::thread::hardware_concurrency());
+        const size_t segments = static_cast<size_t>(
+            std::max<uint64_t>(1, std::min(hardware, total / MIN_RESAMPLE_SEGMENT_FRAMES)));
+        output.clear();
+        ret = resampleSegments(polyphase, input.data(), input_frames, 0, 0, total, segments, output);
+        if (ret != ErrorCode::Success) {
+            return ret;
+        }
+        LOG_INFO("Resampled: {} frames -> {} frames (polyphase {}/{}, quality={}, {} segments)", input_frames,
+                 output.size() / channels, polyphase.getUpFactor(), polyphase.getDownFactor(), quality, segments);
+        return ErrorCode::Success;
+    }
+
+    // Calculate output frames
+    double ratio = static_cast<double>(output_rate) / static_cast<double>(input_rate);
+    size_t output_frames = static_cast<size_t>(input_frames * ratio) + 1;
+
+    // Setup libsamplerate
+    SRC_DATA src_data;
+    std::memset(&src_data, 0, sizeof(SRC_DATA));
+
+    src_data.data_in = const_cast<float*>(input.data());
+    src_data.input_frames = input_frames;
+    src_data.output_frames = output_frames;
+    src_data.src_ratio = ratio;
+
+    output.resize(output_frames * channels);
+    src_data.data_out = output.data();
+
+    // Get converter type from quality string
+    int converter_type = getConverterType(quality);
+    const char* quality_name = (converter_type == SRC_SINC_BEST_QUALITY) ? "best" :
+                               (converter_type == SRC_SINC_MEDIUM_QUALITY) ? "medium" :
+                               (converter_type == SRC_SINC_FASTEST) ? "fast" : "unknown";
+
+    LOG_INFO("Resampling quality: {}", quality_name);
+
+    int error = 0;
+    SRC_STATE* src_state = src_new(converter_type, channels, &error);
+    if (error) {
+        LOG_ERROR("libsamplerate initialization error: {}", src_strerror(error));
+        return ErrorCode::AudioDecodeError;
+    }
+
+    error = src_process(src_state, &src_data);
+    src_delete(src_state);
+
+    if (error) {
+        LOG_ERROR("libsamplerate error: {}", src_strerror(error));
+        return ErrorCode::AudioDecodeError;
+    }
+
+    output.resize(src_data.output_frames_gen * channels);
+
+    LOG_INFO("Resampled: {} frames -> {} frames", input_frames, src_data.output_frames_gen);
+
+    return ErrorCode::Success;
+}
+
+ErrorCode FormatConverter::convertBitDepth(const std::vector<float>& input,
+                                            int input_bits,
+                                            int output_bits,
+                                            std::vector<uint8_t>& output,
+                                            audio::DitherState* dither) {
+    if (input_bits != 32) {
+        LOG_ERROR("Only 32-bit float input is supported");
+        return ErrorCode::InvalidOperation;
+    }
+
+    switch (output_bits) {
+        case 16:
+        case 24: {
+            // Packed little-endian 16-bit or 24-bit (3 bytes) PCM, SIMD with optional TPDF dither
+            const audio::SampleFormat format = output_bits == 16 ? audio::SampleFormat::Int16
+                                                                 : audio::SampleFormat::Int24;
+            output.resize(input.size() * (output_bits / 8));
+            audio::SampleConverter::fromFloat(input.data(), input.size(), format, output.data(), dither);
+            break;
+        }
+
+        case 32: {
+            // Keep as 32-bit float
+            size_t byte_count = input.size() * sizeof(float);
+            output.resize(byte_count);
+            std::memcpy(output.data(), input.data(), byte_count);
+            break;
+        }
+
+        default:
+            LOG_ERROR("Unsupported output bit depth: {}", output_bits);
+            return ErrorCode::InvalidOperation;
+    }
+
+    LOG_DEBUG("Bit depth converted: {} -> {}", input_bits, output_bits);
+
+    return ErrorCode::Success;
+}
+
+ErrorCode FormatConverter::convertStdinToStdout(int sample_rate,
+                                                 int bit_depth,
+                                                 int channels,
+                                                 const char* quality,
+                                                 bool dither) {
+    LOG_INFO("Converting stdin to stdout (pipeline mode)");
+    LOG_INFO("  Target sample rate: {}", sample_rate);
+    LOG_INFO("  Target bit depth: {}", bit_depth);
+    LOG_INFO("  Target channels: {}", channels);
+    LOG_INFO("  Quality: {}", quality);
+
+    // Set stdin/stdout to binary mode
+    #ifdef PLATFORM_WINDOWS
+        _setmode(_fileno(stdin), _O_BINARY);
+        _setmode(_fileno(stdout), _O_BINARY);
+    #endif
+
+    // Disable buffering for stdin/stdout to enable streaming
+    std::ios_base::sync_with_stdio(false);
+    std::cin.tie(nullptr);
+    std::cout.setf(std::ios::unitbuf);  // Force unbuffered output
+
+    // Read and parse JSON metadata from xpuLoad
+    std::string json_str;
+    char c;
+    bool json_complete = false;
+    int brace_count = 0;
+    bool in_json = false;
+    int max_json_size = 100000;
+    int json_bytes = 0;
+
+    while (std::cin.get(c) && json_bytes < max_json_size) {
+        json_str += c;
+        json_bytes++;
+
+        if (c == '{') {
+            in_json = true;
+            brace_count++;
+        } else if (c == '}') {
+            brace_count--;
+            if (in_json && brace_count == 0) {
+                int next_char = std::cin.peek();
+                if (next_char == '\n' || next_char == '\r') {
+                    std::cin.get(c);
+                    if (c == '\r' && std::cin.peek() == '\n') {
+                        std::cin.get(c);
+                    }
+                    json_complete = true;
+                    break;
+                }
+            }
+        }
+    }
+
+    if (!json_complete) {
+        LOG_ERROR("Failed to read complete JSON metadata from stdin");
+        return ErrorCode::InvalidOperation;
+    }
+
+    LOG_INFO("JSON metadata received: {} bytes", json_str.size());
+
+    protocol::MetadataJSON metadata;
+    if (!metadata.parse(json_str)) {
+        LOG_ERROR("Invalid JSON metadata from stdin");
+        return ErrorCode::InvalidArgument;
+    }
+    const int input_sample_rate = positiveInt(metadata, "sample_rate", 48000);
+    const int input_channels = positiveInt(metadata, "channels", 2);
+
+    LOG_INFO("Input format: {} Hz, {} channels", input_sample_rate, input_channels);
+
+    // Read 8-byte size header
+    uint64_t data_size = 0;
+    char size_buffer[8];
+    if (!std::cin.read(size_buffer, 8)) {
+        LOG_ERROR("Failed to read size header from stdin");
+        return ErrorCode::InvalidOperation;
+    }
+    std::memcpy(&data_size, size_buffer, 8);
+
+    if (data_size == 0) {
+        LOG_ERROR("Invalid data size: 0");
+        return ErrorCode::InvalidOperation;
+    }
+
+    const audio::SampleFormat input_format = parseSampleFormat(metadata);
+    LOG_INFO("PCM data size: {} bytes ({})", data_size, audio::AudioFormatUtils::sampleFormatToString(input_format));
+
+    // Read PCM data
+    std::vector<uint8_t> pcm_data(data_size);
+    std::cin.read(reinterpret_cast<char*>(pcm_data.data()), data_size);
+
+    if (!std::cin) {
+        LOG_ERROR("Failed to read PCM data from stdin");
+        return ErrorCode::InvalidOperation;
+    }
+
+    // Convert to float vector
+    std::vector<float> audio_buffer;
+    ErrorCode converted = samplesToFloat(pcm_data, input_format, audio_buffer);
+    if (converted != ErrorCode::Success) {
+        return converted;
+    }
+    size_t sample_count = audio_buffer.size();
+
+    // Determine output parameters
+    int output_sample_rate = (sample_rate > 0) ? sample_rate : input_sample_rate;
+    int output_channels = (channels > 0) ? channels : input_channels;
+    int output_bit_depth = bit_depth;
+
+    // Resample if needed
+    if (output_sample_rate != input_sample_rate) {
+        LOG_INFO("Resampling: {} Hz -> {} Hz", input_sample_rate, output_sample_rate);
+        std::vector<float> resampled;
+        ErrorCode ret = resample(audio_buffer, input_sample_rate, output_sample_rate, input_channels, resampled, quality);
+        if (ret != ErrorCode::Success) {
+            LOG_ERROR("Resampling failed: {}", static_cast<int>(ret));
+            return ret;
+        }
+        audio_buffer = std::move(resampled);
+    }
+
+    // Convert channels if needed
+    if (output_channels != input_channels) {
+        LOG_INFO("Converting channels: {} -> {}", input_channels, output_channels);
+        std::vector<float> remixed;
+
+        if (output_channels < input_channels) {
+            // Downmix
+            size_t frames = audio_buffer.size() / input_channels;
+            remixed.resize(frames * output_channels);
+            for (size_t i = 0; i < frames; ++i) {
+                for (int ch = 0; ch < output_channels; ++ch) {
+                    remixed[i * output_channels + ch] = audio_buffer[i * input_channels + ch];
+                }
+            }
+        } else {
+            // Upmix
+            size_t frames = audio_buffer.size() / input_channels;
+            remixed.resize(frames * output_channels);
+            for (size_t i = 0; i < frames; ++i) {
+                for (int ch = 0; ch < output_channels; ++ch) {
+                    int src_ch = (ch < input_channels) ? ch : 0;
+                    remixed[i * output_channels + ch] = audio_buffer[i * input_channels + src_ch];
+                }
+            }
+        }
+        audio_buffer = std::move(remixed);
+    }
+
+    // Convert bit depth if needed (output 32-bit float for xpuPlay)
+    std::vector<uint8_t> output_data;
+    if (output_bit_depth != 32) {
+        audio::DitherState dither_state;
+        ErrorCode ret = convertBitDepth(audio_buffer, 32, output_bit_depth, output_data,
+                                        dither ? &dither_state : nullptr);
+        if (ret != ErrorCode::Success) {
+            LOG_ERROR("Bit depth conversion failed: {}", static_cast<int>(ret));
+            return ret;
+        }
+    } else {
+        // Keep as 32-bit float
+        size_t byte_count = audio_buffer.size() * sizeof(float);
+        output_data.resize(byte_count);
+        std::memcpy(output_data.data(), audio_buffer.data(), byte_count);
+    }
+
+    // Create new metadata for output
+    protocol::AudioMetadata output_metadata;
+    output_metadata.sample_rate = output_sample_rate;
+    output_metadata.original_sample_rate = input_sample_rate;
+    output_metadata.channels = output_channels;
+    output_metadata.bit_depth = output_bit_depth;
+    output_metadata.original_bit_depth = 32;
+    output_metadata.sample_count = output_data.size() / (output_bit_depth / 8);
+    output_metadata.is_lossless = true;
+
+    // Calculate duration
+    size_t total_samples = output_metadata.sample_count / output_metadata.channels;
+    output_metadata.duration = static_cast<double>(total_samples) / output_sample_rate;
+
+    // Generate JSON metadata
+    std::ostringstream json;
+    json << "{\n";
+    json << "  \"success\": true,\n";
+    json << "  \"metadata\": {\n";
+    json << "    \"file_path\": \"stdin\",\n";
+    json << "    \"format\": \"PCM\",\n";
+    json << "    \"sample_rate\": " << output_metadata.sample_rate << ",\n";
+    json << "    \"original_sample_rate\": " << output_metadata.original_sample_rate << ",\n";
+    json << "    \"channels\": " << output_metadata.channels << ",\n";
+    json << "    \"bit_depth\": " << output_metadata.bit_depth << ",\n";
+    json << "    \"original_bit_depth\": " << output_metadata.original_bit_depth << ",\n";
+    json << "    \"sample_count\": " << output_metadata.sample_count << ",\n";
+    json << "    \"duration\": " << output_metadata.duration << ",\n";
+    json << "    \"is_lossless\": true,\n";
+    json << "    \"sample_format\": \"" << outputSampleFormat(output_bit_depth) << "\"\n";
+    json << "  }\n";
+    json << "}\n";
+
+    // Output to stdout: [JSON metadata][8-byte size header][PCM data]
+    std::cout << json.str();
+    std::cout.flush();
+
+    uint64_t output_size = output_data.size();
+    std::cout.write(reinterpret_cast<const char*>(&output_size), sizeof(output_size));
+    std::cout.write(reinterpret_cast<const char*>(output_data.data()), output_data.size());
+    std::cout.flush();
+
+    LOG_INFO("Conversion complete: {} samples, {} bytes output to stdout",
+             sample_count, output_data.size());
+
+    return ErrorCode::Success;
+}
+
+ErrorCode FormatConverter::convertStdinToStdoutStreaming(int sample_rate,
+                                                         int bit_depth,
+                                                         int channels,
+                                                         const char* quality,
+                                                         int chunk_size,
+                                                         bool verbose,
+                                                         bool dither) {
+    LOG_INFO("Converting stdin to stdout (streaming mode)");
+    LOG_INFO("  Target sample rate: {}", sample_rate > 0 ? sample_rate : 0);
+    LOG_INFO("  Target bit depth: {}", bit_depth);
+    LOG_INFO("  Target channels: {}", channels > 0 ? channels : 0);
+    LOG_INFO("  Quality: {}", quality);
+    LOG_INFO("  Chunk size: {} frames", chunk_size);
+    LOG_INFO("  Dither: {}", dither && bit_depth < 32 ? "TPDF" : "off");
+
+    // Set stdin/stdout to binary mode
+    #ifdef PLATFORM_WINDOWS
+        _setmode(_fileno(stdin), _O_BINARY);
+        _setmode(_fileno(stdout), _O_BINARY);
+    #endif
+
+    // Disable buffering for stdin/stdout to enable streaming
+    std::ios_base::sync_with_stdio(false);
+    std::cin.tie(nullptr);
+    std::cout.setf(std::ios::unitbuf);  // Force unbuffered output
+
+    // ===== Phase 1: Parse JSON metadata =====
+    std::string json_str;
+    char c;
+    bool json_complete = false;
+    int brace_count = 0;
+    bool in_json = false;
+    int max_json_size = 100000;
+    int json_bytes = 0;
+
+    while (std::cin.get(c) && json_bytes < max_json_size) {
+        json_str += c;
+        json_bytes++;
+
+        if (c == '{') {
+            in_json = true;
+            brace_count++;
+        } else if (c == '}') {
+            brace_count--;
+            if (in_json && brace_count == 0) {
+                int next_char = std::cin.peek();
+                if (next_char == '\n' || next_char == '\r') {
+                    std::cin.get(c);
+                    if (c == '\r' && std::cin.peek() == '\n') {
+                        std::cin.get(c);
+                    }
+                    json_complete = true;
+                    break;
+                }
+            }
+        }
+    }
+
+    if (!json_complete) {
+        LOG_ERROR("Failed to read complete JSON metadata from stdin");
+        return ErrorCode::InvalidOperation;
+    }
+
+    LOG_INFO("JSON metadata received: {} bytes", json_str.size());
+
+    protocol::MetadataJSON metadata;
+    if (!metadata.parse(json_str)) {
+        LOG_ERROR("Invalid JSON metadata from stdin");
+        return ErrorCode::InvalidArgument;
+    }
+    const int input_sample_rate = positiveInt(metadata, "sample_rate", 48000);
+    const int input_channels = positiveInt(metadata, "channels", 2);
+    // Default to false for backward compatibility
+    bool streaming_mode = metadata.getBool("streaming_mode", false);
+
+    LOG_INFO("Streaming mode from metadata: {}", streaming_mode ? "true" : "false");
+
+    // If streaming_mode is false, this is likely a mistake in the pipeline
+    // We should log a warning but continue in streaming mode anyway
+    if (!streaming_mode) {
+        LOG_WARN("Metadata indicates file mode, but we're reading from stdin - forcing streaming mode");
+        streaming_mode = true;
+    }
+
+    LOG_INFO("Input format: {} Hz, {} channels", input_sample_rate, input_channels);
+
+    if (metadata.getString("encoding", "") == "dop") {
+        if ((sample_rate > 0 && sample_rate != input_sample_rate) || bit_depth != 32 ||
+            (channels > 0 && channels != input_channels)) {
+            LOG_WARN("DoP input: ignoring sample rate/bit depth/channel conversion");
+        }
+        LOG_INFO("DoP stream detected, passing frames through untouched");
+        return passThroughDoPStream(input_sample_rate, input_channels);
+    }
+
+    const audio::SampleFormat input_format = parseSampleFormat(metadata);
+    if (!audio::SampleConverter::isSupported(input_format)) {
+        LOG_ERROR("Unsupported input sample format: {}", audio::AudioFormatUtils::sampleFormatToString(input_format));
+        return ErrorCode::UnsupportedFormat;
+    }
+    const int input_bytes = audio::AudioFormatUtils::getBytesPerSample(input_format);
+    const int input_bits = input_bytes * 8;
+    const bool integer_input = audio::SampleConverter::isInteger(input_format);
+    LOG_INFO("Input sample format: {}", audio::AudioFormatUtils::sampleFormatToString(input_format));
+
+    // Integer input already in the requested format is copied bit-exactly
+    if (integer_input && (sample_rate <= 0 || sample_rate == input_sample_rate) &&
+        (channels <= 0 || channels == input_channels) &&
+        ((input_format == audio::SampleFormat::Int16 && bit_depth == 16) ||
+         (input_format == audio::SampleFormat::Int24 && bit_depth == 24))) {
+        LOG_INFO("Input is already {}-bit integer PCM, passing chunks through untouched", bit_depth);
+        return passThroughIntegerStream(input_sample_rate, input_channels, bit_depth, input_format);
+    }
+
+    // In streaming mode, we read multiple chunks: [chunk size][chunk data]...
+    // Each chunk has its own 8-byte size header
+    // We don't know the total size upfront, so we'll read until EOF
+
+    // Determine output parameters
+    int output_sample_rate = (sample_rate > 0) ? sample_rate : input_sample_rate;
+    int output_channels = (channels > 0) ? channels : input_channels;
+    int output_bit_depth = bit_depth;
+
+    // ===== Phase 1.5: Output metadata before streaming =====
+    // Note: In streaming mode, we don't know the total size upfront
+    // So we output metadata with estimated/placeholder values
+
+    // Generate JSON metadata
+    std::ostringstream json;
+    json << "{\n";
+    json << "  \"success\": true,\n";
+    json << "  \"metadata\": {\n";
+    json << "    \"file_path\": \"stdin\",\n";
+    json << "    \"format\": \"PCM\",\n";
+    json << "    \"sample_rate\": " << output_sample_rate << ",\n";
+    json << "    \"original_sample_rate\": " << input_sample_rate << ",\n";
+    json << "    \"channels\": " << output_channels << ",\n";
+    json << "    \"bit_depth\": " << output_bit_depth << ",\n";
+    json << "    \"original_bit_depth\": " << input_bits << ",\n";
+    json << "    \"is_lossless\": true,\n";
+    json << "    \"sample_format\": \"" << outputSampleFormat(output_bit_depth) << "\"\n";
+    json << "  }\n";
+    json << "}\n";
+
+    // Output to stdout: [JSON metadata] (no size header for streaming mode)
+    std::cout << json.str();
+    std::cout.flush();
+    #ifdef PLATFORM_WINDOWS
+    _flushall();  // Force flush all streams on Windows
+    #else
+    fflush(nullptr);  // Force flush all streams on Unix
+    #endif
+
+    LOG_INFO("Metadata sent to stdout");
+    LOG_INFO("Streaming mode: will output chunks as [size][data]...");
+
+    // ===== Phase 2: Initialize streaming resampler =====
+    StreamingResampler resampler;
+    bool needs_resampling = (output_sample_rate != input_sample_rate);
+
+    if (needs_resampling) {
+        ErrorCode ret = resampler.init(input_sample_rate, output_sample_rate, input_channels, quality);
+        if (ret != ErrorCode::Success) {
+            LOG_ERROR("Failed to initialize streaming resampler");
+            return ret;
+        }
+        LOG_INFO("Streaming resampler initialized: {} Hz -> {} Hz (ratio={}, quality={})",
+                 input_sample_rate, output_sample_rate, resampler.getRatio(), quality);
+    }
+
+    // Allocate buffers with pre-allocation for better performance
+    // Pre-allocate to maximum expected size to avoid reallocations
+    constexpr size_t MAX_CHUNK_SIZE = 256 * 1024;  // 256KB max chunk size
+    constexpr size_t MAX_SAMPLES = MAX_CHUNK_SIZE / sizeof(float);
+    constexpr size_t MAX_CHANNELS = 8;  // Support up to 8 channels
+    constexpr size_t RESAMPLE_RATIO = 2;  // Max resample ratio (upsampling can double frames)
+
+    std::vector<float> input_buffer;
+    std::vector<uint8_t> raw_buffer;  // Integer input chunk before conversion to float
+    std::vector<float> resampled_buffer;
+    std::vector<float> output_buffer;
+    std::vector<float> remixed_buffer;
+    std::vector<uint8_t> write_buffer;
+
+    // Pre-allocate buffers to avoid frequent reallocations
+    input_buffer.reserve(MAX_SAMPLES);
+    resampled_buffer.reserve(MAX_SAMPLES * RESAMPLE_RATIO);
+    output_buffer.reserve(MAX_SAMPLES * RESAMPLE_RATIO);
+    remixed_buffer.reserve(MAX_SAMPLES * MAX_CHANNELS);
+    write_buffer.reserve(MAX_CHUNK_SIZE * 4);  // 32-bit float to 8-bit may need 4x space
+
+    // Track statistics
+    size_t total_output_frames = 0;
+    int chunk_count = 0;        // Input chunk counter
+    int output_chunk_count = 0; // Output chunk counter
+    bool first_chunk = true;
+
+    // ===== Phase 3: Process chunks in a loop with aggregation =====
+    // When downsampling (e.g., DSD 2.8MHz -> 48kHz), output chunks are very small
+    // We need to aggregate multiple chunks before output to avoid:
+    // 1. Too many small writes (inefficient)
+    // 2. Pipe buffer filling up and blocking
+    // 3. xpuPlay not getting enough data per read
+
+    // Calculate minimum output chunk size (at least 1024 frames, ~21ms at 48kHz)
+    size_t min_output_frames = 1024;
+    size_t min_output_samples = min_output_frames * output_channels;
+
+    // Accumulation buffer for aggregated output
+    std::vector<float> accumulation_buffer;
+    accumulation_buffer.reserve(min_output_samples * 4);  // Pre-allocate for multiple chunks
+
+    // Accumulation samples counter
+    size_t accumulated_samples = 0;
+
+    // One dither sequence for the whole stream, continued across chunks
+    audio::DitherState dither_state;
+    audio::DitherState* chunk_dither = dither ? &dither_state : nullptr;
+
+    // Convert the accumulated samples to the output bit depth and write them
+    // as one chunk: [8-byte size header][PCM data]
+    auto writeAccumulated = [&]() -> ErrorCode {
+        if (output_bit_depth != 32) {
+            ErrorCode ret = convertBitDepth(accumulation_buffer, 32, output_bit_depth, write_buffer, chunk_dither);
+            if (ret != ErrorCode::Success) {
+                LOG_ERROR("Bit depth conversion failed at chunk {}", chunk_count);
+                return ret;
+            }
+        } else {
+            // Keep as 32-bit float
+            size_t byte_count = accumulation_buffer.size() * sizeof(float);
+            write_buffer.resize(byte_count);
+            std::memcpy(write_buffer.data(), accumulation_buffer.data(), byte_count);
+        }
+
+        uint64_t chunk_size = write_buffer.size();
+        std::cout.write(reinterpret_cast<const char*>(&chunk_size), sizeof(chunk_size));
+        std::cout.write(reinterpret_cast<const char*>(write_buffer.data()), write_buffer.size());
+        std::cout.flush();
+        #ifdef PLATFORM_WINDOWS
+        _flushall();  // Force flush all streams on Windows
+        #else
+        fflush(nullptr);  // Force flush all streams on Unix
+        #endif
+
+        if (!std::cout) {
+            LOG_ERROR("Failed to write to stdout at chunk {}", chunk_count);
+            return ErrorCode::FileWriteError;
+        }
+        return ErrorCode::Success;
+    };
+
+    while (true) {
+        // Read chunk size header (8 bytes) - directly into uint64_t to avoid memcpy
+        uint64_t chunk_input_size = 0;
+
+        if (!std::cin.read(reinterpret_cast<char*>(&chunk_input_size), sizeof(chunk_input_size))) {
+            // EOF or error - flush any remaining accumulated data
+            if (std::cin.eof()) {
+                LOG_INFO("End of input stream reached");
+                break;
+            } else {
+                LOG_ERROR("Failed to read chunk size header");
+                return ErrorCode::FileReadError;
+            }
+        }
+
+        if (chunk_input_size == 0) {
+            LOG_INFO("Received zero-size chunk, ending stream");
+            break;
+        }
+
+        // Track record of a multi-track stream: write out the previous track's
+        // samples, then forward the next track's metadata in the output format
+        if (chunk_input_size & protocol::TRACK_RECORD_FLAG) {
+            std::string record(chunk_input_size & ~protocol::TRACK_RECORD_FLAG, '\0');
+            if (!std::cin.read(&record[0], static_cast<std::streamsize>(record.size()))) {
+                LOG_ERROR("Failed to read track record ({} bytes)", record.size());
+                return ErrorCode::FileReadError;
+            }
+            if (accumulated_samples > 0) {
+                ErrorCode ret = writeAccumulated();
+                if (ret != ErrorCode::Success) {
+                    return ret;
+                }
+                output_chunk_count++;
+                accumulation_buffer.clear();
+                accumulated_samples = 0;
+            }
+            protocol::MetadataJSON track;
+            if (track.parse(record)) {
+                track.setStreamFormat(output_sample_rate, output_channels, output_bit_depth);
+                record = track.dump();
+            } else {
+                LOG_WARN("Track record is not valid JSON, forwarding it unchanged");
+            }
+            if (!protocol::writeTrackRecord(std::cout, record) || !std::cout.flush()) {
+                LOG_ERROR("Failed to write track record to stdout");
+                return ErrorCode::FileWriteError;
+            }
+            LOG_INFO("Track record forwarded: {} bytes", record.size());
+            continue;
+        }
+
+        size_t input_samples = chunk_input_size / input_bytes;
+        size_t input_frames = input_samples / input_channels;
+
+        // Log first few chunks
+        if (first_chunk || chunk_count <= 2) {
+            LOG_INFO("Received input chunk {}: {} bytes ({} samples, {} frames)",
+                     chunk_count + 1, chunk_input_size, input_samples, input_frames);
+        }
+
+        // Resize input buffer
+        input_buffer.resize(input_samples);
+
+        // Read float chunk data directly into input_buffer, integer data via raw_buffer
+        if (integer_input) {
+            raw_buffer.resize(chunk_input_size);
+            if (!std::cin.read(reinterpret_cast<char*>(raw_buffer.data()), chunk_input_size)) {
+                LOG_ERROR("Failed to read chunk {} data ({} bytes)", chunk_count + 1, chunk_input_size);
+                return ErrorCode::FileReadError;
+            }
+            audio::SampleConverter::toFloat(raw_buffer.data(), input_format, input_samples, input_buffer.data());
+        } else if (!std::cin.read(reinterpret_cast<char*>(input_buffer.data()), chunk_input_size)) {
+            LOG_ERROR("Failed to read chunk {} data ({} bytes)", chunk_count + 1, chunk_input_size);
+            return ErrorCode::FileReadError;
+        }
+
+        chunk_count++;
+        first_chunk = false;
+
+        // Resample if needed
+        if (needs_resampling) {
+            ErrorCode ret = resampler.process(input_buffer.data(), input_frames, resampled_buffer);
+            if (ret != ErrorCode::Success) {
+                LOG_ERROR("Resampling failed at chunk {}", chunk_count);
+                return ret;
+            }
+
+            if (verbose || chunk_count <= 2) {
+                size_t output_frames = resampled_buffer.size() / input_channels;
+                LOG_INFO("Processing chunk {}: {} frames -> {} frames",
+                         chunk_count, input_frames, output_frames);
+            }
+
+            // Swap instead of move to preserve buffer capacity for next iteration
+            output_buffer.swap(resampled_buffer);
+        } else {
+            // No resampling needed, swap to preserve buffer capacity
+            output_buffer.swap(input_buffer);
+        }
+
+        // Convert channels if needed
+        if (output_channels != input_channels) {
+            // Reuse pre-allocated remixed_buffer instead of allocating new vector
+            size_t frames = output_buffer.size() / input_channels;
+            size_t total_samples = frames * output_channels;
+
+            // Ensure remixed_buffer is large enough
+            if (total_samples > remixed_buffer.capacity()) {
+                remixed_buffer.reserve(total_samples);
+            }
+            remixed_buffer.resize(total_samples);
+
+            if (output_channels < input_channels) {
+                // Downmix: take first N channels
+                for (size_t i = 0; i < frames; ++i) {
+                    for (int ch = 0; ch < output_channels; ++ch) {
+                        remixed_buffer[i * output_channels + ch] = output_buffer[i * input_channels + ch];
+                    }
+                }
+            } else {
+                // Upmix: duplicate channels
+                for (size_t i = 0; i < frames; ++i) {
+                    for (int ch = 0; ch < output_channels; ++ch) {
+                        int src_ch = (ch < input_channels) ? ch : 0;
+                        remixed_buffer[i * output_channels + ch] = output_buffer[i * input_channels + src_ch];
+                    }
+                }
+            }
+
+            output_buffer = std::move(remixed_buffer);
+        }
+
+        // ===== AGGREGATION LOGIC =====
+        // Add current output to accumulation buffer
+        size_t current_output_samples = output_buffer.size();
+        accumulated_samples += current_output_samples;
+
+        // Resize accumulation buffer to fit new data
+        size_t old_size = accumulation_buffer.size();
+        accumulation_buffer.resize(old_size + current_output_samples);
+
+        // Copy current output to accumulation buffer
+        std::memcpy(accumulation_buffer.data() + old_size, output_buffer.data(),
+                    current_output_samples * sizeof(float));
+
+        // Track output frames for statistics
+        total_output_frames += current_output_samples / output_channels;
+
+        // Only output when we have enough accumulated data
+        if (accumulated_samples >= min_output_samples) {
+            ErrorCode ret = writeAccumulated();
+            if (ret != ErrorCode::Success) {
+                return ret;
+            }
+            const uint64_t chunk_size = write_buffer.size();
+
+            if (verbose || chunk_count <= 10) {
+                size_t output_frames = accumulation_buffer.size() / output_channels;
+                LOG_INFO("Output aggregated chunk: {} frames ({} samples, {} bytes)",
+                         output_frames, accumulation_buffer.size(), chunk_size);
+
+                // Debug: Log first few samples to check if they're silent
+                if (output_chunk_count <= 2) {
+                    float min_val = accumulation_buffer[0];
+                    float max_val = accumulation_buffer[0];
+                    double sum = 0.0;
+                    size_t check_count = (accumulation_buffer.size() < 100) ? accumulation_buffer.size() : 100;
+                    for (size_t i = 0; i < check_count; ++i) {
+                        if (accumulation_buffer[i] < min_val) min_val = accumulation_buffer[i];
+                        if (accumulation_buffer[i] > max_val) max_val = accumulation_buffer[i];
+                        sum += (accumulation_buffer[i] >= 0) ? accumulation_buffer[i] : -accumulation_buffer[i];
+                    }
+                    double avg = sum / check_count;
+                    LOG_INFO("  Sample stats (first {}): min={}, max={}, avg_abs={}", check_count, min_val, max_val, avg);
+                }
+            }
+
+            output_chunk_count++;
+
+            // Clear accumulation buffer
+            accumulation_buffer.clear();
+            accumulated_samples = 0;
+        }
+    }
+
+    // Flush any remaining accumulated data
+    if (accumulated_samples > 0) {
+        LOG_INFO("Flushing remaining accumulated data: {} samples", accumulated_samples);
+        ErrorCode ret = writeAccumulated();
+        if (ret != ErrorCode::Success) {
+            return ret;
+        }
+    }
+
+    // ===== Phase 4: Flush remaining data from resampler =====
+    if (needs_resampling) {
+        ErrorCode ret = resampler.flush(output_buffer);
+        if (ret != ErrorCode::Success) {
+            LOG_ERROR("Resampler flush failed");
+            return ret;
+        }
+
+        if (!output_buffer.empty()) {
+            size_t flush_frames = output_buffer.size() / input_channels;
+            LOG_INFO("Flushing resampler: {} frames remaining", flush_frames);
+
+            // Convert channels if needed
+            if (output_channels != input_channels) {
+                std::vector<float> remixed;
+                size_t frames = output_buffer.size() / input_channels;
+                remixed.resize(frames * output_channels);
+
+                if (output_channels < input_channels) {
+                    // Downmix
+                    for (size_t i = 0; i < frames; ++i) {
+                        for (int ch = 0; ch < output_channels; ++ch) {
+                            remixed[i * output_channels + ch] = output_buffer[i * input_channels + ch];
+                        }
+                    }
+                } else {
+                    // Upmix
+                    for (size_t i = 0; i < frames; ++i) {
+                        for (int ch = 0; ch < output_channels; ++ch) {
+                            int src_ch = (ch < input_channels) ? ch : 0;
+                            remixed[i * output_channels + ch] = output_buffer[i * input_channels + src_ch];
+                        }
+                    }
+                }
+
+                output_buffer = std::move(remixed);
+            }
+
+            total_output_frames += output_buffer.size() / output_channels;
+
+            // Convert bit depth
+            if (output_bit_depth != 32) {
+                convertBitDepth(output_buffer, 32, output_bit_depth, write_buffer, chunk_dither);
+            } else {
+                size_t byte_count = output_buffer.size() * sizeof(float);
+                write_buffer.resize(byte_count);
+                std::memcpy(write_buffer.data(), output_buffer.data(), byte_count);
+            }
+
+            // Write to stdout: [8-byte size header][PCM data]
+            uint64_t flush_size = write_buffer.size();
+            std::cout.write(reinterpret_cast<const char*>(&flush_size), sizeof(flush_size));
+            std::cout.write(reinterpret_cast<const char*>(write_buffer.data()), write_buffer.size());
+            std::cout.flush();
+            #ifdef PLATFORM_WINDOWS
+            _flushall();
+            #else
+            fflush(nullptr);
+            #endif
+
+        }
+    }
+
+    // ===== Phase 5: Log statistics =====
+    LOG_INFO("Streaming conversion complete:");
+    LOG_INFO("  Total output frames: {}", total_output_frames);
+    LOG_INFO("  Total input chunks processed: {}", chunk_count);
+
+    // Note: In streaming mode, we don't output metadata at the end
+    // because we've already sent the audio data chunk by chunk
+    // The initial JSON metadata was read but not re-emitted
+
+    return ErrorCode::Success;
+}
+
+} // namespace in2wav
+} // namespace xpu
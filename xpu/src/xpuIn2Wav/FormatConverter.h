@@ -0,0 +1,192 @@
+/**
+ * @file FormatConverter.h
+ * @brief Audio format conversion implementation
+ */
+
+#ifndef XPU_IN2WAV_FORMAT_CONVERTER_H
+#define XPU_IN2WAV_FORMAT_CONVERTER_H
+
+#include "protocol/ErrorCode.h"
+#include "audio/AudioFormat.h"
+#include "audio/SampleConverter.h"
+#include "audio/PolyphaseResampler.h"
+#include <string>
+#include <vector>
+#include <memory>
+#include <algorithm>
+
+namespace xpu {
+namespace in2wav {
+
+/**
+ * @brief Streaming resampler for real-time processing
+ *
+ * Rational ratios (44.1k <-> 48k, 2x, 4x, ...) with a "fast", "medium" or
+ * "best" quality run on the SIMD polyphase resampler from libxpu; other
+ * ratios and qualities ("linear", "zero") use libsamplerate.
+ */
+class StreamingResampler {
+public:
+    StreamingResampler();
+    ~StreamingResampler();
+
+    /**
+     * @brief Initialize the resampler
+     */
+    ErrorCode init(int input_rate, int output_rate, int channels, const char* quality = "medium");
+
+    /**
+     * @brief Process a chunk of audio data
+     * @param input Input audio frames (interleaved)
+     * @param input_frames Number of input frames
+     * @param output Output buffer (will be resized)
+     * @return Number of output frames generated
+     */
+    ErrorCode process(const float* input, int input_frames, std::vector<float>& output);
+
+    /**
+     * @brief Flush remaining data
+     */
+    ErrorCode flush(std::vector<float>& output);
+
+    /**
+     * @brief Resample polyphase ratios on up to threads threads
+     *
+     * Input is buffered until each thread has a full share of output, so a
+     * process() call may return no frames; the buffer only keeps the frames
+     * the remaining filter windows need. Output is identical to a single
+     * thread. Call before the first process().
+     */
+    void setThreads(int threads) { threads_ = std::max(1, threads); }
+
+    /**
+     * @brief Check if resampling is needed
+     */
+    bool isActive() const { return input_rate_ != output_rate_; }
+
+    /**
+     * @brief Get ratios
+     */
+    double getRatio() const { return ratio_; }
+
+    /**
+     * @brief Check whether the polyphase resampler is used instead of libsamplerate
+     */
+    bool usesPolyphase() const { return polyphase_ != nullptr; }
+
+private:
+    ErrorCode processPending(uint64_t last_output, std::vector<float>& output);
+
+    int input_rate_;
+    int output_rate_;
+    int channels_;
+    double ratio_;
+    void* src_state_;  // Opaque pointer to SRC_STATE from libsamplerate
+    std::unique_ptr<audio::PolyphaseResampler> polyphase_;
+    bool initialized_;
+
+    // Multi-threaded polyphase path: input window and stream positions
+    int threads_;
+    std::vector<float> pending_;
+    uint64_t pending_start_;
+    uint64_t input_frames_;
+    uint64_t output_frames_;
+};
+
+/**
+ * @brief Format converter class
+ */
+class FormatConverter {
+public:
+    /**
+     * @brief Convert audio to WAV format from file
+     * Decodes, converts and writes chunk by chunk, so memory use does not
+     * depend on the file length; outputs over 4 GB are written as RF64.
+     */
+    static ErrorCode convertToWAV(const std::string& input_file,
+                                   const std::string& output_file,
+                                   int sample_rate,
+                                   int bit_depth,
+                                   int channels,
+                                   const char* quality = "medium",
+                                   bool dither = false);
+
+    /**
+     * @brief Convert audio to WAV format from stdin
+     * Reads xpuLoad output format: [JSON metadata][8-byte size header][PCM data]...
+     * Chunks are written as they arrive (tracks of a multi-track stream are
+     * joined); outputs over 4 GB are written as RF64. DoP input
+     * ("encoding": "dop") is written as a 24-bit WAV at its own rate and
+     * channel count without dither, whatever the requested format.
+     */
+    static ErrorCode convertStdinToWAV(const std::string& output_file,
+                                      int sample_rate,
+                                      int bit_depth,
+                                      int channels,
+                                      const char* quality = "medium",
+                                      bool dither = false);
+
+    /**
+     * @brief Convert audio to WAV format from stdin and output to stdout
+     * Reads xpuLoad output format and outputs xpuPlay compatible format
+     * Output format: [JSON metadata][8-byte size header][PCM data]
+     */
+    static ErrorCode convertStdinToStdout(int sample_rate,
+                                         int bit_depth,
+                                         int channels,
+                                         const char* quality = "medium",
+                                         bool dither = false);
+
+    /**
+     * @brief Stream conversion: read from stdin, process in chunks, write to stdout
+     * This method processes audio data in chunks to reduce memory usage and latency
+     * Reads xpuLoad output format and outputs xpuPlay compatible format
+     * Output format: [JSON metadata][8-byte size header][PCM data]
+     *
+     * @param sample_rate Target sample rate (0 = keep original)
+     * @param bit_depth Target bit depth (16, 24, 32)
+     * @param channels Target channels (0 = keep original)
+     * @param quality Resampling quality ("best", "medium", "fast")
+     * @param chunk_size Number of frames to process per chunk (default: 4096)
+     * @param verbose Enable verbose logging
+     * @param dither TPDF dither when reducing to 16 or 24 bits
+     */
+    static ErrorCode convertStdinToStdoutStreaming(int sample_rate,
+                                                   int bit_depth,
+                                                   int channels,
+                                                   const char* quality = "medium",
+                                                   int chunk_size = 4096,
+                                                   bool verbose = false,
+                                                   bool dither = false);
+
+    /**
+     * @brief Apply resampling
+     * Polyphase ratios are split into output segments resampled on one
+     * thread per core (for inputs long enough to pay off); the result is
+     * bit-identical to serial processing. libsamplerate runs serially.
+     * @param channels Channels of the interleaved input
+     */
+    static ErrorCode resample(const std::vector<float>& input,
+                              int input_rate,
+                              int output_rate,
+                              int channels,
+                              std::vector<float>& output,
+                              const char* quality = "medium");
+
+    /**
+     * @brief Convert bit depth
+     * @param output_bits 16 or 24 (packed integer PCM) or 32 (float, copied)
+     * @param dither TPDF dither state for 16 / 24 bits, nullptr = none; pass
+     *               the same state for every chunk of a stream
+     */
+    static ErrorCode convertBitDepth(const std::vector<float>& input,
+                                      int input_bits,
+                                      int output_bits,
+                                      std::vector<uint8_t>& output,
+                                      audio::DitherState* dither = nullptr);
+};
+
+} // namespace in2wav
+} // namespace xpu
+
+#endif // XPU_IN2WAV_FORMAT_CONVERTER_H
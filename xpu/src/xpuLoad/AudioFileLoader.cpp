@@ -0,0 +1,1847 @@
+/**
+ * @file AudioFileLoader.cpp
+ * @brief Audio file loader implementation
+ */
+
+#include "AudioFileLoader.h"
+#include "utils/Logger.h"
+#include "utils/MappedFile.h"
+#include "utils/PlatformUtils.h"
+#include "utils/ReadAhead.h"
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <condition_variable>
+#include <cstring>
+#include <limits>
+#include <mutex>
+#include <new>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <codecvt>
+#include <locale>
+
+extern "C" {
+#include <libavformat/avformat.h>
+#include <libavcodec/avcodec.h>
+#include <libavutil/avutil.h>
+#include <libswresample/swresample.h>
+}
+
+using namespace xpu;
+
+namespace xpu {
+namespace load {
+
+/**
+ * @brief Frames added to the duration-based PCM estimate (priming, rounding)
+ */
+constexpr uint64_t PCM_ESTIMATE_SLACK_FRAMES = 8192;
+
+/**
+ * @brief Minimum growth step when the batch PCM buffer outgrows its estimate
+ */
+constexpr size_t PCM_MIN_GROWTH_BYTES = 1024 * 1024;
+
+/**
+ * @brief Shortest segment worth its own demuxer and decoder in parallel load()
+ */
+constexpr int SEGMENT_MIN_SECONDS = 10;
+
+/**
+ * @brief Source frames decoded and dropped before each segment (filter and resampler history)
+ */
+constexpr uint64_t SEGMENT_LEAD_IN_FRAMES = 8192;
+
+/**
+ * @brief Chunk size segments stream their output in
+ */
+constexpr size_t SEGMENT_CHUNK_BYTES = 256 * 1024;
+
+/**
+ * @brief Window kept prefetched ahead of the read position of a mapped input
+ */
+constexpr uint64_t MAPPED_READAHEAD_BYTES = 4 * 1024 * 1024;
+
+/**
+ * @brief Memory-mapped input file behind a custom AVIOContext
+ *
+ * The demuxer's buffer refills are copies out of a shared read-only mapping
+ * instead of read() calls, and concurrent decoders of one file (e.g. the
+ * load() segments) share its page cache. The pages ahead of the read
+ * position are prefetched with MADV_WILLNEED.
+ */
+class MappedInput {
+public:
+    MappedInput() = default;
+    ~MappedInput() {
+        if (avio_) {
+            av_freep(&avio_->buffer);
+            avio_context_free(&avio_);
+        }
+    }
+
+    MappedInput(const MappedInput&) = delete;
+    MappedInput& operator=(const MappedInput&) = delete;
+
+    ErrorCode open(const std::string& path, size_t buffer_size) {
+        ErrorCode result = file_.open(path);
+        if (result != ErrorCode::Success) {
+            return result;
+        }
+        file_.adviseSequential(0, file_.size());
+
+        unsigned char* buffer = static_cast<unsigned char*>(av_malloc(buffer_size));
+        if (!buffer) {
+            return ErrorCode::OutOfMemory;
+        }
+        avio_ = avio_alloc_context(buffer, static_cast<int>(buffer_size), 0, this,
+                                   &MappedInput::read, nullptr, &MappedInput::seek);
+        if (!avio_) {
+            av_free(buffer);
+            return ErrorCode::OutOfMemory;
+        }
+        return ErrorCode::Success;
+    }
+
+    AVIOContext* context() const { return avio_; }
+
+private:
+    static int read(void* opaque, uint8_t* buf, int buf_size) {
+        MappedInput* input = static_cast<MappedInput*>(opaque);
+        const uint64_t size = input->file_.size();
+        if (input->position_ >= size) {
+            return AVERROR_EOF;
+        }
+
+        // Keep at least half a window prefetched ahead of the reader
+        if (input->position_ + MAPPED_READAHEAD_BYTES / 2 > input->prefetched_) {
+            const uint64_t from = std::max(input->prefetched_, input->position_);
+            input->file_.prefetch(from, MAPPED_READAHEAD_BYTES);
+            input->prefetched_ = from + MAPPED_READAHEAD_BYTES;
+        }
+
+        const size_t bytes = static_cast<size_t>(std::min<uint64_t>(buf_size, size - input->position_));
+        std::memcpy(buf, input->file_.data() + input->position_, bytes);
+        input->position_ += bytes;
+        return static_cast<int>(bytes);
+    }
+
+    static int64_t seek(void* opaque, int64_t offset, int whence) {
+        MappedInput* input = static_cast<MappedInput*>(opaque);
+        const int64_t size = static_cast<int64_t>(input->file_.size());
+        if (whence & AVSEEK_SIZE) {
+            return size;
+        }
+
+        int64_t target;
+        switch (whence & ~AVSEEK_FORCE) {
+            case SEEK_SET: target = offset; break;
+            case SEEK_CUR: target = static_cast<int64_t>(input->position_) + offset; break;
+            case SEEK_END: target = size + offset; break;
+            default: return AVERROR(EINVAL);
+        }
+        if (target < 0) {
+            return AVERROR(EINVAL);
+        }
+        input->position_ = static_cast<uint64_t>(target);
+        input->prefetched_ = std::min(input->prefetched_, input->position_);
+        return target;
+    }
+
+    utils::MappedFile file_;
+    uint64_t position_ = 0;
+    uint64_t prefetched_ = 0;  // End of the range already prefetched
+    AVIOContext* avio_ = nullptr;
+};
+
+/**
+ * @brief Clean and validate UTF-8 string
+ * Removes invalid UTF-8 sequences and handles potential UTF-16 data
+ * Detects UTF-16 LE/BE with or without BOM
+ */
+static std::string cleanUTF8(const char* input) {
+    if (!input) return "";
+
+    std::string result;
+    const unsigned char* p = (const unsigned char*)input;
+    size_t len = strlen((const char*)p);
+
+    // Detect if this looks like UTF-16 LE (with or without BOM)
+    // UTF-16 LE has pattern: low byte, high byte, low byte, high byte...
+    // ASCII characters in UTF-16 LE appear as: ascii_byte, 0x00, ascii_byte, 0x00...
+    bool is_utf16_le = false;
+    bool has_bom_le = (len >= 2 && p[0] == 0xFF && p[1] == 0xFE);
+
+    // Check for UTF-16 LE pattern (alternating byte, null for ASCII)
+    if (!has_bom_le && len >= 4) {
+        int utf16_le_score = 0;
+        for (size_t i = 0; i < std::min(len, size_t(20)); i += 2) {
+            // Check for pattern: printable char followed by null
+            if (i + 1 < len && p[i] >= 32 && p[i] <= 126 && p[i + 1] == 0) {
+                utf16_le_score++;
+            }
+        }
+        // If most characters fit this pattern, it's likely UTF-16 LE
+        is_utf16_le = (utf16_le_score >= 2);
+    }
+
+    if (has_bom_le || is_utf16_le) {
+        // UTF-16 LE detected - convert ASCII characters only
+        size_t start = has_bom_le ? 2 : 0;
+        for (size_t i = start; i + 1 < len; i += 2) {
+            unsigned char low = p[i];
+            unsigned char high = p[i + 1];
+            // Extract ASCII characters from UTF-16 LE
+            if (high == 0 && low >= 32 && low <= 126) {
+                result += low;
+            } else if (high == 0 && low == 0) {
+                break;  // Null terminator
+            }
+            // Skip non-ASCII UTF-16 characters
+        }
+        return result;
+    }
+
+    // Check for UTF-16 BE BOM (FE FF)
+    bool has_bom_be = (len >= 2 && p[0] == 0xFE && p[1] == 0xFF);
+
+    // Detect if this looks like UTF-16 BE (with or without BOM)
+    // UTF-16 BE has pattern: high byte, low byte, high byte, low byte...
+    // ASCII characters in UTF-16 BE appear as: 0x00, ascii_byte, 0x00, ascii_byte...
+    bool is_utf16_be = false;
+    if (!has_bom_be && len >= 4) {
+        int utf16_be_score = 0;
+        for (size_t i = 0; i < std::min(len, size_t(20)); i += 2) {
+            // Check for pattern: null followed by printable char
+            if (i + 1 < len && p[i] == 0 && p[i + 1] >= 32 && p[i + 1] <= 126) {
+                utf16_be_score++;
+            }
+        }
+        // If most characters fit this pattern, it's likely UTF-16 BE
+        is_utf16_be = (utf16_be_score >= 2);
+    }
+
+    if (has_bom_be || is_utf16_be) {
+        // UTF-16 BE detected - convert ASCII characters only
+        size_t start = has_bom_be ? 2 : 0;
+        for (size_t i = start; i + 1 < len; i += 2) {
+            unsigned char high = p[i];
+            unsigned char low = p[i + 1];
+            // Extract ASCII characters from UTF-16 BE
+            if (high == 0 && low >= 32 && low <= 126) {
+                result += low;
+            } else if (high == 0 && low == 0) {
+                break;  // Null terminator
+            }
+            // Skip non-ASCII UTF-16 characters
+        }
+        return result;
+    }
+
+    // Process as UTF-8 or ASCII
+    while (*p) {
+        if (*p < 128) {
+            // ASCII character (0-127) - always safe
+            result += *p++;
+        } else if ((*p & 0xE0) == 0xC0) {
+            // 2-byte UTF-8 sequence
+            if (p[1] && (p[1] & 0xC0) == 0x80) {
+                result += *p++;
+                result += *p++;
+            } else {
+                // Invalid UTF-8, skip this byte
+                p++;
+            }
+        } else if ((*p & 0xF0) == 0xE0) {
+            // 3-byte UTF-8 sequence
+            if (p[1] && p[2] && (p[1] & 0xC0) == 0x80 && (p[2] & 0xC0) == 0x80) {
+                result += *p++;
+                result += *p++;
+                result += *p++;
+            } else {
+                // Invalid UTF-8, skip this byte
+                p++;
+            }
+        } else if ((*p & 0xF8) == 0xF0) {
+            // 4-byte UTF-8 sequence
+            if (p[1] && p[2] && p[3] && (p[1] & 0xC0) == 0x80 && (p[2] & 0xC0) == 0x80 && (p[3] & 0xC0) == 0x80) {
+                result += *p++;
+                result += *p++;
+                result += *p++;
+                result += *p++;
+            } else {
+                // Invalid UTF-8, skip this byte
+                p++;
+            }
+        } else {
+            // Invalid UTF-8 start byte, skip
+            p++;
+        }
+    }
+
+    return result;
+}
+
+/**
+ * @brief Implementation class
+ */
+class AudioFileLoader::Impl {
+public:
+    protocol::AudioMetadata metadata;
+    std::vector<uint8_t> pcm_data;
+    bool loaded = false;
+    int target_sample_rate = 48000;  // Default target sample rate
+    int dsd_decimation = 16;  // Default DSD decimation factor (16, 32, or 64)
+    int audio_stream_index = -1;     // Audio stream index in the file
+    double start_seconds = 0.0;      // Streaming range start (seek())
+    double range_seconds = 0.0;      // Streaming range length (0 = to the end)
+    int decoder_threads = 0;         // FFmpeg decoder threads (0 = auto)
+    int load_segments = 1;           // Parallel load() segments (0 = auto, 1 = serial)
+    bool native_sample_format = false;  // Integer sources keep their integer format
+    InputIO input_io = InputIO::Auto;
+    size_t avio_buffer_size = DEFAULT_AVIO_BUFFER_SIZE;
+    std::vector<audio::AudioFormat> mapped_formats = {
+        audio::AudioFormat::FLAC, audio::AudioFormat::WAV, audio::AudioFormat::ALAC,
+        audio::AudioFormat::DSD, audio::AudioFormat::DSDIFF, audio::AudioFormat::AIFF,
+        audio::AudioFormat::AIFC
+    };
+
+    // FFmpeg contexts
+    AVFormatContext* format_ctx = nullptr;
+    AVCodecContext* codec_ctx = nullptr;
+    SwrContext* swr_ctx = nullptr;
+    std::unique_ptr<MappedInput> mapped_input;  // Custom I/O of format_ctx (outlives it)
+    utils::ReadAheadConfig read_ahead_config;     // Disabled by default
+    std::unique_ptr<utils::ReadAhead> read_ahead;
+
+    /**
+     * @brief Report the demuxer's file position to the read-ahead
+     */
+    void trackReadPosition() {
+        if (read_ahead && format_ctx && format_ctx->pb) {
+            read_ahead->advance(static_cast<uint64_t>(std::max<int64_t>(avio_tell(format_ctx->pb), 0)));
+        }
+    }
+
+    /**
+     * @brief Open format_ctx on the file, memory-mapped if input_io selects it
+     *
+     * Falls back to the FFmpeg file protocol when the file cannot be mapped
+     * (e.g. pipes, URLs).
+     */
+    ErrorCode openInput(const std::string& filepath);
+
+    /**
+     * @brief Find, configure and open the decoder for the audio stream
+     *
+     * Frame and/or slice threading is enabled when the codec supports it;
+     * the log reports whether the codec actually decodes on several threads.
+     * A decoder still open from the previous file is flushed and reused if
+     * decoderMatches() the new stream, which saves the codec init and
+     * thread start-up.
+     */
+    ErrorCode openDecoder(const AVCodecParameters* codec_par);
+
+    /**
+     * @brief Whether the open decoder can decode a stream with these parameters
+     */
+    bool decoderMatches(const AVCodecParameters* codec_par) const;
+
+    /**
+     * @brief Close the previous file (if any) so the next one can be opened
+     *
+     * Resets metadata and range; the decoder stays open for openDecoder().
+     */
+    void closeInput();
+
+    /**
+     * @brief Decode the whole stream front to back into pcm_data (load())
+     */
+    ErrorCode decodeSerial(size_t& decoded_frames);
+
+    /**
+     * @brief Time segments of the whole stream, split on whole resampling periods
+     */
+    struct SegmentPlan {
+        int count = 0;
+        uint64_t source_frames = 0;   // Stream length from the header
+        uint64_t period = 1;          // Source frames per resampling period
+        uint64_t out_per_period = 1;  // Output frames per resampling period
+        uint64_t lead_in = 0;         // Source frames decoded and dropped before each segment
+        std::vector<uint64_t> source_start;
+        std::vector<uint64_t> output_start;
+    };
+
+    /**
+     * @brief Split the stream into up to max_segments segments of at least SEGMENT_MIN_SECONDS
+     * @return ErrorCode::NotSupported if the file cannot be split in two or more
+     */
+    ErrorCode planSegments(int max_segments, SegmentPlan& plan) const;
+
+    /**
+     * @brief Decode one planned segment with its own demuxer and decoder
+     * @param sink Receives the segment's output in order; returning false stops
+     * @param produced Output frames passed to sink
+     *
+     * A nested loader using seek() + streamRawPCM(). The segment starts
+     * lead_in frames early and drops that output, so decoder and resampler
+     * state at its start match a serial decode; every segment but the last
+     * ends at the next one's first output frame.
+     */
+    ErrorCode decodeSegment(const std::string& filepath, const SegmentPlan& plan, int index,
+                            const PCMStreamingCallback& sink, uint64_t& produced) const;
+
+    /**
+     * @brief Decode the whole stream as parallel time segments into pcm_data (load())
+     * @return ErrorCode::NotSupported if the file cannot be split; any error
+     *         but OutOfMemory means the caller should decode serially
+     *
+     * One segment per thread, each written straight to its place in pcm_data.
+     */
+    ErrorCode decodeSegments(const std::string& filepath, size_t& decoded_frames);
+
+    /**
+     * @brief Stream the whole stream as parallel time segments, in order (streamRawPCM())
+     * @return ErrorCode::NotSupported if the file cannot be split or its first
+     *         segment fails; nothing has reached callback then
+     *
+     * Segments of SEGMENT_MIN_SECONDS to twice that are decoded by a pool of
+     * load_segments threads (0 = one per core). A thread only starts a
+     * segment up to one pool size ahead of the one being streamed, so the
+     * memory held depends on the thread count, not the file length.
+     */
+    ErrorCode streamSegments(const std::string& filepath, const PCMStreamingCallback& callback,
+                             size_t chunk_size_bytes);
+
+    // Output format: source channel layout, packed output_format at output_rate
+    int output_rate = 0;
+    int output_channels = 0;
+    audio::SampleFormat output_format = audio::SampleFormat::Float32;
+    int output_bytes = 4;   // Bytes per output sample (3 for packed Int24)
+    int convert_bytes = 4;  // Bytes per sample as converted (Int24 goes through S32)
+    AVSampleFormat convert_format = AV_SAMPLE_FMT_FLT;
+    bool passthrough = false;  // Decoder already produces convert_format at output_rate
+
+    /**
+     * @brief Choose output_format for a stream converted to target_rate
+     *
+     * The source's integer format when native_sample_format is set, the
+     * source is integer PCM and the rate is kept; Float32 otherwise. Also
+     * sets the metadata bit depth and sample format.
+     */
+    void selectOutputFormat(const AVCodecParameters* codec_par, int target_rate);
+
+    /**
+     * @brief Set up conversion from the opened decoder to packed output_format
+     *
+     * The source channel layout is kept (no downmix). When the decoder
+     * already outputs the packed format (or its mono planar variant) at the
+     * target rate, swr is skipped and frames are copied straight to the output.
+     */
+    ErrorCode setupConverter(int target_rate);
+
+    /**
+     * @brief Upper bound of output frames for in_frames more input (0 = flush)
+     */
+    int maxOutputFrames(int in_frames) const;
+
+    /**
+     * @brief Expected output frames of the whole stream at output_rate (0 = unknown)
+     *
+     * From the stream duration, else the container duration, plus some slack
+     * for decoder and resampler rounding.
+     */
+    uint64_t estimateOutputFrames() const;
+
+    /**
+     * @brief Convert one decoded frame (nullptr = flush swr) into interleaved output_format
+     * @param out Destination, room for capacity frames of output_channels samples
+     *            of convert_bytes each (Int24 is packed to 3 bytes in place afterwards)
+     * @param skip Leading samples of the frame to leave out (range start)
+     * @return Frames written, or a negative AVERROR
+     */
+    int convertFrame(const AVFrame* frame, uint8_t* out, int capacity, int skip = 0);
+};
+
+void AudioFileLoader::Impl::selectOutputFormat(const AVCodecParameters* codec_par, int target_rate) {
+    output_format = audio::SampleFormat::Float32;
+
+    const AVSampleFormat source_format = static_cast<AVSampleFormat>(codec_par->format);
+    const AVSampleFormat packed = av_get_packed_sample_fmt(source_format);
+    const bool integer = packed == AV_SAMPLE_FMT_U8 || packed == AV_SAMPLE_FMT_S16 || packed == AV_SAMPLE_FMT_S32;
+    if (native_sample_format && integer && target_rate == codec_par->sample_rate) {
+        int bits = codec_par->bits_per_raw_sample;
+        if (bits <= 0) {
+            bits = av_get_bytes_per_sample(packed) * 8;
+        }
+        output_format = bits <= 16 ? audio::SampleFormat::Int16 :
+                        bits <= 24 ? audio::SampleFormat::Int24 : audio::SampleFormat::Int32;
+    } else if (native_sample_format) {
+        LOG_INFO("Native sample format not available ({} source{}), output is float",
+                 integer ? "integer" : "non-integer",
+                 target_rate != codec_par->sample_rate ? " resampled" : "");
+    }
+
+    output_bytes = audio::AudioFormatUtils::getBytesPerSample(output_format);
+    metadata.bit_depth = output_bytes * 8;
+    metadata.sample_format = audio::AudioFormatUtils::sampleFormatToString(output_format);
+    LOG_INFO("Output sample format: {}", metadata.sample_format);
+}
+
+void AudioFileLoader::Impl::closeInput() {
+    if (swr_ctx) {
+        swr_free(&swr_ctx);
+    }
+    if (format_ctx) {
+        avformat_close_input(&format_ctx);
+    }
+    mapped_input.reset();
+    read_ahead.reset();
+    metadata = protocol::AudioMetadata();
+    std::vector<uint8_t>().swap(pcm_data);
+    loaded = false;
+    audio_stream_index = -1;
+    start_seconds = 0.0;
+    range_seconds = 0.0;
+}
+
+ErrorCode AudioFileLoader::Impl::openInput(const std::string& filepath) {
+    closeInput();
+
+    const audio::AudioFormat format = audio::AudioFormatUtils::formatFromExtension(filepath);
+    const bool map = input_io == InputIO::Mapped ||
+        (input_io == InputIO::Auto &&
+         std::find(mapped_formats.begin(), mapped_formats.end(), format) != mapped_formats.end());
+
+    if (map) {
+        auto input = std::make_unique<MappedInput>();
+        if (input->open(filepath, avio_buffer_size) == ErrorCode::Success) {
+            format_ctx = avformat_alloc_context();
+            if (!format_ctx) {
+                LOG_ERROR("Failed to allocate format context");
+                return ErrorCode::OutOfMemory;
+            }
+            format_ctx->pb = input->context();
+            format_ctx->flags |= AVFMT_FLAG_CUSTOM_IO;
+            mapped_input = std::move(input);
+        } else if (input_io == InputIO::Mapped) {
+            LOG_WARN("Cannot map {}, reading through the file protocol", filepath);
+        }
+    }
+
+    // The path is passed with custom I/O too: probing also uses the extension
+    int ret = avformat_open_input(&format_ctx, filepath.c_str(), nullptr, nullptr);
+    if (ret != 0) {
+        LOG_ERROR("Failed to open file: {}", filepath);
+        return ErrorCode::FileReadError;
+    }
+    LOG_INFO("Input I/O: {}", mapped_input ? "memory-mapped" : "file protocol");
+
+    // Pipes and URLs fail to open here and are read without read-ahead
+    read_ahead.reset();
+    if (read_ahead_config.enabled()) {
+        auto ahead = std::make_unique<utils::ReadAhead>(read_ahead_config);
+        if (ahead->open(filepath) == ErrorCode::Success) {
+            read_ahead = std::move(ahead);
+            trackReadPosition();
+        }
+    }
+    return ErrorCode::Success;
+}
+
+bool AudioFileLoader::Impl::decoderMatches(const AVCodecParameters* codec_par) const {
+    if (codec_ctx->codec_id != codec_par->codec_id ||
+        codec_ctx->sample_rate != codec_par->sample_rate ||
+        av_channel_layout_compare(&codec_ctx->ch_layout, &codec_par->ch_layout) != 0 ||
+        codec_ctx->bits_per_coded_sample != codec_par->bits_per_coded_sample ||
+        codec_ctx->block_align != codec_par->block_align ||
+        codec_ctx->extradata_size != codec_par->extradata_size) {
+        return false;
+    }
+    const uint8_t* open = codec_ctx->extradata;
+    const uint8_t* next = codec_par->extradata;
+    if (codec_par->extradata_size == 0) {
+        return true;
+    }
+    if (codec_par->codec_id == AV_CODEC_ID_FLAC && codec_par->extradata_size >= 18) {
+        // STREAMINFO: the block sizes and rate / channels / bits matter; frame
+        // size bounds, sample count and MD5 differ per track
+        return std::memcmp(open, next, 4) == 0 && std::memcmp(open + 10, next + 10, 3) == 0 &&
+               (open[13] & 0xF0) == (next[13] & 0xF0);
+    }
+    return std::memcmp(open, next, static_cast<size_t>(codec_par->extradata_size)) == 0;
+}
+
+ErrorCode AudioFileLoader::Impl::openDecoder(const AVCodecParameters* codec_par) {
+    // With the packet time base the decoder applies the demuxer's skip-samples
+    // side data with correct timestamps: encoder delay and padding (LAME /
+    // iTunes gapless info, Opus pre-skip, MP4 edit lists) are trimmed, so
+    // consecutive tracks join without gaps
+    const AVRational time_base = format_ctx->streams[audio_stream_index]->time_base;
+    if (codec_ctx) {
+        if (decoderMatches(codec_par) && av_cmp_q(codec_ctx->pkt_timebase, time_base) == 0) {
+            avcodec_flush_buffers(codec_ctx);
+            LOG_INFO("Decoder {}: reusing the open decoder", codec_ctx->codec->name);
+            return ErrorCode::Success;
+        }
+        avcodec_free_context(&codec_ctx);
+    }
+
+    const AVCodec* codec = avcodec_find_decoder(codec_par->codec_id);
+    if (!codec) {
+        LOG_ERROR("Codec not found for codec_id: {}", codec_par->codec_id);
+        return ErrorCode::UnsupportedFormat;
+    }
+
+    codec_ctx = avcodec_alloc_context3(codec);
+    if (!codec_ctx) {
+        LOG_ERROR("Failed to allocate codec context");
+        return ErrorCode::OutOfMemory;
+    }
+
+    int ret = avcodec_parameters_to_context(codec_ctx, codec_par);
+    if (ret < 0) {
+        LOG_ERROR("Failed to copy codec parameters");
+        return ErrorCode::InvalidOperation;
+    }
+    codec_ctx->pkt_timebase = time_base;
+
+    // Only request the threading modes the codec implements; FFmpeg sizes
+    // the pool itself for thread_count 0
+    int thread_type = 0;
+    if (codec->capabilities & AV_CODEC_CAP_FRAME_THREADS) {
+        thread_type |= FF_THREAD_FRAME;
+    }
+    if (codec->capabilities & AV_CODEC_CAP_SLICE_THREADS) {
+        thread_type |= FF_THREAD_SLICE;
+    }
+    codec_ctx->thread_type = thread_type;
+    codec_ctx->thread_count = thread_type ? decoder_threads : 1;
+
+    ret = avcodec_open2(codec_ctx, codec, nullptr);
+    if (ret < 0) {
+        LOG_ERROR("Failed to open codec");
+        return ErrorCode::InvalidOperation;
+    }
+
+    if (codec_ctx->active_thread_type & FF_THREAD_FRAME) {
+        LOG_INFO("Decoder {}: {} threads (frame threading)", codec->name, codec_ctx->thread_count);
+    } else if (codec_ctx->active_thread_type & FF_THREAD_SLICE) {
+        LOG_INFO("Decoder {}: {} threads (slice threading)", codec->name, codec_ctx->thread_count);
+    } else {
+        LOG_INFO("Decoder {}: single-threaded{}", codec->name,
+                 thread_type ? "" : " (codec has no threading support)");
+    }
+    return ErrorCode::Success;
+}
+
+ErrorCode AudioFileLoader::Impl::setupConverter(int target_rate) {
+    output_rate = target_rate;
+    output_channels = codec_ctx->ch_layout.nb_channels;
+    if (output_channels <= 0) {
+        LOG_ERROR("Decoder reports no channels");
+        return ErrorCode::UnsupportedFormat;
+    }
+
+    convert_format = output_format == audio::SampleFormat::Int16 ? AV_SAMPLE_FMT_S16 :
+                     output_format == audio::SampleFormat::Float32 ? AV_SAMPLE_FMT_FLT : AV_SAMPLE_FMT_S32;
+    convert_bytes = av_get_bytes_per_sample(convert_format);
+    output_bytes = audio::AudioFormatUtils::getBytesPerSample(output_format);
+
+    const AVSampleFormat sample_fmt = codec_ctx->sample_fmt;
+    passthrough = target_rate == codec_ctx->sample_rate &&
+                  (sample_fmt == convert_format ||
+                   (sample_fmt == av_get_planar_sample_fmt(convert_format) && output_channels == 1));
+    if (passthrough) {
+        LOG_INFO("Decoder output is already packed {} at {} Hz, skipping resampler",
+                 av_get_sample_fmt_name(convert_format), target_rate);
+        return ErrorCode::Success;
+    }
+
+    // Same layout on both sides so swr never remixes; unspecified orders
+    // get FFmpeg's default layout for the channel count
+    AVChannelLayout layout;
+    if (codec_ctx->ch_layout.order == AV_CHANNEL_ORDER_UNSPEC) {
+        av_channel_layout_default(&layout, output_channels);
+    } else if (av_channel_layout_copy(&layout, &codec_ctx->ch_layout) < 0) {
+        return ErrorCode::OutOfMemory;
+    }
+
+    swr_alloc_set_opts2(&swr_ctx,
+                        &layout,
+                        convert_format,
+                        target_rate,
+                        &layout,
+                        sample_fmt,
+                        codec_ctx->sample_rate,
+                        0, nullptr);
+    av_channel_layout_uninit(&layout);
+
+    if (!swr_ctx || swr_init(swr_ctx) < 0) {
+        LOG_ERROR("Failed to initialize resampler");
+        return ErrorCode::InvalidOperation;
+    }
+    return ErrorCode::Success;
+}
+
+int AudioFileLoader::Impl::maxOutputFrames(int in_frames) const {
+    if (passthrough) {
+        return in_frames;
+    }
+    return std::max(0, swr_get_out_samples(swr_ctx, in_frames));
+}
+
+uint64_t AudioFileLoader::Impl::estimateOutputFrames() const {
+    const AVStream* stream = format_ctx->streams[audio_stream_index];
+    double seconds = 0.0;
+    if (stream->duration != AV_NOPTS_VALUE && stream->duration > 0) {
+        seconds = stream->duration * av_q2d(stream->time_base);
+    } else if (format_ctx->duration != AV_NOPTS_VALUE && format_ctx->duration > 0) {
+        seconds = static_cast<double>(format_ctx->duration) / AV_TIME_BASE;
+    }
+    if (seconds <= 0.0) {
+        return 0;
+    }
+    return static_cast<uint64_t>(std::ceil(seconds * output_rate)) + PCM_ESTIMATE_SLACK_FRAMES;
+}
+
+int AudioFileLoader::Impl::convertFrame(const AVFrame* frame, uint8_t* out, int capacity, int skip) {
+    int frames;
+    if (passthrough) {
+        if (!frame) {
+            return 0;
+        }
+        frames = std::min(frame->nb_samples - skip, capacity);
+        std::memcpy(out, frame->data[0] + static_cast<size_t>(skip) * output_channels * convert_bytes,
+                    static_cast<size_t>(frames) * output_channels * convert_bytes);
+    } else if (!frame) {
+        uint8_t* out_data[1] = { out };
+        frames = swr_convert(swr_ctx, out_data, capacity, nullptr, 0);
+    } else {
+        const uint8_t** in_data = const_cast<const uint8_t**>(frame->extended_data);
+        std::vector<const uint8_t*> trimmed;
+        if (skip > 0) {
+            // Advance every plane (or the single packed plane) past the skipped samples
+            const AVSampleFormat format = static_cast<AVSampleFormat>(frame->format);
+            const bool planar = av_sample_fmt_is_planar(format) != 0;
+            const size_t offset = static_cast<size_t>(skip) * av_get_bytes_per_sample(format) *
+                                  (planar ? 1 : output_channels);
+            for (int plane = 0; plane < (planar ? output_channels : 1); ++plane) {
+                trimmed.push_back(frame->extended_data[plane] + offset);
+            }
+            in_data = trimmed.data();
+        }
+        uint8_t* out_data[1] = { out };
+        frames = swr_convert(swr_ctx, out_data, capacity, in_data, frame->nb_samples - skip);
+    }
+
+    if (frames > 0 && output_format == audio::SampleFormat::Int24) {
+        // S32 holds 24-bit sources left-aligned: keep the top three bytes of
+        // each little-endian sample, compacting forward in place
+        const size_t samples = static_cast<size_t>(frames) * output_channels;
+        for (size_t i = 0; i < samples; ++i) {
+            out[i * 3] = out[i * 4 + 1];
+            out[i * 3 + 1] = out[i * 4 + 2];
+            out[i * 3 + 2] = out[i * 4 + 3];
+        }
+    }
+    return frames;
+}
+
+ErrorCode AudioFileLoader::Impl::decodeSerial(size_t& decoded_frames) {
+    // Frames are converted straight into the PCM buffer (interleaved output
+    // samples), sized once from the duration so the track is held in memory only once
+    const int channels = output_channels;
+    const size_t frame_bytes = static_cast<size_t>(channels) * output_bytes;
+    std::vector<uint8_t>().swap(pcm_data);
+    decoded_frames = 0;
+    const uint64_t estimated_frames = estimateOutputFrames();
+    if (estimated_frames > 0) {
+        const uint64_t estimated_bytes = estimated_frames * frame_bytes;
+        try {
+            pcm_data.reserve(static_cast<size_t>(estimated_bytes));
+        } catch (const std::bad_alloc&) {
+            LOG_ERROR("Cannot allocate {} bytes for {} decoded frames", estimated_bytes, estimated_frames);
+            return ErrorCode::OutOfMemory;
+        }
+        LOG_INFO("PCM buffer pre-sized for {} frames ({} bytes)", estimated_frames, estimated_bytes);
+    }
+
+    AVPacket* packet = av_packet_alloc();
+    AVFrame* frame = av_frame_alloc();
+
+    bool out_of_memory = false;
+    auto append = [&](const AVFrame* source) -> int {
+        int capacity = maxOutputFrames(source ? source->nb_samples : 0);
+        if (capacity <= 0 || out_of_memory) {
+            return 0;
+        }
+        // Room for the conversion width; Int24 is compacted afterwards
+        const size_t needed = decoded_frames * frame_bytes +
+                              static_cast<size_t>(capacity) * channels * convert_bytes;
+        try {
+            if (needed > pcm_data.capacity()) {
+                // Estimate short or unknown: grow in 1/8 steps rather than doubling
+                const size_t current = pcm_data.capacity();
+                pcm_data.reserve(std::max(needed, current + std::max(current / 8, PCM_MIN_GROWTH_BYTES)));
+            }
+            pcm_data.resize(needed);
+        } catch (const std::bad_alloc&) {
+            LOG_ERROR("Out of memory after {} decoded frames", decoded_frames);
+            out_of_memory = true;
+            return 0;
+        }
+        int converted = convertFrame(source, pcm_data.data() + decoded_frames * frame_bytes, capacity);
+        if (converted > 0) {
+            decoded_frames += converted;
+        }
+        return converted;
+    };
+
+    int packet_count = 0;
+    int frame_count = 0;
+
+    while (!out_of_memory && av_read_frame(format_ctx, packet) >= 0) {
+        packet_count++;
+        trackReadPosition();
+        if (packet->stream_index == audio_stream_index) {
+            int send_result = avcodec_send_packet(codec_ctx, packet);
+            if (send_result == 0) {
+                while (avcodec_receive_frame(codec_ctx, frame) == 0) {
+                    frame_count++;
+                    int converted = append(frame);
+                    if (converted < 0) {
+                        LOG_ERROR("swr_convert failed: {}", converted);
+                    }
+                }
+            } else {
+                LOG_ERROR("avcodec_send_packet failed: {}", send_result);
+            }
+        }
+        av_packet_unref(packet);
+    }
+
+    LOG_INFO("Read {} packets, decoded {} frames", packet_count, frame_count);
+
+    // Flush decoder
+    avcodec_send_packet(codec_ctx, nullptr);
+    while (avcodec_receive_frame(codec_ctx, frame) == 0) {
+        int converted = append(frame);
+        if (converted < 0) {
+            LOG_ERROR("swr_convert failed during flush: {}", converted);
+        }
+    }
+
+    // Flush any remaining samples in resampler
+    while (append(nullptr) > 0) {
+    }
+
+    if (out_of_memory) {
+        av_frame_free(&frame);
+        av_packet_free(&packet);
+        std::vector<uint8_t>().swap(pcm_data);
+        return ErrorCode::OutOfMemory;
+    }
+
+    // Trim the unused tail of the last conversion (capacity is kept: copying
+    // to shrink would briefly need the track twice)
+    pcm_data.resize(decoded_frames * frame_bytes);
+    LOG_INFO("Decoded samples: {} ({} bytes, {})", decoded_frames * channels, pcm_data.size(),
+             audio::AudioFormatUtils::sampleFormatToString(output_format));
+    if (estimated_frames > 0 && decoded_frames > estimated_frames) {
+        LOG_WARN("Duration estimate was short: {} frames expected, {} decoded", estimated_frames, decoded_frames);
+    }
+
+    av_frame_free(&frame);
+    av_packet_free(&packet);
+    return ErrorCode::Success;
+}
+
+ErrorCode AudioFileLoader::Impl::planSegments(int max_segments, SegmentPlan& plan) const {
+    const AVStream* stream = format_ctx->streams[audio_stream_index];
+    const int source_rate = codec_ctx->sample_rate;
+
+    // A segment can only start at a seek point that decodes on its own
+    // (FLAC, PCM, ALAC, DSD); predictive codecs such as MP3 need the packets
+    // before it, and the input must allow seeking
+    const AVCodecDescriptor* descriptor = avcodec_descriptor_get(stream->codecpar->codec_id);
+    if (!descriptor || !(descriptor->props & AV_CODEC_PROP_INTRA_ONLY) ||
+        !format_ctx->pb || !(format_ctx->pb->seekable & AVIO_SEEKABLE_NORMAL) || source_rate <= 0) {
+        return ErrorCode::NotSupported;
+    }
+
+    uint64_t source_frames = 0;
+    if (stream->duration != AV_NOPTS_VALUE && stream->duration > 0) {
+        source_frames = av_rescale_q(stream->duration, stream->time_base, AVRational{1, source_rate});
+    } else if (format_ctx->duration != AV_NOPTS_VALUE && format_ctx->duration > 0) {
+        source_frames = av_rescale(format_ctx->duration, source_rate, AV_TIME_BASE);
+    }
+
+    const uint64_t min_frames = static_cast<uint64_t>(SEGMENT_MIN_SECONDS) * source_rate;
+    const int segments = static_cast<int>(std::min<uint64_t>(max_segments, source_frames / min_frames));
+    if (segments < 2) {
+        return ErrorCode::NotSupported;
+    }
+
+    // Boundaries fall on whole resampling periods (period source frames give
+    // out_per_period output frames), so each segment's output starts at an
+    // exact output frame with the resampler in the same phase
+    const int divisor = std::gcd(source_rate, output_rate);
+    plan.count = segments;
+    plan.source_frames = source_frames;
+    plan.period = source_rate / divisor;
+    plan.out_per_period = output_rate / divisor;
+    plan.lead_in = (SEGMENT_LEAD_IN_FRAMES + plan.period - 1) / plan.period * plan.period;
+    plan.source_start.resize(segments);
+    plan.output_start.resize(segments);
+    for (int i = 0; i < segments; ++i) {
+        plan.source_start[i] = source_frames * i / segments / plan.period * plan.period;
+        plan.output_start[i] = plan.source_start[i] / plan.period * plan.out_per_period;
+    }
+    return ErrorCode::Success;
+}
+
+ErrorCode AudioFileLoader::Impl::decodeSegment(const std::string& filepath, const SegmentPlan& plan, int index,
+                                               const PCMStreamingCallback& sink, uint64_t& produced) const {
+    const int source_rate = codec_ctx->sample_rate;
+    const size_t frame_bytes = static_cast<size_t>(output_channels) * output_bytes;
+    const bool last = index == plan.count - 1;
+    const uint64_t start = plan.source_start[index];
+    const uint64_t begin = start > plan.lead_in ? start - plan.lead_in : 0;
+    uint64_t drop = (start - begin) / plan.period * plan.out_per_period;
+    const uint64_t limit = last ? std::numeric_limits<uint64_t>::max()
+                                : plan.output_start[index + 1] - plan.output_start[index];
+    produced = 0;
+
+    // Own demuxer and decoder; the segments already keep every core busy
+    AudioFileLoader segment;
+    segment.setTargetSampleRate(target_sample_rate);
+    segment.setDSDDecimation(dsd_decimation);
+    segment.setDecoderThreads(1);
+    segment.setNativeSampleFormat(native_sample_format);
+    segment.setInputIO(input_io, avio_buffer_size);
+    segment.setMappedFormats(mapped_formats);
+    if (read_ahead_config.enabled()) {
+        // One read in flight per segment; the segments run side by side
+        utils::ReadAheadConfig segment_read_ahead = read_ahead_config;
+        segment_read_ahead.threads = 1;
+        segment.setReadAhead(segment_read_ahead);
+    }
+
+    ErrorCode result = segment.prepareStreaming(filepath);
+    if (result == ErrorCode::Success && begin > 0) {
+        const double length = last ? 0.0 : static_cast<double>(plan.source_start[index + 1] - begin) / source_rate;
+        result = segment.seek(static_cast<double>(begin) / source_rate, length);
+    } else if (result == ErrorCode::Success && !last) {
+        result = segment.seek(0.0, static_cast<double>(plan.source_start[index + 1]) / source_rate);
+    }
+    if (result == ErrorCode::Success) {
+        result = segment.streamRawPCM([&](const uint8_t* data, size_t bytes) {
+            size_t frames = bytes / frame_bytes;
+            const size_t skipped = static_cast<size_t>(std::min<uint64_t>(drop, frames));
+            drop -= skipped;
+            data += skipped * frame_bytes;
+            frames = static_cast<size_t>(std::min<uint64_t>(frames - skipped, limit - produced));
+            if (frames == 0) {
+                return true;
+            }
+            if (!sink(data, frames * frame_bytes)) {
+                return false;
+            }
+            produced += frames;
+            return true;
+        }, SEGMENT_CHUNK_BYTES);
+    }
+    return result;
+}
+
+ErrorCode AudioFileLoader::Impl::decodeSegments(const std::string& filepath, size_t& decoded_frames) {
+    SegmentPlan plan;
+    ErrorCode planned = planSegments(load_segments > 0 ? load_segments : utils::PlatformUtils::getCPUCount(), plan);
+    if (planned != ErrorCode::Success) {
+        return planned;
+    }
+    const int segments = plan.count;
+
+    // Every segment but the last has an exact length and is written in place;
+    // the last one runs to the real end of the stream and is appended after
+    const size_t frame_bytes = static_cast<size_t>(output_channels) * output_bytes;
+    const uint64_t fixed_frames = plan.output_start[segments - 1];
+    std::vector<uint8_t>().swap(pcm_data);
+    try {
+        pcm_data.reserve(std::max(estimateOutputFrames(), fixed_frames) * frame_bytes);
+        pcm_data.resize(fixed_frames * frame_bytes);
+    } catch (const std::bad_alloc&) {
+        LOG_ERROR("Cannot allocate {} decoded frames", fixed_frames);
+        return ErrorCode::OutOfMemory;
+    }
+
+    LOG_INFO("Decoding {} segments of ~{:.1f} s in parallel ({} frames lead-in)", segments,
+             static_cast<double>(plan.source_frames) / segments / codec_ctx->sample_rate, plan.lead_in);
+
+    uint8_t* output = pcm_data.data();
+    std::vector<uint8_t> tail;
+    std::vector<ErrorCode> results(segments, ErrorCode::Success);
+    std::vector<uint64_t> produced(segments, 0);
+
+    auto decodeOne = [&](int index) {
+        const bool last = index == segments - 1;
+        ErrorCode result = decodeSegment(filepath, plan, index, [&](const uint8_t* data, size_t bytes) {
+            if (last) {
+                try {
+                    tail.insert(tail.end(), data, data + bytes);
+                } catch (const std::bad_alloc&) {
+                    results[index] = ErrorCode::OutOfMemory;
+                    return false;
+                }
+            } else {
+                std::memcpy(output + (plan.output_start[index] + produced[index]) * frame_bytes, data, bytes);
+            }
+            return true;
+        }, produced[index]);
+        if (results[index] == ErrorCode::Success) {
+            results[index] = result;
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int i = 1; i < segments; ++i) {
+        threads.emplace_back(decodeOne, i);
+    }
+    decodeOne(0);
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    // A short segment means the stream is shorter than its header says:
+    // the output would have a gap, so let the caller decode serially instead
+    for (int i = 0; i < segments; ++i) {
+        const bool short_segment = i < segments - 1 &&
+                                   produced[i] != plan.output_start[i + 1] - plan.output_start[i];
+        if (results[i] != ErrorCode::Success || short_segment) {
+            LOG_WARN("Segment {} failed ({} frames, error {}), decoding serially",
+                     i, produced[i], static_cast<int>(results[i]));
+            std::vector<uint8_t>().swap(pcm_data);
+            return results[i] == ErrorCode::OutOfMemory ? ErrorCode::OutOfMemory : ErrorCode::AudioDecodeError;
+        }
+    }
+
+    const size_t fixed_bytes = pcm_data.size();
+    try {
+        pcm_data.resize(fixed_bytes + tail.size());
+    } catch (const std::bad_alloc&) {
+        LOG_ERROR("Out of memory appending the last segment");
+        std::vector<uint8_t>().swap(pcm_data);
+        return ErrorCode::OutOfMemory;
+    }
+    std::memcpy(pcm_data.data() + fixed_bytes, tail.data(), tail.size());
+
+    decoded_frames = pcm_data.size() / frame_bytes;
+    LOG_INFO("Decoded samples: {} ({} bytes, {}) in {} segments",
+             decoded_frames * output_channels, pcm_data.size(),
+             audio::AudioFormatUtils::sampleFormatToString(output_format), segments);
+    return ErrorCode::Success;
+}
+
+ErrorCode AudioFileLoader::Impl::streamSegments(const std::string& filepath, const PCMStreamingCallback& callback,
+                                                size_t chunk_size_bytes) {
+    SegmentPlan plan;
+    if (planSegments(std::numeric_limits<int>::max(), plan) != ErrorCode::Success) {
+        return ErrorCode::NotSupported;
+    }
+    const int workers = std::min(plan.count, load_segments > 0 ? load_segments : utils::PlatformUtils::getCPUCount());
+    if (workers < 2) {
+        return ErrorCode::NotSupported;
+    }
+
+    LOG_INFO("Streaming {} segments of ~{:.1f} s on {} threads ({} frames lead-in)", plan.count,
+             static_cast<double>(plan.source_frames) / plan.count / codec_ctx->sample_rate, workers, plan.lead_in);
+
+    struct Segment {
+        std::vector<uint8_t> data;
+        uint64_t produced = 0;
+        ErrorCode result = ErrorCode::Success;
+        bool done = false;
+    };
+    std::vector<Segment> decoded(plan.count);
+    std::mutex mutex;
+    std::condition_variable changed;
+    int next = 0;      // Next segment to decode
+    int streamed = 0;  // Segments passed to callback
+    bool stop = false;
+
+    auto worker = [&]() {
+        for (;;) {
+            int index;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                changed.wait(lock, [&] { return stop || next >= plan.count || next < streamed + workers; });
+                if (stop || next >= plan.count) {
+                    return;
+                }
+                index = next++;
+            }
+            Segment& segment = decoded[index];
+            uint64_t produced = 0;
+            ErrorCode result = decodeSegment(filepath, plan, index, [&](const uint8_t* data, size_t bytes) {
+                try {
+                    segment.data.insert(segment.data.end(), data, data + bytes);
+                } catch (const std::bad_alloc&) {
+                    segment.result = ErrorCode::OutOfMemory;
+                    return false;
+                }
+                return true;
+            }, produced);
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                segment.produced = produced;
+                if (segment.result == ErrorCode::Success) {
+                    segment.result = result;
+                }
+                segment.done = true;
+            }
+            changed.notify_all();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < workers; ++i) {
+        threads.emplace_back(worker);
+    }
+
+    // Pass the segments on in order, in whole-frame chunks
+    const size_t frame_bytes = static_cast<size_t>(output_channels) * output_bytes;
+    const size_t chunk_bytes = std::max<size_t>(1, chunk_size_bytes / frame_bytes) * frame_bytes;
+    ErrorCode ret = ErrorCode::Success;
+    bool keep_going = true;
+    for (int i = 0; i < plan.count && keep_going; ++i) {
+        Segment& segment = decoded[i];
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            changed.wait(lock, [&] { return segment.done; });
+        }
+
+        // A short segment means the stream is shorter than its header says
+        const bool short_segment = i < plan.count - 1 &&
+                                   segment.produced != plan.output_start[i + 1] - plan.output_start[i];
+        if (segment.result != ErrorCode::Success || short_segment) {
+            if (i == 0 && segment.result != ErrorCode::OutOfMemory) {
+                LOG_WARN("Segment 0 failed ({} frames, error {}), decoding serially",
+                         segment.produced, static_cast<int>(segment.result));
+                ret = ErrorCode::NotSupported;
+            } else {
+                LOG_ERROR("Segment {} failed ({} frames, error {})", i, segment.produced,
+                          static_cast<int>(segment.result));
+                ret = segment.result == ErrorCode::OutOfMemory ? ErrorCode::OutOfMemory : ErrorCode::AudioDecodeError;
+            }
+            break;
+        }
+
+        for (size_t offset = 0; offset < segment.data.size() && keep_going; offset += chunk_bytes) {
+            if (!callback(segment.data.data() + offset, std::min(chunk_bytes, segment.data.size() - offset))) {
+                LOG_INFO("Streaming stopped by callback");
+                keep_going = false;
+            }
+        }
+        std::vector<uint8_t>().swap(segment.data);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            ++streamed;
+        }
+        changed.notify_all();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stop = true;
+    }
+    changed.notify_all();
+    for (auto& t : threads) {
+        t.join();
+    }
+    if (ret == ErrorCode::Success) {
+        LOG_INFO("Streaming complete: {} segments", plan.count);
+    }
+    return ret;
+}
+
+AudioFileLoader::AudioFileLoader()
+    : impl_(std::make_unique<Impl>()) {}
+
+AudioFileLoader::~AudioFileLoader() {
+    // Cleanup FFmpeg resources
+    if (impl_->swr_ctx) {
+        swr_free(&impl_->swr_ctx);
+    }
+    if (impl_->codec_ctx) {
+        avcodec_free_context(&impl_->codec_ctx);
+    }
+    if (impl_->format_ctx) {
+        avformat_close_input(&impl_->format_ctx);
+    }
+}
+
+void AudioFileLoader::setTargetSampleRate(int sample_rate) {
+    impl_->target_sample_rate = sample_rate;
+    LOG_INFO("Target sample rate set to: {}", sample_rate);
+}
+
+void AudioFileLoader::setDecoderThreads(int threads) {
+    impl_->decoder_threads = threads > 0 ? threads : 0;
+    if (threads > 0) {
+        LOG_INFO("Decoder threads set to: {}", threads);
+    } else {
+        LOG_INFO("Decoder threads set to: auto");
+    }
+}
+
+void AudioFileLoader::setLoadSegments(int segments) {
+    impl_->load_segments = std::max(0, segments);
+    if (segments == 0) {
+        LOG_INFO("Parallel load segments: auto");
+    } else {
+        LOG_INFO("Parallel load segments: {}", impl_->load_segments);
+    }
+}
+
+void AudioFileLoader::setNativeSampleFormat(bool enabled) {
+    impl_->native_sample_format = enabled;
+}
+
+void AudioFileLoader::setInputIO(InputIO mode, size_t buffer_size) {
+    impl_->input_io = mode;
+    impl_->avio_buffer_size = std::max<size_t>(buffer_size, 4096);
+}
+
+void AudioFileLoader::setMappedFormats(const std::vector<audio::AudioFormat>& formats) {
+    impl_->mapped_formats = formats;
+}
+
+void AudioFileLoader::setReadAhead(const utils::ReadAheadConfig& config) {
+    impl_->read_ahead_config = config;
+}
+
+void AudioFileLoader::setDSDDecimation(int factor) {
+    if (factor != 16 && factor != 32 && factor != 64) {
+        LOG_ERROR("Invalid DSD decimation factor: {}, must be 16, 32, or 64", factor);
+        return;
+    }
+    impl_->dsd_decimation = factor;
+    LOG_INFO("DSD decimation factor set to: {}", factor);
+}
+
+ErrorCode AudioFileLoader::seek(double start_seconds, double duration_seconds) {
+    if (!impl_->format_ctx || impl_->audio_stream_index == -1) {
+        LOG_ERROR("seek() called without prepareStreaming()");
+        return ErrorCode::InvalidOperation;
+    }
+
+    // Duration is 0 when the container does not report one; the range is then open-ended
+    const double length = impl_->metadata.duration;
+    if (!(start_seconds >= 0.0) || !(duration_seconds >= 0.0) ||
+        (start_seconds > 0.0 && length > 0.0 && start_seconds >= length)) {
+        LOG_ERROR("Invalid range: start {:.3f} s, duration {:.3f} s (file is {:.3f} s)",
+                  start_seconds, duration_seconds, length);
+        return ErrorCode::InvalidArgument;
+    }
+
+    impl_->start_seconds = start_seconds;
+    impl_->range_seconds = duration_seconds;
+
+    if (length > 0.0) {
+        const double remaining = length - start_seconds;
+        impl_->metadata.duration = duration_seconds > 0.0 ? std::min(duration_seconds, remaining) : remaining;
+        impl_->metadata.sample_count = static_cast<uint64_t>(
+            impl_->metadata.duration * impl_->metadata.sample_rate);
+    }
+    LOG_INFO("Streaming range: start {:.3f} s, duration {:.3f} s", start_seconds, impl_->metadata.duration);
+    return ErrorCode::Success;
+}
+
+ErrorCode AudioFileLoader::load(const std::string& filepath) {
+    LOG_INFO("Loading audio file: {}", filepath);
+
+    // Open input file
+    ErrorCode opened = impl_->openInput(filepath);
+    if (opened != ErrorCode::Success) {
+        return opened;
+    }
+
+    // Retrieve stream information
+    int ret = avformat_find_stream_info(impl_->format_ctx, nullptr);
+    if (ret < 0) {
+        LOG_ERROR("Failed to find stream info");
+        return ErrorCode::CorruptedFile;
+    }
+
+    // Find audio stream
+    impl_->audio_stream_index = -1;
+    for (unsigned int i = 0; i < impl_->format_ctx->nb_streams; ++i) {
+        if (impl_->format_ctx->streams[i]->codecpar->codec_type == AVMEDIA_TYPE_AUDIO) {
+            impl_->audio_stream_index = i;
+            break;
+        }
+    }
+
+    if (impl_->audio_stream_index == -1) {
+        LOG_ERROR("No audio stream found");
+        return ErrorCode::InvalidOperation;
+    }
+
+    // Get codec parameters
+    AVCodecParameters* codec_par = impl_->format_ctx->streams[impl_->audio_stream_index]->codecpar;
+
+    // Update metadata - preserve original file properties
+    impl_->metadata.sample_rate = codec_par->sample_rate;
+    impl_->metadata.channels = codec_par->ch_layout.nb_channels;
+
+    // Get original bit depth from codec parameters
+    // codec_par->format is the internal sample format, not the original bit depth
+    // We need to check codec_par->bits_per_raw_sample or codec_par->bits_per_coded_sample
+    int source_bit_depth = codec_par->bits_per_raw_sample;
+    if (source_bit_depth == 0) {
+        source_bit_depth = codec_par->bits_per_coded_sample;
+    }
+    if (source_bit_depth == 0) {
+        // Fallback: estimate from sample format
+        source_bit_depth = codec_par->format == AV_SAMPLE_FMT_FLTP ? 32 :
+                            codec_par->format == AV_SAMPLE_FMT_S16 || codec_par->format == AV_SAMPLE_FMT_S16P ? 16 :
+                            codec_par->format == AV_SAMPLE_FMT_S32 || codec_par->format == AV_SAMPLE_FMT_S32P ? 32 : 24;
+    }
+    impl_->metadata.bit_depth = source_bit_depth;
+
+    // Calculate duration
+    if (impl_->format_ctx->duration != AV_NOPTS_VALUE) {
+        impl_->metadata.duration = static_cast<double>(impl_->format_ctx->duration) / AV_TIME_BASE;
+        impl_->metadata.sample_count = static_cast<uint64_t>(
+            impl_->metadata.duration * impl_->metadata.sample_rate);
+    }
+
+    // Extract metadata tags (title, artist, album, etc.)
+    AVDictionaryEntry* tag = nullptr;
+    while ((tag = av_dict_get(impl_->format_ctx->metadata, "", tag, AV_DICT_IGNORE_SUFFIX))) {
+        std::string key = tag->key;
+        std::string value = tag->value ? tag->value : "";
+
+        if (key == "title") impl_->metadata.title = value;
+        else if (key == "artist") impl_->metadata.artist = value;
+        else if (key == "album") impl_->metadata.album = value;
+        else if (key == "track") impl_->metadata.track_number = std::stoi(value);
+        else if (key == "genre") impl_->metadata.genre = value;
+        else if (key == "date") impl_->metadata.year = std::stoi(value);
+    }
+
+    // Detect audio format
+    audio::AudioFormat format_enum = audio::AudioFormatUtils::formatFromExtension(filepath);
+    impl_->metadata.format = audio::AudioFormatUtils::formatToString(format_enum);
+    impl_->metadata.format_name = impl_->metadata.format;
+
+    // Initialize decoder
+    opened = impl_->openDecoder(codec_par);
+    if (opened != ErrorCode::Success) {
+        return opened;
+    }
+
+    // Setup resampler to convert to standard format
+    // Target: target_sample_rate Hz, stereo, 32-bit float planar
+    // For DSD: if target_sample_rate is 0, use DSD rate / dsd_decimation
+    // For non-DSD: if target_sample_rate is 0, keep the original sample rate
+    int actual_target_rate;
+
+    if (format_enum == audio::AudioFormat::DSD && impl_->target_sample_rate == 0) {
+        // DSD with no target specified: use DSD rate / dsd_decimation
+        actual_target_rate = impl_->codec_ctx->sample_rate / impl_->dsd_decimation;
+    } else if (impl_->target_sample_rate > 0) {
+        actual_target_rate = impl_->target_sample_rate;
+    } else {
+        actual_target_rate = impl_->codec_ctx->sample_rate;
+    }
+
+    LOG_INFO("Setting up resampler: requested_rate={}, actual_rate={}, original_rate={}",
+             impl_->target_sample_rate, actual_target_rate, impl_->codec_ctx->sample_rate);
+
+    // Keep the source bit depth for the metadata; selectOutputFormat() sets the output one
+    const int source_bits = impl_->metadata.bit_depth;
+    impl_->selectOutputFormat(codec_par, actual_target_rate);
+    const int output_bits = impl_->metadata.bit_depth;
+    impl_->metadata.bit_depth = source_bits;
+
+    ErrorCode result = impl_->setupConverter(actual_target_rate);
+    if (result != ErrorCode::Success) {
+        return result;
+    }
+    const int channels = impl_->output_channels;
+
+    // Decode audio data: in parallel segments when enabled and the file
+    // allows it, otherwise front to back
+    size_t decoded_frames = 0;
+    ErrorCode decoded = ErrorCode::NotSupported;
+    if (impl_->load_segments != 1) {
+        decoded = impl_->decodeSegments(filepath, decoded_frames);
+    }
+    if (decoded != ErrorCode::Success && decoded != ErrorCode::OutOfMemory) {
+        decoded = impl_->decodeSerial(decoded_frames);
+    }
+    if (decoded != ErrorCode::Success) {
+        return decoded;
+    }
+
+    // Store original properties before overwriting (for high-res detection)
+    int original_sample_rate = impl_->metadata.sample_rate;
+    int original_bit_depth = impl_->metadata.bit_depth;
+
+    // Update metadata with actual output format (for PCM data)
+    impl_->metadata.sample_rate = actual_target_rate;  // Output format (or original if target was 0)
+    impl_->metadata.channels = channels;  // Source layout is kept
+    impl_->metadata.bit_depth = output_bits;  // 32-bit float, or the native integer width
+    impl_->metadata.sample_count = decoded_frames;
+
+    // Store original properties for reference
+    impl_->metadata.original_sample_rate = original_sample_rate;
+    impl_->metadata.original_bit_depth = original_bit_depth;
+    impl_->metadata.is_high_res = (original_sample_rate >= 96000);
+
+    impl_->loaded = true;
+    LOG_INFO("Audio file loaded successfully");
+    LOG_INFO("  Format: {} Hz, {} channels, {}-bit",
+             impl_->metadata.sample_rate,
+             impl_->metadata.channels,
+             impl_->metadata.bit_depth);
+    LOG_INFO("  Duration: {:.2f} seconds", impl_->metadata.duration);
+
+    return ErrorCode::Success;
+}
+
+ErrorCode AudioFileLoader::prepareStreaming(const std::string& filepath) {
+    LOG_INFO("Preparing streaming for audio file: {}", filepath);
+
+    // Open input file
+    ErrorCode opened = impl_->openInput(filepath);
+    if (opened != ErrorCode::Success) {
+        return opened;
+    }
+
+    // Retrieve stream information (this is fast - doesn't decode entire file)
+    int ret = avformat_find_stream_info(impl_->format_ctx, nullptr);
+    if (ret < 0) {
+        LOG_ERROR("Failed to find stream info");
+        return ErrorCode::CorruptedFile;
+    }
+
+    // Find audio stream
+    impl_->audio_stream_index = -1;
+    for (unsigned int i = 0; i < impl_->format_ctx->nb_streams; ++i) {
+        if (impl_->format_ctx->streams[i]->codecpar->codec_type == AVMEDIA_TYPE_AUDIO) {
+            impl_->audio_stream_index = i;
+            break;
+        }
+    }
+
+    if (impl_->audio_stream_index == -1) {
+        LOG_ERROR("No audio stream found");
+        return ErrorCode::InvalidOperation;
+    }
+
+    // Get codec parameters
+    AVCodecParameters* codec_par = impl_->format_ctx->streams[impl_->audio_stream_index]->codecpar;
+
+    // Update metadata - preserve original file properties
+    impl_->metadata.file_path = filepath;
+    int original_sample_rate = codec_par->sample_rate;
+    impl_->metadata.original_sample_rate = original_sample_rate;
+    impl_->metadata.channels = codec_par->ch_layout.nb_channels;
+
+    // Get original bit depth
+    int source_bit_depth = codec_par->bits_per_raw_sample;
+    if (source_bit_depth == 0) {
+        source_bit_depth = codec_par->bits_per_coded_sample;
+    }
+
+    // Detect audio format
+    audio::AudioFormat format_enum = audio::AudioFormatUtils::formatFromExtension(filepath);
+
+    // For DSD format, the original bit depth is always 1-bit
+    // codec_par->bits_per_coded_sample might be 8 (byte storage), but actual DSD is 1-bit
+    if (format_enum == audio::AudioFormat::DSD) {
+        source_bit_depth = 1;  // DSD is always 1-bit
+    } else if (source_bit_depth == 0) {
+        source_bit_depth = codec_par->format == AV_SAMPLE_FMT_FLTP ? 32 :
+                            codec_par->format == AV_SAMPLE_FMT_S16 || codec_par->format == AV_SAMPLE_FMT_S16P ? 16 :
+                            codec_par->format == AV_SAMPLE_FMT_S32 || codec_par->format == AV_SAMPLE_FMT_S32P ? 32 : 24;
+    }
+
+    impl_->metadata.original_bit_depth = source_bit_depth;
+
+    // Calculate output sample rate and bit depth
+    // For DSD: PCM rate = DSD rate / dsd_decimation, output is 32-bit float
+    // For non-DSD: use target_sample_rate if specified, otherwise keep original
+    int output_sample_rate;
+    if (format_enum == audio::AudioFormat::DSD) {
+        // DSD: PCM sample rate = DSD rate / dsd_decimation (e.g., DSD64: 2822400/16 = 176400 Hz)
+        if (impl_->target_sample_rate > 0) {
+            output_sample_rate = impl_->target_sample_rate;
+        } else {
+            output_sample_rate = original_sample_rate / impl_->dsd_decimation;  // Default: DSD/16
+        }
+    } else {
+        // Non-DSD: use target sample rate or keep original
+        if (impl_->target_sample_rate > 0) {
+            output_sample_rate = impl_->target_sample_rate;
+        } else {
+            output_sample_rate = original_sample_rate;
+        }
+    }
+
+    // Output is 32-bit float unless native integer output applies
+    impl_->selectOutputFormat(codec_par, output_sample_rate);
+    impl_->metadata.sample_rate = output_sample_rate;
+
+    // Calculate duration
+    if (impl_->format_ctx->duration != AV_NOPTS_VALUE) {
+        impl_->metadata.duration = static_cast<double>(impl_->format_ctx->duration) / AV_TIME_BASE;
+        impl_->metadata.sample_count = static_cast<uint64_t>(
+            impl_->metadata.duration * impl_->metadata.sample_rate);
+    }
+
+    // Extract metadata tags
+    AVDictionaryEntry* tag = nullptr;
+    while ((tag = av_dict_get(impl_->format_ctx->metadata, "", tag, AV_DICT_IGNORE_SUFFIX))) {
+        std::string key = tag->key;
+        const char* value_ptr = tag->value;
+
+        if (!value_ptr) continue;
+
+        // Clean UTF-8 encoding to avoid display issues
+        std::string value = cleanUTF8(value_ptr);
+
+        if (key == "title") impl_->metadata.title = value;
+        else if (key == "artist") impl_->metadata.artist = value;
+        else if (key == "album") impl_->metadata.album = value;
+        else if (key == "track") {
+            try {
+                impl_->metadata.track_number = std::stoi(value);
+            } catch (...) {
+                // Ignore conversion errors
+            }
+        }
+        else if (key == "genre") impl_->metadata.genre = value;
+        else if (key == "date") {
+            try {
+                impl_->metadata.year = std::stoi(value);
+            } catch (...) {
+                impl_->metadata.year = value;  // Keep as string if conversion fails
+            }
+        }
+    }
+
+    // Set format information
+    impl_->metadata.format = audio::AudioFormatUtils::formatToString(format_enum);
+    impl_->metadata.format_name = impl_->metadata.format;
+
+    // Mark as lossless based on format
+    impl_->metadata.is_lossless = (format_enum == audio::AudioFormat::FLAC ||
+                                    format_enum == audio::AudioFormat::WAV ||
+                                    format_enum == audio::AudioFormat::ALAC ||
+                                    format_enum == audio::AudioFormat::DSD);
+
+    // Mark high-resolution audio
+    if (impl_->metadata.sample_rate >= 96000) {
+        impl_->metadata.is_high_res = true;
+    }
+
+    LOG_INFO("Streaming prepared successfully");
+    LOG_INFO("  Format: {} Hz, {} channels, {}-bit",
+             impl_->metadata.sample_rate,
+             impl_->metadata.channels,
+             impl_->metadata.bit_depth);
+    LOG_INFO("  Duration: {:.2f} seconds", impl_->metadata.duration);
+
+    return ErrorCode::Success;
+}
+
+ErrorCode AudioFileLoader::streamPCM(StreamingCallback callback, size_t chunk_size_bytes) {
+    if (impl_->output_format != audio::SampleFormat::Float32) {
+        LOG_ERROR("streamPCM() delivers float samples but the output is {}, use streamRawPCM()",
+                  impl_->metadata.sample_format);
+        return ErrorCode::InvalidOperation;
+    }
+    return streamRawPCM([&callback](const uint8_t* chunk_data, size_t chunk_bytes) {
+        return callback(reinterpret_cast<const float*>(chunk_data), chunk_bytes / sizeof(float));
+    }, chunk_size_bytes);
+}
+
+ErrorCode AudioFileLoader::streamRawPCM(PCMStreamingCallback callback, size_t chunk_size_bytes) {
+    // Check if prepareStreaming() was called
+    if (!impl_->format_ctx || impl_->audio_stream_index == -1) {
+        LOG_ERROR("streamPCM() called without prepareStreaming()");
+        return ErrorCode::InvalidOperation;
+    }
+
+    LOG_INFO("Streaming PCM data in chunks: {} bytes", chunk_size_bytes);
+
+    // Get codec parameters
+    AVCodecParameters* codec_par = impl_->format_ctx->streams[impl_->audio_stream_index]->codecpar;
+
+    // Initialize decoder
+    ErrorCode opened = impl_->openDecoder(codec_par);
+    if (opened != ErrorCode::Success) {
+        return opened;
+    }
+
+    // Setup resampler
+    // For DSD: if target_sample_rate is 0, use DSD rate / dsd_decimation
+    // For non-DSD: if target_sample_rate is 0, use original rate
+    int actual_target_rate;
+    audio::AudioFormat format_enum = audio::AudioFormatUtils::formatFromExtension(impl_->metadata.file_path);
+
+    if (format_enum == audio::AudioFormat::DSD && impl_->target_sample_rate == 0) {
+        // DSD with no target specified: use DSD rate / dsd_decimation
+        actual_target_rate = impl_->codec_ctx->sample_rate / impl_->dsd_decimation;
+    } else if (impl_->target_sample_rate > 0) {
+        actual_target_rate = impl_->target_sample_rate;
+    } else {
+        actual_target_rate = impl_->codec_ctx->sample_rate;
+    }
+
+    LOG_INFO("Setting up resampler: requested_rate={}, actual_rate={}, original_rate={}",
+             impl_->target_sample_rate, actual_target_rate, impl_->codec_ctx->sample_rate);
+
+    ErrorCode result = impl_->setupConverter(actual_target_rate);
+    if (result != ErrorCode::Success) {
+        return result;
+    }
+    const int channels = impl_->output_channels;
+    const size_t frame_bytes = static_cast<size_t>(channels) * impl_->output_bytes;
+    const size_t convert_frame_bytes = static_cast<size_t>(channels) * impl_->convert_bytes;
+
+    // Verify that actual_target_rate matches the expected output sample rate
+    // (they should match since prepareStreaming already calculated this)
+    if (actual_target_rate != impl_->metadata.sample_rate) {
+        LOG_WARN("Sample rate mismatch: prepareStreaming set {}, but streamPCM calculated {}",
+                 impl_->metadata.sample_rate, actual_target_rate);
+    }
+
+    // Whole stream with segments enabled: decode them in parallel and pass
+    // them on in order; files that cannot be split are decoded below
+    if (impl_->load_segments != 1 && impl_->start_seconds <= 0.0 && impl_->range_seconds <= 0.0) {
+        result = impl_->streamSegments(impl_->metadata.file_path, callback, chunk_size_bytes);
+        if (result != ErrorCode::NotSupported) {
+            return result;
+        }
+    }
+
+    // Range start: seek to the closest earlier seek point, then drop decoded
+    // samples up to the exact start by frame timestamps (source rate)
+    AVStream* stream = impl_->format_ctx->streams[impl_->audio_stream_index];
+    const AVRational source_time_base{1, impl_->codec_ctx->sample_rate};
+    const int64_t stream_start = stream->start_time != AV_NOPTS_VALUE ? stream->start_time : 0;
+    int64_t trim_until = std::llround(impl_->start_seconds * impl_->codec_ctx->sample_rate);
+    int64_t position = 0;  // Source sample of the next decoded frame when it has no timestamp
+    if (trim_until > 0) {
+        int64_t target = av_rescale_q(trim_until, source_time_base, stream->time_base) + stream_start;
+        int seek_result = av_seek_frame(impl_->format_ctx, impl_->audio_stream_index, target,
+                                        AVSEEK_FLAG_BACKWARD);
+        if (seek_result < 0) {
+            LOG_WARN("Seek to {:.3f} s failed ({}), decoding up to it instead",
+                     impl_->start_seconds, seek_result);
+        }
+    }
+
+    // Range end, in output frames
+    uint64_t frames_left = impl_->range_seconds > 0.0
+        ? static_cast<uint64_t>(std::llround(impl_->range_seconds * actual_target_rate))
+        : std::numeric_limits<uint64_t>::max();
+    bool range_done = false;
+
+    // Decode and stream in chunks
+    AVPacket* packet = av_packet_alloc();
+    AVFrame* frame = av_frame_alloc();
+
+    // Chunk buffer (whole frames of interleaved output samples); frames are
+    // converted directly into it, so each sample is written exactly once. It
+    // is sized for the conversion width, Int24 is compacted after conversion.
+    size_t chunk_frames = std::max<size_t>(1, chunk_size_bytes / frame_bytes);
+    std::vector<uint8_t> chunk_buffer(chunk_frames * convert_frame_bytes);
+    size_t chunk_fill = 0;  // Frames in chunk_buffer
+
+    int packet_count = 0;
+    int frame_count = 0;
+    int chunk_count = 0;
+
+    auto flush_chunk = [&]() {
+        if (chunk_fill > 0) {
+            chunk_count++;
+            size_t bytes = chunk_fill * frame_bytes;
+            LOG_DEBUG("Sending chunk {}: {} samples ({} bytes)",
+                     chunk_count, chunk_fill * channels, bytes);
+            chunk_fill = 0;
+            return callback(chunk_buffer.data(), bytes);
+        }
+        return true;
+    };
+
+    // Samples to drop from the start of a decoded frame, or -1 to drop it
+    // entirely, until the range start is reached
+    auto leading_trim = [&](const AVFrame* source) -> int {
+        if (trim_until <= 0) {
+            return 0;
+        }
+        if (source->best_effort_timestamp != AV_NOPTS_VALUE) {
+            position = av_rescale_q(source->best_effort_timestamp - stream_start,
+                                    stream->time_base, source_time_base);
+        }
+        const int64_t end = position + source->nb_samples;
+        if (end <= trim_until) {
+            position = end;
+            return -1;
+        }
+        const int skip = static_cast<int>(std::max<int64_t>(0, trim_until - position));
+        trim_until = 0;
+        return skip;
+    };
+
+    // Convert one frame (nullptr = drain resampler) into the chunk buffer,
+    // leaving out skip leading samples. Returns frames converted (< 0 on
+    // conversion error) and clears keep_going when the callback asks to
+    // stop or the range end is reached.
+    bool keep_going = true;
+    auto emit = [&](const AVFrame* source, int skip) -> int {
+        size_t needed = static_cast<size_t>(impl_->maxOutputFrames(source ? source->nb_samples - skip : 0));
+        if (needed == 0) {
+            return 0;
+        }
+        if (chunk_fill + needed > chunk_frames && !flush_chunk()) {
+            keep_going = false;
+            return 0;
+        }
+        if (needed > chunk_frames) {
+            // A single decoded frame larger than the requested chunk
+            chunk_frames = needed;
+            chunk_buffer.resize(chunk_frames * convert_frame_bytes);
+        }
+
+        int converted = impl_->convertFrame(source, chunk_buffer.data() + chunk_fill * frame_bytes,
+                                            static_cast<int>(chunk_frames - chunk_fill), skip);
+        if (converted > 0) {
+            if (static_cast<uint64_t>(converted) >= frames_left) {
+                converted = static_cast<int>(frames_left);
+                range_done = true;
+            }
+            frames_left -= converted;
+            chunk_fill += converted;
+            if ((chunk_fill == chunk_frames || range_done) && !flush_chunk()) {
+                keep_going = false;
+            }
+            if (range_done) {
+                keep_going = false;
+            }
+        }
+        return converted;
+    };
+
+    // Main decoding loop
+    while (keep_going && av_read_frame(impl_->format_ctx, packet) >= 0) {
+        packet_count++;
+        impl_->trackReadPosition();
+        if (packet->stream_index == impl_->audio_stream_index) {
+            int send_result = avcodec_send_packet(impl_->codec_ctx, packet);
+            if (send_result == 0) {
+                while (keep_going && avcodec_receive_frame(impl_->codec_ctx, frame) == 0) {
+                    frame_count++;
+                    int skip = leading_trim(frame);
+                    if (skip < 0) {
+                        continue;
+                    }
+                    int converted = emit(frame, skip);
+                    if (converted < 0) {
+                        LOG_ERROR("swr_convert failed: {}", converted);
+                    }
+                }
+            } else {
+                LOG_ERROR("avcodec_send_packet failed: {}", send_result);
+            }
+        }
+        av_packet_unref(packet);
+    }
+    if (!keep_going) {
+        if (range_done) {
+            LOG_INFO("Reached end of range");
+        } else {
+            LOG_INFO("Streaming stopped by callback");
+        }
+        goto cleanup;
+    }
+
+    // Flush decoder
+    avcodec_send_packet(impl_->codec_ctx, nullptr);
+    while (keep_going && avcodec_receive_frame(impl_->codec_ctx, frame) == 0) {
+        int skip = leading_trim(frame);
+        if (skip < 0) {
+            continue;
+        }
+        int converted = emit(frame, skip);
+        if (converted < 0) {
+            LOG_ERROR("swr_convert failed during flush: {}", converted);
+        }
+    }
+
+    // Flush any remaining samples in resampler
+    while (keep_going && emit(nullptr, 0) > 0) {
+    }
+    if (!keep_going) {
+        if (!range_done) {
+            LOG_INFO("Streaming stopped by callback during flush");
+        }
+        goto cleanup;
+    }
+
+    // Flush final chunk
+    flush_chunk();
+
+cleanup:
+    av_frame_free(&frame);
+    av_packet_free(&packet);
+
+    LOG_INFO("Streaming complete: {} packets, {} frames, {} chunks",
+             packet_count, frame_count, chunk_count);
+
+    return ErrorCode::Success;
+}
+
+ErrorCode AudioFileLoader::loadStreaming(const std::string& filepath,
+                                         StreamingCallback callback,
+                                         size_t chunk_size_bytes) {
+    LOG_INFO("Loading audio file in streaming mode (legacy one-shot): {}", filepath);
+    LOG_INFO("  Chunk size: {} bytes", chunk_size_bytes);
+
+    // Prepare streaming (extract metadata)
+    ErrorCode ret = prepareStreaming(filepath);
+    if (ret != ErrorCode::Success) {
+        return ret;
+    }
+
+    // Stream PCM data
+    return streamPCM(callback, chunk_size_bytes);
+}
+
+void AudioFileLoader::close() {
+    impl_->closeInput();
+}
+
+const protocol::AudioMetadata& AudioFileLoader::getMetadata() const {
+    return impl_->metadata;
+}
+
+const std::vector<uint8_t>& AudioFileLoader::getPCMData() const {
+    return impl_->pcm_data;
+}
+
+bool AudioFileLoader::isLoaded() const {
+    return impl_->loaded;
+}
+
+} // namespace load
+} // namespace xpu
@@ -0,0 +1,256 @@
+/**
+ * @file AudioFileLoader.h
+ * @brief Audio file loader implementation
+ */
+
+#ifndef XPU_LOAD_AUDIO_FILE_LOADER_H
+#define XPU_LOAD_AUDIO_FILE_LOADER_H
+
+#include "protocol/ErrorCode.h"
+#include "audio/AudioFormat.h"
+#include "protocol/Protocol.h"
+#include "utils/ReadAhead.h"
+#include <string>
+#include <vector>
+#include <memory>
+#include <functional>
+
+namespace xpu {
+namespace load {
+
+/**
+ * @brief Callback type for streaming mode
+ * @param chunk_data Pointer to chunk data (interleaved float samples)
+ * @param chunk_samples Number of float samples in chunk
+ * @return true to continue streaming, false to stop
+ */
+using StreamingCallback = std::function<bool(const float* chunk_data, size_t chunk_samples)>;
+
+/**
+ * @brief Callback type for streaming in the output sample format
+ * @param chunk_data Pointer to chunk data (interleaved samples, see getMetadata().sample_format)
+ * @param chunk_bytes Number of bytes in chunk (whole frames)
+ * @return true to continue streaming, false to stop
+ */
+using PCMStreamingCallback = std::function<bool(const uint8_t* chunk_data, size_t chunk_bytes)>;
+
+/**
+ * @brief How AudioFileLoader reads the input file
+ */
+enum class InputIO {
+    File,    // FFmpeg file protocol (read() into the AVIO buffer)
+    Mapped,  // Memory-mapped file behind a custom AVIOContext
+    Auto     // Mapped for the formats set with setMappedFormats(), file protocol otherwise
+};
+
+/**
+ * @brief Default AVIO buffer size (bytes handed to the demuxer per refill)
+ */
+constexpr size_t DEFAULT_AVIO_BUFFER_SIZE = 256 * 1024;
+
+/**
+ * @brief Audio file loader class
+ *
+ * Output is interleaved 32-bit float in the source channel layout (FFmpeg
+ * channel order, e.g. FL FR FC LFE BL BR for 5.1); channels are never
+ * downmixed. With setNativeSampleFormat() integer sources are delivered in
+ * their own integer format instead (Int16, packed Int24 or Int32).
+ *
+ * A loader can open one file after another (load() / prepareStreaming()
+ * close the previous one). The decoder is kept across files and reused
+ * when the next stream has the same codec parameters, e.g. the next track
+ * of an album.
+ */
+class AudioFileLoader {
+public:
+    AudioFileLoader();
+    ~AudioFileLoader();
+
+    /**
+     * @brief Set target sample rate for output
+     * @param sample_rate Target sample rate (0 = keep original, e.g., 48000, 96000)
+     */
+    void setTargetSampleRate(int sample_rate);
+
+    /**
+     * @brief Set the number of FFmpeg decoder threads
+     * @param threads Thread count (0 = auto, one per core; 1 = single-threaded)
+     *
+     * Applies to codecs with frame or slice threading (e.g. FLAC, WavPack,
+     * ALAC, the DSD decoders); others always decode on one thread.
+     */
+    void setDecoderThreads(int threads);
+
+    /**
+     * @brief Decode in parallel time segments
+     * @param segments Segment count (0 = one per core, 1 = serial, the default)
+     *
+     * Used for seekable inputs whose packets decode independently (FLAC, WAV,
+     * ALAC, DSF/DSDIFF, ...) and at least 10 s per segment; other files are
+     * decoded serially. Each segment opens the file on its own thread and the
+     * output is stitched sample-accurately. load() decodes this many segments
+     * side by side; streamPCM() / streamRawPCM() of a whole stream (no seek())
+     * decode 10-20 s segments on this many threads and deliver them in order,
+     * holding at most one segment per thread.
+     */
+    void setLoadSegments(int segments);
+
+    /**
+     * @brief Select how the input file is read
+     * @param mode File, Mapped or Auto (default: Auto)
+     * @param buffer_size AVIO buffer size for mapped input in bytes
+     *
+     * Mapped input avoids a read() per buffer refill and shares the page
+     * cache between decoders of the same file; it falls back to the file
+     * protocol for anything that cannot be mapped.
+     */
+    void setInputIO(InputIO mode, size_t buffer_size = DEFAULT_AVIO_BUFFER_SIZE);
+
+    /**
+     * @brief Formats read memory-mapped in InputIO::Auto mode
+     *
+     * Default: the lossless formats (FLAC, WAV, ALAC, DSF, DSDIFF, AIFF),
+     * whose bitrate makes I/O a noticeable share of decode time.
+     */
+    void setMappedFormats(const std::vector<audio::AudioFormat>& formats);
+
+    /**
+     * @brief Keep the source's integer sample format in the output
+     * @param enabled true = Int16 / Int24 / Int32 output for integer sources (default: false)
+     *
+     * Applies when the source is integer PCM (FLAC, WAV, ALAC, AIFF, ...) and
+     * the sample rate is kept; the samples are then passed through without a
+     * float round trip. Sources up to 16 bits give Int16, up to 24 bits packed
+     * 3-byte Int24, wider ones Int32. Everything else (lossy codecs, DSD,
+     * resampling) stays Float32. The chosen format is reported in the
+     * metadata (sample_format, bit_depth); use streamRawPCM() to receive it.
+     */
+    void setNativeSampleFormat(bool enabled);
+
+    /**
+     * @brief Read the input file ahead of the demuxer on background threads
+     * @param config Window, threads and hints (default: disabled)
+     *
+     * Keeps config.window_bytes past the demuxer's position in the page
+     * cache so decoding does not stall on slow storage. Applies to regular
+     * files, with either input I/O mode; pipes and URLs are read as before.
+     */
+    void setReadAhead(const utils::ReadAheadConfig& config);
+
+    /**
+     * @brief Set DSD decimation factor for output
+     * @param factor Decimation factor: 16, 32, or 64 (default: 16)
+     *               Higher factors = lower quality but less CPU/memory
+     *               For DSD64: /16 = 176.4kHz, /32 = 88.2kHz, /64 = 44.1kHz
+     * @note Only affects DSD files when target_sample_rate is 0
+     */
+    void setDSDDecimation(int factor);
+
+    /**
+     * @brief Load audio file (batch mode - loads entire file into memory)
+     */
+    ErrorCode load(const std::string& filepath);
+
+    /**
+     * @brief Prepare for streaming (opens file and extracts metadata)
+     * @param filepath Path to audio file
+     * @return ErrorCode::Success on success, error code otherwise
+     *
+     * This method opens the file and extracts metadata WITHOUT decoding PCM data.
+     * Call getMetadata() after this to retrieve the metadata.
+     * Then call streamPCM() to start streaming PCM data.
+     *
+     * Example workflow:
+     *   1. prepareStreaming(filepath) - Opens file and extracts metadata
+     *   2. getMetadata() - Retrieve metadata
+     *   3. Output metadata to stdout
+     *   4. streamPCM(callback) - Stream PCM data
+     */
+    ErrorCode prepareStreaming(const std::string& filepath);
+
+    /**
+     * @brief Restrict streamPCM() to a time range (call after prepareStreaming())
+     * @param start_seconds Position of the first output sample
+     * @param duration_seconds Length of the range (0 = to the end of the file)
+     * @return ErrorCode::InvalidArgument if the range is negative or starts past the end
+     *
+     * streamPCM() seeks with av_seek_frame() to the closest earlier seek
+     * point and drops decoded samples by frame timestamp, so the output
+     * starts at the exact sample. The metadata duration and sample count
+     * describe the range. load() always decodes the whole file.
+     */
+    ErrorCode seek(double start_seconds, double duration_seconds = 0.0);
+
+    /**
+     * @brief Stream PCM data using callback (requires prepareStreaming() first)
+     * @param callback Callback function for each chunk
+     * @param chunk_size_bytes Target chunk size (default: 64KB)
+     * @return ErrorCode::Success on success, error code otherwise
+     *
+     * Chunks hold whole frames and never exceed chunk_size_bytes unless a
+     * single decoded frame is larger.
+     *
+     * NOTE: You MUST call prepareStreaming() before this method.
+     */
+    ErrorCode streamPCM(StreamingCallback callback, size_t chunk_size_bytes = 64 * 1024);
+
+    /**
+     * @brief Stream PCM data in the output sample format (requires prepareStreaming() first)
+     * @param callback Callback function for each chunk
+     * @param chunk_size_bytes Target chunk size (default: 64KB)
+     * @return ErrorCode::Success on success, error code otherwise
+     *
+     * Same as streamPCM() but chunks are raw bytes in the format reported by
+     * getMetadata().sample_format. streamPCM() only works for Float32 output.
+     */
+    ErrorCode streamRawPCM(PCMStreamingCallback callback, size_t chunk_size_bytes = 64 * 1024);
+
+    /**
+     * @brief Load and stream audio file in chunks (legacy one-shot method)
+     * @param filepath Path to audio file
+     * @param callback Callback function for each chunk
+     * @param chunk_size_bytes Target chunk size (default: 64KB)
+     * @return ErrorCode::Success on success, error code otherwise
+     *
+     * NOTE: This is a legacy method that combines prepareStreaming() + streamPCM().
+     * The caller is responsible for outputting metadata before calling this method.
+     *
+     * Recommended workflow for new code:
+     *   1. prepareStreaming(filepath) - Extract metadata
+     *   2. getMetadata() - Retrieve metadata
+     *   3. Output metadata to stdout
+     *   4. streamPCM(callback) - Stream PCM data
+     */
+    ErrorCode loadStreaming(const std::string& filepath,
+                           StreamingCallback callback,
+                           size_t chunk_size_bytes = 64 * 1024);
+
+    /**
+     * @brief Close the current file (the decoder stays open for the next one)
+     */
+    void close();
+
+    /**
+     * @brief Get metadata (valid after load() or prepareStreaming())
+     */
+    const protocol::AudioMetadata& getMetadata() const;
+
+    /**
+     * @brief Get PCM data
+     */
+    const std::vector<uint8_t>& getPCMData() const;
+
+    /**
+     * @brief Check if file is loaded
+     */
+    bool isLoaded() const;
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace load
+} // namespace xpu
+
+#endif // XPU_LOAD_AUDIO_FILE_LOADER_H
@@ -0,0 +1,127 @@
+/**
+ * @file ChunkOutput.cpp
+ * @brief Chunked PCM output of xpuLoad (stdout or a --serve socket)
+ */
+
+#include "ChunkOutput.h"
+#include "protocol/Protocol.h"
+#include "utils/Logger.h"
+#include <cstdio>
+#include <iostream>
+
+#ifndef PLATFORM_WINDOWS
+#include <cerrno>
+#include <unistd.h>
+#endif
+
+namespace xpu {
+namespace load {
+
+#ifndef PLATFORM_WINDOWS
+bool writeAll(int fd, const void* data, size_t bytes) {
+    const char* p = static_cast<const char*>(data);
+    while (bytes > 0) {
+        ssize_t written = ::write(fd, p, bytes);
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written <= 0) {
+            return false;
+        }
+        p += written;
+        bytes -= static_cast<size_t>(written);
+    }
+    return true;
+}
+#endif
+
+ChunkOutput::ChunkOutput(size_t buffer_bytes, int socket_fd)
+    : socket_fd_(socket_fd) {
+    if (buffer_bytes > 0) {
+        ring_ = std::make_unique<utils::RingBuffer>(buffer_bytes);
+        thread_ = std::thread([this] { drain(); });
+        LOG_INFO("Output thread started ({} KB ring buffer)", ring_->capacity() / 1024);
+    }
+}
+
+ChunkOutput::~ChunkOutput() {
+    finish();
+}
+
+bool ChunkOutput::write(const float* chunk_data, size_t chunk_samples) {
+    return writeBytes(reinterpret_cast<const uint8_t*>(chunk_data), chunk_samples * sizeof(float));
+}
+
+bool ChunkOutput::writeBytes(const uint8_t* chunk_data, size_t chunk_bytes) {
+    chunk_count_++;
+    const uint64_t size_header = chunk_bytes;
+
+    // Log first few chunks
+    if (chunk_count_ <= 5) {
+        LOG_INFO("Output chunk {}: {} bytes", chunk_count_, size_header);
+    }
+
+    return writeFramed(size_header, chunk_data, chunk_bytes);
+}
+
+bool ChunkOutput::writeRecord(const std::string& json) {
+    LOG_INFO("Output track record: {} bytes", json.size());
+    return writeFramed(json.size() | protocol::TRACK_RECORD_FLAG,
+                       reinterpret_cast<const uint8_t*>(json.data()), json.size());
+}
+
+bool ChunkOutput::finish() {
+    if (thread_.joinable()) {
+        ring_->close();
+        thread_.join();
+    }
+    return !failed_;
+}
+
+bool ChunkOutput::writeFramed(uint64_t size_header, const uint8_t* data, size_t bytes) {
+    if (!ring_) {
+        if (!writeOut(&size_header, sizeof(size_header)) || !writeOut(data, bytes)) {
+            failed_ = true;
+            return false;
+        }
+        return true;
+    }
+    return ring_->write(&size_header, sizeof(size_header)) == sizeof(size_header) &&
+           ring_->write(data, bytes) == bytes;
+}
+
+void ChunkOutput::drain() {
+    const uint8_t* data = nullptr;
+    while (size_t bytes = ring_->peek(data)) {
+        if (!writeOut(data, bytes)) {
+            LOG_ERROR("Writing to {} failed, stopping output", socket_fd_ < 0 ? "stdout" : "socket");
+            failed_ = true;
+            ring_->close();
+            return;
+        }
+        ring_->consume(bytes);
+    }
+}
+
+bool ChunkOutput::writeOut(const void* data, size_t bytes) {
+    #ifndef PLATFORM_WINDOWS
+    if (socket_fd_ >= 0) {
+        return writeAll(socket_fd_, data, bytes);
+    }
+    #endif
+    std::cout.write(static_cast<const char*>(data), static_cast<std::streamsize>(bytes));
+    return flushStdout();
+}
+
+bool ChunkOutput::flushStdout() {
+    std::cout.flush();
+    #ifdef PLATFORM_WINDOWS
+    _flushall();
+    #else
+    fflush(nullptr);
+    #endif
+    return std::cout.good();
+}
+
+} // namespace load
+} // namespace xpu
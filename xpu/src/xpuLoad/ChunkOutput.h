@@ -0,0 +1,99 @@
+/**
+ * @file ChunkOutput.h
+ * @brief Chunked PCM output of xpuLoad (stdout or a --serve socket)
+ */
+
+#ifndef XPU_LOAD_CHUNK_OUTPUT_H
+#define XPU_LOAD_CHUNK_OUTPUT_H
+
+#include "utils/RingBuffer.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+
+namespace xpu {
+namespace load {
+
+#ifndef PLATFORM_WINDOWS
+/**
+ * @brief Write all bytes to a socket (false once the peer has gone)
+ */
+bool writeAll(int fd, const void* data, size_t bytes);
+#endif
+
+/**
+ * @brief Writes streamed chunks to stdout as [8-byte size header][PCM data]
+ *
+ * With a buffer, chunks are queued in a ring buffer that an output thread
+ * drains to stdout, so decoding continues while the pipe is full and the
+ * pipe keeps being fed while the decoder works. Without one (size 0) each
+ * chunk is written and flushed from the decoding thread.
+ *
+ * With a socket (--serve) the chunks go to the socket instead of stdout.
+ * Multi-track streams put a track record (see protocol::TRACK_RECORD_FLAG)
+ * between the chunks of two tracks.
+ */
+class ChunkOutput {
+public:
+    explicit ChunkOutput(size_t buffer_bytes, int socket_fd = -1);
+
+    ~ChunkOutput();
+
+    ChunkOutput(const ChunkOutput&) = delete;
+    ChunkOutput& operator=(const ChunkOutput&) = delete;
+
+    /**
+     * @brief Queue (or write) one chunk
+     * @return false once stdout has failed, to stop decoding
+     */
+    bool write(const float* chunk_data, size_t chunk_samples);
+
+    /**
+     * @brief Queue (or write) one chunk of raw sample bytes
+     * @return false once stdout has failed, to stop decoding
+     */
+    bool writeBytes(const uint8_t* chunk_data, size_t chunk_bytes);
+
+    /**
+     * @brief Queue (or write) the metadata JSON of the next track
+     * @return false once stdout has failed, to stop decoding
+     */
+    bool writeRecord(const std::string& json);
+
+    /**
+     * @brief Wait until every queued chunk has reached stdout
+     * @return false if writing to stdout failed
+     */
+    bool finish();
+
+    int chunkCount() const {
+        return chunk_count_;
+    }
+
+    /**
+     * @brief false once writing has failed (the reader has gone)
+     */
+    bool good() const {
+        return !failed_;
+    }
+
+private:
+    bool writeFramed(uint64_t size_header, const uint8_t* data, size_t bytes);
+    void drain();
+    bool writeOut(const void* data, size_t bytes);
+    static bool flushStdout();
+
+    int socket_fd_;
+    std::unique_ptr<utils::RingBuffer> ring_;
+    std::thread thread_;
+    std::atomic<bool> failed_{false};
+    int chunk_count_ = 0;
+};
+
+} // namespace load
+} // namespace xpu
+
+#endif // XPU_LOAD_CHUNK_OUTPUT_H
@@ -0,0 +1,1848 @@
+/**
+ * @file DSDDecoder.cpp
+ * @brief DSD (Direct Stream Digital) format decoder implementation
+ */
+
+#include "DSDDecoder.h"
+#include "utils/Logger.h"
+#include "utils/PlatformUtils.h"
+#include "utils/MappedFile.h"
+#include "utils/ReadAhead.h"
+#include "audio/DSDDecimator.h"
+#include "audio/DoPEncoder.h"
+#include "audio/DSTDecoder.h"
+#include "audio/PolyphaseResampler.h"
+#include <fstream>
+#include <cstring>
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <limits>
+#include <mutex>
+#include <new>
+#include <thread>
+
+using namespace xpu;
+
+namespace xpu {
+namespace load {
+
+/**
+ * @brief DSF format header structure
+ */
+#pragma pack(push, 1)
+struct DSFHeader {
+    char id[4];              // 'D', 'S', 'D', ' '
+    uint64_t chunk_size;     // Total chunk size (always 28)
+    uint32_t padding1;       // Padding (4 bytes)
+    uint64_t file_size;      // Total file size
+    uint32_t padding2;       // Padding (4 bytes)
+};
+
+struct DSFFmtChunk {
+    char id[4];              // 'f', 'm', 't', ' '
+    uint64_t chunk_size;     // Chunk size
+    uint32_t version;        // Format version
+    uint32_t format_id;      // Format ID (0 = DSD raw)
+    uint32_t channel_type;   // Channel type
+    uint32_t channel_num;    // Number of channels
+    uint32_t sampling_freq;  // Sampling frequency (Hz)
+    uint32_t bits_per_sample;// Bits per sample (always 1 for DSD)
+    uint64_t sample_count;   // Total sample count
+    uint32_t block_size;     // Block size per channel
+    uint32_t reserved;       // Reserved
+};
+
+struct DSFDataChunk {
+    char id[4];              // 'd', 'a', 't', 'a'
+    uint64_t chunk_size;     // Chunk size (12-byte header + sample data)
+};
+#pragma pack(pop)
+
+/**
+ * @brief Layout of a DSDIFF file (DSDIFF 1.5: FRM8 form with PROP and DSD / DST chunks)
+ */
+struct DSDIFFInfo {
+    uint32_t sample_rate = 0;
+    uint16_t channels = 0;
+    bool dst = false;            // CMPR 'DST ': sound data is DST-compressed
+    uint64_t data_offset = 0;    // Contents of the 'DSD ' or 'DST ' chunk
+    uint64_t data_size = 0;
+    uint32_t dst_frames = 0;     // DST frame count (FRTE)
+    uint16_t dst_frame_rate = 0; // DST frames per second (FRTE, always 75)
+};
+
+namespace {
+
+/**
+ * @brief Read a big-endian unsigned integer (DSDIFF is big-endian throughout)
+ */
+uint64_t readBE(std::istream& in, int bytes) {
+    uint8_t buf[8] = {};
+    in.read(reinterpret_cast<char*>(buf), bytes);
+    uint64_t v = 0;
+    for (int i = 0; i < bytes; ++i) {
+        v = (v << 8) | buf[i];
+    }
+    return v;
+}
+
+/**
+ * @brief Read a DSDIFF chunk header: 4-byte ID and 64-bit data size
+ */
+bool readChunkHeader(std::istream& in, char id[4], uint64_t& size) {
+    in.read(id, 4);
+    size = readBE(in, 8);
+    return in.good();
+}
+
+/**
+ * @brief Skip chunk data including the pad byte of odd-sized chunks
+ */
+void skipChunk(std::istream& in, uint64_t start, uint64_t size) {
+    in.seekg(static_cast<std::streamoff>(start + size + (size & 1)));
+}
+
+} // anonymous namespace
+
+/**
+ * @brief Parse the DSDIFF container up to the sound data chunk
+ *
+ * Reads the PROP 'SND ' chunk (FS, CHNL, CMPR) and locates the 'DSD ' or
+ * 'DST ' chunk; for DST the FRTE frame count is read as well.
+ */
+ErrorCode readDSDIFFInfo(std::istream& file, DSDIFFInfo& info) {
+    char id[4];
+    uint64_t size = 0;
+    if (!readChunkHeader(file, id, size) || std::memcmp(id, "FRM8", 4) != 0) {
+        LOG_ERROR("Invalid DSDIFF file format");
+        return ErrorCode::UnsupportedFormat;
+    }
+    char form_type[4];
+    file.read(form_type, 4);
+    if (std::memcmp(form_type, "DSD ", 4) != 0) {
+        LOG_ERROR("Invalid DSDIFF form type");
+        return ErrorCode::UnsupportedFormat;
+    }
+
+    bool found_prop = false;
+    while (readChunkHeader(file, id, size)) {
+        const uint64_t start = static_cast<uint64_t>(file.tellg());
+        LOG_DEBUG("Found chunk: {:.4s}, size: {} bytes", id, size);
+
+        if (std::memcmp(id, "PROP", 4) == 0) {
+            char prop_type[4];
+            file.read(prop_type, 4);
+            if (std::memcmp(prop_type, "SND ", 4) != 0) {
+                skipChunk(file, start, size);
+                continue;
+            }
+
+            // Local chunks of the sound property chunk
+            uint64_t end = start + size;
+            char local_id[4];
+            uint64_t local_size = 0;
+            while (static_cast<uint64_t>(file.tellg()) + 12 <= end &&
+                   readChunkHeader(file, local_id, local_size)) {
+                const uint64_t local_start = static_cast<uint64_t>(file.tellg());
+                if (std::memcmp(local_id, "FS  ", 4) == 0) {
+                    info.sample_rate = static_cast<uint32_t>(readBE(file, 4));
+                } else if (std::memcmp(local_id, "CHNL", 4) == 0) {
+                    info.channels = static_cast<uint16_t>(readBE(file, 2));
+                } else if (std::memcmp(local_id, "CMPR", 4) == 0) {
+                    char compression[4];
+                    file.read(compression, 4);
+                    if (std::memcmp(compression, "DST ", 4) == 0) {
+                        info.dst = true;
+                    } else if (std::memcmp(compression, "DSD ", 4) != 0) {
+                        LOG_ERROR("Unsupported DSDIFF compression: {:.4s}", compression);
+                        return ErrorCode::UnsupportedFormat;
+                    }
+                }
+                skipChunk(file, local_start, local_size);
+            }
+            found_prop = true;
+            skipChunk(file, start, size);
+
+        } else if (std::memcmp(id, "DSD ", 4) == 0 || std::memcmp(id, "DST ", 4) == 0) {
+            if (!found_prop) {
+                LOG_ERROR("Sound data chunk found before PROP chunk");
+                return ErrorCode::CorruptedFile;
+            }
+            if ((std::memcmp(id, "DST ", 4) == 0) != info.dst) {
+                LOG_ERROR("DSDIFF sound data chunk {:.4s} does not match CMPR", id);
+                return ErrorCode::CorruptedFile;
+            }
+
+            info.data_offset = start;
+            info.data_size = size;
+
+            if (info.dst) {
+                // FRTE comes first in the DST chunk
+                char frte_id[4];
+                uint64_t frte_size = 0;
+                if (!readChunkHeader(file, frte_id, frte_size) ||
+                    std::memcmp(frte_id, "FRTE", 4) != 0 || frte_size < 6) {
+                    LOG_ERROR("DST chunk without FRTE frame information");
+                    return ErrorCode::CorruptedFile;
+                }
+                info.dst_frames = static_cast<uint32_t>(readBE(file, 4));
+                info.dst_frame_rate = static_cast<uint16_t>(readBE(file, 2));
+            }
+            break;
+
+        } else {
+            skipChunk(file, start, size);
+        }
+    }
+
+    if (!found_prop || info.data_size == 0 || info.sample_rate == 0 || info.channels == 0) {
+        LOG_ERROR("DSDIFF file missing required chunks");
+        return ErrorCode::CorruptedFile;
+    }
+    if (info.dst && (!audio::DSTDecoder::isSupported(info.channels, info.sample_rate) ||
+                     info.dst_frame_rate != audio::DSTDecoder::FRAME_RATE)) {
+        LOG_ERROR("Unsupported DST stream: {} channels at {} Hz, {} frames/s",
+                  info.channels, info.sample_rate, info.dst_frame_rate);
+        return ErrorCode::UnsupportedFormat;
+    }
+    return ErrorCode::Success;
+}
+
+/**
+ * @brief DSDIFF frame size used by the streaming reader (bytes per channel)
+ */
+constexpr size_t DSDIFF_FRAME_BYTES = 4096;
+
+/**
+ * @brief Read-ahead window kept in flight when decoding from a mapped file
+ */
+constexpr size_t DSD_READAHEAD_BYTES = 4 * 1024 * 1024;
+
+/**
+ * @brief Minimal fork-join worker pool for parallel DSD decoding
+ *
+ * run() executes job(0..size()-1) with the calling thread taking job 0,
+ * and returns when every job has finished.
+ */
+class DecodeWorkers {
+public:
+    explicit DecodeWorkers(size_t threads) {
+        for (size_t i = 1; i < threads; ++i) {
+            threads_.emplace_back([this, i] { workerLoop(i); });
+        }
+    }
+
+    ~DecodeWorkers() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            shutdown_ = true;
+        }
+        start_cv_.notify_all();
+        for (auto& t : threads_) {
+            t.join();
+        }
+    }
+
+    size_t size() const {
+        return threads_.size() + 1;
+    }
+
+    void run(const std::function<void(size_t)>& job) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            job_ = &job;
+            pending_ = threads_.size();
+            ++generation_;
+        }
+        start_cv_.notify_all();
+
+        job(0);
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_cv_.wait(lock, [this] { return pending_ == 0; });
+        job_ = nullptr;
+    }
+
+private:
+    void workerLoop(size_t index) {
+        uint64_t seen = 0;
+        while (true) {
+            const std::function<void(size_t)>* job = nullptr;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                start_cv_.wait(lock, [&] { return shutdown_ || generation_ != seen; });
+                if (shutdown_) {
+                    return;
+                }
+                seen = generation_;
+                job = job_;
+            }
+
+            (*job)(index);
+
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (--pending_ == 0) {
+                done_cv_.notify_one();
+            }
+        }
+    }
+
+    std::vector<std::thread> threads_;
+    std::mutex mutex_;
+    std::condition_variable start_cv_;
+    std::condition_variable done_cv_;
+    const std::function<void(size_t)>* job_ = nullptr;
+    size_t pending_ = 0;
+    uint64_t generation_ = 0;
+    bool shutdown_ = false;
+};
+
+/**
+ * @brief Parallel DST frame decoder over the contents of a 'DST ' chunk
+ *
+ * DST frames are independent, so each refill decodes a batch of frames at
+ * once (frame i of the batch on worker i % workers, each worker with its
+ * own audio::DSTDecoder) and then hands them out one by one in file order.
+ * Frames that fail to decode are replaced with DSD silence to keep timing.
+ */
+class DSTFrameSource {
+public:
+    DSTFrameSource(const uint8_t* data, uint64_t size, uint32_t channels, uint32_t dsd_rate,
+                   DecodeWorkers* workers, const utils::MappedFile* mapping = nullptr)
+        : data_(data)
+        , cursor_(data)
+        , end_(data + size)
+        , prefetched_(data)
+        , mapping_(mapping)
+        , workers_(workers) {
+        const size_t worker_count = workers ? workers->size() : 1;
+        for (size_t i = 0; i < worker_count; ++i) {
+            decoders_.push_back(std::make_unique<audio::DSTDecoder>(channels, dsd_rate));
+        }
+        frame_bytes_ = decoders_[0]->getFrameBytes();
+        group_bytes_ = frame_bytes_ * channels;
+        batch_frames_ = worker_count * DST_FRAMES_PER_WORKER;
+    }
+
+    /**
+     * @brief DSD bytes per channel in one frame
+     */
+    size_t frameBytes() const {
+        return frame_bytes_;
+    }
+
+    /**
+     * @brief Report the read position to a read-ahead
+     * @param data_offset File offset of the start of the data
+     */
+    void setReadAhead(utils::ReadAhead* read_ahead, uint64_t data_offset) {
+        read_ahead_ = read_ahead;
+        data_offset_ = data_offset;
+        reportPosition();
+    }
+
+    /**
+     * @brief Next decoded frame, planar ([ch0 bytes][ch1 bytes]...), or nullptr at end
+     */
+    const uint8_t* next() {
+        if (next_frame_ == frames_.size()) {
+            if (!decodeBatch()) {
+                return nullptr;
+            }
+        }
+        return decoded_.data() + group_bytes_ * next_frame_++;
+    }
+
+    /**
+     * @brief Skip frames without decoding them (only before the first next())
+     *
+     * Walks the DSTF chunk headers, so seeking costs one header read per
+     * skipped frame instead of a full decode.
+     * @return Number of frames actually skipped (less at end of data)
+     */
+    uint64_t skipFrames(uint64_t count) {
+        uint64_t skipped = 0;
+        while (skipped < count && end_ - cursor_ >= 12) {
+            const uint8_t* payload = cursor_ + 12;
+            const uint64_t size = chunkSize(cursor_);
+            if (size > static_cast<uint64_t>(end_ - payload)) {
+                cursor_ = end_;
+                break;
+            }
+            if (std::memcmp(cursor_, "DSTF", 4) == 0) {
+                ++skipped;
+            }
+            cursor_ = payload + std::min<uint64_t>(size + (size & 1), end_ - payload);
+        }
+        frames_done_ += skipped;
+        prefetched_ = cursor_;
+        reportPosition();
+        return skipped;
+    }
+
+private:
+    static constexpr size_t DST_FRAMES_PER_WORKER = 4;
+
+    struct Frame {
+        const uint8_t* data;
+        size_t size;
+    };
+
+    static uint64_t chunkSize(const uint8_t* header) {
+        uint64_t size = 0;
+        for (int i = 4; i < 12; ++i) {
+            size = (size << 8) | header[i];
+        }
+        return size;
+    }
+
+    /**
+     * @brief Collect the next DSTF chunks and decode them in parallel
+     */
+    bool decodeBatch() {
+        frames_.clear();
+        next_frame_ = 0;
+
+        while (frames_.size() < batch_frames_ && end_ - cursor_ >= 12) {
+            const uint64_t size = chunkSize(cursor_);
+            const uint8_t* payload = cursor_ + 12;
+            if (size > static_cast<uint64_t>(end_ - payload)) {
+                LOG_WARN("Truncated DST chunk: dropping {} trailing bytes", end_ - cursor_);
+                cursor_ = end_;
+                break;
+            }
+            if (std::memcmp(cursor_, "DSTF", 4) == 0) {
+                frames_.push_back({payload, static_cast<size_t>(size)});
+            }
+            // FRTE, DSTC (CRC) and unknown chunks are skipped
+            cursor_ = payload + std::min<uint64_t>(size + (size & 1), end_ - payload);
+        }
+        prefetchAhead();
+
+        if (frames_.empty()) {
+            return false;
+        }
+
+        decoded_.resize(frames_.size() * group_bytes_);
+        std::vector<ErrorCode> results(frames_.size(), ErrorCode::Success);
+        const size_t worker_count = decoders_.size();
+
+        auto decodeShare = [&](size_t index) {
+            for (size_t f = index; f < frames_.size(); f += worker_count) {
+                results[f] = decoders_[index]->decodeFrame(frames_[f].data, frames_[f].size,
+                                                           decoded_.data() + f * group_bytes_);
+            }
+        };
+        if (workers_ && worker_count > 1) {
+            workers_->run(decodeShare);
+        } else {
+            decodeShare(0);
+        }
+
+        for (size_t f = 0; f < frames_.size(); ++f) {
+            if (results[f] != ErrorCode::Success) {
+                LOG_WARN("DST frame {} failed to decode (error {}), inserting silence",
+                         frames_done_ + f, static_cast<int>(results[f]));
+                std::fill_n(decoded_.begin() + f * group_bytes_, group_bytes_,
+                            audio::DSDDecimator::SILENCE_BYTE);
+            }
+        }
+        frames_done_ += frames_.size();
+        return true;
+    }
+
+    void prefetchAhead() {
+        reportPosition();
+        if (!mapping_ || cursor_ + DSD_READAHEAD_BYTES / 2 < prefetched_) {
+            return;
+        }
+        prefetched_ = std::max(prefetched_, cursor_);
+        mapping_->prefetch(static_cast<uint64_t>(prefetched_ - mapping_->data()), DSD_READAHEAD_BYTES);
+        prefetched_ += DSD_READAHEAD_BYTES;
+    }
+
+    void reportPosition() {
+        if (read_ahead_) {
+            read_ahead_->advance(data_offset_ + static_cast<uint64_t>(cursor_ - data_));
+        }
+    }
+
+    const uint8_t* data_;
+    const uint8_t* cursor_;
+    const uint8_t* end_;
+    const uint8_t* prefetched_;
+    const utils::MappedFile* mapping_;
+    utils::ReadAhead* read_ahead_ = nullptr;
+    uint64_t data_offset_ = 0;
+    DecodeWorkers* workers_;
+    std::vector<std::unique_ptr<audio::DSTDecoder>> decoders_;
+    size_t frame_bytes_ = 0;
+    size_t group_bytes_ = 0;
+    size_t batch_frames_ = 0;
+    std::vector<Frame> frames_;
+    size_t next_frame_ = 0;
+    uint64_t frames_done_ = 0;
+    std::vector<uint8_t> decoded_;
+};
+
+/**
+ * @brief Incremental DSD data reader
+ *
+ * Pulls DSF block groups (block_size bytes per channel) or DSDIFF frames
+ * (byte-interleaved channels) from the open file, or from a span over the
+ * data chunk (memory-mapped file or in-memory copy), or decoded frames from
+ * a DSTFrameSource, and splits them into per-channel byte buffers. Only
+ * about one output chunk worth of DSD data is buffered, so memory stays
+ * constant regardless of file length.
+ *
+ * Each channel buffer starts with history_bytes of DSD silence so the
+ * decimation filter has a full window for the first output sample. A
+ * reader positioned mid-stream passes the real preceding data instead and
+ * uses skipLeading() to land inside the first block group or DST frame.
+ */
+class DSDChannelReader {
+public:
+    DSDChannelReader(std::ifstream& file, DSDFormat format, uint32_t channels,
+                     uint32_t block_size, uint64_t data_size, size_t history_bytes)
+        : file_(&file)
+        , format_(format)
+        , channels_(channels)
+        , remaining_(data_size)
+        , channel_data_(channels) {
+        init(block_size, history_bytes);
+    }
+
+    DSDChannelReader(const uint8_t* data, uint64_t data_size, DSDFormat format,
+                     uint32_t channels, uint32_t block_size, size_t history_bytes,
+                     const utils::MappedFile* mapping = nullptr)
+        : memory_(data)
+        , mapping_(mapping)
+        , prefetched_(data)
+        , format_(format)
+        , channels_(channels)
+        , remaining_(data_size)
+        , channel_data_(channels) {
+        init(block_size, history_bytes);
+    }
+
+    DSDChannelReader(DSTFrameSource& source, uint32_t channels, size_t history_bytes)
+        : dst_(&source)
+        , format_(DSDFormat::DSDIFF)
+        , channels_(channels)
+        , remaining_(std::numeric_limits<uint64_t>::max())
+        , channel_data_(channels) {
+        init(static_cast<uint32_t>(source.frameBytes()), history_bytes);
+    }
+
+    /**
+     * @brief Ensure at least min_bytes per channel are buffered
+     * @return Bytes available per channel (less than min_bytes only at end of data)
+     */
+    size_t fill(size_t min_bytes) {
+        while (available() < min_bytes && remaining_ > 0) {
+            compact();
+            if (!readFrame()) {
+                break;
+            }
+        }
+        return available();
+    }
+
+    size_t available() const {
+        return channel_data_.empty() ? 0 : channel_data_[0].size() - read_pos_;
+    }
+
+    const uint8_t* channelData(uint32_t ch) const {
+        return channel_data_[ch].data() + read_pos_;
+    }
+
+    void consume(size_t bytes) {
+        read_pos_ += bytes;
+    }
+
+    /**
+     * @brief Report the read position to a read-ahead (file or mapping readers)
+     * @param file_offset File offset of the next byte read
+     */
+    void setReadAhead(utils::ReadAhead* read_ahead, uint64_t file_offset) {
+        read_ahead_ = read_ahead;
+        file_offset_ = file_offset;
+        if (read_ahead_) {
+            read_ahead_->advance(file_offset_);
+        }
+    }
+
+    /**
+     * @brief Drop the first bytes of every channel from the next planar group
+     * (a position inside a DSF block or DST frame; call before fill())
+     */
+    void skipLeading(size_t bytes) {
+        skip_ = std::min<size_t>(bytes, frame_bytes_);
+    }
+
+private:
+    void init(uint32_t block_size, size_t history_bytes) {
+        frame_bytes_ = (format_ == DSDFormat::DSF || dst_) ? block_size : DSDIFF_FRAME_BYTES;
+        group_bytes_ = static_cast<size_t>(frame_bytes_) * channels_;
+        if (file_) {
+            raw_.resize(group_bytes_);
+        }
+        for (auto& data : channel_data_) {
+            data.reserve(history_bytes + frame_bytes_ * 2);
+            data.assign(history_bytes, audio::DSDDecimator::SILENCE_BYTE);
+        }
+    }
+
+    void compact() {
+        if (read_pos_ == 0) {
+            return;
+        }
+        for (auto& data : channel_data_) {
+            data.erase(data.begin(), data.begin() + read_pos_);
+        }
+        read_pos_ = 0;
+    }
+
+    bool readFrame() {
+        if (dst_) {
+            const uint8_t* frame = dst_->next();
+            if (!frame) {
+                remaining_ = 0;
+                return false;
+            }
+            appendPlanar(frame);
+            return true;
+        }
+
+        size_t want = static_cast<size_t>(std::min<uint64_t>(group_bytes_, remaining_));
+        const uint8_t* src = nullptr;
+        size_t got = 0;
+
+        if (file_) {
+            file_->read(reinterpret_cast<char*>(raw_.data()), want);
+            got = static_cast<size_t>(file_->gcount());
+            src = raw_.data();
+        } else {
+            got = want;
+            src = memory_;
+            memory_ += got;
+            prefetchAhead();
+        }
+        remaining_ = (got < want) ? 0 : remaining_ - got;
+        if (read_ahead_) {
+            file_offset_ += got;
+            read_ahead_->advance(file_offset_);
+        }
+
+        size_t per_channel = got / channels_;
+        if (format_ == DSDFormat::DSF && got < group_bytes_) {
+            // DSF groups are block-sequential, so a partial group has no usable layout
+            per_channel = 0;
+        }
+        if (per_channel == 0) {
+            if (got > 0) {
+                LOG_WARN("Truncated DSD data: dropping {} trailing bytes", got);
+            }
+            remaining_ = 0;
+            return false;
+        }
+
+        if (format_ == DSDFormat::DSF) {
+            appendPlanar(src);
+        } else {
+            // DSDIFF: bytes interleaved by channel
+            for (uint32_t ch = 0; ch < channels_; ++ch) {
+                auto& data = channel_data_[ch];
+                size_t base = data.size();
+                data.resize(base + per_channel);
+                const uint8_t* channel_src = src + ch;
+                for (size_t i = 0; i < per_channel; ++i) {
+                    data[base + i] = channel_src[i * channels_];
+                }
+            }
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief Append one planar group: [ch0 block][ch1 block]... (DSF, decoded DST)
+     */
+    void appendPlanar(const uint8_t* src) {
+        for (uint32_t ch = 0; ch < channels_; ++ch) {
+            const uint8_t* block = src + static_cast<size_t>(ch) * frame_bytes_;
+            channel_data_[ch].insert(channel_data_[ch].end(), block + skip_, block + frame_bytes_);
+        }
+        skip_ = 0;
+    }
+
+    /**
+     * @brief Keep about DSD_READAHEAD_BYTES of the mapping ahead of the read position
+     */
+    void prefetchAhead() {
+        if (!mapping_ || memory_ + DSD_READAHEAD_BYTES / 2 < prefetched_) {
+            return;
+        }
+        prefetched_ = std::max(prefetched_, memory_);
+        mapping_->prefetch(static_cast<uint64_t>(prefetched_ - mapping_->data()), DSD_READAHEAD_BYTES);
+        prefetched_ += DSD_READAHEAD_BYTES;
+    }
+
+    std::ifstream* file_ = nullptr;
+    DSTFrameSource* dst_ = nullptr;
+    const uint8_t* memory_ = nullptr;
+    const utils::MappedFile* mapping_ = nullptr;
+    const uint8_t* prefetched_ = nullptr;  // End of the range already prefetched
+    utils::ReadAhead* read_ahead_ = nullptr;
+    uint64_t file_offset_ = 0;             // File position of the next read (read-ahead)
+    DSDFormat format_;
+    uint32_t channels_;
+    uint32_t frame_bytes_ = 0;
+    size_t group_bytes_ = 0;
+    uint64_t remaining_;
+    size_t read_pos_ = 0;
+    size_t skip_ = 0;  // Leading bytes per channel to drop from the next planar group
+    std::vector<uint8_t> raw_;
+    std::vector<std::vector<uint8_t>> channel_data_;
+};
+
+/**
+ * @brief Decode DSD from a channel reader into interleaved float chunks
+ *
+ * With workers, each refill decodes one chunk per worker at once: the frame
+ * range is split into contiguous slices (all channels per slice, so output
+ * writes never share cache lines across threads), then the chunks are handed
+ * to the callback in order.
+ *
+ * @return Number of frames delivered to the callback
+ */
+uint64_t decodeFrames(DSDChannelReader& reader, const audio::DSDDecimator& decimator,
+                      uint32_t channels, uint64_t total_frames, size_t chunk_frames,
+                      const DSDStreamingCallback& callback, DecodeWorkers* workers = nullptr) {
+    const size_t stride = decimator.getStrideBytes();
+    const size_t history = decimator.getHistoryBytes();
+    const size_t worker_count = workers ? workers->size() : 1;
+    const size_t batch_frames = chunk_frames * worker_count;
+
+    std::vector<float> batch_buffer(batch_frames * channels);
+    uint64_t frames_decoded = 0;
+    int chunk_count = 0;
+    bool stopped = false;
+
+    while (frames_decoded < total_frames && !stopped) {
+        // Buffer enough block groups for one full batch (less only at end of data)
+        size_t available = reader.fill(batch_frames * stride + history);
+        size_t frames = std::min<uint64_t>({available > history ? (available - history) / stride : 0,
+                                            batch_frames,
+                                            total_frames - frames_decoded});
+        if (frames == 0) {
+            LOG_WARN("DSD data ended after {} of {} frames", frames_decoded, total_frames);
+            break;
+        }
+
+        auto decodeSlice = [&](size_t begin, size_t end) {
+            for (uint32_t ch = 0; ch < channels; ++ch) {
+                decimator.process(reader.channelData(ch) + begin * stride, end - begin,
+                                  batch_buffer.data() + begin * channels + ch, channels);
+            }
+        };
+
+        if (worker_count > 1) {
+            const size_t slice = (frames + worker_count - 1) / worker_count;
+            workers->run([&](size_t index) {
+                size_t begin = std::min(frames, index * slice);
+                size_t end = std::min(frames, begin + slice);
+                if (begin < end) {
+                    decodeSlice(begin, end);
+                }
+            });
+        } else {
+            decodeSlice(0, frames);
+        }
+
+        reader.consume(frames * stride);
+
+        // Hand out the batch in chunk-sized pieces, in order
+        for (size_t offset = 0; offset < frames; offset += chunk_frames) {
+            size_t n = std::min(chunk_frames, frames - offset);
+
+            chunk_count++;
+            if (chunk_count <= 5) {
+                LOG_INFO("Output chunk {}: {} samples ({} bytes)",
+                         chunk_count, n * channels, n * channels * sizeof(float));
+            }
+
+            frames_decoded += n;
+            if (!callback(batch_buffer.data() + offset * channels, n * channels)) {
+                LOG_INFO("Streaming stopped by callback");
+                stopped = true;
+                break;
+            }
+        }
+    }
+
+    return frames_decoded;
+}
+
+/**
+ * @brief Decode DSD and pass it through the rational polyphase stage
+ *
+ * Decimated chunks are resampled as they are produced and forwarded to the
+ * callback (frame-aligned, sizes follow the resampling ratio); the filter
+ * tail is flushed at the end. Without a resampler this is decodeFrames().
+ *
+ * @return Number of output frames delivered to the callback
+ */
+uint64_t decodeAndResample(DSDChannelReader& reader, const audio::DSDDecimator& decimator,
+                           uint32_t channels, uint64_t total_frames, size_t chunk_frames,
+                           const DSDStreamingCallback& callback, DecodeWorkers* workers,
+                           audio::PolyphaseResampler* resampler) {
+    if (!resampler) {
+        return decodeFrames(reader, decimator, channels, total_frames, chunk_frames,
+                            callback, workers);
+    }
+
+    std::vector<float> resampled;
+    uint64_t output_frames = 0;
+    bool stopped = false;
+
+    auto forward = [&](const float* data, size_t samples) {
+        resampler->process(data, samples / channels, resampled);
+        if (resampled.empty()) {
+            return true;
+        }
+        output_frames += resampled.size() / channels;
+        stopped = !callback(resampled.data(), resampled.size());
+        return !stopped;
+    };
+
+    decodeFrames(reader, decimator, channels, total_frames, chunk_frames, forward, workers);
+
+    if (!stopped) {
+        resampler->flush(resampled);
+        if (!resampled.empty()) {
+            output_frames += resampled.size() / channels;
+            callback(resampled.data(), resampled.size());
+        }
+    }
+
+    return output_frames;
+}
+
+/**
+ * @brief Pack DSD from a channel reader into interleaved DoP chunks
+ *
+ * Every frame takes two bytes per channel straight from the reader; the
+ * marker phase follows the absolute frame index (counted from first_frame
+ * when the reader starts mid-stream) so it alternates across chunk
+ * boundaries and matches a decode from the start.
+ *
+ * @return Number of frames delivered to the callback
+ */
+uint64_t encodeDoPFrames(DSDChannelReader& reader, const audio::DoPEncoder& encoder,
+                         uint32_t channels, uint64_t total_frames, size_t chunk_frames,
+                         const DSDStreamingCallback& callback, uint64_t first_frame = 0) {
+    const size_t stride = audio::DoPEncoder::BYTES_PER_FRAME;
+
+    std::vector<float> chunk_buffer(chunk_frames * channels);
+    uint64_t frames_encoded = 0;
+    int chunk_count = 0;
+
+    while (frames_encoded < total_frames) {
+        size_t available = reader.fill(chunk_frames * stride);
+        size_t frames = std::min<uint64_t>({available / stride, chunk_frames,
+                                            total_frames - frames_encoded});
+        if (frames == 0) {
+            LOG_WARN("DSD data ended after {} of {} DoP frames", frames_encoded, total_frames);
+            break;
+        }
+
+        for (uint32_t ch = 0; ch < channels; ++ch) {
+            encoder.process(reader.channelData(ch), frames, first_frame + frames_encoded,
+                            chunk_buffer.data() + ch, channels);
+        }
+        reader.consume(frames * stride);
+
+        chunk_count++;
+        if (chunk_count <= 5) {
+            LOG_INFO("Output DoP chunk {}: {} samples ({} bytes)",
+                     chunk_count, frames * channels, frames * channels * sizeof(float));
+        }
+
+        frames_encoded += frames;
+        if (!callback(chunk_buffer.data(), frames * channels)) {
+            LOG_INFO("Streaming stopped by callback");
+            break;
+        }
+    }
+
+    return frames_encoded;
+}
+
+/**
+ * @brief Implementation class
+ */
+class DSDDecoder::Impl {
+public:
+    protocol::AudioMetadata metadata;
+    std::vector<uint8_t> pcm_data;
+    std::vector<uint8_t> dsd_data;
+    bool loaded = false;
+    int target_sample_rate = 0;  // Target sample rate (0 = DSD rate / decimation)
+    int dsd_decimation = 16;  // Default DSD decimation factor (16, 32, or 64)
+    audio::DSDFilterMode filter_mode = audio::DSDFilterMode::Filtered;
+    int decode_threads = 1;  // Worker threads for DSD decoding (1 = serial)
+    DSDOutputMode output_mode = DSDOutputMode::PCM;
+    double start_seconds = 0.0;     // Streaming range start (seek())
+    double range_seconds = 0.0;     // Streaming range length (0 = to the end)
+
+    uint32_t dsd_rate = 0;       // DSD sample rate (e.g., 2822400 for DSD64)
+    uint32_t channels = 0;
+    uint64_t dsd_sample_count = 0;
+    uint32_t block_size = 0;     // Block size per channel (for DSF format)
+    bool dst = false;            // DSDIFF sound data is DST-compressed
+
+    // Streaming support
+    std::ifstream dsd_file;
+    utils::MappedFile mapped_file;  // Shared read-only view of the whole file
+    uint64_t dsd_data_offset = 0;  // Offset to DSD data in file
+    uint64_t dsd_data_size = 0;    // Size of DSD data
+    DSDFormat format = DSDFormat::None;
+    std::unique_ptr<DSTFrameSource> dst_source;  // Frame decoder behind the current reader (DST only)
+    utils::ReadAheadConfig read_ahead_config;     // Disabled by default
+    std::unique_ptr<utils::ReadAhead> read_ahead;  // Over the data chunk while streaming from the file
+
+    /**
+     * @brief Map the file so the decoder reads the data chunk in place
+     * @return false if mapping failed (callers fall back to stream reads)
+     */
+    bool mapData(const std::string& filepath) {
+        if (mapped_file.open(filepath) != ErrorCode::Success) {
+            LOG_WARN("Failed to map DSD file, falling back to buffered reads");
+            return false;
+        }
+        if (dsd_data_offset >= mapped_file.size()) {
+            LOG_WARN("DSD data offset {} beyond end of file ({} bytes)", dsd_data_offset, mapped_file.size());
+            mapped_file.close();
+            return false;
+        }
+        if (dsd_data_size > mapped_file.size() - dsd_data_offset) {
+            LOG_WARN("DSD data chunk truncated: {} of {} bytes present",
+                     mapped_file.size() - dsd_data_offset, dsd_data_size);
+            dsd_data_size = mapped_file.size() - dsd_data_offset;
+        }
+
+        mapped_file.adviseSequential(dsd_data_offset, dsd_data_size);
+        mapped_file.prefetch(dsd_data_offset, DSD_READAHEAD_BYTES);
+        LOG_INFO("DSD data mapped: {} bytes at offset {}", dsd_data_size, dsd_data_offset);
+        startReadAhead(filepath);
+        return true;
+    }
+
+    /**
+     * @brief Start reading the data chunk ahead of the readers (if configured)
+     */
+    void startReadAhead(const std::string& filepath) {
+        read_ahead.reset();
+        if (!read_ahead_config.enabled() || dsd_data_size == 0) {
+            return;
+        }
+        auto ahead = std::make_unique<utils::ReadAhead>(read_ahead_config);
+        if (ahead->open(filepath, dsd_data_offset, dsd_data_size) == ErrorCode::Success) {
+            read_ahead = std::move(ahead);
+        }
+    }
+
+    bool hasData() const {
+        return mapped_file.isOpen() || !dsd_data.empty() || dsd_file.is_open();
+    }
+
+    /**
+     * @brief Take over the stream layout parsed from a DSDIFF file
+     */
+    void applyDSDIFFInfo(const DSDIFFInfo& info, const std::string& filepath) {
+        format = DSDFormat::DSDIFF;
+        channels = info.channels;
+        dsd_rate = info.sample_rate;
+        dst = info.dst;
+        dsd_data_offset = info.data_offset;
+        dsd_data_size = info.data_size;
+        // DST frames are 1/75 s; plain DSD is byte-interleaved, 8 samples per byte
+        dsd_sample_count = dst ? static_cast<uint64_t>(info.dst_frames) * (dsd_rate / info.dst_frame_rate)
+                               : dsd_data_size / channels * 8;
+
+        double duration = static_cast<double>(dsd_sample_count) / dsd_rate;
+
+        metadata.file_path = filepath;
+        metadata.channels = channels;
+        // Store ORIGINAL DSD rate (for information)
+        metadata.original_sample_rate = dsd_rate;
+        metadata.original_bit_depth = 1; // DSD is 1-bit
+        metadata.format = "DSDIFF";
+        metadata.format_name = dst ? "DSDIFF (DST)" : "DSDIFF";
+        metadata.is_lossless = true;
+        metadata.duration = duration;
+        // Sample count will be updated after actual conversion
+        metadata.sample_count = 0;
+
+        LOG_INFO("DSDIFF Properties:");
+        LOG_INFO("  Channels: {}", channels);
+        LOG_INFO("  DSD Rate: {} Hz ({}x oversampling)", dsd_rate, dsd_rate / 44100);
+        LOG_INFO("  Compression: {}", dst ? "DST" : "none");
+        if (dst) {
+            LOG_INFO("  DST frames: {} ({} per second)", info.dst_frames, info.dst_frame_rate);
+        }
+        LOG_INFO("  Samples: {}", dsd_sample_count);
+        LOG_INFO("  Duration: {:.2f} seconds", duration);
+        LOG_INFO("  Data offset: {} bytes", dsd_data_offset);
+        LOG_INFO("  Data size: {} bytes", dsd_data_size);
+    }
+
+    /**
+     * @brief Reader over the data chunk: mapping, in-memory copy or open file
+     *
+     * DST data is decoded frame by frame (in parallel on workers, if given)
+     * and needs the chunk in memory, so without a mapping it is read in first.
+     *
+     * start_byte positions the reader mid-stream (bytes per channel): the
+     * buffer then begins history_bytes earlier with real data, so filter
+     * output from there on matches a decode from the start. DSF seeks to the
+     * enclosing block group, DSDIFF straight to the byte, and DST walks the
+     * frame headers to the enclosing frame.
+     */
+    DSDChannelReader createReader(size_t history_bytes, DecodeWorkers* workers = nullptr,
+                                  uint64_t start_byte = 0) {
+        // Data byte the buffer starts at, and the silence still needed before it
+        const uint64_t begin = start_byte > history_bytes ? start_byte - history_bytes : 0;
+        const size_t prefix = static_cast<size_t>(history_bytes - (start_byte - begin));
+
+        if (dst) {
+            if (!mapped_file.isOpen() && dsd_data.empty() && dsd_file.is_open()) {
+                dsd_file.clear();
+                dsd_file.seekg(dsd_data_offset);
+                dsd_data.resize(dsd_data_size);
+                dsd_file.read(reinterpret_cast<char*>(dsd_data.data()), dsd_data_size);
+                dsd_data.resize(static_cast<size_t>(dsd_file.gcount()));
+            }
+            if (mapped_file.isOpen()) {
+                dst_source = std::make_unique<DSTFrameSource>(mapped_file.data() + dsd_data_offset,
+                                                              dsd_data_size, channels, dsd_rate,
+                                                              workers, &mapped_file);
+                dst_source->setReadAhead(read_ahead.get(), dsd_data_offset);
+            } else {
+                dst_source = std::make_unique<DSTFrameSource>(dsd_data.data(), dsd_data.size(),
+                                                              channels, dsd_rate, workers);
+            }
+            const uint64_t frame_bytes = dst_source->frameBytes();
+            dst_source->skipFrames(begin / frame_bytes);
+            DSDChannelReader reader(*dst_source, channels, prefix);
+            reader.skipLeading(static_cast<size_t>(begin % frame_bytes));
+            return reader;
+        }
+
+        // Byte offset into the data chunk, and the remainder inside a DSF block
+        uint64_t offset = begin * channels;
+        size_t in_block = 0;
+        if (format == DSDFormat::DSF) {
+            offset = begin / block_size * block_size * channels;
+            in_block = static_cast<size_t>(begin % block_size);
+        }
+
+        if (mapped_file.isOpen()) {
+            offset = std::min(offset, dsd_data_size);
+            DSDChannelReader reader(mapped_file.data() + dsd_data_offset + offset,
+                                    dsd_data_size - offset, format, channels, block_size,
+                                    prefix, &mapped_file);
+            reader.setReadAhead(read_ahead.get(), dsd_data_offset + offset);
+            reader.skipLeading(in_block);
+            return reader;
+        }
+        if (!dsd_data.empty()) {
+            offset = std::min<uint64_t>(offset, dsd_data.size());
+            DSDChannelReader reader(dsd_data.data() + offset, dsd_data.size() - offset, format,
+                                    channels, block_size, prefix);
+            reader.skipLeading(in_block);
+            return reader;
+        }
+        offset = std::min(offset, dsd_data_size);
+        dsd_file.clear();
+        dsd_file.seekg(static_cast<std::streamoff>(dsd_data_offset + offset));
+        DSDChannelReader reader(dsd_file, format, channels, block_size, dsd_data_size - offset, prefix);
+        reader.setReadAhead(read_ahead.get(), dsd_data_offset + offset);
+        reader.skipLeading(in_block);
+        return reader;
+    }
+
+    /**
+     * @brief Drop the mapping / in-memory copy once batch decoding is done
+     */
+    void releaseData() {
+        dst_source.reset();
+        read_ahead.reset();
+        mapped_file.close();
+        std::vector<uint8_t>().swap(dsd_data);
+    }
+
+    /**
+     * @brief Rate after integer decimation (44.1k family for standard DSD rates)
+     */
+    uint32_t intermediateSampleRate() const {
+        return dsd_rate / dsd_decimation;
+    }
+
+    /**
+     * @brief Final output rate: the target if the polyphase stage can reach it
+     * (DoP always runs at DSD rate / 16)
+     */
+    uint32_t outputSampleRate() const {
+        if (output_mode == DSDOutputMode::DoP) {
+            return dsd_rate / 16;
+        }
+        const uint32_t intermediate = intermediateSampleRate();
+        if (target_sample_rate <= 0 ||
+            !audio::PolyphaseResampler::isSupportedRatio(intermediate, target_sample_rate)) {
+            return intermediate;
+        }
+        return static_cast<uint32_t>(target_sample_rate);
+    }
+
+    /**
+     * @brief Create the rational polyphase stage (nullptr when not needed)
+     */
+    std::unique_ptr<audio::PolyphaseResampler> createResampler() const {
+        const uint32_t intermediate = intermediateSampleRate();
+        const uint32_t output = outputSampleRate();
+        if (output == intermediate) {
+            return nullptr;
+        }
+
+        auto resampler = std::make_unique<audio::PolyphaseResampler>();
+        if (resampler->init(intermediate, output, channels) != ErrorCode::Success) {
+            return nullptr;
+        }
+        LOG_INFO("DSD polyphase stage: {} Hz -> {} Hz (L/M = {}/{}, {} taps per phase)",
+                 intermediate, output, resampler->getUpFactor(), resampler->getDownFactor(),
+                 resampler->getTapsPerPhase());
+        return resampler;
+    }
+
+    /**
+     * @brief Output frames covered by the streaming range, given the full length
+     * @param first Set to the first output frame of the range
+     */
+    uint64_t rangeFrames(uint64_t total, uint32_t rate, uint64_t& first) const {
+        first = std::min<uint64_t>(static_cast<uint64_t>(std::llround(start_seconds * rate)), total);
+        uint64_t count = total - first;
+        if (range_seconds > 0.0) {
+            count = std::min<uint64_t>(count, static_cast<uint64_t>(std::llround(range_seconds * rate)));
+        }
+        return count;
+    }
+
+    /**
+     * @brief Size the batch PCM buffer once for the exact output length
+     *
+     * Any previous buffer is released first, so a reload never holds two
+     * decoded tracks at once.
+     * @return false if the allocation failed
+     */
+    bool reservePCM(uint64_t frames) {
+        std::vector<uint8_t>().swap(pcm_data);
+        const uint64_t bytes = frames * channels * sizeof(float);
+        try {
+            pcm_data.reserve(static_cast<size_t>(bytes));
+        } catch (const std::bad_alloc&) {
+            LOG_ERROR("Cannot allocate {} bytes for {} decoded frames", bytes, frames);
+            releaseData();
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Expected output frames for a given number of decimated frames
+     */
+    uint64_t outputFrames(uint64_t decimated_frames) const {
+        const uint64_t intermediate = intermediateSampleRate();
+        const uint64_t output = outputSampleRate();
+        return (decimated_frames * output + intermediate - 1) / intermediate;
+    }
+};
+
+DSDDecoder::DSDDecoder()
+    : impl_(std::make_unique<Impl>()) {}
+
+DSDDecoder::~DSDDecoder() = default;
+
+void DSDDecoder::setTargetSampleRate(int sample_rate) {
+    impl_->target_sample_rate = sample_rate > 0 ? sample_rate : 0;
+    LOG_INFO("Target sample rate set to: {}", sample_rate);
+}
+
+void DSDDecoder::setDSDDecimation(int factor) {
+    if (factor != 16 && factor != 32 && factor != 64) {
+        LOG_ERROR("Invalid DSD decimation factor: {}, must be 16, 32, or 64", factor);
+        return;
+    }
+    impl_->dsd_decimation = factor;
+    LOG_INFO("DSD decimation factor set to: {}", factor);
+}
+
+void DSDDecoder::setDSDFilterMode(audio::DSDFilterMode mode) {
+    impl_->filter_mode = mode;
+    LOG_INFO("DSD filter mode set to: {}", mode == audio::DSDFilterMode::Fast ? "fast" : "filtered");
+}
+
+void DSDDecoder::setDecodeThreads(int threads) {
+    if (threads <= 0) {
+        threads = std::max(1, utils::PlatformUtils::getCPUCount());
+    }
+    impl_->decode_threads = threads;
+    LOG_INFO("DSD decode threads set to: {}", threads);
+}
+
+void DSDDecoder::setReadAhead(const utils::ReadAheadConfig& config) {
+    impl_->read_ahead_config = config;
+}
+
+void DSDDecoder::setOutputMode(DSDOutputMode mode) {
+    impl_->output_mode = mode;
+    LOG_INFO("DSD output mode set to: {}", mode == DSDOutputMode::DoP ? "dop" : "pcm");
+}
+
+ErrorCode DSDDecoder::seek(double start_seconds, double duration_seconds) {
+    if (impl_->dsd_rate == 0) {
+        LOG_ERROR("seek() called without prepareStreaming()");
+        return ErrorCode::InvalidOperation;
+    }
+
+    const double length = static_cast<double>(impl_->dsd_sample_count) / impl_->dsd_rate;
+    if (!(start_seconds >= 0.0) || !(duration_seconds >= 0.0) ||
+        (start_seconds > 0.0 && start_seconds >= length)) {
+        LOG_ERROR("Invalid range: start {:.3f} s, duration {:.3f} s (file is {:.3f} s)",
+                  start_seconds, duration_seconds, length);
+        return ErrorCode::InvalidArgument;
+    }
+
+    impl_->start_seconds = start_seconds;
+    impl_->range_seconds = duration_seconds;
+
+    const double remaining = length - start_seconds;
+    impl_->metadata.duration = duration_seconds > 0.0 ? std::min(duration_seconds, remaining) : remaining;
+    LOG_INFO("Streaming range: start {:.3f} s, duration {:.3f} s", start_seconds, impl_->metadata.duration);
+    return ErrorCode::Success;
+}
+
+DSDFormat DSDDecoder::detectFormat(const std::string& filepath) {
+    std::ifstream file(filepath, std::ios::binary);
+    if (!file) {
+        return DSDFormat::DSF; // Default
+    }
+
+    char id[4];
+    file.read(id, 4);
+
+    if (std::memcmp(id, "DSD ", 4) == 0) {
+        return DSDFormat::DSF;
+    } else if (std::memcmp(id, "FRM8", 4) == 0) {
+        return DSDFormat::DSDIFF;
+    }
+
+    // Check extension
+    if (filepath.size() > 4) {
+        std::string ext = filepath.substr(filepath.size() - 4);
+        std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+        if (ext == ".dsf") return DSDFormat::DSF;
+        if (ext == ".dff") return DSDFormat::DSDIFF;
+    }
+
+    return DSDFormat::DSF; // Default
+}
+
+ErrorCode DSDDecoder::load(const std::string& filepath) {
+    LOG_INFO("Loading DSD file: {}", filepath);
+
+    DSDFormat format = detectFormat(filepath);
+
+    if (format == DSDFormat::DSF) {
+        return parseDSF(filepath);
+    } else {
+        return parseDSDIFF(filepath);
+    }
+}
+
+ErrorCode DSDDecoder::parseDSF(const std::string& filepath) {
+    std::ifstream file(filepath, std::ios::binary);
+    if (!file) {
+        LOG_ERROR("Failed to open DSD file: {}", filepath);
+        return ErrorCode::FileReadError;
+    }
+
+    // Read DSF header
+    DSFHeader header;
+    file.read(reinterpret_cast<char*>(&header), sizeof(DSFHeader));
+
+    if (std::memcmp(header.id, "DSD ", 4) != 0) {
+        LOG_ERROR("Invalid DSF file format");
+        return ErrorCode::UnsupportedFormat;
+    }
+
+    // Read format chunk
+    DSFFmtChunk fmt;
+    file.read(reinterpret_cast<char*>(&fmt), sizeof(DSFFmtChunk));
+
+    if (std::memcmp(fmt.id, "fmt ", 4) != 0) {
+        LOG_ERROR("Invalid DSF format chunk");
+        return ErrorCode::CorruptedFile;
+    }
+
+    // Validate DSD format
+    if (fmt.format_id != 0) {
+        LOG_ERROR("Unsupported DSD format ID: {}", fmt.format_id);
+        return ErrorCode::UnsupportedFormat;
+    }
+
+    // Store metadata
+    impl_->format = DSDFormat::DSF;
+    impl_->channels = fmt.channel_num;
+    impl_->dsd_rate = fmt.sampling_freq;
+    impl_->dsd_sample_count = fmt.sample_count;
+    impl_->block_size = fmt.block_size;
+
+    impl_->metadata.channels = fmt.channel_num;
+    // Store ORIGINAL DSD rate (for information)
+    impl_->metadata.original_sample_rate = fmt.sampling_freq;
+    // OUTPUT sample rate will be set by decodeDSDToPCM()
+    impl_->metadata.sample_rate = 0;
+    impl_->metadata.bit_depth = 1; // DSD is 1-bit
+    impl_->metadata.original_bit_depth = 1;
+    impl_->metadata.format = "DSD";
+    impl_->metadata.format_name = "DSD";
+
+    // Calculate duration
+    double duration = static_cast<double>(fmt.sample_count) / fmt.sampling_freq;
+    impl_->metadata.duration = duration;
+    // Sample count will be updated by decodeDSDToPCM after conversion
+    impl_->metadata.sample_count = 0;
+
+    LOG_INFO("DSD Format: DSF");
+    LOG_INFO("  Channels: {}", fmt.channel_num);
+    LOG_INFO("  DSD Rate: {} Hz ({}x oversampling)", fmt.sampling_freq, fmt.sampling_freq / 44100);
+    LOG_INFO("  Samples: {}", fmt.sample_count);
+    LOG_INFO("  Duration: {:.2f} seconds", duration);
+
+    // Read data chunk
+    DSFDataChunk data;
+    file.read(reinterpret_cast<char*>(&data), sizeof(DSFDataChunk));
+
+    if (std::memcmp(data.id, "data", 4) != 0) {
+        LOG_ERROR("Invalid DSF data chunk");
+        return ErrorCode::CorruptedFile;
+    }
+
+    // chunk_size includes the 12-byte chunk header
+    impl_->dsd_data_offset = file.tellg();
+    impl_->dsd_data_size = data.chunk_size - sizeof(DSFDataChunk);
+
+    // Decode straight from the mapped file; copy only if mapping fails
+    if (!impl_->mapData(filepath)) {
+        impl_->dsd_data.resize(impl_->dsd_data_size);
+        file.read(reinterpret_cast<char*>(impl_->dsd_data.data()), impl_->dsd_data_size);
+        impl_->dsd_data.resize(static_cast<size_t>(file.gcount()));
+    }
+
+    // Decode DSD to PCM
+    ErrorCode ret = decodeDSDToPCM();
+    if (ret != ErrorCode::Success) {
+        return ret;
+    }
+
+    impl_->loaded = true;
+    LOG_INFO("DSD file loaded and decoded successfully");
+
+    return ErrorCode::Success;
+}
+
+ErrorCode DSDDecoder::parseDSDIFF(const std::string& filepath) {
+    std::ifstream file(filepath, std::ios::binary);
+    if (!file) {
+        LOG_ERROR("Failed to open DSDIFF file: {}", filepath);
+        return ErrorCode::FileReadError;
+    }
+
+    DSDIFFInfo info;
+    ErrorCode ret = readDSDIFFInfo(file, info);
+    if (ret != ErrorCode::Success) {
+        return ret;
+    }
+
+    impl_->applyDSDIFFInfo(info, filepath);
+    // OUTPUT sample rate will be set by decodeDSDToPCM()
+    impl_->metadata.sample_rate = 0;
+    impl_->metadata.bit_depth = 1; // DSD is 1-bit
+
+    // Decode straight from the mapped file; copy only if mapping fails
+    if (!impl_->mapData(filepath)) {
+        file.clear();
+        file.seekg(static_cast<std::streamoff>(impl_->dsd_data_offset));
+        impl_->dsd_data.resize(impl_->dsd_data_size);
+        file.read(reinterpret_cast<char*>(impl_->dsd_data.data()), impl_->dsd_data_size);
+        impl_->dsd_data.resize(static_cast<size_t>(file.gcount()));
+    }
+
+    // Decode DSD to PCM
+    ret = decodeDSDToPCM();
+    if (ret != ErrorCode::Success) {
+        return ret;
+    }
+
+    impl_->loaded = true;
+    LOG_INFO("DSDIFF file loaded and decoded successfully");
+
+    return ErrorCode::Success;
+}
+
+ErrorCode DSDDecoder::decodeDSDToPCM() {
+    LOG_INFO("Decoding DSD to PCM...");
+
+    if (!impl_->hasData() || impl_->dsd_rate == 0 || impl_->channels == 0) {
+        LOG_ERROR("No DSD data to decode");
+        return ErrorCode::InvalidOperation;
+    }
+
+    if (impl_->format == DSDFormat::DSF && impl_->block_size == 0) {
+        LOG_ERROR("Invalid DSF block size: 0");
+        return ErrorCode::CorruptedFile;
+    }
+
+    std::unique_ptr<DecodeWorkers> workers;
+    if (impl_->decode_threads > 1) {
+        workers = std::make_unique<DecodeWorkers>(impl_->decode_threads);
+    }
+
+    if (impl_->output_mode == DSDOutputMode::DoP) {
+        // Raw DSD bits packed into DoP frames, no filtering
+        const uint32_t channels = impl_->channels;
+        const uint64_t total_frames = impl_->dsd_sample_count / 16;
+
+        audio::DoPEncoder encoder(impl_->format == DSDFormat::DSF);
+        if (!impl_->reservePCM(total_frames)) {
+            return ErrorCode::OutOfMemory;
+        }
+        DSDChannelReader reader = impl_->createReader(0, workers.get());
+
+        uint64_t frames_encoded = encodeDoPFrames(reader, encoder, channels, total_frames, 16384,
+            [this](const float* data, size_t samples) {
+                const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data);
+                impl_->pcm_data.insert(impl_->pcm_data.end(), bytes, bytes + samples * sizeof(float));
+                return true;
+            });
+
+        impl_->releaseData();
+
+        impl_->metadata.sample_rate = impl_->outputSampleRate();
+        impl_->metadata.channels = channels;
+        impl_->metadata.bit_depth = 24; // DoP words (carried as float32)
+        impl_->metadata.sample_count = frames_encoded;
+        impl_->metadata.encoding = "dop";
+
+        LOG_INFO("DSD packed to DoP: {} Hz, {} channels, {} frames",
+                 impl_->metadata.sample_rate, channels, frames_encoded);
+
+        return ErrorCode::Success;
+    }
+
+    // Decode with the same filter cascade as streamPCM(): integer decimation to
+    // DSD rate / decimation, then the polyphase stage to the target rate if set
+    const uint32_t decimation_factor = impl_->dsd_decimation;
+    const uint32_t output_sample_rate = impl_->outputSampleRate();
+    const uint32_t channels = impl_->channels;
+    const uint64_t total_output_frames = impl_->dsd_sample_count / decimation_factor;
+
+    audio::DSDDecimator decimator(decimation_factor, impl_->format == DSDFormat::DSF, impl_->filter_mode);
+    if (!impl_->reservePCM(impl_->outputFrames(total_output_frames))) {
+        return ErrorCode::OutOfMemory;
+    }
+    DSDChannelReader reader = impl_->createReader(decimator.getHistoryBytes(), workers.get());
+
+    const size_t chunk_frames = 16384;
+
+    std::unique_ptr<audio::PolyphaseResampler> resampler = impl_->createResampler();
+
+    uint64_t frames_decoded = decodeAndResample(reader, decimator, channels, total_output_frames,
+        chunk_frames, [this](const float* data, size_t samples) {
+            const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data);
+            impl_->pcm_data.insert(impl_->pcm_data.end(), bytes, bytes + samples * sizeof(float));
+            return true;
+        }, workers.get(), resampler.get());
+
+    // Raw DSD is no longer needed once decoded
+    impl_->releaseData();
+
+    // Update metadata with output format
+    impl_->metadata.sample_rate = output_sample_rate;
+    impl_->metadata.channels = channels;
+    impl_->metadata.bit_depth = 32; // 32-bit float output
+    impl_->metadata.sample_count = frames_decoded;
+
+    LOG_INFO("DSD decoding complete:");
+    LOG_INFO("  Output: {} Hz, {} channels, {}-bit float (decimation /{})",
+             output_sample_rate, channels, 32, decimation_factor);
+    LOG_INFO("  Samples: {}", impl_->metadata.sample_count);
+
+    return ErrorCode::Success;
+}
+
+const protocol::AudioMetadata& DSDDecoder::getMetadata() const {
+    return impl_->metadata;
+}
+
+const std::vector<uint8_t>& DSDDecoder::getPCMData() const {
+    return impl_->pcm_data;
+}
+
+ErrorCode DSDDecoder::prepareStreaming(const std::string& filepath) {
+    LOG_INFO("Preparing DSD streaming for: {}", filepath);
+
+    // Detect format
+    impl_->format = detectFormat(filepath);
+
+    // Open file for streaming
+    impl_->dsd_file.open(filepath, std::ios::binary);
+    if (!impl_->dsd_file) {
+        LOG_ERROR("Failed to open DSD file: {}", filepath);
+        return ErrorCode::FileReadError;
+    }
+
+    if (impl_->format == DSDFormat::DSF) {
+        // DSF format parsing
+        LOG_INFO("Detected DSF format");
+
+        // Read DSF header
+        DSFHeader header;
+        impl_->dsd_file.read(reinterpret_cast<char*>(&header), sizeof(DSFHeader));
+
+        if (std::memcmp(header.id, "DSD ", 4) != 0) {
+            LOG_ERROR("Invalid DSF file format");
+            return ErrorCode::UnsupportedFormat;
+        }
+
+        // Read format chunk
+        DSFFmtChunk fmt;
+        impl_->dsd_file.read(reinterpret_cast<char*>(&fmt), sizeof(DSFFmtChunk));
+
+        if (std::memcmp(fmt.id, "fmt ", 4) != 0) {
+            LOG_ERROR("Invalid DSF format chunk");
+            return ErrorCode::CorruptedFile;
+        }
+
+        // Validate DSD format
+        if (fmt.format_id != 0) {
+            LOG_ERROR("Unsupported DSD format ID: {}", fmt.format_id);
+            return ErrorCode::UnsupportedFormat;
+        }
+
+        // Store metadata
+        impl_->channels = fmt.channel_num;
+        impl_->dsd_rate = fmt.sampling_freq;
+        impl_->dsd_sample_count = fmt.sample_count;
+        impl_->block_size = fmt.block_size;
+
+        // Use configurable decimation factor for DSD conversion
+        // Default: /16 (high quality), /32 (if target > 352kHz), /64 (lower quality)
+        // For DSD64 with /16: 2822400 / 16 = 176400 Hz
+        // For DSD64 with /32: 2822400 / 32 = 88200 Hz
+        // For DSD64 with /64: 2822400 / 64 = 44100 Hz
+        const uint32_t intermediate_sample_rate = impl_->dsd_rate / impl_->dsd_decimation;
+
+        LOG_INFO("Using DSD decimation factor: {}", impl_->dsd_decimation);
+        LOG_INFO("Intermediate sample rate: {} Hz (DSD rate {} / {})",
+                 intermediate_sample_rate, impl_->dsd_rate, impl_->dsd_decimation);
+
+        impl_->metadata.file_path = filepath;
+        impl_->metadata.channels = fmt.channel_num;
+        // Store ORIGINAL DSD rate (for information)
+        impl_->metadata.original_sample_rate = fmt.sampling_freq;
+        // Store OUTPUT sample rate (what streamPCM will actually produce)
+        impl_->metadata.sample_rate = impl_->outputSampleRate();
+        impl_->metadata.bit_depth = 32; // 32-bit float output from streamPCM
+        impl_->metadata.original_bit_depth = 1; // DSD is 1-bit
+        impl_->metadata.format = "DSD";
+        impl_->metadata.format_name = "DSD";
+        impl_->metadata.is_lossless = true;
+
+        // Calculate duration based on DSD sample count and rate
+        double duration = static_cast<double>(fmt.sample_count) / fmt.sampling_freq;
+        impl_->metadata.duration = duration;
+        // Sample count will be updated by streamPCM after actual conversion
+        impl_->metadata.sample_count = 0;
+
+        // Mark high-resolution audio
+        if (impl_->metadata.sample_rate >= 96000) {
+            impl_->metadata.is_high_res = true;
+        }
+
+        LOG_INFO("DSD Format: DSF (streaming mode)");
+        LOG_INFO("  Channels: {}", fmt.channel_num);
+        LOG_INFO("  DSD Rate: {} Hz ({}x oversampling)", fmt.sampling_freq, fmt.sampling_freq / 44100);
+        LOG_INFO("  Samples: {}", fmt.sample_count);
+        LOG_INFO("  Block size: {} bytes per channel", fmt.block_size);
+        LOG_INFO("  Duration: {:.2f} seconds", duration);
+        LOG_INFO("  Output metadata: sample_rate={} Hz (DSD64), original_sample_rate={} Hz",
+                 impl_->metadata.sample_rate, impl_->metadata.original_sample_rate);
+
+        // Read data chunk
+        DSFDataChunk data;
+        impl_->dsd_file.read(reinterpret_cast<char*>(&data), sizeof(DSFDataChunk));
+
+        if (std::memcmp(data.id, "data", 4) != 0) {
+            LOG_ERROR("Invalid DSF data chunk");
+            return ErrorCode::CorruptedFile;
+        }
+
+        // Store DSD data location for streaming
+        impl_->dsd_data_offset = impl_->dsd_file.tellg();
+        impl_->dsd_data_size = data.chunk_size - sizeof(DSFDataChunk);
+
+        LOG_INFO("DSD streaming prepared successfully");
+        LOG_INFO("  Data offset: {} bytes", impl_->dsd_data_offset);
+        LOG_INFO("  Data size: {} bytes", impl_->dsd_data_size);
+
+    } else if (impl_->format == DSDFormat::DSDIFF) {
+        // DSDIFF format parsing
+        LOG_INFO("Detected DSDIFF format");
+
+        DSDIFFInfo info;
+        ErrorCode ret = readDSDIFFInfo(impl_->dsd_file, info);
+        if (ret != ErrorCode::Success) {
+            return ret;
+        }
+
+        impl_->applyDSDIFFInfo(info, filepath);
+
+        // Use configurable decimation factor for DSD conversion
+        const uint32_t intermediate_sample_rate = impl_->dsd_rate / impl_->dsd_decimation;
+
+        LOG_INFO("Using DSD decimation factor: {}", impl_->dsd_decimation);
+        LOG_INFO("Intermediate sample rate: {} Hz (DSD rate {} / {})",
+                 intermediate_sample_rate, impl_->dsd_rate, impl_->dsd_decimation);
+
+        // Store OUTPUT sample rate (what streamPCM will actually produce)
+        impl_->metadata.sample_rate = impl_->outputSampleRate();
+        impl_->metadata.bit_depth = 32; // 32-bit float output from streamPCM
+
+        // Mark high-resolution audio
+        if (impl_->metadata.sample_rate >= 96000) {
+            impl_->metadata.is_high_res = true;
+        }
+
+        LOG_INFO("DSDIFF streaming prepared successfully");
+
+    } else {
+        LOG_ERROR("Unknown DSD format");
+        return ErrorCode::UnsupportedFormat;
+    }
+
+    // Stream the data chunk from a shared mapping; the ifstream stays as fallback
+    if (!impl_->mapData(filepath)) {
+        impl_->startReadAhead(filepath);
+    }
+
+    if (impl_->output_mode == DSDOutputMode::DoP) {
+        impl_->metadata.sample_rate = impl_->outputSampleRate();
+        impl_->metadata.bit_depth = 24; // DoP words (carried as float32)
+        impl_->metadata.encoding = "dop";
+        impl_->metadata.is_high_res = true;
+        if (impl_->target_sample_rate > 0) {
+            LOG_WARN("Target sample rate {} Hz ignored in DoP mode (output {} Hz)",
+                     impl_->target_sample_rate, impl_->metadata.sample_rate);
+        }
+        LOG_INFO("DoP output: {} Hz, {} channels", impl_->metadata.sample_rate, impl_->channels);
+    } else if (impl_->target_sample_rate > 0 &&
+        impl_->outputSampleRate() != static_cast<uint32_t>(impl_->target_sample_rate)) {
+        LOG_WARN("Target sample rate {} Hz is not reachable from {} Hz with the polyphase stage, "
+                 "keeping {} Hz", impl_->target_sample_rate, impl_->intermediateSampleRate(),
+                 impl_->intermediateSampleRate());
+    }
+
+    return ErrorCode::Success;
+}
+
+ErrorCode DSDDecoder::streamPCM(DSDStreamingCallback callback, size_t chunk_size_bytes) {
+    // Check if prepareStreaming() was called
+    if (!impl_->dsd_file.is_open()) {
+        LOG_ERROR("streamPCM() called without prepareStreaming()");
+        return ErrorCode::InvalidOperation;
+    }
+
+    LOG_INFO("Streaming DSD to PCM in chunks: {} bytes", chunk_size_bytes);
+
+    // Output keeps the file's channel layout (matches the metadata emitted after prepareStreaming)
+    const uint32_t channels = impl_->channels;
+
+    // Use configurable decimation factor for DSD conversion
+    // The decimation factor determines how much we reduce the DSD sample rate
+    // Default: /16 (high quality), /32 (if target > 352kHz), /64 (lower quality)
+    const uint32_t decimation_factor = impl_->dsd_decimation;
+
+    if (impl_->dsd_rate == 0) {
+        LOG_ERROR("Invalid DSD rate: 0");
+        return ErrorCode::InvalidArgument;
+    }
+
+    if (channels == 0) {
+        LOG_ERROR("Invalid channel count: 0");
+        return ErrorCode::InvalidOperation;
+    }
+
+    if (impl_->format == DSDFormat::DSF && impl_->block_size == 0) {
+        LOG_ERROR("Invalid DSF block size: 0");
+        return ErrorCode::CorruptedFile;
+    }
+
+    const uint32_t intermediate_sample_rate = impl_->dsd_rate / decimation_factor;
+
+    LOG_INFO("Using DSD decimation factor: {}", decimation_factor);
+    LOG_INFO("Intermediate sample rate: {} Hz (DSD rate {} / {})",
+             intermediate_sample_rate, impl_->dsd_rate, decimation_factor);
+
+    // Check for empty data
+    if (impl_->dsd_data_size == 0) {
+        LOG_ERROR("DSD data size is 0, nothing to decode");
+        return ErrorCode::InvalidOperation;
+    }
+
+    // Output frames = DSD samples per channel / decimation factor
+    const uint64_t total_output_frames = impl_->dsd_sample_count / decimation_factor;
+
+    // Update metadata with output format
+    // Integer decimation to intermediate_sample_rate, then the polyphase stage to the target
+    impl_->metadata.sample_rate = impl_->outputSampleRate();
+    impl_->metadata.channels = channels;
+    impl_->metadata.bit_depth = 32; // 32-bit float output
+    impl_->metadata.sample_count = impl_->outputFrames(total_output_frames);
+
+    // Chunks always hold whole interleaved frames
+    size_t chunk_frames = chunk_size_bytes / (sizeof(float) * channels);
+    if (chunk_frames == 0) {
+        LOG_ERROR("Invalid chunk size: {} bytes (smaller than one {}-channel frame)",
+                  chunk_size_bytes, channels);
+        return ErrorCode::InvalidArgument;
+    }
+
+    // Prevent excessively large chunks that could cause memory issues
+    const size_t MAX_CHUNK_SAMPLES = 10 * 1024 * 1024;  // 10M samples = 40MB
+    if (chunk_frames * channels > MAX_CHUNK_SAMPLES) {
+        LOG_ERROR("Chunk size {} samples exceeds maximum {} samples",
+                  chunk_frames * channels, MAX_CHUNK_SAMPLES);
+        return ErrorCode::InvalidArgument;
+    }
+
+    std::unique_ptr<DecodeWorkers> workers;
+    if (impl_->decode_threads > 1) {
+        workers = std::make_unique<DecodeWorkers>(impl_->decode_threads);
+        LOG_INFO("DSD decoding with {} threads", impl_->decode_threads);
+    }
+
+    if (impl_->output_mode == DSDOutputMode::DoP) {
+        // Each DoP frame carries 2 bytes per channel, so the range starts on a byte boundary
+        uint64_t first_dop_frame = 0;
+        const uint64_t total_dop_frames = impl_->rangeFrames(impl_->dsd_sample_count / 16,
+                                                             impl_->outputSampleRate(), first_dop_frame);
+
+        impl_->metadata.sample_rate = impl_->outputSampleRate();
+        impl_->metadata.bit_depth = 24; // DoP words (carried as float32)
+        impl_->metadata.sample_count = total_dop_frames;
+        impl_->metadata.encoding = "dop";
+
+        audio::DoPEncoder encoder(impl_->format == DSDFormat::DSF);
+        DSDChannelReader reader = impl_->createReader(0, workers.get(),
+                                                      first_dop_frame * audio::DoPEncoder::BYTES_PER_FRAME);
+
+        uint64_t frames_encoded = encodeDoPFrames(reader, encoder, channels, total_dop_frames,
+                                                  chunk_frames, callback, first_dop_frame);
+
+        LOG_INFO("DoP streaming complete: {} output samples", frames_encoded * channels);
+
+        return ErrorCode::Success;
+    }
+
+    // DSF stores the first DSD sample in bit 0 of each byte, DSDIFF in bit 7
+    audio::DSDDecimator decimator(decimation_factor, impl_->format == DSDFormat::DSF, impl_->filter_mode);
+    LOG_INFO("DSD filter: {}, kernels: {}",
+             impl_->filter_mode == audio::DSDFilterMode::Fast ? "fast" : "filtered",
+             audio::simdLevelName(decimator.getSIMDLevel()));
+
+    std::unique_ptr<audio::PolyphaseResampler> resampler = impl_->createResampler();
+
+    if (impl_->start_seconds <= 0.0 && impl_->range_seconds <= 0.0) {
+        DSDChannelReader reader = impl_->createReader(decimator.getHistoryBytes(), workers.get());
+
+        uint64_t frames_decoded = decodeAndResample(reader, decimator, channels,
+                                                    total_output_frames, chunk_frames, callback,
+                                                    workers.get(), resampler.get());
+
+        LOG_INFO("DSD streaming complete: {} output samples", frames_decoded * channels);
+        return ErrorCode::Success;
+    }
+
+    // Range decode: start at the decimated frame that feeds the first output
+    // frame, with real data as filter history, so the samples are identical
+    // to the same span of a decode from the beginning
+    uint64_t first_frame = 0;
+    uint64_t range_frames = impl_->rangeFrames(impl_->metadata.sample_count,
+                                               impl_->metadata.sample_rate, first_frame);
+    impl_->metadata.sample_count = range_frames;
+
+    uint64_t decimated_first = first_frame;
+    uint64_t lead_in = 0;  // Output frames to drop before the range begins
+    if (resampler) {
+        // Restart on a whole L/M period, K taps of input early, to prime the polyphase stage
+        const uint64_t up = resampler->getUpFactor();
+        const uint64_t down = resampler->getDownFactor();
+        const uint64_t prime = (resampler->getTapsPerPhase() + down - 1) / down;
+        const uint64_t period = first_frame / up;
+        const uint64_t restart = period > prime ? period - prime : 0;
+        decimated_first = restart * down;
+        lead_in = first_frame - restart * up;
+    }
+
+    LOG_INFO("Range decode: output frames {} .. {} (decimated frame {}, {} lead-in frames)",
+             first_frame, first_frame + range_frames, decimated_first, lead_in);
+
+    DSDChannelReader reader = impl_->createReader(decimator.getHistoryBytes(), workers.get(),
+                                                  decimated_first * decimator.getStrideBytes());
+
+    uint64_t frames_left = range_frames;
+    auto ranged = [&](const float* data, size_t samples) {
+        size_t frames = samples / channels;
+        const size_t skip = static_cast<size_t>(std::min<uint64_t>(lead_in, frames));
+        lead_in -= skip;
+        frames = static_cast<size_t>(std::min<uint64_t>(frames - skip, frames_left));
+        if (frames > 0) {
+            frames_left -= frames;
+            if (!callback(data + skip * channels, frames * channels)) {
+                return false;
+            }
+        }
+        return frames_left > 0;
+    };
+
+    // Without the polyphase stage the decimator output is the range itself
+    const uint64_t decimated_frames = resampler ? total_output_frames - std::min(decimated_first, total_output_frames)
+                                                : range_frames;
+    decodeAndResample(reader, decimator, channels, decimated_frames, chunk_frames, ranged,
+                      workers.get(), resampler.get());
+
+    LOG_INFO("DSD streaming complete: {} output samples", (range_frames - frames_left) * channels);
+
+    return ErrorCode::Success;
+}
+
+bool DSDDecoder::isLoaded() const {
+    return impl_->loaded;
+}
+
+} // namespace load
+} // namespace xpu
@@ -0,0 +1,204 @@
+/**
+ * @file DSDDecoder.h
+ * @brief DSD (Direct Stream Digital) format decoder
+ * Supports DSF and DSDIFF formats (plain or DST-compressed)
+ */
+
+#ifndef XPU_LOAD_DSD_DECODER_H
+#define XPU_LOAD_DSD_DECODER_H
+
+#include "protocol/ErrorCode.h"
+#include "protocol/Protocol.h"
+#include "../lib/audio/AudioFormat.h"
+#include "../lib/audio/DSDDecimator.h"
+#include "utils/ReadAhead.h"
+#include <string>
+#include <vector>
+#include <memory>
+#include <functional>
+
+namespace xpu {
+namespace load {
+
+/**
+ * @brief DSD format types
+ */
+enum class DSDFormat {
+    None,    // Not a DSD format
+    DSF,     // Sony DSF format
+    DSDIFF   // Philips DSDIFF format
+};
+
+/**
+ * @brief DSD output mode
+ */
+enum class DSDOutputMode {
+    PCM,     // Decimate to PCM (default)
+    DoP      // Pack raw DSD into DoP frames (DSD rate / 16, 0x05/0xFA markers)
+};
+
+/**
+ * @brief Callback type for streaming mode
+ * @param chunk_data Pointer to chunk data (interleaved float samples)
+ * @param chunk_samples Number of float samples in chunk
+ * @return true to continue streaming, false to stop
+ */
+using DSDStreamingCallback = std::function<bool(const float* chunk_data, size_t chunk_samples)>;
+
+/**
+ * @brief DSD decoder class
+ * Decodes DSD audio data and converts to PCM
+ */
+class DSDDecoder {
+public:
+    DSDDecoder();
+    ~DSDDecoder();
+
+    /**
+     * @brief Set target sample rate for output
+     * @param sample_rate Target sample rate (e.g., 48000, 96000; 0 = DSD rate / decimation)
+     *
+     * DSD is first decimated by the integer factor (44.1k family for standard
+     * DSD rates), then a rational polyphase stage converts to the target, so
+     * 48k-family rates are reached in one pass with the correct pitch.
+     */
+    void setTargetSampleRate(int sample_rate);
+
+    /**
+     * @brief Set DSD decimation factor for output
+     * @param factor Decimation factor: 16, 32, or 64 (default: 16)
+     *               Higher factors = lower quality but less CPU/memory
+     *               For DSD64: /16 = 176.4kHz, /32 = 88.2kHz, /64 = 44.1kHz
+     */
+    void setDSDDecimation(int factor);
+
+    /**
+     * @brief Set DSD decimation filter mode
+     * @param mode Filtered (FIR, default) or Fast (popcount boxcar average)
+     */
+    void setDSDFilterMode(audio::DSDFilterMode mode);
+
+    /**
+     * @brief Set number of DSD decoding threads
+     * @param threads Worker threads (1 = serial, default; 0 = one per CPU)
+     *
+     * Each refill decodes one chunk per thread in parallel; chunks are still
+     * delivered to the streaming callback in order. DST-compressed DSDIFF
+     * also decodes its (independent) DST frames on these threads.
+     */
+    void setDecodeThreads(int threads);
+
+    /**
+     * @brief Read the DSD data chunk ahead of the decoder on background threads
+     * @param config Window, threads and hints (default: disabled)
+     *
+     * Used while decoding from the file (mapped or buffered reads); the
+     * window follows the read position, including after seek().
+     */
+    void setReadAhead(const utils::ReadAheadConfig& config);
+
+    /**
+     * @brief Set output mode
+     * @param mode PCM (default) or DoP
+     *
+     * In DoP mode the DSD bits are passed through untouched: each channel
+     * sample is a 24-bit DoP word carried as float32 (see audio::DoPEncoder),
+     * the output rate is DSD rate / 16 and metadata.encoding is "dop". Target
+     * sample rate, decimation and filter settings are ignored.
+     */
+    void setOutputMode(DSDOutputMode mode);
+
+    /**
+     * @brief Load DSD file (batch mode - decodes the whole file into memory)
+     *
+     * The DSD data is read through a shared read-only mapping, so only the
+     * decoded PCM is held privately.
+     * @param filepath Path to DSD file (.dsf or .dff)
+     * @return ErrorCode::Success on success
+     */
+    ErrorCode load(const std::string& filepath);
+
+    /**
+     * @brief Prepare for streaming (opens file and extracts metadata)
+     * @param filepath Path to DSD file (.dsf or .dff)
+     * @return ErrorCode::Success on success
+     *
+     * This method opens the file and extracts metadata WITHOUT decoding DSD data.
+     * The data chunk is memory-mapped (read-only, sequential access hints);
+     * if mapping fails, streamPCM() falls back to buffered reads.
+     * Call getMetadata() after this to retrieve the metadata.
+     * Then call streamPCM() to start streaming PCM data.
+     */
+    ErrorCode prepareStreaming(const std::string& filepath);
+
+    /**
+     * @brief Restrict streamPCM() to a time range (call after prepareStreaming())
+     * @param start_seconds Position of the first output sample
+     * @param duration_seconds Length of the range (0 = to the end of the file)
+     * @return ErrorCode::InvalidArgument if the range is negative or starts past the end
+     *
+     * Seeking is sample-accurate at the output rate: DSF jumps to the block
+     * group holding the start, DSDIFF to the byte, and DST skips whole frames
+     * by their chunk headers; the filters are primed with the preceding data,
+     * so the output equals the same span of a full decode. The metadata
+     * duration (and the sample count set by streamPCM()) describe the range.
+     * load() always decodes the whole file.
+     */
+    ErrorCode seek(double start_seconds, double duration_seconds = 0.0);
+
+    /**
+     * @brief Stream PCM data using callback (requires prepareStreaming() first)
+     * @param callback Callback function for each chunk
+     * @param chunk_size_bytes Target chunk size (default: 64KB)
+     * @return ErrorCode::Success on success
+     *
+     * NOTE: You MUST call prepareStreaming() before this method.
+     */
+    ErrorCode streamPCM(DSDStreamingCallback callback, size_t chunk_size_bytes = 64 * 1024);
+
+    /**
+     * @brief Get metadata (valid after load() or prepareStreaming())
+     */
+    const protocol::AudioMetadata& getMetadata() const;
+
+    /**
+     * @brief Get decoded PCM data (32-bit float) - batch mode only
+     * Output keeps the file's channels at the target rate (or DSD rate / decimation)
+     */
+    const std::vector<uint8_t>& getPCMData() const;
+
+    /**
+     * @brief Check if file is loaded
+     */
+    bool isLoaded() const;
+
+    /**
+     * @brief Detect DSD format from file
+     */
+    static DSDFormat detectFormat(const std::string& filepath);
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> impl_;
+
+    /**
+     * @brief Parse DSF format header
+     */
+    ErrorCode parseDSF(const std::string& filepath);
+
+    /**
+     * @brief Parse DSDIFF format header
+     */
+    ErrorCode parseDSDIFF(const std::string& filepath);
+
+    /**
+     * @brief Decode DSD data to PCM
+     * Uses the table-driven FIR decimator (audio::DSDDecimator)
+     */
+    ErrorCode decodeDSDToPCM();
+};
+
+} // namespace load
+} // namespace xpu
+
+#endif // XPU_LOAD_DSD_DECODER_H
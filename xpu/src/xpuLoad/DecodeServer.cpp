@@ -0,0 +1,324 @@
+/**
+ * @file DecodeServer.cpp
+ * @brief Decode server of xpuLoad (--serve): requests over a UNIX socket
+ */
+
+#include "DecodeServer.h"
+#include "ChunkOutput.h"
+#include "protocol/ErrorResponse.h"
+#include "utils/Logger.h"
+#include <nlohmann/json.hpp>
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#ifndef PLATFORM_WINDOWS
+#include <cerrno>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace xpu {
+namespace load {
+
+namespace {
+
+constexpr int MIN_REQUEST_SAMPLE_RATE = 8000;
+constexpr int MAX_REQUEST_SAMPLE_RATE = 768000;
+constexpr double MAX_REQUEST_SECONDS = 7.0 * 24.0 * 3600.0;
+
+bool readString(const nlohmann::json& request, const char* key, std::string& value, std::string& error) {
+    auto it = request.find(key);
+    if (it == request.end()) {
+        return true;
+    }
+    if (!it->is_string()) {
+        error = std::string(key) + " must be a string";
+        return false;
+    }
+    value = it->get<std::string>();
+    return true;
+}
+
+bool readBool(const nlohmann::json& request, const char* key, bool& value, std::string& error) {
+    auto it = request.find(key);
+    if (it == request.end()) {
+        return true;
+    }
+    if (!it->is_boolean()) {
+        error = std::string(key) + " must be true or false";
+        return false;
+    }
+    value = it->get<bool>();
+    return true;
+}
+
+/**
+ * @brief Integer field within [min, max]; doubles such as 48000.5 are rejected
+ */
+bool readInt(const nlohmann::json& request, const char* key, int min, int max, int& value, std::string& error) {
+    auto it = request.find(key);
+    if (it == request.end()) {
+        return true;
+    }
+    const bool in_range = it->is_number_integer() && it->get<int64_t>() >= min && it->get<int64_t>() <= max;
+    if (!in_range) {
+        error = std::string(key) + " must be an integer from " + std::to_string(min) + " to " + std::to_string(max);
+        return false;
+    }
+    value = static_cast<int>(it->get<int64_t>());
+    return true;
+}
+
+bool readSeconds(const nlohmann::json& request, const char* key, double& value, std::string& error) {
+    auto it = request.find(key);
+    if (it == request.end()) {
+        return true;
+    }
+    const double seconds = it->is_number() ? it->get<double>() : -1.0;
+    if (!(seconds >= 0.0 && seconds <= MAX_REQUEST_SECONDS)) {
+        error = std::string(key) + " must be a number of seconds from 0 to " +
+                std::to_string(static_cast<int>(MAX_REQUEST_SECONDS));
+        return false;
+    }
+    value = seconds;
+    return true;
+}
+
+} // anonymous namespace
+
+bool parseServeRequest(const std::string& line, TrackRequest& request, std::string& error) {
+    const nlohmann::json json = nlohmann::json::parse(line, nullptr, false);
+    if (json.is_discarded() || !json.is_object()) {
+        error = "request must be a JSON object";
+        return false;
+    }
+
+    request.path.clear();
+    std::string sample_format = request.native_sample_format ? "native" : "float";
+    if (!readString(json, "path", request.path, error) ||
+        !readInt(json, "sample_rate", MIN_REQUEST_SAMPLE_RATE, MAX_REQUEST_SAMPLE_RATE,
+                 request.target_sample_rate, error) ||
+        !readInt(json, "dsd_decimation", 16, 64, request.dsd_decimation, error) ||
+        !readString(json, "dsd_decoder", request.dsd_decoder, error) ||
+        !readBool(json, "dop", request.dop_output, error) ||
+        !readSeconds(json, "start", request.start_seconds, error) ||
+        !readSeconds(json, "duration", request.duration_seconds, error) ||
+        !readString(json, "sample_format", sample_format, error) ||
+        !readBool(json, "metadata_only", request.metadata_only, error)) {
+        return false;
+    }
+
+    if (request.path.empty()) {
+        error = "request needs a \"path\"";
+        return false;
+    }
+    if (request.dsd_decimation != 16 && request.dsd_decimation != 32 && request.dsd_decimation != 64) {
+        error = "dsd_decimation must be 16, 32 or 64";
+        return false;
+    }
+    if (sample_format != "float" && sample_format != "native") {
+        error = "sample_format must be \"float\" or \"native\"";
+        return false;
+    }
+    request.native_sample_format = sample_format == "native";
+    if (request.dop_output) {
+        request.dsd_decoder = "native";
+    }
+    if (request.dsd_decoder != "ffmpeg" && request.dsd_decoder != "native") {
+        error = "dsd_decoder must be \"ffmpeg\" or \"native\" in server mode";
+        return false;
+    }
+    return true;
+}
+
+#ifndef PLATFORM_WINDOWS
+
+DecodeServer::DecodeServer(const TrackRequest& defaults, Handler handler)
+    : defaults_(defaults)
+    , handler_(std::move(handler)) {}
+
+DecodeServer::~DecodeServer() {
+    if (listen_fd_ >= 0) {
+        ::close(listen_fd_);
+        unlink(socket_path_.c_str());
+    }
+}
+
+ErrorCode DecodeServer::listen(const std::string& socket_path, std::string& error) {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (socket_path.size() >= sizeof(address.sun_path)) {
+        error = "socket path too long: " + socket_path;
+        return ErrorCode::InvalidArgument;
+    }
+    std::memcpy(address.sun_path, socket_path.c_str(), socket_path.size() + 1);
+
+    struct stat st;
+    if (lstat(socket_path.c_str(), &st) == 0) {
+        int probe = socket(AF_UNIX, SOCK_STREAM, 0);
+        const bool running = probe >= 0 &&
+            connect(probe, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0;
+        if (probe >= 0) {
+            ::close(probe);
+        }
+        if (!S_ISSOCK(st.st_mode) || running) {
+            error = socket_path + (running ? " is in use" : " exists and is not a socket");
+            return ErrorCode::InvalidArgument;
+        }
+        unlink(socket_path.c_str());
+    }
+
+    const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0 ||
+        bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        ::listen(fd, SOMAXCONN) != 0) {
+        error = "cannot listen on " + socket_path + ": " + std::strerror(errno);
+        if (fd >= 0) {
+            ::close(fd);
+        }
+        return ErrorCode::NetworkIOError;
+    }
+    listen_fd_ = fd;
+    socket_path_ = socket_path;
+    return ErrorCode::Success;
+}
+
+void DecodeServer::run(const std::atomic<bool>& stop) {
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i < max_connections_; ++i) {
+        workers.emplace_back([this] { work(); });
+    }
+
+    while (!stop) {
+        {
+            // Accept only when a worker can take the connection right away
+            std::unique_lock<std::mutex> lock(mutex_);
+            if (!slot_free_.wait_for(lock, std::chrono::milliseconds(500), [this] {
+                    return connections_.size() < max_connections_;
+                })) {
+                continue;  // All workers busy: check the stop flag
+            }
+        }
+        pollfd listener{listen_fd_, POLLIN, 0};
+        if (poll(&listener, 1, 500) <= 0) {
+            continue;  // Timeout or signal: check the stop flag
+        }
+        const int fd = accept(listen_fd_, nullptr, nullptr);
+        if (fd < 0) {
+            continue;
+        }
+        // A client that never finishes its request line must not hold a worker
+        timeval timeout{request_timeout_ms_ / 1000, (request_timeout_ms_ % 1000) * 1000};
+        setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        connections_.insert(fd);
+        pending_.push_back(fd);
+        work_ready_.notify_one();
+    }
+
+    ::close(listen_fd_);
+    listen_fd_ = -1;
+    unlink(socket_path_.c_str());
+
+    // Unblock connections still streaming, then wait for their workers
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+        for (int fd : connections_) {
+            shutdown(fd, SHUT_RDWR);
+        }
+    }
+    work_ready_.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+void DecodeServer::work() {
+    while (true) {
+        int fd = -1;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            work_ready_.wait(lock, [this] { return stopping_ || !pending_.empty(); });
+            if (pending_.empty()) {
+                return;
+            }
+            fd = pending_.front();
+            pending_.pop_front();
+        }
+
+        serveConnection(fd);
+
+        // Forget the fd before closing it: once closed, the number can be
+        // reused by a new connection that the shutdown above must not touch
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            connections_.erase(fd);
+        }
+        ::close(fd);
+        slot_free_.notify_one();
+    }
+}
+
+void DecodeServer::serveConnection(int fd) {
+    const auto start = std::chrono::steady_clock::now();
+    std::string line;
+    TrackRequest request = defaults_;
+    std::string error;
+    if (!readRequestLine(fd, line)) {
+        LOG_WARN("Connection closed or timed out without a request");
+        return;
+    }
+    if (!parseServeRequest(line, request, error)) {
+        sendError(fd, ErrorCode::InvalidArgument, error);
+        return;
+    }
+
+    LOG_INFO("Request: {}", request.path);
+    ErrorCode ret = handler_(fd, request);
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (ret == ErrorCode::Success) {
+        LOG_INFO("Served {} in {:.3f} s", request.path, seconds);
+    } else {
+        LOG_WARN("Request for {} ended with error {}", request.path, static_cast<int>(ret));
+    }
+}
+
+bool DecodeServer::readRequestLine(int fd, std::string& line) {
+    constexpr size_t MAX_REQUEST_BYTES = 64 * 1024;
+    char c = 0;
+    while (line.size() < MAX_REQUEST_BYTES) {
+        ssize_t got = ::read(fd, &c, 1);
+        if (got < 0 && errno == EINTR) {
+            continue;
+        }
+        if (got < 0) {
+            return false;  // Request timeout (EAGAIN) or connection error
+        }
+        if (got == 0) {
+            return !line.empty();  // EOF ends the request too
+        }
+        if (c == '\n') {
+            return true;
+        }
+        line += c;
+    }
+    return false;
+}
+
+bool DecodeServer::sendError(int fd, ErrorCode code, const std::string& detail) {
+    LOG_ERROR("Request failed: {}", detail);
+    const std::string json = ErrorResponse(code, "xpuLoad", detail).toJSON();
+    return writeAll(fd, json.data(), json.size());
+}
+
+#endif
+
+} // namespace load
+} // namespace xpu
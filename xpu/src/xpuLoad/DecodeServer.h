@@ -0,0 +1,133 @@
+/**
+ * @file DecodeServer.h
+ * @brief Decode server of xpuLoad (--serve): requests over a UNIX socket
+ */
+
+#ifndef XPU_LOAD_DECODE_SERVER_H
+#define XPU_LOAD_DECODE_SERVER_H
+
+#include "protocol/ErrorCode.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <set>
+#include <string>
+
+namespace xpu {
+namespace load {
+
+/**
+ * @brief Per-track options of a --serve request or --playlist entry (defaults from the command line)
+ */
+struct TrackRequest {
+    std::string path;
+    int target_sample_rate = 0;
+    int dsd_decimation = 16;
+    std::string dsd_decoder = "ffmpeg";
+    bool dop_output = false;
+    double start_seconds = 0.0;
+    double duration_seconds = 0.0;
+    bool native_sample_format = false;
+    bool metadata_only = false;
+};
+
+/**
+ * @brief Parse one request line (a JSON object) over the defaults in request
+ *
+ * Keys: path (required), sample_rate (8000 - 768000), dsd_decimation
+ * (16, 32 or 64), dsd_decoder ("ffmpeg" or "native"), dop, start and
+ * duration (seconds), sample_format ("float" or "native"), metadata_only.
+ * Unknown keys are ignored.
+ *
+ * @return false with a message in error if the request is invalid
+ */
+bool parseServeRequest(const std::string& line, TrackRequest& request, std::string& error);
+
+#ifndef PLATFORM_WINDOWS
+
+/**
+ * @brief Accepts decode requests on a UNIX socket and answers each on its connection
+ *
+ * Each connection sends one request line and receives the reply written
+ * by the handler ([JSON metadata][8-byte size][PCM data]...), or an error
+ * JSON if the request is invalid; the server then closes the connection.
+ * A fixed pool of workers serves the connections, so at most
+ * max_connections are open at a time; further clients wait in the listen
+ * backlog. A client that does not send its request within the request
+ * timeout is dropped.
+ */
+class DecodeServer {
+public:
+    /**
+     * @brief Writes the reply to a valid request on fd
+     */
+    using Handler = std::function<ErrorCode(int fd, const TrackRequest& request)>;
+
+    static constexpr size_t DEFAULT_MAX_CONNECTIONS = 8;
+    static constexpr int DEFAULT_REQUEST_TIMEOUT_MS = 5000;
+
+    /**
+     * @param defaults Request options before the request line is applied
+     * @param handler Called on a worker thread for each valid request
+     */
+    DecodeServer(const TrackRequest& defaults, Handler handler);
+    ~DecodeServer();
+
+    DecodeServer(const DecodeServer&) = delete;
+    DecodeServer& operator=(const DecodeServer&) = delete;
+
+    void setMaxConnections(size_t count) { max_connections_ = count > 0 ? count : 1; }
+    void setRequestTimeout(int milliseconds) { request_timeout_ms_ = milliseconds; }
+
+    /**
+     * @brief Listen on socket_path
+     *
+     * A stale socket left by a server that did not shut down is replaced,
+     * but never another file or a server that is still running.
+     *
+     * @return Error code with a message in error on failure
+     */
+    ErrorCode listen(const std::string& socket_path, std::string& error);
+
+    /**
+     * @brief Serve connections until stop is set
+     *
+     * On stop the socket is removed, open connections are shut down and
+     * their workers joined before returning.
+     */
+    void run(const std::atomic<bool>& stop);
+
+    /**
+     * @brief Answer a request with an error JSON
+     */
+    static bool sendError(int fd, ErrorCode code, const std::string& detail);
+
+private:
+    void work();
+    void serveConnection(int fd);
+    bool readRequestLine(int fd, std::string& line);
+
+    TrackRequest defaults_;
+    Handler handler_;
+    size_t max_connections_ = DEFAULT_MAX_CONNECTIONS;
+    int request_timeout_ms_ = DEFAULT_REQUEST_TIMEOUT_MS;
+    std::string socket_path_;
+    int listen_fd_ = -1;
+
+    std::mutex mutex_;
+    std::condition_variable work_ready_;  // Connection queued or stopping
+    std::condition_variable slot_free_;   // A worker finished a connection
+    std::deque<int> pending_;             // Accepted, not yet picked up by a worker
+    std::set<int> connections_;           // Accepted and not yet closed
+    bool stopping_ = false;
+};
+
+#endif
+
+} // namespace load
+} // namespace xpu
+
+#endif // XPU_LOAD_DECODE_SERVER_H
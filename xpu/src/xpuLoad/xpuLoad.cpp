@@ -0,0 +1,1287 @@
+/**
+ * @file xpuLoad.cpp
+ * @brief Audio file loader - XPU Module 1
+ *
+ * Loads audio files and outputs metadata and PCM data to stdout
+ * Supports: FLAC, WAV, ALAC, DSD (DSF/DSD), MP3, AAC, OGG, OPUS
+ */
+
+#include "AudioFileLoader.h"
+#include "SACDDecoder.h"
+#include "DSDDecoder.h"
+#include "ChunkOutput.h"
+#include "DecodeServer.h"
+#include "protocol/ErrorCode.h"
+#include "protocol/ErrorResponse.h"
+#include "protocol/MetadataJSON.h"
+#include "protocol/Protocol.h"
+#include "utils/Logger.h"
+#include "utils/ConfigLoader.h"
+#include "utils/PlatformUtils.h"
+#include "utils/ReadAhead.h"
+#include "../lib/audio/AudioFormat.h"
+#include <iostream>
+#include <fstream>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <sstream>
+#include <memory>
+#include <mutex>
+
+extern "C" {
+#include <libavutil/log.h>
+}
+
+#ifdef PLATFORM_WINDOWS
+#include <windows.h>
+#include <io.h>
+#include <fcntl.h>
+#else
+#include <unistd.h>  // for isatty()
+#include <csignal>
+#endif
+
+using namespace xpu;
+
+/**
+ * @brief Default depth of the output ring buffer (--output-buffer)
+ */
+constexpr size_t DEFAULT_OUTPUT_BUFFER_KB = 4096;
+
+/**
+ * @brief Print usage information
+ */
+void printUsage(const char* program_name) {
+    std::cout << "Usage: " << program_name << " [options] <input_file> [<input_file>...]\n";
+    std::cout << "\nOptions:\n";
+    std::cout << "  -h, --help              Show this help message\n";
+    std::cout << "  -v, --version           Show version information\n";
+    std::cout << "  -V, --verbose           Enable verbose output\n";
+    std::cout << "  -m, --metadata          Output only metadata (JSON format)\n";
+    std::cout << "  -d, --data              Output only PCM data (binary)\n";
+    std::cout << "  -r <rate>, --sample-rate <rate>  Target sample rate (default: keep original)\n";
+    std::cout << "  --dsd-decimation <factor> DSD decimation factor: 16, 32, or 64 (default: 16)\n";
+    std::cout << "                          Auto: uses /32 if target PCM rate > 352kHz\n";
+    std::cout << "  --dsd-decoder <type>    DSD decoder: ffmpeg, sacd or native (default: ffmpeg)\n";
+    std::cout << "  --dop                   Output DSD as DoP frames (native decoder, DSD rate / 16)\n";
+    std::cout << "  --start <time>          Start decoding at <time> (seconds or [hh:]mm:ss[.fff])\n";
+    std::cout << "  --duration <time>       Decode only <time> from the start position\n";
+    std::cout << "  --decoder-threads <N|auto> Decoder threads (default: auto, one per core;\n";
+    std::cout << "                          used by codecs with frame/slice threading and the native DSD decoder)\n";
+    std::cout << "  --input-io <mode>       Input reads: file, mmap or auto (default: auto = mmap for\n";
+    std::cout << "                          the --mmap-formats, file protocol otherwise)\n";
+    std::cout << "  --mmap-formats <list>   Extensions read memory-mapped in auto mode\n";
+    std::cout << "                          (default: flac,wav,m4a,dsf,dff,aiff,aifc)\n";
+    std::cout << "  --io-buffer <KB>        Demuxer buffer for mapped input (default: "
+              << load::DEFAULT_AVIO_BUFFER_SIZE / 1024 << ")\n";
+    std::cout << "  --sample-format <fmt>   PCM sample format: float or native (default: float;\n";
+    std::cout << "                          native = source integer format (16/24/32-bit) when not resampled)\n";
+    std::cout << "  --readahead <MB>        Read the input this far ahead of the decoder on background\n";
+    std::cout << "                          threads (default: [io] readahead_mb in xpuSetting.conf; 0 = off)\n";
+    std::cout << "  --output-buffer <KB>    Output ring buffer between decoder and stdout\n";
+    std::cout << "                          (default: " << DEFAULT_OUTPUT_BUFFER_KB << "; 0 = write from the decoder)\n";
+    std::cout << "  --playlist <file|->     Decode the tracks listed in <file> (one path per line, '#' lines\n";
+    std::cout << "                          ignored; - = stdin) as one multi-track stream (see below)\n";
+    std::cout << "  --serve <socket>        Run as decode server on a UNIX socket (see below)\n";
+    std::cout << "\nSupported formats:\n";
+    std::cout << "  Lossless: FLAC, WAV, ALAC, DSD (DSF/DSDIFF)\n";
+    std::cout << "  Lossy: MP3, AAC, OGG, OPUS\n";
+    std::cout << "\nDSD Decoders:\n";
+    std::cout << "  ffmpeg  - Built-in FFmpeg DSD decoder (dsd2pcm algorithm)\n";
+    std::cout << "  sacd    - foo_input_sacd.dll (high quality SACD decoder)\n";
+    std::cout << "  native  - Built-in DSF/DSDIFF decoder incl. DST (table FIR, polyphase to target rate)\n";
+    std::cout << "\nHigh-resolution support:\n";
+    std::cout << "  Up to 768kHz sample rate, 32-bit depth\n";
+    std::cout << "\nOutput format:\n";
+    std::cout << "  By default: Keeps original sample rate\n";
+    std::cout << "  With -r/--sample-rate: Outputs at specified rate (32-bit float)\n";
+    std::cout << "  For DSD: PCM sample rate = DSD rate / 32 (e.g., DSD64 -> 88.2kHz)\n";
+    std::cout << "  Output: [JSON metadata][8-byte size header][PCM data]\n";
+    std::cout << "  PCM data: interleaved, source channel layout; 32-bit float, or with\n";
+    std::cout << "            --sample-format native the format named in \"sample_format\"\n";
+    std::cout << "\nMulti-track stream (several input files or --playlist):\n";
+    std::cout << "  One stream for all tracks: between two tracks a chunk whose size header has\n";
+    std::cout << "  the top bit set carries the next track's metadata JSON (omitted with -d).\n";
+    std::cout << "  Tracks are decoded at the first track's sample rate, encoder delay and padding\n";
+    std::cout << "  are trimmed; tracks with another channel count or sample format are skipped.\n";
+    std::cout << "\nDecode server (--serve):\n";
+    std::cout << "  Each connection sends one JSON request line and receives the output above,\n";
+    std::cout << "  then the server closes it. Keys: path (required), sample_rate, dsd_decimation,\n";
+    std::cout << "  dsd_decoder (ffmpeg/native), dop, start, duration (seconds), sample_format\n";
+    std::cout << "  (float/native), metadata_only. Other options on the command line set the defaults.\n";
+    std::cout << "  Errors are answered with an error JSON instead of the metadata.\n";
+    std::cout << "\nDSD Decimation:\n";
+    std::cout << "  --dsd-decimation 16: DSD/16 (default, high quality)\n";
+    std::cout << "  --dsd-decimation 32: DSD/32 (if target > 352kHz)\n";
+    std::cout << "  --dsd-decimation 64: DSD/64 (lower quality, smaller files)\n";
+    std::cout << "\nExamples:\n";
+    std::cout << "  " << program_name << " song.flac\n";
+    std::cout << "  " << program_name << " -r 48000 song.flac\n";
+    std::cout << "  " << program_name << " --metadata song.dsf\n";
+    std::cout << "  " << program_name << " --dsd-decoder sacd song.dsf\n";
+    std::cout << "  " << program_name << " --dsd-decimation 32 song.dsf\n";
+    std::cout << "  " << program_name << " --dop song.dsf | xpuPlay\n";
+    std::cout << "  " << program_name << " --start 1:30 --duration 20 song.flac | xpuPlay\n";
+    std::cout << "  " << program_name << " song.flac | xpuIn2Wav -\n";
+    std::cout << "  " << program_name << " song.flac | xpuIn2Wav - -r 48000 -b 16\n";
+    std::cout << "  " << program_name << " --sample-format native song.flac | xpuIn2Wav - -b 24\n";
+    std::cout << "  " << program_name << " 01.flac 02.flac 03.flac | xpuPlay\n";
+    std::cout << "  " << program_name << " --playlist album.m3u | xpuProcess --volume 80 | xpuPlay\n";
+    std::cout << "  " << program_name << " --serve /tmp/xpuLoad.sock &\n";
+    std::cout << "  echo '{\"path\": \"song.flac\"}' | nc -U /tmp/xpuLoad.sock | xpuPlay\n";
+}
+
+/**
+ * @brief Parse a time argument: seconds ("90.5") or [hh:]mm:ss[.fff] ("1:30.5")
+ * @return false if the text is not a non-negative time
+ */
+bool parseTime(const char* text, double& seconds) {
+    seconds = 0.0;
+    int fields = 0;
+    const char* p = text;
+    while (true) {
+        char* end = nullptr;
+        double value = strtod(p, &end);
+        if (end == p || !std::isfinite(value) || value < 0.0 || ++fields > 3) {
+            return false;
+        }
+        seconds = seconds * 60.0 + value;
+        if (*end == '\0') {
+            return true;
+        }
+        // Only the last field may have a fraction
+        const char* dot = std::strchr(p, '.');
+        if (*end != ':' || (dot && dot < end)) {
+            return false;
+        }
+        p = end + 1;
+    }
+}
+
+/**
+ * @brief Read-ahead settings from the [io] section of xpuSetting.conf
+ * @return Disabled settings if there is no config file
+ */
+utils::ReadAheadConfig loadReadAheadConfig() {
+    const std::string path = utils::PlatformUtils::getConfigFilePath();
+    std::map<std::string, utils::ConfigValue> config;
+    if (!utils::PlatformUtils::fileExists(path) ||
+        utils::ConfigLoader::loadFromFile(path, config) != ErrorCode::Success) {
+        return utils::ReadAheadConfig();
+    }
+    return utils::ReadAheadConfig::fromConfig(config);
+}
+
+/**
+ * @brief Print version information
+ */
+void printVersion() {
+    std::cout << "xpuLoad version 0.1.0\n";
+    std::cout << "XPU - Cross-Platform Professional Audio Playback System\n";
+    std::cout << "Copyright (c) 2025 XPU Project\n";
+}
+
+/**
+ * @brief Convert metadata to JSON string
+ */
+std::string metadataToJSON(const protocol::AudioMetadata& metadata) {
+    std::ostringstream json;
+    json << "{\n";
+    json << "  \"success\": true,\n";
+    json << "  \"metadata\": {\n";
+    json << "    \"file_path\": " << protocol::quoteJSON(metadata.file_path) << ",\n";
+    json << "    \"format\": " << protocol::quoteJSON(metadata.format_name) << ",\n";
+    json << "    \"title\": " << protocol::quoteJSON(metadata.title) << ",\n";
+    json << "    \"artist\": " << protocol::quoteJSON(metadata.artist) << ",\n";
+    json << "    \"album\": " << protocol::quoteJSON(metadata.album) << ",\n";
+    json << "    \"year\": " << protocol::quoteJSON(metadata.year) << ",\n";
+    json << "    \"genre\": " << protocol::quoteJSON(metadata.genre) << ",\n";
+    json << "    \"track_number\": " << metadata.track_number << ",\n";
+    json << "    \"duration\": " << metadata.duration << ",\n";
+    json << "    \"sample_rate\": " << metadata.sample_rate << ",\n";
+    json << "    \"original_sample_rate\": " << metadata.original_sample_rate << ",\n";
+    json << "    \"bit_depth\": " << metadata.bit_depth << ",\n";
+    json << "    \"original_bit_depth\": " << metadata.original_bit_depth << ",\n";
+    json << "    \"channels\": " << metadata.channels << ",\n";
+    json << "    \"sample_count\": " << metadata.sample_count << ",\n";
+    json << "    \"bitrate\": " << metadata.bitrate << ",\n";
+    json << "    \"is_lossless\": " << (metadata.is_lossless ? "true" : "false") << ",\n";
+    json << "    \"is_high_res\": " << (metadata.is_high_res ? "true" : "false") << ",\n";
+    json << "    \"streaming_mode\": " << (metadata.streaming_mode ? "true" : "false") << ",\n";
+    json << "    \"encoding\": " << protocol::quoteJSON(metadata.encoding) << ",\n";
+    json << "    \"sample_format\": " << protocol::quoteJSON(metadata.sample_format) << "\n";
+    json << "  }\n";
+    json << "}\n";
+    return json.str();
+}
+
+/**
+ * @brief Settings that apply to every track of a --serve or --playlist run
+ */
+struct DecodeConfig {
+    load::TrackRequest defaults;
+    int decoder_threads = 0;
+    load::InputIO input_io = load::InputIO::Auto;
+    size_t io_buffer_size = load::DEFAULT_AVIO_BUFFER_SIZE;
+    std::vector<audio::AudioFormat> mapped_formats;
+    utils::ReadAheadConfig read_ahead;
+    size_t output_buffer_kb = DEFAULT_OUTPUT_BUFFER_KB;
+};
+
+/**
+ * @brief One track opened with the decoder its request selects
+ *
+ * DSD files with the native decoder (or DoP output) go through DSDDecoder,
+ * everything else through the AudioFileLoader handed to the constructor,
+ * which can be taken back with releaseLoader() for the next track.
+ */
+class TrackSource {
+public:
+    explicit TrackSource(std::unique_ptr<load::AudioFileLoader> loader)
+        : loader_(std::move(loader)) {}
+
+    /**
+     * @brief Open the file, apply the range and read the metadata
+     * @return Error code with a message in error on failure
+     */
+    ErrorCode open(load::TrackRequest request, const DecodeConfig& config, std::string& error) {
+        const bool is_dsd = audio::AudioFormatUtils::formatFromExtension(request.path) == audio::AudioFormat::DSD;
+        if (request.dop_output && !is_dsd) {
+            error = "dop requires a DSD input file";
+            return ErrorCode::InvalidArgument;
+        }
+        if (request.target_sample_rate > 352000 && request.dsd_decimation == 16) {
+            request.dsd_decimation = 32;
+        }
+        const bool has_range = request.start_seconds > 0.0 || request.duration_seconds > 0.0;
+
+        ErrorCode ret = ErrorCode::Success;
+        if (is_dsd && (request.dsd_decoder == "native" || request.dop_output)) {
+            dsd_ = std::make_unique<load::DSDDecoder>();
+            dsd_->setTargetSampleRate(request.target_sample_rate);
+            dsd_->setDSDDecimation(request.dsd_decimation);
+            dsd_->setOutputMode(request.dop_output ? load::DSDOutputMode::DoP : load::DSDOutputMode::PCM);
+            dsd_->setDecodeThreads(config.decoder_threads);
+            dsd_->setReadAhead(config.read_ahead);
+
+            ret = dsd_->prepareStreaming(request.path);
+            if (ret == ErrorCode::Success && has_range) {
+                ret = dsd_->seek(request.start_seconds, request.duration_seconds);
+            }
+        } else {
+            if (!loader_) {
+                loader_ = std::make_unique<load::AudioFileLoader>();
+            }
+            loader_->setTargetSampleRate(request.target_sample_rate);
+            loader_->setDSDDecimation(request.dsd_decimation);
+            loader_->setDecoderThreads(config.decoder_threads);
+            loader_->setInputIO(config.input_io, config.io_buffer_size);
+            loader_->setNativeSampleFormat(request.native_sample_format);
+            loader_->setReadAhead(config.read_ahead);
+            if (!config.mapped_formats.empty()) {
+                loader_->setMappedFormats(config.mapped_formats);
+            }
+
+            ret = loader_->prepareStreaming(request.path);
+            if (ret == ErrorCode::Success && has_range) {
+                ret = loader_->seek(request.start_seconds, request.duration_seconds);
+            }
+        }
+        if (ret != ErrorCode::Success) {
+            error = "cannot open " + request.path;
+        }
+        return ret;
+    }
+
+    /**
+     * @brief Metadata of the opened track (high-res flag set)
+     */
+    protocol::AudioMetadata metadata() const {
+        protocol::AudioMetadata metadata = dsd_ ? dsd_->getMetadata() : loader_->getMetadata();
+        if (metadata.sample_rate >= 96000) {
+            metadata.is_high_res = true;
+        }
+        return metadata;
+    }
+
+    /**
+     * @brief Decode the track into output
+     */
+    ErrorCode stream(load::ChunkOutput& output) {
+        if (dsd_) {
+            return dsd_->streamPCM([&output](const float* chunk_data, size_t chunk_samples) {
+                return output.write(chunk_data, chunk_samples);
+            }, 64 * 1024);
+        }
+        return loader_->streamRawPCM([&output](const uint8_t* chunk_data, size_t chunk_bytes) {
+            return output.writeBytes(chunk_data, chunk_bytes);
+        }, 64 * 1024);
+    }
+
+    /**
+     * @brief Take back the loader (closed, decoder still open) for the next track
+     */
+    std::unique_ptr<load::AudioFileLoader> releaseLoader() {
+        if (loader_) {
+            loader_->close();
+        }
+        return std::move(loader_);
+    }
+
+private:
+    std::unique_ptr<load::AudioFileLoader> loader_;
+    std::unique_ptr<load::DSDDecoder> dsd_;
+};
+
+#ifndef PLATFORM_WINDOWS
+
+/**
+ * @brief Idle AudioFileLoaders kept between --serve requests
+ *
+ * A loader keeps its decoder open after a track, so the next track with the
+ * same codec parameters (typically the rest of the album) skips the codec
+ * init and decoder thread start-up. The most recently used loader is
+ * handed out first.
+ */
+class LoaderPool {
+public:
+    std::unique_ptr<load::AudioFileLoader> take() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (idle_.empty()) {
+            return std::make_unique<load::AudioFileLoader>();
+        }
+        std::unique_ptr<load::AudioFileLoader> loader = std::move(idle_.back());
+        idle_.pop_back();
+        return loader;
+    }
+
+    void give(std::unique_ptr<load::AudioFileLoader> loader) {
+        loader->close();
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (idle_.size() < MAX_IDLE) {
+            idle_.push_back(std::move(loader));
+        }
+    }
+
+private:
+    static constexpr size_t MAX_IDLE = 4;
+
+    std::mutex mutex_;
+    std::vector<std::unique_ptr<load::AudioFileLoader>> idle_;
+};
+
+std::atomic<bool> g_serve_stop(false);
+
+void onServeSignal(int) {
+    g_serve_stop = true;
+}
+
+/**
+ * @brief Decode one request to the socket: [JSON metadata][8-byte size][PCM data]...
+ */
+ErrorCode serveTrack(int fd, const load::TrackRequest& request, const DecodeConfig& config, LoaderPool& loaders) {
+    TrackSource track(loaders.take());
+    std::string error;
+    ErrorCode ret = track.open(request, config, error);
+    if (ret != ErrorCode::Success) {
+        load::DecodeServer::sendError(fd, ret, error);
+    } else {
+        protocol::AudioMetadata metadata = track.metadata();
+        metadata.streaming_mode = !request.metadata_only;
+        const std::string json = ::metadataToJSON(metadata);
+        if (load::writeAll(fd, json.data(), json.size()) && !request.metadata_only) {
+            load::ChunkOutput output(config.output_buffer_kb * 1024, fd);
+            ret = track.stream(output);
+            output.finish();
+        }
+    }
+    if (std::unique_ptr<load::AudioFileLoader> loader = track.releaseLoader()) {
+        loaders.give(std::move(loader));
+    }
+    return ret;
+}
+
+#endif
+
+/**
+ * @brief Run the decode server (--serve) until SIGINT / SIGTERM
+ *
+ * Each connection sends one request, a JSON object on one line, e.g.
+ *   {"path": "/music/01.flac", "sample_rate": 48000}
+ * and receives the same stream as a pipe from xpuLoad: the metadata JSON
+ * followed by [8-byte size][PCM data] chunks; the server closes the
+ * connection after the last chunk. Errors are answered with an error JSON
+ * instead of the metadata. Up to load::DecodeServer::DEFAULT_MAX_CONNECTIONS
+ * connections are served in parallel.
+ */
+int serve(const std::string& socket_path, const DecodeConfig& config) {
+#ifdef PLATFORM_WINDOWS
+    (void)config;
+    std::cerr << "Error: --serve is not supported on Windows\n";
+    LOG_ERROR("--serve {}: UNIX sockets are not supported on Windows", socket_path);
+    return 1;
+#else
+    LoaderPool loaders;
+    load::DecodeServer server(config.defaults, [&config, &loaders](int fd, const load::TrackRequest& request) {
+        return serveTrack(fd, request, config, loaders);
+    });
+
+    std::string error;
+    if (server.listen(socket_path, error) != ErrorCode::Success) {
+        std::cerr << "Error: " << error << "\n";
+        LOG_ERROR("--serve: {}", error);
+        return 1;
+    }
+
+    // A client that disconnects mid-stream must fail the write, not end the server
+    signal(SIGPIPE, SIG_IGN);
+    signal(SIGINT, onServeSignal);
+    signal(SIGTERM, onServeSignal);
+    LOG_INFO("Serving decode requests on {}", socket_path);
+
+    server.run(g_serve_stop);
+    LOG_INFO("Decode server stopped");
+    return 0;
+#endif
+}
+
+/**
+ * @brief Read a playlist: one path per line, '#' lines (M3U tags) and blank lines ignored
+ * @param source File name, or "-" for stdin
+ */
+bool readPlaylist(const std::string& source, std::vector<std::string>& paths) {
+    std::ifstream file;
+    if (source != "-") {
+        file.open(source);
+        if (!file) {
+            return false;
+        }
+    }
+    std::istream& in = source == "-" ? std::cin : file;
+    std::string line;
+    while (std::getline(in, line)) {
+        while (!line.empty() && (line.back() == '\r' || line.back() == ' ' || line.back() == '\t')) {
+            line.pop_back();
+        }
+        const size_t begin = line.find_first_not_of(" \t");
+        if (begin == std::string::npos || line[begin] == '#') {
+            continue;
+        }
+        paths.push_back(line.substr(begin));
+    }
+    return true;
+}
+
+/**
+ * @brief Whether a track can continue a stream opened with the first track's format
+ */
+bool sameStreamFormat(const protocol::AudioMetadata& stream, const protocol::AudioMetadata& track) {
+    return track.sample_rate == stream.sample_rate && track.channels == stream.channels &&
+           track.sample_format == stream.sample_format && track.encoding == stream.encoding;
+}
+
+/**
+ * @brief Decode several tracks into one stream (several inputs or --playlist)
+ *
+ * The stream is [JSON metadata of the first track][8-byte size][data]...,
+ * with a track record (the next track's metadata JSON, size header marked
+ * with protocol::TRACK_RECORD_FLAG) where a track ends, so the downstream
+ * stages and the audio device stay open across tracks. All tracks are
+ * decoded at the first track's sample rate, and --start / --duration apply
+ * to the first track only. A track whose channel count or sample format
+ * still differs, or that cannot be opened, is skipped with a warning. One
+ * AudioFileLoader is reused, so the decoder stays open across tracks of the
+ * same codec parameters.
+ */
+int streamPlaylist(const std::vector<std::string>& paths, const DecodeConfig& config,
+                   bool metadata_only, bool data_only) {
+    #ifdef PLATFORM_WINDOWS
+    DWORD mode;
+    const bool is_piped = !GetConsoleMode(GetStdHandle(STD_OUTPUT_HANDLE), &mode);
+    #else
+    const bool is_piped = !isatty(STDOUT_FILENO);
+    #endif
+    const bool stream_data = !metadata_only && (data_only || is_piped);
+
+    std::unique_ptr<load::AudioFileLoader> loader = std::make_unique<load::AudioFileLoader>();
+    std::unique_ptr<load::ChunkOutput> output;
+    protocol::AudioMetadata stream_format;
+    bool started = false;
+    size_t played = 0;
+
+    for (size_t i = 0; i < paths.size(); ++i) {
+        load::TrackRequest request = config.defaults;
+        request.path = paths[i];
+        if (started) {
+            // --start / --duration only apply to the first track
+            request.target_sample_rate = stream_format.sample_rate;
+            request.start_seconds = 0.0;
+            request.duration_seconds = 0.0;
+        }
+        LOG_INFO("Track {}/{}: {}", i + 1, paths.size(), request.path);
+
+        TrackSource track(std::move(loader));
+        std::string error;
+        ErrorCode ret = track.open(request, config, error);
+        protocol::AudioMetadata metadata;
+        if (ret == ErrorCode::Success) {
+            metadata = track.metadata();
+            if (started && !sameStreamFormat(stream_format, metadata)) {
+                error = "format " + std::to_string(metadata.channels) + " ch " + metadata.sample_format +
+                        " does not match the stream (" + std::to_string(stream_format.channels) + " ch " +
+                        stream_format.sample_format + ")";
+                ret = ErrorCode::UnsupportedFormat;
+            }
+        }
+        if (ret != ErrorCode::Success) {
+            std::cerr << "Warning: skipping " << request.path << ": " << error << "\n";
+            LOG_WARN("Skipping {}: {}", request.path, error);
+            loader = track.releaseLoader();
+            continue;
+        }
+
+        metadata.streaming_mode = stream_data;
+        const std::string json = ::metadataToJSON(metadata);
+        if (!started) {
+            stream_format = metadata;
+            started = true;
+            if (!data_only) {
+                std::cout << json;
+                std::cout.flush();
+            }
+            if (stream_data) {
+                output = std::make_unique<load::ChunkOutput>(config.output_buffer_kb * 1024);
+            }
+        } else if (!stream_data) {
+            std::cout << json;
+            std::cout.flush();
+        } else if (!data_only && !output->writeRecord(json)) {
+            break;
+        }
+
+        if (stream_data) {
+            ret = track.stream(*output);
+            if (!output->good()) {
+                break;
+            }
+            if (ret != ErrorCode::Success) {
+                // The chunks so far hold whole frames, so the stream goes on with the next track
+                std::cerr << "Warning: decoding " << request.path << " stopped early\n";
+                LOG_WARN("Decoding {} failed: {}", request.path, static_cast<int>(ret));
+            }
+        }
+        played++;
+        loader = track.releaseLoader();
+    }
+
+    if (!started) {
+        std::cerr << "Error: no playable track\n";
+        LOG_ERROR("No playable track in {} entries", paths.size());
+        return static_cast<int>(getHTTPStatusCode(ErrorCode::FileNotFound));
+    }
+    if (output && !output->finish()) {
+        LOG_ERROR("Writing PCM data to stdout failed");
+        return static_cast<int>(getHTTPStatusCode(ErrorCode::FileWriteError));
+    }
+    LOG_INFO("Playlist complete: {} of {} tracks{}", played, paths.size(),
+             output ? ", " + std::to_string(output->chunkCount()) + " chunks" : std::string());
+    return 0;
+}
+
+/**
+ * @brief Main entry point
+ */
+int main(int argc, char* argv[]) {
+    // Set console to UTF-8 mode on Windows
+    #ifdef PLATFORM_WINDOWS
+        SetConsoleOutputCP(CP_UTF8);
+        SetConsoleCP(CP_UTF8);
+        // Set stdout to binary mode for proper data piping
+        _setmode(_fileno(stdout), _O_BINARY);
+    #endif
+
+    // Disable buffering for stdin/stdout to enable streaming
+    std::ios_base::sync_with_stdio(false);
+    std::cin.tie(nullptr);
+    std::cout.setf(std::ios::unitbuf);  // Force unbuffered output
+
+    // Parse command-line arguments (first pass to get verbose flag)
+    bool verbose = false;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "-V") == 0 || strcmp(argv[i], "--verbose") == 0) {
+            verbose = true;
+            break;
+        }
+    }
+
+    // Initialize logger with verbose setting
+    utils::Logger::initialize(utils::PlatformUtils::getLogFilePath(), true, verbose, "xpuLoad");
+
+    // Set FFmpeg log level based on verbose flag
+    // When not verbose, suppress FFmpeg info/warning messages
+    if (verbose) {
+        av_log_set_level(AV_LOG_WARNING);  // Show warnings and errors in verbose mode
+    } else {
+        av_log_set_level(AV_LOG_ERROR);    // Only show errors in silent mode
+    }
+
+    LOG_INFO("xpuLoad starting");
+
+    // Parse command-line arguments (second pass for all options)
+    const char* input_file = nullptr;
+    std::vector<std::string> input_files;  // All positional inputs (several = one multi-track stream)
+    std::string playlist;  // --playlist: file with one path per line, "-" = stdin
+    bool metadata_only = false;
+    bool data_only = false;
+    int target_sample_rate = 0;  // 0 = keep original, no conversion
+    int dsd_decimation = 16;  // Default DSD decimation factor: 16, 32, or 64
+    std::string dsd_decoder = "ffmpeg";  // Default DSD decoder
+    bool dop_output = false;  // Pack DSD into DoP frames instead of decoding to PCM
+    double start_seconds = 0.0;     // --start: range start
+    double duration_seconds = 0.0;  // --duration: range length (0 = to the end)
+    size_t output_buffer_kb = DEFAULT_OUTPUT_BUFFER_KB;  // --output-buffer: 0 = no output thread
+    int decoder_threads = 0;  // --decoder-threads: 0 = auto (one per core)
+    load::InputIO input_io = load::InputIO::Auto;  // --input-io
+    size_t io_buffer_size = load::DEFAULT_AVIO_BUFFER_SIZE;  // --io-buffer
+    std::vector<audio::AudioFormat> mapped_formats;  // --mmap-formats (empty = loader default)
+    bool native_sample_format = false;  // --sample-format native
+    utils::ReadAheadConfig read_ahead = loadReadAheadConfig();  // --readahead overrides the window
+    std::string serve_socket;  // --serve: run as decode server on this UNIX socket
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
+            printUsage(argv[0]);
+            return 0;
+        } else if (strcmp(argv[i], "-v") == 0 || strcmp(argv[i], "--version") == 0) {
+            printVersion();
+            return 0;
+        } else if (strcmp(argv[i], "-V") == 0 || strcmp(argv[i], "--verbose") == 0) {
+            verbose = true;
+        } else if (strcmp(argv[i], "-m") == 0 || strcmp(argv[i], "--metadata") == 0) {
+            metadata_only = true;
+        } else if (strcmp(argv[i], "-d") == 0 || strcmp(argv[i], "--data") == 0) {
+            data_only = true;
+        } else if (strcmp(argv[i], "-r") == 0) {
+            // -r is shorthand for --sample-rate
+            if (i + 1 < argc && argv[i + 1][0] != '-') {
+                target_sample_rate = atoi(argv[++i]);
+            } else {
+                std::cerr << "Error: -r requires a sample rate argument\n";
+                printUsage(argv[0]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--dsd-decimation") == 0) {
+            if (i + 1 < argc) {
+                dsd_decimation = atoi(argv[++i]);
+                if (dsd_decimation != 16 && dsd_decimation != 32 && dsd_decimation != 64) {
+                    std::cerr << "Error: --dsd-decimation must be 16, 32, or 64\n";
+                    printUsage(argv[0]);
+                    return 1;
+                }
+            } else {
+                std::cerr << "Error: --dsd-decimation requires a factor argument\n";
+                printUsage(argv[0]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--sample-rate") == 0) {
+            if (i + 1 < argc) {
+                target_sample_rate = atoi(argv[++i]);
+            } else {
+                std::cerr << "Error: --sample-rate requires a rate argument\n";
+                printUsage(argv[0]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--dsd-decoder") == 0) {
+            if (i + 1 < argc) {
+                dsd_decoder = argv[++i];
+                if (dsd_decoder != "ffmpeg" && dsd_decoder != "sacd" && dsd_decoder != "native") {
+                    std::cerr << "Error: --dsd-decoder must be 'ffmpeg', 'sacd' or 'native'\n";
+                    printUsage(argv[0]);
+                    return 1;
+                }
+            } else {
+                std::cerr << "Error: --dsd-decoder requires a decoder type\n";
+                printUsage(argv[0]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--dop") == 0) {
+            dop_output = true;
+        } else if (strcmp(argv[i], "--decoder-threads") == 0) {
+            char* end = nullptr;
+            long threads = -1;
+            if (i + 1 < argc) {
+                threads = strcmp(argv[i + 1], "auto") == 0 ? 0 : strtol(argv[i + 1], &end, 10);
+            }
+            if (threads < 0 || threads > 256 || (end && (end == argv[i + 1] || *end != '\0'))) {
+                std::cerr << "Error: --decoder-threads requires a thread count or 'auto'\n";
+                printUsage(argv[0]);
+                return 1;
+            }
+            decoder_threads = static_cast<int>(threads);
+            ++i;
+        } else if (strcmp(argv[i], "--input-io") == 0) {
+            const char* mode = i + 1 < argc ? argv[++i] : "";
+            if (strcmp(mode, "file") == 0) {
+                input_io = load::InputIO::File;
+            } else if (strcmp(mode, "mmap") == 0) {
+                input_io = load::InputIO::Mapped;
+            } else if (strcmp(mode, "auto") == 0) {
+                input_io = load::InputIO::Auto;
+            } else {
+                std::cerr << "Error: --input-io must be 'file', 'mmap' or 'auto'\n";
+                printUsage(argv[0]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--mmap-formats") == 0) {
+            if (i + 1 >= argc) {
+                std::cerr << "Error: --mmap-formats requires a list of extensions\n";
+                printUsage(argv[0]);
+                return 1;
+            }
+            const std::string list = argv[++i];
+            size_t begin = 0;
+            while (begin <= list.size()) {
+                size_t end = list.find(',', begin);
+                if (end == std::string::npos) {
+                    end = list.size();
+                }
+                const std::string ext = list.substr(begin, end - begin);
+                const audio::AudioFormat format = audio::AudioFormatUtils::formatFromExtension("." + ext);
+                if (format == audio::AudioFormat::Unknown) {
+                    std::cerr << "Error: unknown format in --mmap-formats: " << ext << "\n";
+                    printUsage(argv[0]);
+                    return 1;
+                }
+                mapped_formats.push_back(format);
+                begin = end + 1;
+            }
+        } else if (strcmp(argv[i], "--io-buffer") == 0) {
+            char* end = nullptr;
+            long kb = i + 1 < argc ? strtol(argv[i + 1], &end, 10) : -1;
+            if (kb < 4 || end == argv[i + 1] || *end != '\0') {
+                std::cerr << "Error: --io-buffer requires a size in KB (at least 4)\n";
+                printUsage(argv[0]);
+                return 1;
+            }
+            io_buffer_size = static_cast<size_t>(kb) * 1024;
+            ++i;
+        } else if (strcmp(argv[i], "--sample-format") == 0) {
+            const char* format = i + 1 < argc ? argv[++i] : "";
+            if (strcmp(format, "float") == 0) {
+                native_sample_format = false;
+            } else if (strcmp(format, "native") == 0) {
+                native_sample_format = true;
+            } else {
+                std::cerr << "Error: --sample-format must be 'float' or 'native'\n";
+                printUsage(argv[0]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--serve") == 0) {
+            if (i + 1 >= argc) {
+                std::cerr << "Error: --serve requires a socket path\n";
+                printUsage(argv[0]);
+                return 1;
+            }
+            serve_socket = argv[++i];
+        } else if (strcmp(argv[i], "--readahead") == 0) {
+            char* end = nullptr;
+            long mb = i + 1 < argc ? strtol(argv[i + 1], &end, 10) : -1;
+            if (mb < 0 || mb > 1024 || end == argv[i + 1] || *end != '\0') {
+                std::cerr << "Error: --readahead requires a size in MB (0 = disabled)\n";
+                printUsage(argv[0]);
+                return 1;
+            }
+            read_ahead.window_bytes = static_cast<size_t>(mb) * 1024 * 1024;
+            ++i;
+        } else if (strcmp(argv[i], "--output-buffer") == 0) {
+            char* end = nullptr;
+            long kb = i + 1 < argc ? strtol(argv[i + 1], &end, 10) : -1;
+            if (kb < 0 || end == argv[i + 1] || *end != '\0') {
+                std::cerr << "Error: --output-buffer requires a size in KB (0 = disabled)\n";
+                printUsage(argv[0]);
+                return 1;
+            }
+            output_buffer_kb = static_cast<size_t>(kb);
+            ++i;
+        } else if (strcmp(argv[i], "--start") == 0 || strcmp(argv[i], "--duration") == 0) {
+            const bool is_start = argv[i][2] == 's';
+            if (i + 1 >= argc || !parseTime(argv[i + 1], is_start ? start_seconds : duration_seconds)) {
+                std::cerr << "Error: " << argv[i] << " requires a time (seconds or [hh:]mm:ss[.fff])\n";
+                printUsage(argv[0]);
+                return 1;
+            }
+            ++i;
+        } else if (strcmp(argv[i], "--playlist") == 0) {
+            if (i + 1 >= argc) {
+                std::cerr << "Error: --playlist requires a file name (or - for stdin)\n";
+                printUsage(argv[0]);
+                return 1;
+            }
+            playlist = argv[++i];
+        } else if (argv[i][0] != '-') {
+            input_file = argv[i];
+            input_files.push_back(argv[i]);
+        } else {
+            std::cerr << "Unknown option: " << argv[i] << "\n";
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (!serve_socket.empty() || !playlist.empty() || input_files.size() > 1) {
+        // Command-line options become the defaults of every request / track
+        DecodeConfig config;
+        config.defaults.target_sample_rate = target_sample_rate;
+        config.defaults.dsd_decimation = dsd_decimation;
+        config.defaults.dsd_decoder = dsd_decoder;
+        if (dsd_decoder == "sacd") {
+            LOG_WARN("The SACD decoder is not available in server or multi-track mode, using ffmpeg");
+            config.defaults.dsd_decoder = "ffmpeg";
+        }
+        config.defaults.dop_output = dop_output;
+        config.defaults.native_sample_format = native_sample_format;
+        config.decoder_threads = decoder_threads;
+        config.input_io = input_io;
+        config.io_buffer_size = io_buffer_size;
+        config.mapped_formats = mapped_formats;
+        config.read_ahead = read_ahead;
+        config.output_buffer_kb = output_buffer_kb;
+        if (!serve_socket.empty()) {
+            return serve(serve_socket, config);
+        }
+
+        config.defaults.start_seconds = start_seconds;
+        config.defaults.duration_seconds = duration_seconds;
+        if (!playlist.empty() && !readPlaylist(playlist, input_files)) {
+            std::cerr << "Error: cannot read playlist " << playlist << "\n";
+            return 1;
+        }
+        if (input_files.empty()) {
+            std::cerr << "Error: No input file specified\n";
+            printUsage(argv[0]);
+            return 1;
+        }
+        if (metadata_only && data_only) {
+            std::cerr << "Error: Cannot specify both --metadata and --data\n";
+            return 1;
+        }
+        return streamPlaylist(input_files, config, metadata_only, data_only);
+    }
+
+    // Validate arguments
+    if (!input_file) {
+        std::cerr << "Error: No input file specified\n";
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    if (metadata_only && data_only) {
+        std::cerr << "Error: Cannot specify both --metadata and --data\n";
+        return 1;
+    }
+
+    // Validate sample rate (only if explicitly specified, not 0)
+    if (target_sample_rate != 0 &&
+        target_sample_rate != 44100 && target_sample_rate != 48000 &&
+        target_sample_rate != 96000 && target_sample_rate != 192000 &&
+        target_sample_rate != 384000 && target_sample_rate != 768000) {
+        std::cerr << "Warning: Unusual sample rate: " << target_sample_rate << "\n";
+    }
+
+    // DoP carries the raw DSD bits, which only the native decoder exposes
+    if (dop_output) {
+        if (dsd_decoder == "sacd") {
+            std::cerr << "Error: --dop requires the native DSD decoder\n";
+            return 1;
+        }
+        dsd_decoder = "native";
+    }
+
+    LOG_INFO("Loading file: {}", input_file);
+    LOG_INFO("Target sample rate: {}", target_sample_rate);
+    LOG_INFO("DSD decoder: {}", dsd_decoder);
+
+    // Auto-downgrade logic: if target PCM rate > 352kHz, use /32 decimation
+    // This prevents excessive memory usage and processing for ultra-high sample rates
+    if (target_sample_rate > 352000 && dsd_decimation == 16) {
+        LOG_INFO("Auto-downgrade: target rate {} Hz > 352kHz, using /32 decimation", target_sample_rate);
+        dsd_decimation = 32;
+    }
+    LOG_INFO("DSD decimation factor: {}", dsd_decimation);
+
+    // Detect format from extension
+    std::string file_path(input_file);
+    audio::AudioFormat format_enum = audio::AudioFormatUtils::formatFromExtension(file_path);
+    bool is_dsd = (format_enum == audio::AudioFormat::DSD);
+
+    if (dop_output && !is_dsd) {
+        std::cerr << "Error: --dop requires a DSD input file\n";
+        return 1;
+    }
+
+    // The SACD plugin only decodes whole tracks
+    const bool has_range = start_seconds > 0.0 || duration_seconds > 0.0;
+    if (has_range && is_dsd && dsd_decoder == "sacd") {
+        std::cerr << "Error: --start/--duration require the native or ffmpeg DSD decoder\n";
+        return 1;
+    }
+
+    ErrorCode ret;
+    protocol::AudioMetadata metadata;
+
+    // Choose decoder based on format and user preference
+    if (is_dsd) {
+        // DSD files: use specified decoder
+        if (dsd_decoder == "sacd") {
+            LOG_INFO("Using SACD decoder (foo_input_sacd.dll)");
+            load::SACDDecoder sacd_decoder;
+
+            // Set target sample rate (0 = DSD_rate/32)
+            sacd_decoder.setTargetSampleRate(target_sample_rate);
+
+            // Step 1: Prepare streaming
+            ret = sacd_decoder.prepareStreaming(input_file);
+            if (ret != ErrorCode::Success) {
+                // SACD decoder failed - return error instead of falling back
+                std::string error_msg = "Error code: " + std::to_string(static_cast<int>(ret));
+                std::cerr << error_msg << "\n";
+                LOG_ERROR("Failed to prepare SACD streaming: {}", static_cast<int>(ret));
+                return static_cast<int>(getHTTPStatusCode(ret));
+            }
+
+            // Step 2: Get metadata
+            metadata = sacd_decoder.getMetadata();
+            LOG_INFO("SACD metadata extracted successfully");
+
+            // Mark high-resolution audio
+            if (metadata.sample_rate >= 96000) {
+                metadata.is_high_res = true;
+                LOG_INFO("High-resolution audio detected: {} Hz", metadata.sample_rate);
+            }
+
+            // Step 3: Output metadata as JSON
+            if (!data_only) {
+                std::cout << ::metadataToJSON(metadata);
+                std::cout.flush();
+                LOG_INFO("Metadata output to stdout");
+            }
+
+            // Step 4: Stream PCM data
+            #ifdef PLATFORM_WINDOWS
+            DWORD mode;
+            bool is_piped = !GetConsoleMode(GetStdHandle(STD_OUTPUT_HANDLE), &mode);
+            #else
+            bool is_piped = !isatty(STDOUT_FILENO);
+            #endif
+
+            if (!metadata_only && (data_only || is_piped)) {
+                load::ChunkOutput output(output_buffer_kb * 1024);
+
+                auto streaming_callback = [&](const float* chunk_data, size_t chunk_samples) -> bool {
+                    return output.write(chunk_data, chunk_samples);
+                };
+
+                LOG_INFO("Starting SACD PCM data streaming...");
+                ret = sacd_decoder.streamPCM(streaming_callback, 64 * 1024);
+
+                if (ret != ErrorCode::Success) {
+                    LOG_ERROR("SACD streaming failed: {}", static_cast<int>(ret));
+                    return static_cast<int>(getHTTPStatusCode(ret));
+                }
+
+                if (!output.finish()) {
+                    LOG_ERROR("Writing PCM data to stdout failed");
+                    return static_cast<int>(getHTTPStatusCode(ErrorCode::FileWriteError));
+                }
+
+                LOG_INFO("SACD PCM data streaming complete: {} chunks", output.chunkCount());
+            } else if (!metadata_only) {
+                LOG_INFO("PCM data skipped (not in pipe mode, use -d to force output)");
+            }
+            // SACD decoder succeeded, skip FFmpeg decoder
+            goto decoder_done;
+        }
+
+        if (dsd_decoder == "native") {
+            LOG_INFO("Using native DSD decoder ({})", dop_output ? "DoP passthrough" : "PCM");
+            load::DSDDecoder dsd;
+
+            dsd.setTargetSampleRate(target_sample_rate);
+            dsd.setDSDDecimation(dsd_decimation);
+            dsd.setOutputMode(dop_output ? load::DSDOutputMode::DoP : load::DSDOutputMode::PCM);
+            // DST frames and decimation slices decode in parallel (0 = one worker per core)
+            dsd.setDecodeThreads(decoder_threads);
+            dsd.setReadAhead(read_ahead);
+
+            // Step 1: Prepare streaming
+            ret = dsd.prepareStreaming(input_file);
+            if (ret != ErrorCode::Success) {
+                std::string error_msg = "Error code: " + std::to_string(static_cast<int>(ret));
+                std::cerr << error_msg << "\n";
+                LOG_ERROR("Failed to prepare DSD streaming: {}", static_cast<int>(ret));
+                return static_cast<int>(getHTTPStatusCode(ret));
+            }
+
+            if (has_range) {
+                ret = dsd.seek(start_seconds, duration_seconds);
+                if (ret != ErrorCode::Success) {
+                    std::cerr << "Error: range outside the file\n";
+                    return static_cast<int>(getHTTPStatusCode(ret));
+                }
+            }
+
+            // Step 2: Get metadata
+            metadata = dsd.getMetadata();
+            LOG_INFO("DSD metadata extracted successfully");
+
+            #ifdef PLATFORM_WINDOWS
+            DWORD mode;
+            bool is_piped = !GetConsoleMode(GetStdHandle(STD_OUTPUT_HANDLE), &mode);
+            #else
+            bool is_piped = !isatty(STDOUT_FILENO);
+            #endif
+
+            metadata.streaming_mode = (is_piped || data_only);
+
+            // Step 3: Output metadata as JSON
+            if (!data_only) {
+                std::cout << ::metadataToJSON(metadata);
+                std::cout.flush();
+                LOG_INFO("Metadata output to stdout");
+            }
+
+            // Step 4: Stream PCM (or DoP) data
+            if (!metadata_only && (data_only || is_piped)) {
+                load::ChunkOutput output(output_buffer_kb * 1024);
+
+                auto streaming_callback = [&](const float* chunk_data, size_t chunk_samples) -> bool {
+                    return output.write(chunk_data, chunk_samples);
+                };
+
+                LOG_INFO("Starting native DSD streaming...");
+                ret = dsd.streamPCM(streaming_callback, 64 * 1024);
+
+                if (ret != ErrorCode::Success) {
+                    LOG_ERROR("DSD streaming failed: {}", static_cast<int>(ret));
+                    return static_cast<int>(getHTTPStatusCode(ret));
+                }
+
+                if (!output.finish()) {
+                    LOG_ERROR("Writing PCM data to stdout failed");
+                    return static_cast<int>(getHTTPStatusCode(ErrorCode::FileWriteError));
+                }
+
+                LOG_INFO("Native DSD streaming complete: {} chunks", output.chunkCount());
+            } else if (!metadata_only) {
+                LOG_INFO("PCM data skipped (not in pipe mode, use -d to force output)");
+            }
+            goto decoder_done;
+        }
+
+        // FFmpeg decoder (used as default or when SACD fails)
+        if (dsd_decoder == "ffmpeg") {
+            // Default: Use FFmpeg decoder (has built-in DSD support via dsd2pcm)
+            LOG_INFO("Using FFmpeg decoder (streaming mode - supports DSD via dsd2pcm)");
+            load::AudioFileLoader loader;
+
+            // Set target sample rate (0 = keep original or use DSD decimation)
+            loader.setTargetSampleRate(target_sample_rate);
+            loader.setDecoderThreads(decoder_threads);
+            loader.setInputIO(input_io, io_buffer_size);
+            loader.setNativeSampleFormat(native_sample_format);
+            loader.setReadAhead(read_ahead);
+            if (!mapped_formats.empty()) {
+                loader.setMappedFormats(mapped_formats);
+            }
+
+            // For DSD files, set decimation factor
+            if (is_dsd) {
+                loader.setDSDDecimation(dsd_decimation);
+                LOG_INFO("DSD file detected: using decimation factor {}", dsd_decimation);
+            }
+
+            // Step 1: Prepare streaming (opens file and extracts metadata)
+            ret = loader.prepareStreaming(input_file);
+            if (ret != ErrorCode::Success) {
+                std::string error_msg = "Error code: " + std::to_string(static_cast<int>(ret));
+                std::cerr << error_msg << "\n";
+                LOG_ERROR("Failed to prepare streaming: {}", static_cast<int>(ret));
+                return static_cast<int>(getHTTPStatusCode(ret));
+            }
+
+            if (has_range) {
+                ret = loader.seek(start_seconds, duration_seconds);
+                if (ret != ErrorCode::Success) {
+                    std::cerr << "Error: range outside the file\n";
+                    return static_cast<int>(getHTTPStatusCode(ret));
+                }
+            }
+
+            // Step 2: Get metadata
+            metadata = loader.getMetadata();
+            LOG_INFO("Metadata extracted successfully");
+
+            // Mark high-resolution audio
+            if (metadata.sample_rate >= 96000) {
+                metadata.is_high_res = true;
+                LOG_INFO("High-resolution audio detected: {} Hz", metadata.sample_rate);
+            }
+
+            // Detect if we're in pipe mode (stdout is connected to another program)
+            // This is done BEFORE outputting metadata, so we can set streaming_mode flag
+            #ifdef PLATFORM_WINDOWS
+            DWORD mode;
+            bool is_piped = !GetConsoleMode(GetStdHandle(STD_OUTPUT_HANDLE), &mode);
+            #else
+            bool is_piped = !isatty(STDOUT_FILENO);
+            #endif
+
+            // Set streaming_mode flag based on pipe detection
+            // If we're in pipe mode OR --data option is specified, we're streaming
+            metadata.streaming_mode = (is_piped || data_only);
+
+            if (metadata.streaming_mode) {
+                LOG_INFO("Streaming mode detected (pipe to another program)");
+            } else {
+                LOG_INFO("File mode (stdout is terminal)");
+            }
+
+            // Step 3: Output metadata as JSON
+            if (!data_only) {
+                std::cout << ::metadataToJSON(metadata);
+                std::cout.flush();
+                LOG_INFO("Metadata output to stdout");
+            }
+
+            // Step 4: Stream PCM data ONLY if:
+            // 1. --data option is specified, OR
+            // 2. stdout is NOT a terminal (piped to another program)
+            // Note: streaming_mode flag already indicates this condition
+
+            if (!metadata_only && (data_only || is_piped)) {
+                // Stream PCM data using callback
+                load::ChunkOutput output(output_buffer_kb * 1024);
+
+                auto streaming_callback = [&](const uint8_t* chunk_data, size_t chunk_bytes) -> bool {
+                    return output.writeBytes(chunk_data, chunk_bytes);
+                };
+
+                LOG_INFO("Starting PCM data streaming...");
+                ret = loader.streamRawPCM(streaming_callback, 64 * 1024);  // 64KB chunks
+
+                if (ret != ErrorCode::Success) {
+                    LOG_ERROR("Streaming failed: {}", static_cast<int>(ret));
+                    return static_cast<int>(getHTTPStatusCode(ret));
+                }
+
+                if (!output.finish()) {
+                    LOG_ERROR("Writing PCM data to stdout failed");
+                    return static_cast<int>(getHTTPStatusCode(ErrorCode::FileWriteError));
+                }
+
+                LOG_INFO("PCM data streaming complete: {} chunks", output.chunkCount());
+            } else if (!metadata_only) {
+                LOG_INFO("PCM data skipped (not in pipe mode, use -d to force output)");
+            }
+        }
+    } else {
+        // Non-DSD files: always use FFmpeg decoder
+        LOG_INFO("Using FFmpeg decoder (streaming mode)");
+        load::AudioFileLoader loader;
+        loader.setTargetSampleRate(target_sample_rate);
+        loader.setDecoderThreads(decoder_threads);
+        loader.setInputIO(input_io, io_buffer_size);
+        loader.setNativeSampleFormat(native_sample_format);
+        loader.setReadAhead(read_ahead);
+        if (!mapped_formats.empty()) {
+            loader.setMappedFormats(mapped_formats);
+        }
+
+        // Step 1: Prepare streaming (opens file and extracts metadata)
+        ret = loader.prepareStreaming(input_file);
+        if (ret != ErrorCode::Success) {
+            std::string error_msg = "Error code: " + std::to_string(static_cast<int>(ret));
+            std::cerr << error_msg << "\n";
+            LOG_ERROR("Failed to prepare streaming: {}", static_cast<int>(ret));
+            return static_cast<int>(getHTTPStatusCode(ret));
+        }
+
+        if (has_range) {
+            ret = loader.seek(start_seconds, duration_seconds);
+            if (ret != ErrorCode::Success) {
+                std::cerr << "Error: range outside the file\n";
+                return static_cast<int>(getHTTPStatusCode(ret));
+            }
+        }
+
+        // Step 2: Get metadata
+        metadata = loader.getMetadata();
+        LOG_INFO("Metadata extracted successfully");
+
+        // Mark high-resolution audio
+        if (metadata.sample_rate >= 96000) {
+            metadata.is_high_res = true;
+            LOG_INFO("High-resolution audio detected: {} Hz", metadata.sample_rate);
+        }
+
+        // Detect if we're in pipe mode
+        #ifdef PLATFORM_WINDOWS
+        DWORD mode;
+        bool is_piped = !GetConsoleMode(GetStdHandle(STD_OUTPUT_HANDLE), &mode);
+        #else
+        bool is_piped = !isatty(STDOUT_FILENO);
+        #endif
+
+        // Set streaming_mode flag based on pipe detection
+        metadata.streaming_mode = (is_piped || data_only);
+
+        if (metadata.streaming_mode) {
+            LOG_INFO("Streaming mode detected (pipe to another program)");
+        } else {
+            LOG_INFO("File mode (stdout is terminal)");
+        }
+
+        // Step 3: Output metadata as JSON
+        if (!data_only) {
+            std::cout << ::metadataToJSON(metadata);
+            std::cout.flush();
+            LOG_INFO("Metadata output to stdout");
+        }
+
+        // Step 4: Stream PCM data ONLY if:
+        // 1. --data option is specified, OR
+        // 2. stdout is NOT a terminal (piped to another program)
+        // Note: streaming_mode flag already indicates this condition
+
+        if (!metadata_only && (data_only || is_piped)) {
+            // Stream PCM data using callback
+            load::ChunkOutput output(output_buffer_kb * 1024);
+
+            auto streaming_callback = [&](const uint8_t* chunk_data, size_t chunk_bytes) -> bool {
+                return output.writeBytes(chunk_data, chunk_bytes);
+            };
+
+            LOG_INFO("Starting PCM data streaming...");
+            ret = loader.streamRawPCM(streaming_callback, 64 * 1024);  // 64KB chunks
+
+            if (ret != ErrorCode::Success) {
+                LOG_ERROR("Streaming failed: {}", static_cast<int>(ret));
+                return static_cast<int>(getHTTPStatusCode(ret));
+            }
+
+            if (!output.finish()) {
+                LOG_ERROR("Writing PCM data to stdout failed");
+                return static_cast<int>(getHTTPStatusCode(ErrorCode::FileWriteError));
+            }
+
+            LOG_INFO("PCM data streaming complete: {} chunks", output.chunkCount());
+        } else if (!metadata_only) {
+            LOG_INFO("PCM data skipped (not in pipe mode, use -d to force output)");
+        }
+    }
+
+decoder_done:
+    LOG_INFO("xpuLoad completed successfully");
+    return 0;
+}
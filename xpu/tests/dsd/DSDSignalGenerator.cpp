@@ -0,0 +1,367 @@
+#include "DSDSignalGenerator.h"
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <fstream>
+
+namespace xpu {
+namespace test {
+
+namespace {
+
+constexpr double PI = 3.14159265358979323846;
+constexpr uint8_t DSD_SILENCE = 0x69;
+constexpr size_t DSF_BLOCK_SIZE = 4096;
+
+// Integrator states beyond this mean the loop has overloaded
+constexpr double OVERLOAD_LIMIT = 1.0e4;
+
+/**
+ * @brief Denominator of (1 - z^-1)^N / A(z) with Butterworth high-pass poles
+ */
+std::vector<double> butterworthDenominator(int order, double cutoff) {
+    const double warped = std::tan(PI * cutoff);
+    std::vector<std::complex<double>> poly(1, 1.0);
+    for (int k = 0; k < order; ++k) {
+        // Left-half-plane low-pass prototype pole, mapped to high-pass, then bilinear
+        std::complex<double> lp = std::polar(1.0, PI * (2.0 * k + order + 1) / (2.0 * order));
+        std::complex<double> s = warped / lp;
+        std::complex<double> z = (1.0 + s) / (1.0 - s);
+
+        std::vector<std::complex<double>> next(poly.size() + 1, 0.0);
+        for (size_t i = 0; i < poly.size(); ++i) {
+            next[i] += poly[i];
+            next[i + 1] -= poly[i] * z;
+        }
+        poly.swap(next);
+    }
+
+    std::vector<double> a(poly.size());
+    for (size_t i = 0; i < poly.size(); ++i) {
+        a[i] = poly[i].real();
+    }
+    return a;
+}
+
+/**
+ * @brief NTF gain at Nyquist: |(1 + 1)^N / A(-1)|
+ */
+double nyquistGain(const std::vector<double>& a) {
+    double sum = 0.0;
+    for (size_t i = 0; i < a.size(); ++i) {
+        sum += (i & 1) ? -a[i] : a[i];
+    }
+    return std::pow(2.0, static_cast<double>(a.size() - 1)) / std::fabs(sum);
+}
+
+void writeBE(std::ofstream& out, uint64_t value, int bytes) {
+    for (int i = bytes - 1; i >= 0; --i) {
+        out.put(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+}
+
+void writeLE(std::ofstream& out, uint64_t value, int bytes) {
+    for (int i = 0; i < bytes; ++i) {
+        out.put(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+}
+
+uint8_t reverseBits(uint8_t v) {
+    uint8_t r = 0;
+    for (int bit = 0; bit < 8; ++bit) {
+        if (v & (1 << bit)) {
+            r |= static_cast<uint8_t>(0x80 >> bit);
+        }
+    }
+    return r;
+}
+
+} // anonymous namespace
+
+uint64_t DSDSignalSpec::sampleCount() const {
+    return static_cast<uint64_t>(duration * dsd_rate) / 8 * 8;
+}
+
+DSDSignalSpec DSDSignalSpec::sine(double frequency, double amplitude, uint32_t dsd_rate,
+                                  double duration, uint32_t channels) {
+    DSDSignalSpec spec;
+    spec.dsd_rate = dsd_rate;
+    spec.channels = channels;
+    spec.duration = duration;
+    spec.channel_tones.push_back({{frequency, amplitude}});
+    return spec;
+}
+
+DSDSignalSpec DSDSignalSpec::multitone(const std::vector<double>& frequencies, double total_amplitude,
+                                       uint32_t dsd_rate, double duration, uint32_t channels) {
+    DSDSignalSpec spec;
+    spec.dsd_rate = dsd_rate;
+    spec.channels = channels;
+    spec.duration = duration;
+    std::vector<DSDTone> tones;
+    for (size_t i = 0; i < frequencies.size(); ++i) {
+        // Spread the phases so the peaks of the tones do not line up
+        tones.push_back({frequencies[i], total_amplitude / frequencies.size(),
+                         PI * i * i / frequencies.size()});
+    }
+    spec.channel_tones.push_back(tones);
+    return spec;
+}
+
+SigmaDeltaModulator::SigmaDeltaModulator(int order, double h_inf)
+    : order_(std::max(1, std::min(order, MAX_ORDER)))
+    , resets_(0)
+{
+    // Out-of-band gain grows with the cutoff: bisect for |NTF(-1)| = h_inf
+    double lo = 1.0e-6;
+    double hi = 0.49;
+    for (int i = 0; i < 100; ++i) {
+        double mid = 0.5 * (lo + hi);
+        if (nyquistGain(butterworthDenominator(order_, mid)) > h_inf) {
+            hi = mid;
+        } else {
+            lo = mid;
+        }
+    }
+    a_ = butterworthDenominator(order_, lo);
+
+    // Numerator (1 - z^-1)^N
+    std::vector<double> b(order_ + 1, 0.0);
+    b[0] = 1.0;
+    for (int n = 0; n < order_; ++n) {
+        for (int k = n + 1; k > 0; --k) {
+            b[k] -= b[k - 1];
+        }
+    }
+    feedback_.resize(order_);
+    for (int k = 1; k <= order_; ++k) {
+        feedback_[k - 1] = b[k] - a_[k];
+    }
+    reset();
+}
+
+void SigmaDeltaModulator::reset() {
+    err_.assign(order_, 0.0);
+    w_.assign(order_, 0.0);
+}
+
+void SigmaDeltaModulator::process(const double* input, size_t samples, uint8_t* out) {
+    // y = Q(x + w), e = y - (x + w), w = (NTF - 1) e  =>  Y = X + NTF * E
+    for (size_t i = 0; i < samples; i += 8) {
+        uint8_t byte = 0;
+        for (int bit = 0; bit < 8; ++bit) {
+            double w = 0.0;
+            for (int k = 0; k < order_; ++k) {
+                w += feedback_[k] * err_[k] - a_[k + 1] * w_[k];
+            }
+            double v = input[i + bit] + w;
+            double y = v >= 0.0 ? 1.0 : -1.0;
+
+            if (std::fabs(w) > OVERLOAD_LIMIT) {
+                ++resets_;
+                reset();
+                w = 0.0;
+                v = input[i + bit];
+                y = v >= 0.0 ? 1.0 : -1.0;
+            }
+
+            for (int k = order_ - 1; k > 0; --k) {
+                err_[k] = err_[k - 1];
+                w_[k] = w_[k - 1];
+            }
+            err_[0] = y - v;
+            w_[0] = w;
+
+            byte = static_cast<uint8_t>((byte << 1) | (y > 0.0 ? 1 : 0));
+        }
+        out[i / 8] = byte;
+    }
+}
+
+DSDSignalGenerator::DSDSignalGenerator(const DSDSignalSpec& spec, int modulator_order)
+    : spec_(spec)
+    , position_(0)
+{
+    for (uint32_t ch = 0; ch < spec_.channels; ++ch) {
+        modulators_.emplace_back(modulator_order);
+
+        std::vector<Oscillator> oscillators;
+        if (!spec_.channel_tones.empty()) {
+            size_t index = std::min<size_t>(ch, spec_.channel_tones.size() - 1);
+            for (const DSDTone& tone : spec_.channel_tones[index]) {
+                double step = 2.0 * PI * tone.frequency / spec_.dsd_rate;
+                // Start a quarter turn back so phase 0 is a sine
+                double start = tone.phase - PI / 2.0;
+                oscillators.push_back({std::cos(step), std::sin(step),
+                                       std::cos(start), std::sin(start), tone.amplitude});
+            }
+        }
+        oscillators_.push_back(oscillators);
+    }
+}
+
+size_t DSDSignalGenerator::generate(size_t bytes_per_channel, std::vector<std::vector<uint8_t>>& channels) {
+    const uint64_t total_bytes = spec_.sampleCount() / 8;
+    const size_t signal_bytes = static_cast<size_t>(
+        std::min<uint64_t>(bytes_per_channel, total_bytes - std::min(total_bytes, position_)));
+
+    channels.resize(spec_.channels);
+    scratch_.resize(signal_bytes * 8);
+
+    for (uint32_t ch = 0; ch < spec_.channels; ++ch) {
+        channels[ch].assign(bytes_per_channel, DSD_SILENCE);
+
+        std::fill(scratch_.begin(), scratch_.end(), 0.0);
+        for (Oscillator& osc : oscillators_[ch]) {
+            for (size_t i = 0; i < scratch_.size(); ++i) {
+                scratch_[i] += osc.amplitude * osc.re;
+                double re = osc.re * osc.cos_step - osc.im * osc.sin_step;
+                osc.im = osc.re * osc.sin_step + osc.im * osc.cos_step;
+                osc.re = re;
+            }
+            // Keep the phasor on the unit circle
+            double norm = 1.0 / std::sqrt(osc.re * osc.re + osc.im * osc.im);
+            osc.re *= norm;
+            osc.im *= norm;
+        }
+
+        modulators_[ch].process(scratch_.data(), scratch_.size(), channels[ch].data());
+    }
+
+    position_ += signal_bytes;
+    return signal_bytes;
+}
+
+uint64_t DSDSignalGenerator::getResetCount() const {
+    uint64_t resets = 0;
+    for (const auto& modulator : modulators_) {
+        resets += modulator.getResetCount();
+    }
+    return resets;
+}
+
+ErrorCode writeDSF(const std::string& path, const DSDSignalSpec& spec) {
+    std::ofstream out(path, std::ios::binary);
+    if (!out) {
+        return ErrorCode::FileWriteError;
+    }
+
+    const uint64_t samples = spec.sampleCount();
+    const uint64_t blocks = (samples / 8 + DSF_BLOCK_SIZE - 1) / DSF_BLOCK_SIZE;
+    const uint64_t data_size = blocks * DSF_BLOCK_SIZE * spec.channels;
+    const uint64_t file_size = 28 + 52 + 12 + data_size;
+    // DSF channel types: 1 mono, 2 stereo, ... 7 for 5.1
+    const uint32_t channel_type = spec.channels == 6 ? 7 : spec.channels;
+
+    out.write("DSD ", 4);
+    writeLE(out, 28, 8);
+    writeLE(out, file_size, 8);
+    writeLE(out, 0, 8);          // No metadata chunk
+
+    out.write("fmt ", 4);
+    writeLE(out, 52, 8);
+    writeLE(out, 1, 4);          // Format version
+    writeLE(out, 0, 4);          // DSD raw
+    writeLE(out, channel_type, 4);
+    writeLE(out, spec.channels, 4);
+    writeLE(out, spec.dsd_rate, 4);
+    writeLE(out, 1, 4);          // Bits per sample: LSB first
+    writeLE(out, samples, 8);
+    writeLE(out, DSF_BLOCK_SIZE, 4);
+    writeLE(out, 0, 4);
+
+    out.write("data", 4);
+    writeLE(out, 12 + data_size, 8);
+
+    DSDSignalGenerator generator(spec);
+    std::vector<std::vector<uint8_t>> channels;
+    for (uint64_t block = 0; block < blocks; ++block) {
+        size_t valid = generator.generate(DSF_BLOCK_SIZE, channels);
+        for (auto& data : channels) {
+            for (size_t i = 0; i < DSF_BLOCK_SIZE; ++i) {
+                // Unused tail of the last block is zero-filled per the DSF spec
+                data[i] = i < valid ? reverseBits(data[i]) : 0;
+            }
+            out.write(reinterpret_cast<const char*>(data.data()), DSF_BLOCK_SIZE);
+        }
+    }
+
+    return out.good() ? ErrorCode::Success : ErrorCode::FileWriteError;
+}
+
+ErrorCode writeDSDIFF(const std::string& path, const DSDSignalSpec& spec) {
+    std::ofstream out(path, std::ios::binary);
+    if (!out) {
+        return ErrorCode::FileWriteError;
+    }
+
+    static const char* const CHANNEL_IDS[] = {"SLFT", "SRGT", "C   ", "LFE ", "LS  ", "RS  "};
+
+    const uint64_t data_size = spec.sampleCount() / 8 * spec.channels;
+    const uint64_t chnl_size = 2 + 4 * static_cast<uint64_t>(spec.channels);
+    const uint64_t cmpr_size = 4 + 1 + 14 + 1;   // "not compressed" + pad to even
+    const uint64_t prop_size = 4 + (12 + 4) + (12 + chnl_size) + (12 + cmpr_size);
+    const uint64_t form_size = 4 + (12 + 4) + (12 + prop_size) + (12 + data_size + (data_size & 1));
+
+    out.write("FRM8", 4);
+    writeBE(out, form_size, 8);
+    out.write("DSD ", 4);
+
+    out.write("FVER", 4);
+    writeBE(out, 4, 8);
+    writeBE(out, 0x01050000, 4);
+
+    out.write("PROP", 4);
+    writeBE(out, prop_size, 8);
+    out.write("SND ", 4);
+
+    out.write("FS  ", 4);
+    writeBE(out, 4, 8);
+    writeBE(out, spec.dsd_rate, 4);
+
+    out.write("CHNL", 4);
+    writeBE(out, chnl_size, 8);
+    writeBE(out, spec.channels, 2);
+    for (uint32_t ch = 0; ch < spec.channels; ++ch) {
+        if (ch < 6) {
+            out.write(CHANNEL_IDS[ch], 4);
+        } else {
+            out.write("C", 1);
+            writeBE(out, ch, 3);
+        }
+    }
+
+    out.write("CMPR", 4);
+    writeBE(out, cmpr_size, 8);
+    out.write("DSD ", 4);
+    out.put(14);
+    out.write("not compressed", 14);
+    out.put(0);
+
+    out.write("DSD ", 4);
+    writeBE(out, data_size, 8);
+
+    DSDSignalGenerator generator(spec);
+    std::vector<std::vector<uint8_t>> channels;
+    std::vector<uint8_t> interleaved;
+    uint64_t remaining = spec.sampleCount() / 8;
+    while (remaining > 0) {
+        size_t bytes = generator.generate(static_cast<size_t>(std::min<uint64_t>(remaining, 65536)), channels);
+        interleaved.resize(bytes * spec.channels);
+        for (size_t i = 0; i < bytes; ++i) {
+            for (uint32_t ch = 0; ch < spec.channels; ++ch) {
+                interleaved[i * spec.channels + ch] = channels[ch][i];
+            }
+        }
+        out.write(reinterpret_cast<const char*>(interleaved.data()), interleaved.size());
+        remaining -= bytes;
+    }
+    if (data_size & 1) {
+        out.put(0);
+    }
+
+    return out.good() ? ErrorCode::Success : ErrorCode::FileWriteError;
+}
+
+} // namespace test
+} // namespace xpu
@@ -0,0 +1,157 @@
+#ifndef XPU_TEST_DSD_SIGNAL_GENERATOR_H
+#define XPU_TEST_DSD_SIGNAL_GENERATOR_H
+
+#include "protocol/ErrorCode.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace xpu {
+namespace test {
+
+/**
+ * @brief Base DSD rate (DSD64 = 64 x 44.1 kHz)
+ */
+constexpr uint32_t DSD64_RATE = 2822400;
+
+/**
+ * @brief One sine component of a test signal
+ */
+struct DSDTone {
+    double frequency;   // Hz
+    double amplitude;   // Linear, 1.0 = full DSD modulation (keep the sum <= 0.5)
+    double phase = 0.0; // Radians
+};
+
+/**
+ * @brief Test signal description
+ *
+ * channel_tones[ch] lists the tones of channel ch; channels beyond the
+ * list reuse the last entry (so one entry gives every channel the same
+ * signal). An empty tone list is digital silence.
+ */
+struct DSDSignalSpec {
+    uint32_t dsd_rate = DSD64_RATE;   // DSD64 .. DSD1024
+    uint32_t channels = 2;
+    double duration = 1.0;            // Seconds
+    std::vector<std::vector<DSDTone>> channel_tones;
+
+    /**
+     * @brief Samples per channel (rounded down to whole bytes)
+     */
+    uint64_t sampleCount() const;
+
+    /**
+     * @brief The same sine on every channel
+     */
+    static DSDSignalSpec sine(double frequency, double amplitude, uint32_t dsd_rate = DSD64_RATE,
+                              double duration = 1.0, uint32_t channels = 2);
+
+    /**
+     * @brief Equal-amplitude tones summing to total_amplitude on every channel
+     */
+    static DSDSignalSpec multitone(const std::vector<double>& frequencies, double total_amplitude,
+                                   uint32_t dsd_rate = DSD64_RATE, double duration = 1.0,
+                                   uint32_t channels = 2);
+};
+
+/**
+ * @brief 1-bit sigma-delta modulator
+ *
+ * Error-feedback structure with a Butterworth-type noise transfer function:
+ * all NTF zeros at DC, poles placed so the out-of-band gain is h_inf (1.5,
+ * the usual stability limit for 1-bit quantizers). Order 5 keeps the
+ * 20 kHz band noise well below what the decimators can resolve at DSD64,
+ * which makes the output a usable reference for SNR/THD measurements.
+ * If the loop ever overloads, its state is reset and counted.
+ */
+class SigmaDeltaModulator {
+public:
+    static constexpr int MAX_ORDER = 8;
+
+    explicit SigmaDeltaModulator(int order = 5, double h_inf = 1.5);
+
+    void reset();
+
+    /**
+     * @brief Modulate samples into MSB-first DSD bytes
+     * @param input samples (count must be a multiple of 8)
+     * @param out samples / 8 bytes
+     */
+    void process(const double* input, size_t samples, uint8_t* out);
+
+    int getOrder() const { return order_; }
+
+    /**
+     * @brief NTF denominator a[0..order] (a[0] = 1)
+     */
+    const std::vector<double>& getDenominator() const { return a_; }
+
+    /**
+     * @brief Number of overload resets so far
+     */
+    uint64_t getResetCount() const { return resets_; }
+
+private:
+    int order_;
+    std::vector<double> a_;        // NTF denominator
+    std::vector<double> feedback_; // b[k] - a[k], k = 1..order
+    std::vector<double> err_;      // e[n-1..n-order]
+    std::vector<double> w_;        // filter output history w[n-1..n-order]
+    uint64_t resets_;
+};
+
+/**
+ * @brief Streaming DSD test-signal generator
+ *
+ * Produces the signal described by a DSDSignalSpec block by block, one
+ * modulator per channel, so files of any length use constant memory.
+ */
+class DSDSignalGenerator {
+public:
+    explicit DSDSignalGenerator(const DSDSignalSpec& spec, int modulator_order = 5);
+
+    const DSDSignalSpec& getSpec() const { return spec_; }
+
+    /**
+     * @brief Generate the next bytes_per_channel bytes of every channel
+     * @param channels Resized to spec.channels planar buffers (MSB first);
+     *        past the end of the signal the remainder is DSD silence
+     * @return Bytes per channel that belong to the signal
+     */
+    size_t generate(size_t bytes_per_channel, std::vector<std::vector<uint8_t>>& channels);
+
+    /**
+     * @brief Total modulator overload resets across channels
+     */
+    uint64_t getResetCount() const;
+
+private:
+    struct Oscillator {
+        double cos_step, sin_step;   // Per-sample rotation
+        double re, im;               // Current phasor
+        double amplitude;
+    };
+
+    DSDSignalSpec spec_;
+    std::vector<SigmaDeltaModulator> modulators_;
+    std::vector<std::vector<Oscillator>> oscillators_;
+    std::vector<double> scratch_;
+    uint64_t position_;  // Bytes generated per channel
+};
+
+/**
+ * @brief Write a test signal as a DSF file (LSB first, 4096-byte blocks)
+ */
+ErrorCode writeDSF(const std::string& path, const DSDSignalSpec& spec);
+
+/**
+ * @brief Write a test signal as an uncompressed DSDIFF 1.5 file
+ */
+ErrorCode writeDSDIFF(const std::string& path, const DSDSignalSpec& spec);
+
+} // namespace test
+} // namespace xpu
+
+#endif // XPU_TEST_DSD_SIGNAL_GENERATOR_H
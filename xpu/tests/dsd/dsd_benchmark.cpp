@@ -0,0 +1,383 @@
+/**
+ * @file dsd_benchmark.cpp
+ * @brief DSD decoder throughput / memory / accuracy benchmark
+ *
+ * Generates sine test files at DSD64..DSD1024 with the synthetic DSD
+ * generator, then streams each through load::DSDDecoder for every
+ * decimation factor, filter mode and thread setting (plus DoP output),
+ * reporting x-realtime throughput, peak RSS and, for PCM output, the SNR
+ * and THD of the decoded tone in the 20 Hz - 20 kHz band.
+ *
+ * Usage: dsd_benchmark [--duration sec] [--max-rate 64|128|256|512|1024]
+ *                      [--dir path] [--keep] [--verbose]
+ */
+
+#include "DSDSignalGenerator.h"
+#include "../../src/xpuLoad/DSDDecoder.h"
+#include "utils/Logger.h"
+#include "utils/PlatformUtils.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef PLATFORM_WINDOWS
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+using namespace xpu;
+
+namespace {
+
+constexpr double PI = 3.14159265358979323846;
+constexpr double TEST_FREQUENCY = 997.0;   // Not a sub-multiple of any rate
+constexpr double TEST_AMPLITUDE = 0.5;     // -6 dB re full DSD modulation
+constexpr size_t MAX_FFT_SIZE = 1 << 20;
+
+/**
+ * @brief Reset the peak RSS counter where the OS allows it
+ */
+void resetPeakRSS() {
+#ifdef PLATFORM_LINUX
+    // "5" resets VmHWM to the current RSS (Linux 4.0+)
+    std::ofstream clear("/proc/self/clear_refs");
+    clear << "5";
+#endif
+}
+
+/**
+ * @brief Peak resident set size in bytes
+ *
+ * On Linux this is the peak since the last resetPeakRSS(); elsewhere it is
+ * the process-wide peak, so only growth between runs is meaningful.
+ */
+size_t peakRSS() {
+#if defined(PLATFORM_WINDOWS)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return counters.PeakWorkingSetSize;
+    }
+    return 0;
+#else
+#ifdef PLATFORM_LINUX
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.compare(0, 6, "VmHWM:") == 0) {
+            return static_cast<size_t>(std::strtoull(line.c_str() + 6, nullptr, 10)) * 1024;
+        }
+    }
+#endif
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef PLATFORM_MACOS
+    return static_cast<size_t>(usage.ru_maxrss);          // Bytes on macOS
+#else
+    return static_cast<size_t>(usage.ru_maxrss) * 1024;   // KiB elsewhere
+#endif
+#endif
+}
+
+/**
+ * @brief In-place radix-2 FFT (size must be a power of two)
+ */
+void fft(std::vector<std::complex<double>>& data) {
+    const size_t n = data.size();
+    for (size_t i = 1, j = 0; i < n; ++i) {
+        size_t bit = n >> 1;
+        for (; j & bit; bit >>= 1) {
+            j ^= bit;
+        }
+        j ^= bit;
+        if (i < j) {
+            std::swap(data[i], data[j]);
+        }
+    }
+    for (size_t len = 2; len <= n; len <<= 1) {
+        std::complex<double> step = std::polar(1.0, -2.0 * PI / len);
+        for (size_t i = 0; i < n; i += len) {
+            std::complex<double> w(1.0, 0.0);
+            for (size_t k = 0; k < len / 2; ++k) {
+                std::complex<double> u = data[i + k];
+                std::complex<double> v = data[i + k + len / 2] * w;
+                data[i + k] = u + v;
+                data[i + k + len / 2] = u - v;
+                w *= step;
+            }
+        }
+    }
+}
+
+struct ToneAnalysis {
+    double snr_db = 0.0;      // Fundamental vs. in-band noise (harmonics excluded)
+    double thd_db = 0.0;      // Harmonics 2..5 vs. fundamental
+};
+
+/**
+ * @brief Least-squares fit of a sinusoid at a known frequency; subtracts it from x
+ * @return Fitted power (amplitude^2 / 2)
+ */
+double removeSinusoid(std::vector<double>& x, double cycles_per_sample) {
+    double scc = 0.0, sss = 0.0, ssc = 0.0, sxc = 0.0, sxs = 0.0;
+    const std::complex<double> step = std::polar(1.0, 2.0 * PI * cycles_per_sample);
+    std::complex<double> phasor(1.0, 0.0);
+    for (double v : x) {
+        double c = phasor.real();
+        double s = phasor.imag();
+        scc += c * c;
+        sss += s * s;
+        ssc += s * c;
+        sxc += v * c;
+        sxs += v * s;
+        phasor *= step;
+    }
+    double det = scc * sss - ssc * ssc;
+    if (std::fabs(det) < 1e-12) {
+        return 0.0;
+    }
+    double a = (sxc * sss - sxs * ssc) / det;
+    double b = (sxs * scc - sxc * ssc) / det;
+
+    phasor = 1.0;
+    for (double& v : x) {
+        v -= a * phasor.real() + b * phasor.imag();
+        phasor *= step;
+    }
+    return (a * a + b * b) / 2.0;
+}
+
+/**
+ * @brief Measure a single tone: sine-fit the fundamental and harmonics 2..5,
+ *        then take the in-band power of the residual from a Hann-windowed FFT
+ *
+ * Subtracting the fitted tones keeps window leakage of the (much stronger)
+ * fundamental out of the noise floor. The first and last 10% are skipped so
+ * filter settling and the tail do not count as noise.
+ */
+ToneAnalysis analyzeTone(const std::vector<float>& samples, double sample_rate, double frequency) {
+    ToneAnalysis result;
+    const size_t skip = samples.size() / 10;
+    size_t n = 1;
+    while (n * 2 <= samples.size() - 2 * skip && n * 2 <= MAX_FFT_SIZE) {
+        n *= 2;
+    }
+    if (n < 1024) {
+        return result;
+    }
+
+    const double band_top = std::min(20000.0, sample_rate / 2.0);
+    std::vector<double> residual(samples.begin() + skip, samples.begin() + skip + n);
+    double fundamental = removeSinusoid(residual, frequency / sample_rate);
+    double harmonics = 0.0;
+    for (int h = 2; h <= 5 && h * frequency < band_top; ++h) {
+        harmonics += removeSinusoid(residual, h * frequency / sample_rate);
+    }
+
+    std::vector<std::complex<double>> spectrum(n);
+    double window_power = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        double w = 0.5 - 0.5 * std::cos(2.0 * PI * i / n);
+        spectrum[i] = residual[i] * w;
+        window_power += w * w;
+    }
+    fft(spectrum);
+
+    const double bin_hz = sample_rate / n;
+    const size_t first_bin = static_cast<size_t>(std::ceil(20.0 / bin_hz));
+    const size_t last_bin = std::min(n / 2 - 1, static_cast<size_t>(band_top / bin_hz));
+    double noise = 0.0;
+    for (size_t b = first_bin; b <= last_bin; ++b) {
+        noise += std::norm(spectrum[b]);
+    }
+    // One-sided spectrum -> mean square of the band-limited residual
+    noise *= 2.0 / (n * window_power);
+
+    result.snr_db = 10.0 * std::log10(fundamental / std::max(noise, 1e-30));
+    result.thd_db = 10.0 * std::log10(std::max(harmonics, 1e-30) / std::max(fundamental, 1e-30));
+    return result;
+}
+
+struct RunConfig {
+    int decimation;
+    audio::DSDFilterMode filter;
+    int threads;                  // 1 = serial, 0 = one per CPU
+    load::DSDOutputMode output;
+};
+
+struct RunResult {
+    ErrorCode error = ErrorCode::Success;
+    double realtime = 0.0;
+    size_t peak_rss = 0;
+    int sample_rate = 0;
+    bool analyzed = false;
+    ToneAnalysis tone;
+};
+
+RunResult runDecoder(const std::string& path, const RunConfig& config, double duration) {
+    RunResult result;
+
+    resetPeakRSS();
+    load::DSDDecoder decoder;
+    decoder.setDSDDecimation(config.decimation);
+    decoder.setDSDFilterMode(config.filter);
+    decoder.setDecodeThreads(config.threads);
+    decoder.setOutputMode(config.output);
+
+    auto start = std::chrono::steady_clock::now();
+    result.error = decoder.prepareStreaming(path);
+    if (result.error != ErrorCode::Success) {
+        return result;
+    }
+
+    const int channels = decoder.getMetadata().channels;
+    const bool analyze = config.output == load::DSDOutputMode::PCM;
+    std::vector<float> left;
+    result.error = decoder.streamPCM([&](const float* data, size_t samples) {
+        if (analyze) {
+            for (size_t i = 0; i < samples; i += channels) {
+                left.push_back(data[i]);
+            }
+        }
+        return true;
+    });
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    result.peak_rss = peakRSS();
+    if (result.error != ErrorCode::Success) {
+        return result;
+    }
+
+    result.realtime = duration / std::max(seconds, 1e-9);
+    result.sample_rate = decoder.getMetadata().sample_rate;
+    if (analyze) {
+        result.tone = analyzeTone(left, result.sample_rate, TEST_FREQUENCY);
+        result.analyzed = true;
+    }
+    return result;
+}
+
+const char* filterName(audio::DSDFilterMode mode) {
+    return mode == audio::DSDFilterMode::Fast ? "fast" : "filtered";
+}
+
+void printUsage(const char* program) {
+    std::printf("Usage: %s [--duration sec] [--max-rate 64|128|256|512|1024] [--dir path] [--keep] [--verbose]\n",
+                program);
+}
+
+} // anonymous namespace
+
+int main(int argc, char* argv[]) {
+    double duration = 2.0;
+    uint32_t max_multiple = 1024;
+    std::string dir = ".";
+    bool keep = false;
+    bool verbose = false;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--duration" && i + 1 < argc) {
+            duration = std::atof(argv[++i]);
+        } else if (arg == "--max-rate" && i + 1 < argc) {
+            max_multiple = static_cast<uint32_t>(std::atoi(argv[++i]));
+        } else if (arg == "--dir" && i + 1 < argc) {
+            dir = argv[++i];
+        } else if (arg == "--keep") {
+            keep = true;
+        } else if (arg == "--verbose") {
+            verbose = true;
+        } else {
+            printUsage(argv[0]);
+            return arg == "--help" || arg == "-h" ? 0 : 1;
+        }
+    }
+    if (duration <= 0.0) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    utils::Logger::initialize(utils::PlatformUtils::getLogFilePath(), true, verbose, "dsd_benchmark");
+
+    const unsigned int cpus = std::max(1u, std::thread::hardware_concurrency());
+    std::printf("DSD decoder benchmark: %.1f s %.0f Hz sine at %.1f, %u CPUs\n\n",
+                duration, TEST_FREQUENCY, TEST_AMPLITUDE, cpus);
+    std::printf("%-8s %-4s %-8s %-4s %-8s %4s %9s %10s %10s %8s %8s\n",
+                "rate", "fmt", "output", "dec", "filter", "thr", "out Hz", "x-realtime", "peak RSS", "SNR dB", "THD dB");
+
+    int failures = 0;
+    for (uint32_t multiple = 64; multiple <= max_multiple; multiple *= 2) {
+        test::DSDSignalSpec spec = test::DSDSignalSpec::sine(
+            TEST_FREQUENCY, TEST_AMPLITUDE, test::DSD64_RATE / 64 * multiple, duration, 2);
+
+        std::vector<std::pair<std::string, std::string>> files = {
+            {"dsf", dir + "/dsd" + std::to_string(multiple) + "_sine.dsf"},
+            {"dff", dir + "/dsd" + std::to_string(multiple) + "_sine.dff"},
+        };
+        if (test::writeDSF(files[0].second, spec) != ErrorCode::Success ||
+            test::writeDSDIFF(files[1].second, spec) != ErrorCode::Success) {
+            std::fprintf(stderr, "Cannot write test files to %s\n", dir.c_str());
+            return 1;
+        }
+
+        std::vector<RunConfig> configs;
+        for (int decimation : {16, 32, 64}) {
+            for (audio::DSDFilterMode filter : {audio::DSDFilterMode::Filtered, audio::DSDFilterMode::Fast}) {
+                configs.push_back({decimation, filter, 1, load::DSDOutputMode::PCM});
+                if (cpus > 1) {
+                    configs.push_back({decimation, filter, 0, load::DSDOutputMode::PCM});
+                }
+            }
+        }
+        configs.push_back({16, audio::DSDFilterMode::Filtered, 1, load::DSDOutputMode::DoP});
+
+        for (const auto& file : files) {
+            for (const RunConfig& config : configs) {
+                // DSDIFF shares the decode path: one PCM and one DoP row are enough
+                if (file.first == "dff" && !(config.decimation == 16 && config.threads == 1 &&
+                                             config.filter == audio::DSDFilterMode::Filtered)) {
+                    continue;
+                }
+
+                RunResult result = runDecoder(file.second, config, duration);
+                const char* output = config.output == load::DSDOutputMode::DoP ? "dop" : "pcm";
+                std::string rate = "DSD" + std::to_string(multiple);
+                if (result.error != ErrorCode::Success) {
+                    std::printf("%-8s %-4s %-8s %-4d %-8s %4u  failed: %s\n", rate.c_str(), file.first.c_str(),
+                                output, config.decimation, filterName(config.filter),
+                                config.threads ? config.threads : cpus, toString(result.error));
+                    ++failures;
+                    continue;
+                }
+
+                std::printf("%-8s %-4s %-8s %-4s %-8s %4u %9d %10.1f %8.1fMB",
+                            rate.c_str(), file.first.c_str(), output,
+                            config.output == load::DSDOutputMode::DoP ? "-" : std::to_string(config.decimation).c_str(),
+                            config.output == load::DSDOutputMode::DoP ? "-" : filterName(config.filter),
+                            config.threads ? config.threads : cpus, result.sample_rate,
+                            result.realtime, result.peak_rss / (1024.0 * 1024.0));
+                if (result.analyzed) {
+                    std::printf(" %8.1f %8.1f\n", result.tone.snr_db, result.tone.thd_db);
+                } else {
+                    std::printf(" %8s %8s\n", "-", "-");
+                }
+            }
+        }
+
+        if (!keep) {
+            for (const auto& file : files) {
+                std::remove(file.second.c_str());
+            }
+        }
+    }
+
+    return failures == 0 ? 0 : 1;
+}
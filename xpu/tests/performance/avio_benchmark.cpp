@@ -0,0 +1,235 @@
+/**
+ * @file avio_benchmark.cpp
+ * @brief AudioFileLoader input I/O benchmark: file protocol vs memory-mapped AVIOContext
+ *
+ * Streams a file through load::AudioFileLoader with InputIO::File and
+ * InputIO::Mapped, once with a single decoder and once with several
+ * decoders of the same file running concurrently, and reports wall time,
+ * input throughput and x-realtime. Without --input a 24-bit / 192 kHz
+ * stereo WAV is generated, since PCM decoding leaves I/O as the main cost.
+ *
+ * Page cache state is not controlled: run once to warm it, or drop caches
+ * between runs for cold numbers.
+ *
+ * Usage: avio_benchmark [--input file] [--duration sec] [--runs n]
+ *                       [--concurrent n] [--buffer KB] [--dir path] [--keep]
+ */
+
+#include "AudioFileLoader.h"
+#include "utils/Logger.h"
+#include "utils/PlatformUtils.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace xpu;
+
+namespace {
+
+constexpr double PI = 3.14159265358979323846;
+constexpr int TEST_RATE = 192000;
+constexpr int TEST_CHANNELS = 2;
+
+void writeLE(std::ofstream& out, uint32_t value, int bytes) {
+    for (int i = 0; i < bytes; ++i) {
+        out.put(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+}
+
+/**
+ * @brief Write a 24-bit stereo sine WAV
+ */
+bool writeTestWAV(const std::string& path, double seconds) {
+    std::ofstream out(path, std::ios::binary);
+    if (!out) {
+        return false;
+    }
+    const uint64_t frames = static_cast<uint64_t>(seconds * TEST_RATE);
+    const uint32_t data_bytes = static_cast<uint32_t>(frames * TEST_CHANNELS * 3);
+
+    out.write("RIFF", 4);
+    writeLE(out, 36 + data_bytes, 4);
+    out.write("WAVEfmt ", 8);
+    writeLE(out, 16, 4);
+    writeLE(out, 1, 2);
+    writeLE(out, TEST_CHANNELS, 2);
+    writeLE(out, TEST_RATE, 4);
+    writeLE(out, TEST_RATE * TEST_CHANNELS * 3, 4);
+    writeLE(out, TEST_CHANNELS * 3, 2);
+    writeLE(out, 24, 2);
+    out.write("data", 4);
+    writeLE(out, data_bytes, 4);
+
+    std::vector<char> block;
+    block.reserve(TEST_RATE * TEST_CHANNELS * 3);
+    for (uint64_t n = 0; n < frames; ++n) {
+        const double t = static_cast<double>(n) / TEST_RATE;
+        const int32_t left = static_cast<int32_t>(std::lround(0.5 * 8388607.0 * std::sin(2.0 * PI * 997.0 * t)));
+        const int32_t right = static_cast<int32_t>(std::lround(0.5 * 8388607.0 * std::sin(2.0 * PI * 1499.0 * t)));
+        for (int32_t sample : {left, right}) {
+            block.push_back(static_cast<char>(sample & 0xFF));
+            block.push_back(static_cast<char>((sample >> 8) & 0xFF));
+            block.push_back(static_cast<char>((sample >> 16) & 0xFF));
+        }
+        if (block.size() >= block.capacity()) {
+            out.write(block.data(), static_cast<std::streamsize>(block.size()));
+            block.clear();
+        }
+    }
+    out.write(block.data(), static_cast<std::streamsize>(block.size()));
+    return static_cast<bool>(out);
+}
+
+struct RunResult {
+    bool ok = false;
+    double seconds = 0.0;      // Wall time
+    double audio_seconds = 0.0;  // Decoded audio, summed over decoders
+};
+
+/**
+ * @brief Stream the file with `decoders` loaders in parallel
+ */
+RunResult streamFile(const std::string& path, load::InputIO io, size_t buffer_size, int decoders) {
+    std::vector<int> ok(decoders, 0);
+    std::vector<double> audio_seconds(decoders, 0.0);
+
+    auto decode = [&](int index) {
+        load::AudioFileLoader loader;
+        loader.setTargetSampleRate(0);
+        loader.setDecoderThreads(1);
+        loader.setInputIO(io, buffer_size);
+        if (loader.prepareStreaming(path) != ErrorCode::Success) {
+            return;
+        }
+        const protocol::AudioMetadata& metadata = loader.getMetadata();
+        uint64_t samples = 0;
+        ErrorCode result = loader.streamPCM([&](const float*, size_t count) {
+            samples += count;
+            return true;
+        });
+        if (result == ErrorCode::Success && metadata.channels > 0 && metadata.sample_rate > 0) {
+            ok[index] = 1;
+            audio_seconds[index] = static_cast<double>(samples) / metadata.channels / metadata.sample_rate;
+        }
+    };
+
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (int i = 1; i < decoders; ++i) {
+        threads.emplace_back(decode, i);
+    }
+    decode(0);
+    for (auto& t : threads) {
+        t.join();
+    }
+    const auto end = std::chrono::steady_clock::now();
+
+    RunResult result;
+    result.ok = std::all_of(ok.begin(), ok.end(), [](int value) { return value != 0; });
+    result.seconds = std::chrono::duration<double>(end - start).count();
+    for (double seconds : audio_seconds) {
+        result.audio_seconds += seconds;
+    }
+    return result;
+}
+
+void printUsage(const char* program) {
+    std::printf("Usage: %s [--input file] [--duration sec] [--runs n] [--concurrent n]\n"
+                "          [--buffer KB] [--dir path] [--keep]\n", program);
+}
+
+} // anonymous namespace
+
+int main(int argc, char* argv[]) {
+    std::string input;
+    double duration = 60.0;
+    int runs = 3;
+    int concurrent = 4;
+    size_t buffer_size = load::DEFAULT_AVIO_BUFFER_SIZE;
+    std::string dir = ".";
+    bool keep = false;
+
+    for (int i = 1; i < argc; ++i) {
+        const bool has_value = i + 1 < argc;
+        if (strcmp(argv[i], "--input") == 0 && has_value) {
+            input = argv[++i];
+        } else if (strcmp(argv[i], "--duration") == 0 && has_value) {
+            duration = std::atof(argv[++i]);
+        } else if (strcmp(argv[i], "--runs") == 0 && has_value) {
+            runs = std::max(1, std::atoi(argv[++i]));
+        } else if (strcmp(argv[i], "--concurrent") == 0 && has_value) {
+            concurrent = std::max(1, std::atoi(argv[++i]));
+        } else if (strcmp(argv[i], "--buffer") == 0 && has_value) {
+            buffer_size = static_cast<size_t>(std::max(4, std::atoi(argv[++i]))) * 1024;
+        } else if (strcmp(argv[i], "--dir") == 0 && has_value) {
+            dir = argv[++i];
+        } else if (strcmp(argv[i], "--keep") == 0) {
+            keep = true;
+        } else {
+            printUsage(argv[0]);
+            return strcmp(argv[i], "--help") == 0 ? 0 : 1;
+        }
+    }
+
+    utils::Logger::initialize(utils::PlatformUtils::getLogFilePath(), false, false, "avio_benchmark");
+
+    const bool generated = input.empty();
+    if (generated) {
+        input = dir + "/avio_benchmark.wav";
+        if (!writeTestWAV(input, duration)) {
+            std::fprintf(stderr, "Cannot write %s\n", input.c_str());
+            return 1;
+        }
+    }
+
+    std::ifstream probe(input, std::ios::binary | std::ios::ate);
+    const double file_mb = static_cast<double>(probe.tellg()) / (1024.0 * 1024.0);
+    probe.close();
+
+    std::printf("Input: %s (%.1f MB), AVIO buffer %zu KB, best of %d runs\n\n",
+                input.c_str(), file_mb, buffer_size / 1024, runs);
+    std::printf("%-8s %-10s %10s %10s %12s\n", "I/O", "decoders", "wall (s)", "MB/s", "x-realtime");
+
+    bool failed = false;
+    const struct {
+        const char* name;
+        load::InputIO io;
+    } modes[] = {{"file", load::InputIO::File}, {"mmap", load::InputIO::Mapped}};
+
+    for (int decoders : {1, concurrent}) {
+        for (const auto& mode : modes) {
+            RunResult best;
+            for (int run = 0; run < runs; ++run) {
+                RunResult result = streamFile(input, mode.io, buffer_size, decoders);
+                if (!result.ok) {
+                    failed = true;
+                    break;
+                }
+                if (!best.ok || result.seconds < best.seconds) {
+                    best = result;
+                }
+            }
+            if (!best.ok) {
+                std::printf("%-8s %-10d %10s\n", mode.name, decoders, "FAILED");
+                continue;
+            }
+            std::printf("%-8s %-10d %10.3f %10.1f %12.1f\n", mode.name, decoders, best.seconds,
+                        file_mb * decoders / best.seconds, best.audio_seconds / best.seconds);
+        }
+        if (concurrent == 1) {
+            break;
+        }
+    }
+
+    if (generated && !keep) {
+        std::remove(input.c_str());
+    }
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,223 @@
+/**
+ * @file test_ChunkStream.cpp
+ * @brief Unit tests for chunk stream framing and track records
+ */
+
+#include <gtest/gtest.h>
+#include "../../src/lib/protocol/ChunkStream.h"
+#include "../../src/lib/protocol/MetadataJSON.h"
+#include "../../src/lib/protocol/Protocol.h"
+#include "../../src/lib/audio/SampleConverter.h"
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace xpu;
+using namespace xpu::protocol;
+
+namespace {
+
+const int CHANNELS = 2;
+const int FRAMES_PER_CHUNK = 256;
+
+std::string trackJSON(const std::string& path, const std::string& title, int sample_rate, uint64_t frames) {
+    MetadataJSON metadata;
+    metadata.parse(R"({"success": true, "metadata": {}})");
+    metadata.set("file_path", path);
+    metadata.set("title", title);
+    metadata.set("sample_rate", sample_rate);
+    metadata.set("channels", CHANNELS);
+    metadata.set("bit_depth", 16);
+    metadata.set("sample_count", frames);
+    metadata.set("sample_format", "Int16");
+    return metadata.dump();
+}
+
+void writeInt16Chunks(std::ostream& out, int chunks, int16_t first_value) {
+    std::vector<int16_t> samples(FRAMES_PER_CHUNK * CHANNELS);
+    for (int c = 0; c < chunks; ++c) {
+        for (size_t i = 0; i < samples.size(); ++i) {
+            samples[i] = static_cast<int16_t>(first_value + c * 100 + static_cast<int>(i));
+        }
+        ASSERT_TRUE(writeChunk(out, samples.data(), samples.size() * sizeof(int16_t)));
+    }
+}
+
+/**
+ * @brief Two tracks of Int16 chunks: [header]\n[3 chunks][record][2 chunks]
+ */
+std::string multiTrackStream() {
+    std::ostringstream out;
+    out << trackJSON("/music/01.flac", "First", 44100, 3 * FRAMES_PER_CHUNK) << "\n";
+    writeInt16Chunks(out, 3, 0);
+    writeTrackRecord(out, trackJSON("/music/02.flac", "Say \"sample_rate\": 8000", 44100,
+                                    2 * FRAMES_PER_CHUNK));
+    writeInt16Chunks(out, 2, 1000);
+    return out.str();
+}
+
+/**
+ * @brief Read the pretty-printed JSON header up to its closing brace and newline
+ */
+std::string readHeader(std::istream& in) {
+    std::string header;
+    std::string line;
+    while (std::getline(in, line) && line != "}") {
+        header += line + "\n";
+    }
+    return header + line;
+}
+
+/**
+ * @brief Chunk or track record read back from a stream
+ */
+struct Frame {
+    bool record = false;
+    std::string data;
+};
+
+std::vector<Frame> readFrames(std::istream& in) {
+    std::vector<Frame> frames;
+    uint64_t size_header = 0;
+    while (in.read(reinterpret_cast<char*>(&size_header), sizeof(size_header)) && size_header != 0) {
+        Frame frame;
+        frame.record = (size_header & TRACK_RECORD_FLAG) != 0;
+        frame.data.resize(size_header & ~TRACK_RECORD_FLAG);
+        in.read(&frame.data[0], static_cast<std::streamsize>(frame.data.size()));
+        frames.push_back(frame);
+    }
+    return frames;
+}
+
+/**
+ * @brief Int16 -> Float32 stage the way xpuIn2Wav / xpuProcess convert a stream
+ *
+ * Chunks are converted sample by sample; track records are forwarded with
+ * the format fields rewritten to the output format.
+ */
+void convertToFloat(std::istream& in, std::ostream& out, int output_sample_rate) {
+    MetadataJSON header;
+    ASSERT_TRUE(header.parse(readHeader(in)));
+    header.setStreamFormat(output_sample_rate, CHANNELS, 32);
+    out << header.dump() << "\n";
+
+    std::vector<float> converted;
+    for (const Frame& frame : readFrames(in)) {
+        if (frame.record) {
+            MetadataJSON track;
+            ASSERT_TRUE(track.parse(frame.data));
+            track.setStreamFormat(output_sample_rate, CHANNELS, 32);
+            ASSERT_TRUE(writeTrackRecord(out, track.dump()));
+            continue;
+        }
+        converted.resize(frame.data.size() / sizeof(int16_t));
+        audio::SampleConverter::toFloat(reinterpret_cast<const uint8_t*>(frame.data.data()),
+                                        audio::SampleFormat::Int16, converted.size(), converted.data());
+        ASSERT_TRUE(writeChunk(out, converted.data(), converted.size() * sizeof(float)));
+    }
+}
+
+} // anonymous namespace
+
+TEST(ChunkStreamTest, PassthroughCopiesChunksAndRecordsByteForByte) {
+    const std::string stream = multiTrackStream();
+    std::istringstream in(stream);
+    std::ostringstream out;
+    out << readHeader(in) << "\n";
+
+    ChunkStreamStats stats;
+    ASSERT_EQ(copyChunkStream(in, out, stats), ErrorCode::Success);
+    EXPECT_EQ(out.str(), stream);
+    EXPECT_EQ(stats.chunks, 5u);
+    EXPECT_EQ(stats.records, 1u);
+    EXPECT_EQ(stats.bytes, 5u * FRAMES_PER_CHUNK * CHANNELS * sizeof(int16_t));
+}
+
+TEST(ChunkStreamTest, PassthroughStopsAtZeroSizeHeader) {
+    std::ostringstream stream;
+    writeInt16Chunks(stream, 1, 0);
+    const uint64_t end_marker = 0;
+    stream.write(reinterpret_cast<const char*>(&end_marker), sizeof(end_marker));
+    writeInt16Chunks(stream, 1, 0);
+
+    std::istringstream in(stream.str());
+    std::ostringstream out;
+    ChunkStreamStats stats;
+    ASSERT_EQ(copyChunkStream(in, out, stats), ErrorCode::Success);
+    EXPECT_EQ(stats.chunks, 1u);
+}
+
+TEST(ChunkStreamTest, PassthroughReportsTruncatedInput) {
+    std::string stream = multiTrackStream();
+    std::istringstream in(stream.substr(0, stream.size() - 10));
+    readHeader(in);
+
+    std::ostringstream out;
+    ChunkStreamStats stats;
+    EXPECT_EQ(copyChunkStream(in, out, stats), ErrorCode::FileReadError);
+    EXPECT_EQ(stats.chunks, 4u);
+    EXPECT_EQ(stats.records, 1u);
+
+    // A partial size header is truncated input too, not a clean end
+    std::istringstream partial(std::string(4, '\x01'));
+    EXPECT_EQ(copyChunkStream(partial, out, stats), ErrorCode::FileReadError);
+}
+
+TEST(ChunkStreamTest, ConverterForwardsRecordInOutputFormat) {
+    std::istringstream in(multiTrackStream());
+    std::ostringstream converted;
+    convertToFloat(in, converted, 44100);
+
+    std::istringstream out(converted.str());
+    MetadataJSON header;
+    ASSERT_TRUE(header.parse(readHeader(out)));
+    EXPECT_EQ(header.getString("sample_format", ""), "Float32");
+
+    const std::vector<Frame> frames = readFrames(out);
+    ASSERT_EQ(frames.size(), 6u);
+    ASSERT_TRUE(frames[3].record);
+
+    MetadataJSON record;
+    ASSERT_TRUE(record.parse(frames[3].data));
+    EXPECT_EQ(record.getString("file_path", ""), "/music/02.flac");
+    EXPECT_EQ(record.getString("title", ""), "Say \"sample_rate\": 8000");
+    EXPECT_EQ(record.getInt("sample_rate", 0), 44100);
+    EXPECT_EQ(record.getInt("channels", 0), CHANNELS);
+    EXPECT_EQ(record.getInt("bit_depth", 0), 32);
+    EXPECT_EQ(record.getString("sample_format", ""), "Float32");
+    EXPECT_EQ(record.getUInt64("sample_count", 0), 2u * FRAMES_PER_CHUNK);
+
+    // Every sample of both tracks arrives, converted, on its side of the record
+    uint64_t track_frames[2] = {0, 0};
+    int track = 0;
+    for (const Frame& frame : frames) {
+        if (frame.record) {
+            track++;
+            continue;
+        }
+        track_frames[track] += frame.data.size() / (sizeof(float) * CHANNELS);
+    }
+    EXPECT_EQ(track_frames[0], header.getUInt64("sample_count", 0));
+    EXPECT_EQ(track_frames[1], record.getUInt64("sample_count", 0));
+
+    float first_sample = 0.0f;
+    std::memcpy(&first_sample, frames[4].data.data() + sizeof(float), sizeof(float));
+    EXPECT_FLOAT_EQ(first_sample, 1001.0f / 32768.0f);
+}
+
+TEST(ChunkStreamTest, ConverterScalesRecordSampleCountToOutputRate) {
+    std::istringstream in(multiTrackStream());
+    std::ostringstream converted;
+    convertToFloat(in, converted, 88200);
+
+    std::istringstream out(converted.str());
+    readHeader(out);
+    const std::vector<Frame> frames = readFrames(out);
+    ASSERT_EQ(frames.size(), 6u);
+
+    MetadataJSON record;
+    ASSERT_TRUE(record.parse(frames[3].data));
+    EXPECT_EQ(record.getInt("sample_rate", 0), 88200);
+    EXPECT_EQ(record.getUInt64("sample_count", 0), 4u * FRAMES_PER_CHUNK);
+}
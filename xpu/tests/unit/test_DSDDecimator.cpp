@@ -0,0 +1,196 @@
+/**
+ * @file test_DSDDecimator.cpp
+ * @brief Unit tests for the table-driven DSD to PCM decimator
+ */
+
+#include <gtest/gtest.h>
+#include "../../src/lib/audio/DSDDecimator.h"
+#include <vector>
+#include <cmath>
+#include <cstdint>
+
+using namespace xpu::audio;
+
+namespace {
+
+constexpr double PI = 3.14159265358979323846;
+
+/**
+ * @brief Second-order sigma-delta modulator producing packed DSD bytes
+ */
+std::vector<uint8_t> modulateSine(size_t bits, double freq, double amplitude,
+                                  double rate, bool lsb_first) {
+    std::vector<uint8_t> out(bits / 8, 0);
+    double i1 = 0.0, i2 = 0.0, y = 1.0;
+    for (size_t k = 0; k < bits; ++k) {
+        double x = amplitude * std::sin(2.0 * PI * freq * k / rate);
+        i1 += x - y;
+        i2 += i1 - y;
+        y = (i2 >= 0.0) ? 1.0 : -1.0;
+        if (y > 0.0) {
+            out[k / 8] |= lsb_first ? (1 << (k % 8)) : (0x80 >> (k % 8));
+        }
+    }
+    return out;
+}
+
+uint8_t reverseBits(uint8_t b) {
+    uint8_t r = 0;
+    for (int i = 0; i < 8; ++i) {
+        r = static_cast<uint8_t>((r << 1) | ((b >> i) & 1));
+    }
+    return r;
+}
+
+} // anonymous namespace
+
+TEST(DSDDecimatorTest, SupportedFactors) {
+    EXPECT_TRUE(DSDDecimator::isSupportedFactor(16));
+    EXPECT_TRUE(DSDDecimator::isSupportedFactor(32));
+    EXPECT_TRUE(DSDDecimator::isSupportedFactor(64));
+    EXPECT_FALSE(DSDDecimator::isSupportedFactor(8));
+    EXPECT_FALSE(DSDDecimator::isSupportedFactor(58));
+
+    DSDDecimator fallback(58, true);
+    EXPECT_EQ(fallback.getDecimation(), 16);
+}
+
+TEST(DSDDecimatorTest, Geometry) {
+    for (int factor : {16, 32, 64}) {
+        DSDDecimator decimator(factor, true);
+        EXPECT_EQ(decimator.getStrideBytes(), static_cast<size_t>(factor / 8));
+        EXPECT_GT(decimator.getFilterBytes(), decimator.getStrideBytes());
+        EXPECT_EQ(decimator.getHistoryBytes(),
+                  decimator.getFilterBytes() - decimator.getStrideBytes());
+    }
+}
+
+TEST(DSDDecimatorTest, UnityDCGain) {
+    for (int factor : {16, 32, 64}) {
+        DSDDecimator decimator(factor, true);
+        std::vector<uint8_t> ones(decimator.getFilterBytes() + 4 * decimator.getStrideBytes(), 0xFF);
+        std::vector<uint8_t> zeros(ones.size(), 0x00);
+        float out[5];
+
+        decimator.process(ones.data(), 5, out, 1);
+        for (float v : out) EXPECT_NEAR(v, 1.0f, 1e-4f);
+
+        decimator.process(zeros.data(), 5, out, 1);
+        for (float v : out) EXPECT_NEAR(v, -1.0f, 1e-4f);
+    }
+}
+
+TEST(DSDDecimatorTest, SilencePatternIsNearZero) {
+    DSDDecimator decimator(16, true);
+    std::vector<uint8_t> silence(decimator.getFilterBytes() + 64 * decimator.getStrideBytes(),
+                                 DSDDecimator::SILENCE_BYTE);
+    std::vector<float> out(65);
+    decimator.process(silence.data(), out.size(), out.data(), 1);
+    for (float v : out) EXPECT_NEAR(v, 0.0f, 1e-3f);
+}
+
+TEST(DSDDecimatorTest, BitOrderTablesAreMirrored) {
+    DSDDecimator lsb(32, true);
+    DSDDecimator msb(32, false);
+    const float* lsb_tables = lsb.getTables();
+    const float* msb_tables = msb.getTables();
+    for (size_t k = 0; k < lsb.getFilterBytes(); ++k) {
+        for (int b = 0; b < 256; ++b) {
+            EXPECT_FLOAT_EQ(lsb_tables[k * 256 + b], msb_tables[k * 256 + reverseBits(b)]);
+        }
+    }
+}
+
+TEST(DSDDecimatorTest, RecoversSineAmplitude) {
+    const double dsd_rate = 2822400.0;
+    for (int factor : {16, 32, 64}) {
+        DSDDecimator decimator(factor, true);
+        const double out_rate = dsd_rate / factor;
+        const size_t frames = static_cast<size_t>(out_rate / 10);  // 100 ms
+        const size_t bytes = (frames - 1) * decimator.getStrideBytes() + decimator.getFilterBytes();
+        std::vector<uint8_t> dsd = modulateSine(bytes * 8, 1000.0, 0.5, dsd_rate, true);
+
+        std::vector<float> out(frames);
+        decimator.process(dsd.data(), frames, out.data(), 1);
+
+        // Correlate against the 1 kHz reference, skipping filter warm-up
+        double s = 0.0, c = 0.0;
+        const size_t start = frames / 10;
+        for (size_t i = start; i < frames; ++i) {
+            double phase = 2.0 * PI * 1000.0 * i / out_rate;
+            s += out[i] * std::sin(phase);
+            c += out[i] * std::cos(phase);
+        }
+        double n = static_cast<double>(frames - start);
+        double amplitude = 2.0 * std::sqrt(s * s + c * c) / n;
+        EXPECT_NEAR(amplitude, 0.5, 0.01) << "decimation /" << factor;
+    }
+}
+
+TEST(DSDDecimatorTest, InterleavedOutputStride) {
+    DSDDecimator decimator(16, false);
+    std::vector<uint8_t> ones(decimator.getFilterBytes() + 3 * decimator.getStrideBytes(), 0xFF);
+    std::vector<float> out(8, 0.0f);
+    decimator.process(ones.data(), 4, out.data() + 1, 2);
+    for (size_t i = 0; i < 4; ++i) {
+        EXPECT_EQ(out[i * 2], 0.0f);
+        EXPECT_NEAR(out[i * 2 + 1], 1.0f, 1e-4f);
+    }
+}
+
+TEST(DSDDecimatorTest, FastModeMatchesBitAverage) {
+    std::vector<uint8_t> dsd(4096);
+    uint32_t state = 12345;
+    for (auto& b : dsd) {
+        state = state * 1664525u + 1013904223u;
+        b = static_cast<uint8_t>(state >> 24);
+    }
+
+    for (int factor : {16, 32, 64}) {
+        DSDDecimator decimator(factor, true, DSDFilterMode::Fast);
+        EXPECT_EQ(decimator.getHistoryBytes(), 0u);
+        EXPECT_EQ(decimator.getTables(), nullptr);
+
+        const size_t stride = decimator.getStrideBytes();
+        const size_t frames = dsd.size() / stride - 3;  // leave an unaligned tail
+        std::vector<float> out(frames);
+        decimator.process(dsd.data(), frames, out.data(), 1);
+
+        for (size_t f = 0; f < frames; ++f) {
+            int ones = 0;
+            for (size_t i = 0; i < stride; ++i) {
+                for (int bit = 0; bit < 8; ++bit) {
+                    ones += (dsd[f * stride + i] >> bit) & 1;
+                }
+            }
+            float expected = static_cast<float>(2 * ones - factor) / factor;
+            ASSERT_EQ(out[f], expected) << "decimation /" << factor << " frame " << f;
+        }
+    }
+}
+
+TEST(DSDDecimatorTest, SIMDLevelsAreBitIdentical) {
+    std::vector<uint8_t> dsd = modulateSine(8 * 65536, 5000.0, 0.4, 2822400.0, false);
+
+    for (DSDFilterMode mode : {DSDFilterMode::Filtered, DSDFilterMode::Fast}) {
+        for (int factor : {16, 32, 64}) {
+            DSDDecimator decimator(factor, false, mode);
+            const size_t frames = (dsd.size() - decimator.getFilterBytes()) / decimator.getStrideBytes() + 1;
+
+            decimator.setSIMDLevel(SIMDLevel::Scalar);
+            ASSERT_EQ(decimator.getSIMDLevel(), SIMDLevel::Scalar);
+            std::vector<float> reference(frames * 2);
+            decimator.process(dsd.data(), frames, reference.data(), 2);
+
+            for (SIMDLevel level : {SIMDLevel::SSE41, SIMDLevel::AVX2, SIMDLevel::NEON}) {
+                decimator.setSIMDLevel(level);
+                std::vector<float> out(frames * 2);
+                decimator.process(dsd.data(), frames, out.data(), 2);
+                for (size_t i = 0; i < out.size(); ++i) {
+                    ASSERT_EQ(out[i], reference[i])
+                        << simdLevelName(decimator.getSIMDLevel()) << " /" << factor << " sample " << i;
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,216 @@
+/**
+ * @file test_DSDSignalGenerator.cpp
+ * @brief Unit tests for the synthetic DSD test-signal generator
+ */
+
+#include <gtest/gtest.h>
+#include "../dsd/DSDSignalGenerator.h"
+#include "../../src/lib/audio/DSDDecimator.h"
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+using namespace xpu;
+using namespace xpu::test;
+
+namespace {
+
+constexpr double PI = 3.14159265358979323846;
+
+/**
+ * @brief Decimate one MSB-first channel and return the amplitude at frequency
+ */
+double measureAmplitude(const std::vector<uint8_t>& dsd, double dsd_rate, double frequency) {
+    audio::DSDDecimator decimator(64, false);
+    const size_t frames = (dsd.size() - decimator.getFilterBytes()) / decimator.getStrideBytes() + 1;
+    std::vector<float> out(frames);
+    decimator.process(dsd.data(), frames, out.data(), 1);
+
+    const double out_rate = dsd_rate / 64;
+    const size_t start = frames / 10;
+    double s = 0.0, c = 0.0;
+    for (size_t i = start; i < frames; ++i) {
+        double phase = 2.0 * PI * frequency * i / out_rate;
+        s += out[i] * std::sin(phase);
+        c += out[i] * std::cos(phase);
+    }
+    return 2.0 * std::sqrt(s * s + c * c) / (frames - start);
+}
+
+std::vector<uint8_t> readFile(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::vector<uint8_t>(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+uint64_t readLE(const std::vector<uint8_t>& data, size_t offset, int bytes) {
+    uint64_t v = 0;
+    for (int i = bytes - 1; i >= 0; --i) {
+        v = (v << 8) | data[offset + i];
+    }
+    return v;
+}
+
+uint64_t readBE(const std::vector<uint8_t>& data, size_t offset, int bytes) {
+    uint64_t v = 0;
+    for (int i = 0; i < bytes; ++i) {
+        v = (v << 8) | data[offset + i];
+    }
+    return v;
+}
+
+} // anonymous namespace
+
+TEST(DSDSignalGeneratorTest, ModulatorNTFHasTargetOutOfBandGain) {
+    for (int order : {2, 5, 7}) {
+        SigmaDeltaModulator modulator(order, 1.5);
+        const auto& a = modulator.getDenominator();
+        ASSERT_EQ(a.size(), static_cast<size_t>(order + 1));
+        EXPECT_DOUBLE_EQ(a[0], 1.0);
+
+        double at_nyquist = 0.0;
+        for (size_t i = 0; i < a.size(); ++i) {
+            at_nyquist += (i & 1) ? -a[i] : a[i];
+        }
+        EXPECT_NEAR(std::pow(2.0, order) / std::fabs(at_nyquist), 1.5, 1e-6) << "order " << order;
+    }
+}
+
+TEST(DSDSignalGeneratorTest, SineIsRecoveredAtEveryRate) {
+    for (uint32_t multiple : {1u, 4u, 16u}) {
+        DSDSignalSpec spec = DSDSignalSpec::sine(1000.0, 0.5, DSD64_RATE * multiple, 0.1, 1);
+        DSDSignalGenerator generator(spec);
+        std::vector<std::vector<uint8_t>> channels;
+        size_t bytes = generator.generate(spec.sampleCount() / 8, channels);
+
+        ASSERT_EQ(bytes, spec.sampleCount() / 8);
+        ASSERT_EQ(channels.size(), 1u);
+        EXPECT_EQ(generator.getResetCount(), 0u) << "DSD" << 64 * multiple;
+        EXPECT_NEAR(measureAmplitude(channels[0], spec.dsd_rate, 1000.0), 0.5, 0.01)
+            << "DSD" << 64 * multiple;
+    }
+}
+
+TEST(DSDSignalGeneratorTest, ChannelsFollowTheirTones) {
+    DSDSignalSpec spec;
+    spec.channels = 3;
+    spec.duration = 0.1;
+    spec.channel_tones = {{{1000.0, 0.4}}, {{3000.0, 0.2}}};
+
+    DSDSignalGenerator generator(spec);
+    std::vector<std::vector<uint8_t>> channels;
+    generator.generate(spec.sampleCount() / 8, channels);
+    ASSERT_EQ(channels.size(), 3u);
+
+    EXPECT_NEAR(measureAmplitude(channels[0], spec.dsd_rate, 1000.0), 0.4, 0.01);
+    EXPECT_LT(measureAmplitude(channels[0], spec.dsd_rate, 3000.0), 0.01);
+    EXPECT_NEAR(measureAmplitude(channels[1], spec.dsd_rate, 3000.0), 0.2, 0.01);
+    // Channels past the list reuse the last entry
+    EXPECT_NEAR(measureAmplitude(channels[2], spec.dsd_rate, 3000.0), 0.2, 0.01);
+}
+
+TEST(DSDSignalGeneratorTest, MultitoneSplitsAmplitude) {
+    DSDSignalSpec spec = DSDSignalSpec::multitone({500.0, 2000.0, 7000.0}, 0.6, DSD64_RATE, 0.1, 1);
+    DSDSignalGenerator generator(spec);
+    std::vector<std::vector<uint8_t>> channels;
+    generator.generate(spec.sampleCount() / 8, channels);
+
+    EXPECT_EQ(generator.getResetCount(), 0u);
+    for (double f : {500.0, 2000.0, 7000.0}) {
+        EXPECT_NEAR(measureAmplitude(channels[0], spec.dsd_rate, f), 0.2, 0.01) << f << " Hz";
+    }
+}
+
+TEST(DSDSignalGeneratorTest, PadsPastTheEndWithSilence) {
+    DSDSignalSpec spec = DSDSignalSpec::sine(1000.0, 0.5, DSD64_RATE, 0.001, 2);
+    const size_t total = spec.sampleCount() / 8;
+
+    DSDSignalGenerator generator(spec);
+    std::vector<std::vector<uint8_t>> channels;
+    EXPECT_EQ(generator.generate(total + 16, channels), total);
+    for (const auto& channel : channels) {
+        ASSERT_EQ(channel.size(), total + 16);
+        for (size_t i = total; i < channel.size(); ++i) {
+            EXPECT_EQ(channel[i], audio::DSDDecimator::SILENCE_BYTE);
+        }
+    }
+    EXPECT_EQ(generator.generate(8, channels), 0u);
+}
+
+TEST(DSDSignalGeneratorTest, WritesDSFLayout) {
+    const std::string path = "test_DSDSignalGenerator.dsf";
+    DSDSignalSpec spec = DSDSignalSpec::sine(1000.0, 0.5, DSD64_RATE * 2, 0.01, 2);
+    ASSERT_EQ(writeDSF(path, spec), ErrorCode::Success);
+
+    std::vector<uint8_t> file = readFile(path);
+    std::remove(path.c_str());
+
+    const uint64_t samples = spec.sampleCount();
+    const uint64_t blocks = (samples / 8 + 4095) / 4096;
+    ASSERT_EQ(file.size(), 92 + blocks * 4096 * 2);
+    EXPECT_EQ(std::string(file.begin(), file.begin() + 4), "DSD ");
+    EXPECT_EQ(readLE(file, 12, 8), file.size());
+    EXPECT_EQ(std::string(file.begin() + 28, file.begin() + 32), "fmt ");
+    EXPECT_EQ(readLE(file, 52, 4), 2u);                 // Channels
+    EXPECT_EQ(readLE(file, 56, 4), spec.dsd_rate);
+    EXPECT_EQ(readLE(file, 60, 4), 1u);                 // LSB first
+    EXPECT_EQ(readLE(file, 64, 8), samples);
+    EXPECT_EQ(readLE(file, 72, 4), 4096u);
+    EXPECT_EQ(std::string(file.begin() + 80, file.begin() + 84), "data");
+
+    // First block of the left channel matches the generator, bit-reversed
+    DSDSignalGenerator generator(spec);
+    std::vector<std::vector<uint8_t>> channels;
+    generator.generate(4096, channels);
+    for (size_t i = 0; i < 64; ++i) {
+        uint8_t msb = channels[0][i];
+        uint8_t lsb = file[92 + i];
+        for (int bit = 0; bit < 8; ++bit) {
+            ASSERT_EQ((msb >> (7 - bit)) & 1, (lsb >> bit) & 1) << "byte " << i;
+        }
+    }
+}
+
+TEST(DSDSignalGeneratorTest, WritesDSDIFFLayout) {
+    const std::string path = "test_DSDSignalGenerator.dff";
+    DSDSignalSpec spec = DSDSignalSpec::sine(1000.0, 0.5, DSD64_RATE, 0.01, 2);
+    ASSERT_EQ(writeDSDIFF(path, spec), ErrorCode::Success);
+
+    std::vector<uint8_t> file = readFile(path);
+    std::remove(path.c_str());
+
+    ASSERT_GT(file.size(), 16u);
+    EXPECT_EQ(std::string(file.begin(), file.begin() + 4), "FRM8");
+    EXPECT_EQ(readBE(file, 4, 8) + 12, file.size());
+    EXPECT_EQ(std::string(file.begin() + 12, file.begin() + 16), "DSD ");
+
+    // Walk the top-level chunks to the sound data
+    size_t pos = 16;
+    std::string last;
+    uint64_t data_size = 0;
+    size_t data_offset = 0;
+    while (pos + 12 <= file.size()) {
+        last.assign(file.begin() + pos, file.begin() + pos + 4);
+        uint64_t size = readBE(file, pos + 4, 8);
+        if (last == "DSD ") {
+            data_size = size;
+            data_offset = pos + 12;
+        }
+        pos += 12 + size + (size & 1);
+    }
+    EXPECT_EQ(pos, file.size());
+    EXPECT_EQ(last, "DSD ");
+    EXPECT_EQ(data_size, spec.sampleCount() / 8 * 2);
+
+    // Byte-interleaved, MSB first
+    DSDSignalGenerator generator(spec);
+    std::vector<std::vector<uint8_t>> channels;
+    generator.generate(32, channels);
+    for (size_t i = 0; i < 32; ++i) {
+        EXPECT_EQ(file[data_offset + i * 2], channels[0][i]);
+        EXPECT_EQ(file[data_offset + i * 2 + 1], channels[1][i]);
+    }
+}
@@ -0,0 +1,284 @@
+/**
+ * @file test_DSTDecoder.cpp
+ * @brief Unit tests for DST frame decoding
+ *
+ * Frames are produced by a minimal reference encoder (fixed prediction
+ * filter and probability table, same arithmetic coder as the decoder), so
+ * each test checks a lossless round trip.
+ */
+
+#include <gtest/gtest.h>
+#include "../../src/lib/audio/DSTDecoder.h"
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+using namespace xpu;
+using namespace xpu::audio;
+
+namespace {
+
+constexpr uint32_t DSD64_RATE = 2822400;
+
+class BitWriter {
+public:
+    void put(uint32_t value, int bits) {
+        for (int i = bits - 1; i >= 0; --i) {
+            bits_.push_back(static_cast<uint8_t>((value >> i) & 1));
+        }
+    }
+
+    void append(const std::vector<uint8_t>& bits) {
+        bits_.insert(bits_.end(), bits.begin(), bits.end());
+    }
+
+    std::vector<uint8_t> bytes() const {
+        std::vector<uint8_t> out((bits_.size() + 7) / 8, 0);
+        for (size_t i = 0; i < bits_.size(); ++i) {
+            out[i / 8] |= static_cast<uint8_t>(bits_[i] << (7 - i % 8));
+        }
+        return out;
+    }
+
+private:
+    std::vector<uint8_t> bits_;
+};
+
+/**
+ * @brief Arithmetic encoder matching the DST decoder (12-bit interval)
+ */
+class ACEncoder {
+public:
+    ACEncoder() : low_(12, 0), a_(4095) {}
+
+    void encode(int e, unsigned int p) {
+        unsigned int k = (a_ >> 8) | ((a_ >> 7) & 1);
+        unsigned int q = k * p;
+        unsigned int a_q = a_ - q;
+        if (e) {
+            a_ = a_q;
+        } else {
+            add(a_q);
+            a_ = q;
+        }
+        while (a_ < 2048) {
+            a_ <<= 1;
+            low_.push_back(0);
+        }
+    }
+
+    const std::vector<uint8_t>& bits() const { return low_; }
+
+private:
+    void add(unsigned int value) {
+        unsigned int carry = 0;
+        for (size_t b = 0; b < low_.size() && (b < 12 || carry); ++b) {
+            size_t pos = low_.size() - 1 - b;
+            unsigned int t = low_[pos] + (b < 12 ? (value >> b) & 1 : 0) + carry;
+            low_[pos] = static_cast<uint8_t>(t & 1);
+            carry = t >> 1;
+        }
+    }
+
+    std::vector<uint8_t> low_;  // Code value, MSB first
+    unsigned int a_;
+};
+
+int reverse7(int c) {
+    int r = 0;
+    for (int bit = 0; bit < 7; ++bit) {
+        if (c & (1 << bit)) {
+            r |= 0x40 >> bit;
+        }
+    }
+    return r + 1;
+}
+
+void putRice(BitWriter& w, int value, int k) {
+    unsigned int m = static_cast<unsigned int>(std::abs(value));
+    for (unsigned int i = 0; i < (m >> k); ++i) {
+        w.put(0, 1);
+    }
+    w.put(1, 1);
+    w.put(m & ((1u << k) - 1), k);
+    if (m) {
+        w.put(value < 0 ? 1 : 0, 1);
+    }
+}
+
+/**
+ * @brief Encode one DST frame (single filter / probability table for all channels)
+ * @param planar Planar MSB-first DSD, frame_bytes per channel
+ * @param code_filter Store the filter with prediction method 1 instead of uncoded
+ */
+std::vector<uint8_t> encodeFrame(const std::vector<uint8_t>& planar, int channels,
+                                 size_t frame_bytes, const std::vector<int>& filter,
+                                 const std::vector<int>& probs, bool code_filter) {
+    BitWriter w;
+    w.put(1, 1);        // DST coded
+    w.put(0x7, 3);      // Single segment for all channels
+    w.put(1, 1);        // Same mapping for filters and probabilities
+    w.put(1, 1);        // Same filter for all channels
+    for (int ch = 0; ch < channels; ++ch) {
+        w.put(0, 1);    // No half probability
+    }
+
+    w.put(static_cast<uint32_t>(filter.size() - 1), 7);
+    if (!code_filter) {
+        w.put(0, 1);
+        for (int c : filter) {
+            w.put(static_cast<uint32_t>(c) & 0x1FF, 9);
+        }
+    } else {
+        // Method 1: predict from the two previous coefficients (-16, 8) / 8
+        const int lsb_size = 3;
+        w.put(1, 1);
+        w.put(1, 2);
+        w.put(static_cast<uint32_t>(filter[0]) & 0x1FF, 9);
+        w.put(static_cast<uint32_t>(filter[1]) & 0x1FF, 9);
+        w.put(lsb_size, 3);
+        for (size_t j = 2; j < filter.size(); ++j) {
+            int x = -16 * filter[j - 1] + 8 * filter[j - 2];
+            int residual = x >= 0 ? filter[j] + (x + 4) / 8 : filter[j] - (-x + 3) / 8;
+            putRice(w, residual, lsb_size);
+        }
+    }
+
+    w.put(static_cast<uint32_t>(probs.size() - 1), 6);
+    w.put(0, 1);
+    for (int p : probs) {
+        w.put(static_cast<uint32_t>(p - 1), 7);
+    }
+
+    w.put(0, 1);        // Stuffing bit before the arithmetic coded data
+
+    ACEncoder ac;
+    ac.encode(1, static_cast<unsigned int>(reverse7(filter[0] & 127)));
+
+    std::vector<uint64_t> history(channels * 2, 0xAAAAAAAAAAAAAAAAull);
+    for (size_t i = 0; i < frame_bytes * 8; ++i) {
+        for (int ch = 0; ch < channels; ++ch) {
+            uint64_t* st = &history[ch * 2];
+            int sum = 0;
+            for (size_t n = 0; n < filter.size(); ++n) {
+                int past = static_cast<int>((st[n >> 6] >> (n & 63)) & 1);
+                sum += (past * 2 - 1) * filter[n];
+            }
+            int16_t predict = static_cast<int16_t>(sum);
+            unsigned int index = static_cast<unsigned int>(std::abs(static_cast<int>(predict))) >> 3;
+            unsigned int p = static_cast<unsigned int>(
+                probs[std::min<size_t>(index, probs.size() - 1)]);
+
+            int v = (planar[ch * frame_bytes + i / 8] >> (7 - i % 8)) & 1;
+            int residual = v ^ ((static_cast<uint16_t>(predict) >> 15) & 1);
+            ac.encode(residual, p);
+
+            st[1] = (st[1] << 1) | (st[0] >> 63);
+            st[0] = (st[0] << 1) | static_cast<uint64_t>(v);
+        }
+    }
+
+    w.append(ac.bits());
+    return w.bytes();
+}
+
+/**
+ * @brief 1-bit first-order sigma-delta of a sine, planar MSB-first
+ */
+std::vector<uint8_t> sigmaDelta(int channels, size_t frame_bytes) {
+    std::vector<uint8_t> planar(channels * frame_bytes, 0);
+    for (int ch = 0; ch < channels; ++ch) {
+        double integrator = 0.0;
+        for (size_t i = 0; i < frame_bytes * 8; ++i) {
+            double x = 0.5 * std::sin(2.0 * M_PI * 1000.0 * (ch + 1) * i / DSD64_RATE);
+            int bit = integrator >= 0.0 ? 1 : 0;
+            integrator += x - (bit ? 1.0 : -1.0);
+            planar[ch * frame_bytes + i / 8] |= static_cast<uint8_t>(bit << (7 - i % 8));
+        }
+    }
+    return planar;
+}
+
+} // anonymous namespace
+
+TEST(DSTDecoderTest, FrameSizeFollowsRate) {
+    EXPECT_EQ(DSTDecoder(2, DSD64_RATE).getFrameBytes(), 4704u);
+    EXPECT_EQ(DSTDecoder(2, DSD64_RATE * 2).getFrameBytes(), 9408u);
+    EXPECT_TRUE(DSTDecoder::isSupported(6, DSD64_RATE));
+    EXPECT_FALSE(DSTDecoder::isSupported(7, DSD64_RATE));
+    EXPECT_FALSE(DSTDecoder::isSupported(2, 0));
+}
+
+TEST(DSTDecoderTest, UncompressedFrameIsDeinterleaved) {
+    DSTDecoder decoder(2, DSD64_RATE);
+    const size_t frame_bytes = decoder.getFrameBytes();
+
+    std::vector<uint8_t> frame(1 + frame_bytes * 2);
+    frame[0] = 0x00;
+    for (size_t i = 0; i < frame_bytes; ++i) {
+        frame[1 + i * 2] = static_cast<uint8_t>(i);
+        frame[2 + i * 2] = static_cast<uint8_t>(~i);
+    }
+
+    std::vector<uint8_t> out(frame_bytes * 2);
+    ASSERT_EQ(decoder.decodeFrame(frame.data(), frame.size(), out.data()), ErrorCode::Success);
+    for (size_t i = 0; i < frame_bytes; ++i) {
+        ASSERT_EQ(out[i], static_cast<uint8_t>(i));
+        ASSERT_EQ(out[frame_bytes + i], static_cast<uint8_t>(~i));
+    }
+}
+
+TEST(DSTDecoderTest, CodedFrameRoundTrips) {
+    const int channels = 2;
+    DSTDecoder decoder(channels, DSD64_RATE);
+    const size_t frame_bytes = decoder.getFrameBytes();
+
+    std::vector<uint8_t> planar = sigmaDelta(channels, frame_bytes);
+    std::vector<int> filter = {120, -60, 40, -25, 15, -10, 6, -3, 2, -1};
+    std::vector<int> probs = {8, 24, 48, 72, 96, 112, 120, 128};
+
+    std::vector<uint8_t> frame = encodeFrame(planar, channels, frame_bytes, filter, probs, false);
+
+    std::vector<uint8_t> out(planar.size(), 0xFF);
+    ASSERT_EQ(decoder.decodeFrame(frame.data(), frame.size(), out.data()), ErrorCode::Success);
+    EXPECT_EQ(out, planar);
+
+    // Decoder state is per frame: decoding again gives the same result
+    std::vector<uint8_t> again(planar.size(), 0);
+    ASSERT_EQ(decoder.decodeFrame(frame.data(), frame.size(), again.data()), ErrorCode::Success);
+    EXPECT_EQ(again, planar);
+}
+
+TEST(DSTDecoderTest, CodedFilterTableRoundTrips) {
+    const int channels = 6;
+    DSTDecoder decoder(channels, DSD64_RATE);
+    const size_t frame_bytes = decoder.getFrameBytes();
+
+    std::vector<uint8_t> planar = sigmaDelta(channels, frame_bytes);
+    std::vector<int> filter;
+    for (int n = 0; n < 40; ++n) {
+        filter.push_back(static_cast<int>(200.0 * std::exp(-n / 8.0) * ((n % 2) ? -1 : 1)));
+    }
+    std::vector<int> probs = {4, 16, 40, 64, 90, 110, 124};
+
+    std::vector<uint8_t> frame = encodeFrame(planar, channels, frame_bytes, filter, probs, true);
+
+    std::vector<uint8_t> out(planar.size(), 0);
+    ASSERT_EQ(decoder.decodeFrame(frame.data(), frame.size(), out.data()), ErrorCode::Success);
+    EXPECT_EQ(out, planar);
+}
+
+TEST(DSTDecoderTest, RejectsMalformedFrames) {
+    DSTDecoder decoder(2, DSD64_RATE);
+    std::vector<uint8_t> out(decoder.getFrameBytes() * 2);
+
+    // Uncompressed frame with non-zero reserved bits
+    const uint8_t bad_header[4] = {0x01, 0x00, 0x00, 0x00};
+    EXPECT_EQ(decoder.decodeFrame(bad_header, sizeof(bad_header), out.data()), ErrorCode::CorruptedFile);
+
+    // Segmented frames are not supported
+    const uint8_t segmented[4] = {0x80, 0x00, 0x00, 0x00};
+    EXPECT_EQ(decoder.decodeFrame(segmented, sizeof(segmented), out.data()), ErrorCode::NotSupported);
+
+    EXPECT_EQ(decoder.decodeFrame(nullptr, 0, out.data()), ErrorCode::CorruptedFile);
+}
@@ -0,0 +1,373 @@
+/**
+ * @file test_DecodeServer.cpp
+ * @brief Unit tests for the xpuLoad decode server (--serve)
+ *
+ * The server and the native DSD decoder live in the xpuLoad module and are
+ * compiled in directly. Requests go over a real UNIX socket; the handler
+ * decodes with DSDDecoder like serveTrack() does for native DSD requests.
+ */
+
+#include <gtest/gtest.h>
+#include "ChunkOutput.h"
+#include "DecodeServer.h"
+#include "DSDDecoder.h"
+#include "protocol/MetadataJSON.h"
+#include "protocol/Protocol.h"
+#include "../dsd/DSDSignalGenerator.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace xpu;
+using namespace xpu::load;
+using namespace xpu::test;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @brief Reply of the server, split into the JSON and the chunks
+ */
+struct Reply {
+    std::string json;
+    std::vector<float> samples;
+    size_t chunks = 0;
+    bool framed = true;  // Chunk data ended on a chunk boundary
+    double first_sample_ms = -1.0;  // Request sent -> first PCM byte received
+};
+
+int connectTo(const std::string& path) {
+    const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+    if (fd >= 0 && connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0) {
+        return fd;
+    }
+    if (fd >= 0) {
+        close(fd);
+    }
+    return -1;
+}
+
+/**
+ * @brief Length of the JSON object at the start of data (0 if incomplete)
+ */
+size_t jsonLength(const std::string& data) {
+    int depth = 0;
+    bool in_string = false;
+    for (size_t i = 0; i < data.size(); ++i) {
+        const char c = data[i];
+        if (in_string) {
+            if (c == '\\') {
+                ++i;
+            } else if (c == '"') {
+                in_string = false;
+            }
+        } else if (c == '"') {
+            in_string = true;
+        } else if (c == '{') {
+            ++depth;
+        } else if (c == '}' && --depth == 0) {
+            return i + 1 < data.size() && data[i + 1] == '\n' ? i + 2 : i + 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Send one request line and read the reply until the server closes the connection
+ */
+Reply request(const std::string& socket_path, const std::string& line) {
+    Reply reply;
+    const int fd = connectTo(socket_path);
+    EXPECT_GE(fd, 0);
+    if (fd < 0) {
+        return reply;
+    }
+    const std::string message = line + "\n";
+    const Clock::time_point sent = Clock::now();
+    EXPECT_EQ(write(fd, message.data(), message.size()), static_cast<ssize_t>(message.size()));
+
+    std::string data;
+    size_t json_end = 0;
+    char buffer[65536];
+    ssize_t got = 0;
+    while ((got = read(fd, buffer, sizeof(buffer))) > 0) {
+        data.append(buffer, static_cast<size_t>(got));
+        if (json_end == 0) {
+            json_end = jsonLength(data);
+        }
+        // First PCM byte: past the JSON and the first size header
+        if (reply.first_sample_ms < 0.0 && json_end > 0 && data.size() > json_end + sizeof(uint64_t)) {
+            reply.first_sample_ms = std::chrono::duration<double, std::milli>(Clock::now() - sent).count();
+        }
+    }
+    close(fd);
+
+    reply.json = data.substr(0, json_end);
+    size_t pos = json_end;
+    while (pos + sizeof(uint64_t) <= data.size()) {
+        uint64_t size = 0;
+        std::memcpy(&size, data.data() + pos, sizeof(size));
+        pos += sizeof(size);
+        if (size % sizeof(float) != 0 || pos + size > data.size()) {
+            reply.framed = false;
+            return reply;
+        }
+        const size_t first = reply.samples.size();
+        reply.samples.resize(first + size / sizeof(float));
+        std::memcpy(reply.samples.data() + first, data.data() + pos, size);
+        pos += size;
+        reply.chunks++;
+    }
+    reply.framed = pos == data.size();
+    return reply;
+}
+
+/**
+ * @brief Decode a request with the native DSD decoder, as serveTrack() does
+ */
+ErrorCode serveDSD(int fd, const TrackRequest& request) {
+    DSDDecoder decoder;
+    decoder.setTargetSampleRate(request.target_sample_rate);
+    decoder.setDSDDecimation(request.dsd_decimation);
+    ErrorCode ret = decoder.prepareStreaming(request.path);
+    if (ret == ErrorCode::Success && (request.start_seconds > 0.0 || request.duration_seconds > 0.0)) {
+        ret = decoder.seek(request.start_seconds, request.duration_seconds);
+    }
+    if (ret != ErrorCode::Success) {
+        DecodeServer::sendError(fd, ret, "cannot open " + request.path);
+        return ret;
+    }
+    protocol::AudioMetadata metadata = decoder.getMetadata();
+    metadata.streaming_mode = !request.metadata_only;
+    const std::string json = protocol::metadataToJSON(metadata);
+    if (!writeAll(fd, json.data(), json.size()) || request.metadata_only) {
+        return ErrorCode::Success;
+    }
+    ChunkOutput output(256 * 1024, fd);
+    ret = decoder.streamPCM([&output](const float* data, size_t samples) {
+        return output.write(data, samples);
+    }, 16 * 1024);
+    output.finish();
+    return ret;
+}
+
+std::vector<float> decodeDirect(const std::string& path) {
+    DSDDecoder decoder;
+    EXPECT_EQ(decoder.prepareStreaming(path), ErrorCode::Success);
+    std::vector<float> samples;
+    EXPECT_EQ(decoder.streamPCM([&samples](const float* data, size_t count) {
+        samples.insert(samples.end(), data, data + count);
+        return true;
+    }, 16 * 1024), ErrorCode::Success);
+    return samples;
+}
+
+class DecodeServerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        DSDSignalSpec spec = DSDSignalSpec::multitone({440.0, 3000.0}, 0.5, DSD64_RATE, 0.5, 2);
+        ASSERT_EQ(writeDSF(dsf_path_, spec), ErrorCode::Success);
+    }
+
+    void TearDown() override {
+        stopServer();
+        std::remove(dsf_path_.c_str());
+        std::remove(socket_path_.c_str());
+    }
+
+    void startServer(size_t max_connections, int request_timeout_ms) {
+        server_ = std::make_unique<DecodeServer>(TrackRequest{}, serveDSD);
+        server_->setMaxConnections(max_connections);
+        server_->setRequestTimeout(request_timeout_ms);
+        std::string error;
+        ASSERT_EQ(server_->listen(socket_path_, error), ErrorCode::Success) << error;
+        thread_ = std::thread([this] { server_->run(stop_); });
+    }
+
+    void stopServer() {
+        if (thread_.joinable()) {
+            stop_ = true;
+            thread_.join();
+        }
+    }
+
+    std::string requestLine(const std::string& extra = std::string()) const {
+        return "{\"path\": " + protocol::quoteJSON(dsf_path_) + extra + "}";
+    }
+
+    const std::string dsf_path_ = "test_DecodeServer.dsf";
+    const std::string socket_path_ = ::testing::TempDir() + "xpu_decode_server_test.sock";
+    std::unique_ptr<DecodeServer> server_;
+    std::atomic<bool> stop_{false};
+    std::thread thread_;
+};
+
+} // anonymous namespace
+
+TEST(ServeRequestTest, ParsesEveryKey) {
+    TrackRequest request;
+    std::string error;
+    ASSERT_TRUE(parseServeRequest(R"({"path": "/music/01 \"live\".dsf", "sample_rate": 96000,
+        "dsd_decimation": 32, "dsd_decoder": "native", "start": 1.5, "duration": 20,
+        "sample_format": "native", "metadata_only": true, "comment": "ignored"})", request, error)) << error;
+    EXPECT_EQ(request.path, "/music/01 \"live\".dsf");
+    EXPECT_EQ(request.target_sample_rate, 96000);
+    EXPECT_EQ(request.dsd_decimation, 32);
+    EXPECT_EQ(request.dsd_decoder, "native");
+    EXPECT_DOUBLE_EQ(request.start_seconds, 1.5);
+    EXPECT_DOUBLE_EQ(request.duration_seconds, 20.0);
+    EXPECT_TRUE(request.native_sample_format);
+    EXPECT_TRUE(request.metadata_only);
+}
+
+TEST(ServeRequestTest, KeysInsideStringsAreNotFields) {
+    TrackRequest request;
+    std::string error;
+    ASSERT_TRUE(parseServeRequest(R"({"path": "a \"sample_rate\": -5, \"dsd_decimation\": 0"})",
+                                  request, error)) << error;
+    EXPECT_EQ(request.path, "a \"sample_rate\": -5, \"dsd_decimation\": 0");
+    EXPECT_EQ(request.target_sample_rate, 0);
+    EXPECT_EQ(request.dsd_decimation, 16);
+}
+
+TEST(ServeRequestTest, RejectsOutOfRangeAndMistypedFields) {
+    const char* invalid[] = {
+        "", "not json", "[1, 2]", "{}", R"({"path": ""})", R"({"path": 5})",
+        R"({"path": "a", "sample_rate": 0})",
+        R"({"path": "a", "sample_rate": -48000})",
+        R"({"path": "a", "sample_rate": 48000.5})",
+        R"({"path": "a", "sample_rate": "48000"})",
+        R"({"path": "a", "sample_rate": 1e12})",
+        R"({"path": "a", "sample_rate": 18446744073709551615})",
+        R"({"path": "a", "dsd_decimation": 0})",
+        R"({"path": "a", "dsd_decimation": -16})",
+        R"({"path": "a", "dsd_decimation": 24})",
+        R"({"path": "a", "start": -1})",
+        R"({"path": "a", "start": "10"})",
+        R"({"path": "a", "duration": 1e300})",
+        R"({"path": "a", "dsd_decoder": "sacd"})",
+        R"({"path": "a", "sample_format": "Int16"})",
+        R"({"path": "a", "dop": "yes"})",
+    };
+    for (const char* line : invalid) {
+        TrackRequest request;
+        std::string error;
+        EXPECT_FALSE(parseServeRequest(line, request, error)) << line;
+        EXPECT_FALSE(error.empty()) << line;
+    }
+}
+
+TEST_F(DecodeServerTest, RepliesWithMetadataAndChunks) {
+    startServer(2, 2000);
+    const std::vector<float> expected = decodeDirect(dsf_path_);
+
+    const Reply reply = request(socket_path_, requestLine());
+    ASSERT_TRUE(reply.framed);
+    protocol::MetadataJSON metadata;
+    ASSERT_TRUE(metadata.parse(reply.json)) << reply.json;
+    EXPECT_EQ(metadata.getInt("sample_rate", 0), static_cast<int>(DSD64_RATE / 16));
+    EXPECT_EQ(metadata.getInt("channels", 0), 2);
+    EXPECT_TRUE(metadata.getBool("streaming_mode", false));
+
+    EXPECT_GT(reply.chunks, 1u);
+    ASSERT_EQ(reply.samples.size(), expected.size());
+    EXPECT_EQ(std::memcmp(reply.samples.data(), expected.data(), expected.size() * sizeof(float)), 0);
+}
+
+TEST_F(DecodeServerTest, RepliesWithErrorJSON) {
+    startServer(2, 2000);
+
+    const Reply invalid = request(socket_path_, requestLine(", \"sample_rate\": 0"));
+    EXPECT_EQ(invalid.chunks, 0u);
+    protocol::MetadataJSON error;
+    ASSERT_TRUE(error.parse(invalid.json)) << invalid.json;
+    EXPECT_NE(invalid.json.find("InvalidArgument"), std::string::npos) << invalid.json;
+    EXPECT_NE(invalid.json.find("sample_rate"), std::string::npos) << invalid.json;
+
+    const Reply missing = request(socket_path_, "{\"path\": \"no_such_file.dsf\"}");
+    EXPECT_EQ(missing.chunks, 0u);
+    EXPECT_NE(missing.json.find("cannot open no_such_file.dsf"), std::string::npos) << missing.json;
+
+    // The server keeps serving after failed requests
+    EXPECT_GT(request(socket_path_, requestLine()).samples.size(), 0u);
+}
+
+TEST_F(DecodeServerTest, DropsClientsThatSendNoRequest) {
+    startServer(1, 200);
+    const int idle = connectTo(socket_path_);
+    ASSERT_GE(idle, 0);
+
+    // The only worker is held by the idle client until its request times out
+    const Clock::time_point start = Clock::now();
+    const Reply reply = request(socket_path_, requestLine(", \"metadata_only\": true"));
+    const double waited_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    EXPECT_FALSE(reply.json.empty());
+    EXPECT_GE(waited_ms, 150.0);
+
+    char c = 0;
+    EXPECT_EQ(read(idle, &c, 1), 0);  // Closed by the server
+    close(idle);
+}
+
+TEST_F(DecodeServerTest, ServesParallelRequestsUpToTheLimit) {
+    startServer(3, 2000);
+    const std::vector<float> expected = decodeDirect(dsf_path_);
+
+    std::vector<Reply> replies(6);
+    std::vector<std::thread> clients;
+    for (Reply& reply : replies) {
+        clients.emplace_back([this, &reply] { reply = request(socket_path_, requestLine()); });
+    }
+    for (std::thread& client : clients) {
+        client.join();
+    }
+    for (const Reply& reply : replies) {
+        ASSERT_TRUE(reply.framed);
+        ASSERT_EQ(reply.samples.size(), expected.size());
+        EXPECT_EQ(std::memcmp(reply.samples.data(), expected.data(), expected.size() * sizeof(float)), 0);
+    }
+}
+
+TEST_F(DecodeServerTest, StopsWithConnectionsOpen) {
+    startServer(2, 60000);
+    const int idle = connectTo(socket_path_);
+    ASSERT_GE(idle, 0);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    stopServer();
+
+    char c = 0;
+    EXPECT_EQ(read(idle, &c, 1), 0);
+    close(idle);
+    EXPECT_NE(access(socket_path_.c_str(), F_OK), 0);  // Socket removed
+}
+
+TEST_F(DecodeServerTest, RecordsTimeToFirstSample) {
+    startServer(1, 2000);
+
+    // The first request pays for the decimation filter design; later ones
+    // reuse it. Timings go to the test report (--gtest_output=xml) only
+    const Reply cold = request(socket_path_, requestLine());
+    std::vector<double> warm;
+    for (int i = 0; i < 5; ++i) {
+        const Reply reply = request(socket_path_, requestLine());
+        ASSERT_GT(reply.first_sample_ms, 0.0);
+        warm.push_back(reply.first_sample_ms);
+    }
+    ASSERT_GT(cold.first_sample_ms, 0.0);
+    std::sort(warm.begin(), warm.end());
+    RecordProperty("cold_first_sample_us", static_cast<int>(cold.first_sample_ms * 1000.0));
+    RecordProperty("warm_first_sample_us", static_cast<int>(warm[warm.size() / 2] * 1000.0));
+}
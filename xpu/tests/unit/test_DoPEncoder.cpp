@@ -0,0 +1,99 @@
+/**
+ * @file test_DoPEncoder.cpp
+ * @brief Unit tests for DSD over PCM (DoP) frame packing
+ */
+
+#include <gtest/gtest.h>
+#include "../../src/lib/audio/DoPEncoder.h"
+#include "../../src/lib/audio/SampleConverter.h"
+#include <vector>
+#include <cstdint>
+
+using namespace xpu::audio;
+
+TEST(DoPEncoderTest, WordsRoundTripExactly) {
+    for (int marker : {DoPEncoder::MARKER_1, DoPEncoder::MARKER_2}) {
+        for (int first = 0; first < 256; first += 7) {
+            for (int second = 0; second < 256; second += 5) {
+                float sample = DoPEncoder::encode(static_cast<uint8_t>(marker),
+                                                  static_cast<uint8_t>(first),
+                                                  static_cast<uint8_t>(second));
+                uint32_t expected = (static_cast<uint32_t>(marker) << 16) |
+                                    (static_cast<uint32_t>(first) << 8) |
+                                    static_cast<uint32_t>(second);
+                EXPECT_EQ(DoPEncoder::decode(sample), expected);
+                EXPECT_GE(sample, -1.0f);
+                EXPECT_LT(sample, 1.0f);
+            }
+        }
+    }
+}
+
+TEST(DoPEncoderTest, MarkersAlternateAcrossCalls) {
+    DoPEncoder encoder(false);
+    std::vector<uint8_t> dsd(16, 0x69);
+    std::vector<float> out(8);
+
+    // Split into two calls; the second continues the marker phase
+    encoder.process(dsd.data(), 3, 0, out.data(), 1);
+    encoder.process(dsd.data() + 6, 5, 3, out.data() + 3, 1);
+
+    for (size_t i = 0; i < out.size(); ++i) {
+        uint8_t marker = static_cast<uint8_t>(DoPEncoder::decode(out[i]) >> 16);
+        EXPECT_EQ(marker, (i % 2) ? DoPEncoder::MARKER_2 : DoPEncoder::MARKER_1) << "frame " << i;
+    }
+}
+
+TEST(DoPEncoderTest, LSBFirstBytesAreReversed) {
+    // DSF 0x01 (first bit set) must become DSDIFF/DoP 0x80
+    const uint8_t dsf[2] = {0x01, 0x0F};
+    const uint8_t dff[2] = {0x80, 0xF0};
+    float from_dsf = 0.0f;
+    float from_dff = 0.0f;
+
+    DoPEncoder(true).process(dsf, 1, 0, &from_dsf, 1);
+    DoPEncoder(false).process(dff, 1, 0, &from_dff, 1);
+
+    EXPECT_EQ(DoPEncoder::decode(from_dsf), 0x0580F0u);
+    EXPECT_EQ(from_dsf, from_dff);
+}
+
+TEST(DoPEncoderTest, InterleavedStride) {
+    DoPEncoder encoder(false);
+    const uint8_t left[4] = {0x11, 0x22, 0x33, 0x44};
+    const uint8_t right[4] = {0xAA, 0xBB, 0xCC, 0xDD};
+    std::vector<float> out(4);
+
+    encoder.process(left, 2, 0, out.data(), 2);
+    encoder.process(right, 2, 0, out.data() + 1, 2);
+
+    EXPECT_EQ(DoPEncoder::decode(out[0]), 0x051122u);
+    EXPECT_EQ(DoPEncoder::decode(out[1]), 0x05AABBu);
+    EXPECT_EQ(DoPEncoder::decode(out[2]), 0xFA3344u);
+    EXPECT_EQ(DoPEncoder::decode(out[3]), 0xFACCDDu);
+}
+
+TEST(DoPEncoderTest, Int24WAVKeepsWordsOnlyWithoutDither) {
+    // xpuIn2Wav writes DoP input as packed 24-bit samples without dither
+    DoPEncoder encoder(false);
+    std::vector<uint8_t> dsd(256);
+    for (size_t i = 0; i < dsd.size(); ++i) {
+        dsd[i] = static_cast<uint8_t>(i * 37 + 11);
+    }
+    std::vector<float> samples(dsd.size() / DoPEncoder::BYTES_PER_FRAME);
+    encoder.process(dsd.data(), samples.size(), 0, samples.data(), 1);
+
+    std::vector<uint8_t> packed(samples.size() * 3);
+    ASSERT_TRUE(SampleConverter::fromFloat(samples.data(), samples.size(), SampleFormat::Int24, packed.data()));
+    for (size_t i = 0; i < samples.size(); ++i) {
+        const uint32_t word = packed[i * 3] | (packed[i * 3 + 1] << 8) |
+                              (static_cast<uint32_t>(packed[i * 3 + 2]) << 16);
+        ASSERT_EQ(word, DoPEncoder::decode(samples[i])) << "frame " << i;
+    }
+
+    DitherState dither;
+    std::vector<uint8_t> dithered(packed.size());
+    ASSERT_TRUE(SampleConverter::fromFloat(samples.data(), samples.size(), SampleFormat::Int24,
+                                           dithered.data(), &dither));
+    EXPECT_NE(dithered, packed);
+}
@@ -0,0 +1,110 @@
+/**
+ * @file test_FilterCache.cpp
+ * @brief Unit tests for the on-disk filter table cache
+ */
+
+#include <gtest/gtest.h>
+#include "../../src/lib/audio/FilterCache.h"
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace xpu;
+using namespace xpu::audio;
+
+class FilterCacheTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        directory_ = ::testing::TempDir() + "xpu_filter_cache_test";
+        FilterCache::setDirectory(directory_);
+    }
+
+    void TearDown() override {
+        std::remove(path(key_).c_str());
+        std::remove(directory_.c_str());
+        FilterCache::setDirectory("");
+    }
+
+    std::string path(const std::string& key) const {
+        return directory_ + "/" + FilterCache::fileName(key);
+    }
+
+    FilterCache::Designer counting(int& designs) const {
+        return [&designs](float* coeffs, size_t count) {
+            ++designs;
+            for (size_t i = 0; i < count; ++i) {
+                coeffs[i] = static_cast<float>(i) * 0.25f;
+            }
+        };
+    }
+
+    std::string directory_;
+    const std::string key_ = "test-table r1 n=20000";
+    const size_t count_ = 20000;
+};
+
+TEST_F(FilterCacheTest, StoredTableIsMappedByLaterUsers) {
+    int designs = 0;
+    {
+        auto table = FilterCache::get(key_, count_, counting(designs));
+        ASSERT_EQ(table->size(), count_);
+        EXPECT_FALSE(table->isMapped());
+        EXPECT_EQ(table->data()[100], 25.0f);
+    }
+    EXPECT_EQ(designs, 1);
+
+    // The in-process copy is gone; the next user maps the stored file
+    auto table = FilterCache::get(key_, count_, counting(designs));
+    EXPECT_EQ(designs, 1);
+    EXPECT_TRUE(table->isMapped());
+    ASSERT_EQ(table->size(), count_);
+    for (size_t i = 0; i < count_; ++i) {
+        ASSERT_EQ(table->data()[i], static_cast<float>(i) * 0.25f) << "coefficient " << i;
+    }
+}
+
+TEST_F(FilterCacheTest, TablesInUseAreShared) {
+    int designs = 0;
+    auto first = FilterCache::get(key_, count_, counting(designs));
+    auto second = FilterCache::get(key_, count_, counting(designs));
+    EXPECT_EQ(first.get(), second.get());
+    EXPECT_EQ(designs, 1);
+}
+
+TEST_F(FilterCacheTest, DamagedFileIsRedesigned) {
+    int designs = 0;
+    FilterCache::get(key_, count_, counting(designs));
+    ASSERT_EQ(designs, 1);
+
+    // Truncate the stored table
+    {
+        std::ofstream out(path(key_), std::ios::binary | std::ios::trunc);
+        out << "XPUFILT";
+    }
+    auto table = FilterCache::get(key_, count_, counting(designs));
+    EXPECT_EQ(designs, 2);
+    EXPECT_FALSE(table->isMapped());
+    EXPECT_EQ(table->data()[4], 1.0f);
+
+    table.reset();
+    EXPECT_TRUE(FilterCache::get(key_, count_, counting(designs))->isMapped());
+    EXPECT_EQ(designs, 2);
+}
+
+TEST_F(FilterCacheTest, SmallTablesAndDisabledCacheStayInMemory) {
+    int designs = 0;
+    const std::string small_key = "test-table r1 n=64";
+    FilterCache::get(small_key, 64, counting(designs));
+    EXPECT_FALSE(std::ifstream(path(small_key)).good());
+
+    FilterCache::setDirectory("");
+    FilterCache::get("test-table r1 disabled", count_, counting(designs));
+    EXPECT_EQ(designs, 2);
+    EXPECT_FALSE(std::ifstream(path("test-table r1 disabled")).good());
+}
+
+TEST_F(FilterCacheTest, FileNameDependsOnKey) {
+    EXPECT_EQ(FilterCache::fileName(key_), FilterCache::fileName(key_));
+    EXPECT_NE(FilterCache::fileName(key_), FilterCache::fileName(key_ + " "));
+}
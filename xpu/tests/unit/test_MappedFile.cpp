@@ -0,0 +1,74 @@
+/**
+ * @file test_MappedFile.cpp
+ * @brief Unit tests for the read-only file mapping
+ */
+
+#include <gtest/gtest.h>
+#include "../../src/lib/utils/MappedFile.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace xpu;
+using namespace xpu::utils;
+
+class MappedFileTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        path_ = ::testing::TempDir() + "xpu_mapped_file_test.bin";
+        data_.resize(3 * 1024 * 1024 + 17);
+        for (size_t i = 0; i < data_.size(); ++i) {
+            data_[i] = static_cast<uint8_t>((i * 31) ^ (i >> 8));
+        }
+        std::ofstream out(path_, std::ios::binary);
+        out.write(reinterpret_cast<const char*>(data_.data()), data_.size());
+    }
+
+    void TearDown() override {
+        std::remove(path_.c_str());
+    }
+
+    std::string path_;
+    std::vector<uint8_t> data_;
+};
+
+TEST_F(MappedFileTest, MapsWholeFile) {
+    MappedFile file;
+    ASSERT_EQ(file.open(path_), ErrorCode::Success);
+    ASSERT_TRUE(file.isOpen());
+    ASSERT_EQ(file.size(), data_.size());
+    EXPECT_TRUE(std::equal(data_.begin(), data_.end(), file.data()));
+}
+
+TEST_F(MappedFileTest, HintsAcceptUnalignedAndOutOfRange) {
+    MappedFile file;
+    ASSERT_EQ(file.open(path_), ErrorCode::Success);
+
+    file.adviseSequential(12345, data_.size());
+    file.prefetch(4097, 1024 * 1024);
+    file.prefetch(data_.size() + 100, 4096);
+    file.prefetch(0, 0);
+
+    EXPECT_EQ(file.data()[12345], data_[12345]);
+}
+
+TEST_F(MappedFileTest, MissingFile) {
+    MappedFile file;
+    EXPECT_EQ(file.open(path_ + ".missing"), ErrorCode::FileNotFound);
+    EXPECT_FALSE(file.isOpen());
+    EXPECT_EQ(file.size(), 0u);
+}
+
+TEST_F(MappedFileTest, CloseReleasesMapping) {
+    MappedFile file;
+    ASSERT_EQ(file.open(path_), ErrorCode::Success);
+    file.close();
+    EXPECT_FALSE(file.isOpen());
+    EXPECT_EQ(file.data(), nullptr);
+
+    // Reopen after close
+    ASSERT_EQ(file.open(path_), ErrorCode::Success);
+    EXPECT_EQ(file.data()[0], data_[0]);
+}
@@ -0,0 +1,136 @@
+/**
+ * @file test_MetadataJSON.cpp
+ * @brief Unit tests for reading and rewriting stream metadata JSON
+ */
+
+#include <gtest/gtest.h>
+#include "../../src/lib/protocol/MetadataJSON.h"
+#include "../../src/lib/protocol/Protocol.h"
+#include <string>
+
+using namespace xpu;
+using namespace xpu::protocol;
+
+namespace {
+
+// Shape written by xpuLoad: fields inside a "metadata" object
+const char* NESTED_JSON = R"({
+  "success": true,
+  "metadata": {
+    "file_path": "/music/01.flac",
+    "title": "Say \"sample_rate\": 8000, \"channels\": 1",
+    "sample_rate": 96000,
+    "bit_depth": 24,
+    "channels": 2,
+    "sample_count": 960000,
+    "duration": 10.0,
+    "streaming_mode": true,
+    "sample_format": "Int24"
+  }
+})";
+
+} // anonymous namespace
+
+TEST(MetadataJSONTest, ReadsNestedMetadataFields) {
+    MetadataJSON metadata;
+    ASSERT_TRUE(metadata.parse(NESTED_JSON));
+    EXPECT_EQ(metadata.getInt("sample_rate", 0), 96000);
+    EXPECT_EQ(metadata.getInt("channels", 0), 2);
+    EXPECT_EQ(metadata.getUInt64("sample_count", 0), 960000u);
+    EXPECT_DOUBLE_EQ(metadata.getDouble("duration", 0.0), 10.0);
+    EXPECT_TRUE(metadata.getBool("streaming_mode", false));
+    EXPECT_EQ(metadata.getString("sample_format", ""), "Int24");
+    EXPECT_EQ(metadata.getString("title", ""), "Say \"sample_rate\": 8000, \"channels\": 1");
+}
+
+TEST(MetadataJSONTest, ReadsFlatMetadataFields) {
+    MetadataJSON metadata;
+    ASSERT_TRUE(metadata.parse(R"({"sample_rate": 44100, "channels": 1, "encoding": "dop"})"));
+    EXPECT_EQ(metadata.getInt("sample_rate", 0), 44100);
+    EXPECT_EQ(metadata.getInt("channels", 0), 1);
+    EXPECT_EQ(metadata.getString("encoding", "pcm"), "dop");
+}
+
+TEST(MetadataJSONTest, FallsBackOnMissingOrMistypedFields) {
+    MetadataJSON metadata;
+    ASSERT_TRUE(metadata.parse(R"({"sample_rate": "48000", "channels": 2.5, "bit_depth": 99999999999,
+                                   "sample_count": -1, "streaming_mode": 1})"));
+    EXPECT_FALSE(metadata.has("encoding"));
+    EXPECT_EQ(metadata.getString("encoding", "pcm"), "pcm");
+    EXPECT_EQ(metadata.getInt("sample_rate", 48000), 48000);
+    EXPECT_EQ(metadata.getInt("channels", 2), 2);
+    EXPECT_EQ(metadata.getInt("bit_depth", 32), 32);
+    EXPECT_EQ(metadata.getUInt64("sample_count", 7), 7u);
+    EXPECT_FALSE(metadata.getBool("streaming_mode", false));
+}
+
+TEST(MetadataJSONTest, RejectsInvalidDocuments) {
+    MetadataJSON metadata;
+    EXPECT_FALSE(metadata.parse("{\"sample_rate\": 48000"));
+    EXPECT_FALSE(metadata.parse("[1, 2]"));
+    EXPECT_FALSE(metadata.parse(""));
+    EXPECT_EQ(metadata.getInt("sample_rate", 0), 0);
+}
+
+TEST(MetadataJSONTest, SetRewritesInPlaceAndKeepsOtherFields) {
+    MetadataJSON metadata;
+    ASSERT_TRUE(metadata.parse(NESTED_JSON));
+    metadata.set("sample_format", "Float32");
+    metadata.set("bit_depth", 32);
+
+    MetadataJSON rewritten;
+    ASSERT_TRUE(rewritten.parse(metadata.dump()));
+    EXPECT_EQ(rewritten.getString("sample_format", ""), "Float32");
+    EXPECT_EQ(rewritten.getInt("bit_depth", 0), 32);
+    EXPECT_EQ(rewritten.getInt("sample_rate", 0), 96000);
+    EXPECT_EQ(rewritten.getString("title", ""), "Say \"sample_rate\": 8000, \"channels\": 1");
+
+    // Rewritten fields stay in the "metadata" object, in their original order
+    const std::string dumped = metadata.dump();
+    EXPECT_LT(dumped.find("\"bit_depth\""), dumped.find("\"channels\""));
+    EXPECT_LT(dumped.find("\"success\""), dumped.find("\"metadata\""));
+    EXPECT_NE(dumped.back(), '\n');
+}
+
+TEST(MetadataJSONTest, QuoteEscapesStrings) {
+    EXPECT_EQ(quoteJSON("plain"), "\"plain\"");
+    EXPECT_EQ(quoteJSON("a \"b\" \\ c"), "\"a \\\"b\\\" \\\\ c\"");
+    EXPECT_EQ(quoteJSON("line\nbreak\ttab"), "\"line\\nbreak\\ttab\"");
+    EXPECT_EQ(quoteJSON("\xC3\xA9t\xC3\xA9"), "\"\xC3\xA9t\xC3\xA9\"");  // UTF-8 kept as is
+    EXPECT_EQ(quoteJSON("caf\xE9"), "\"caf\xEF\xBF\xBD\"");            // Latin-1 byte replaced
+
+    MetadataJSON metadata;
+    EXPECT_TRUE(metadata.parse("{\"title\": " + quoteJSON("\"quoted\"\n") + "}"));
+    EXPECT_EQ(metadata.getString("title", ""), "\"quoted\"\n");
+}
+
+TEST(MetadataJSONTest, SetStreamFormatScalesSampleCount) {
+    MetadataJSON metadata;
+    ASSERT_TRUE(metadata.parse(NESTED_JSON));
+    metadata.setStreamFormat(48000, 2, 32);
+    EXPECT_EQ(metadata.getInt("sample_rate", 0), 48000);
+    EXPECT_EQ(metadata.getInt("channels", 0), 2);
+    EXPECT_EQ(metadata.getInt("bit_depth", 0), 32);
+    EXPECT_EQ(metadata.getString("sample_format", ""), "Float32");
+    EXPECT_EQ(metadata.getUInt64("sample_count", 0), 480000u);
+
+    // Same rate: sample_count is kept
+    metadata.setStreamFormat(48000, 1, 16);
+    EXPECT_EQ(metadata.getUInt64("sample_count", 0), 480000u);
+    EXPECT_EQ(metadata.getString("sample_format", ""), "Int16");
+}
+
+TEST(MetadataJSONTest, MetadataToJSONEscapesStrings) {
+    AudioMetadata meta;
+    meta.title = "Say \"hi\"";
+    meta.artist = "Back\\slash";
+    meta.file_path = "/music/a\nb.flac";
+    meta.sample_rate = 44100;
+
+    MetadataJSON metadata;
+    ASSERT_TRUE(metadata.parse(metadataToJSON(meta)));
+    EXPECT_EQ(metadata.getString("title", ""), meta.title);
+    EXPECT_EQ(metadata.getString("artist", ""), meta.artist);
+    EXPECT_EQ(metadata.getString("file_path", ""), meta.file_path);
+    EXPECT_EQ(metadata.getInt("sample_rate", 0), 44100);
+}
@@ -0,0 +1,303 @@
+/**
+ * @file test_PolyphaseResampler.cpp
+ * @brief Unit tests for the rational polyphase resampler
+ */
+
+#include <gtest/gtest.h>
+#include "../../src/lib/audio/PolyphaseResampler.h"
+#include <vector>
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <thread>
+
+using namespace xpu;
+using namespace xpu::audio;
+
+namespace {
+
+constexpr double PI = 3.14159265358979323846;
+
+// Keep designed filter tables out of the user's cache directory
+class MemoryFilterCache : public ::testing::Environment {
+public:
+    void SetUp() override { FilterCache::setDirectory(""); }
+};
+
+const ::testing::Environment* const memory_filter_cache =
+    ::testing::AddGlobalTestEnvironment(new MemoryFilterCache);
+
+std::vector<float> makeSine(size_t frames, int channels, double freq, double amplitude, double rate) {
+    std::vector<float> out(frames * channels);
+    for (size_t i = 0; i < frames; ++i) {
+        for (int ch = 0; ch < channels; ++ch) {
+            out[i * channels + ch] = static_cast<float>(amplitude * std::sin(2.0 * PI * freq * i / rate));
+        }
+    }
+    return out;
+}
+
+std::vector<float> resampleAll(const std::vector<float>& input, int in_rate, int out_rate,
+                               int channels, size_t chunk_frames,
+                               ResamplerQuality quality = ResamplerQuality::Fast,
+                               SIMDLevel level = detectSIMDLevel()) {
+    PolyphaseResampler resampler;
+    EXPECT_EQ(resampler.init(in_rate, out_rate, channels, quality), ErrorCode::Success);
+    resampler.setSIMDLevel(level);
+
+    std::vector<float> result;
+    std::vector<float> chunk;
+    const size_t frames = input.size() / channels;
+    for (size_t i = 0; i < frames; i += chunk_frames) {
+        size_t n = std::min(chunk_frames, frames - i);
+        EXPECT_EQ(resampler.process(input.data() + i * channels, n, chunk), ErrorCode::Success);
+        result.insert(result.end(), chunk.begin(), chunk.end());
+    }
+    EXPECT_EQ(resampler.flush(chunk), ErrorCode::Success);
+    result.insert(result.end(), chunk.begin(), chunk.end());
+    return result;
+}
+
+} // anonymous namespace
+
+TEST(PolyphaseResamplerTest, ReducesRatio) {
+    PolyphaseResampler resampler;
+    ASSERT_EQ(resampler.init(176400, 48000, 2), ErrorCode::Success);
+    EXPECT_EQ(resampler.getUpFactor(), 40);
+    EXPECT_EQ(resampler.getDownFactor(), 147);
+    EXPECT_TRUE(resampler.isActive());
+}
+
+TEST(PolyphaseResamplerTest, RejectsUnsupportedRatio) {
+    EXPECT_FALSE(PolyphaseResampler::isSupportedRatio(44100, 47999));
+    EXPECT_FALSE(PolyphaseResampler::isSupportedRatio(0, 48000));
+
+    PolyphaseResampler resampler;
+    EXPECT_EQ(resampler.init(44100, 47999, 2), ErrorCode::NotSupported);
+    EXPECT_EQ(resampler.init(44100, 48000, 0), ErrorCode::InvalidArgument);
+}
+
+TEST(PolyphaseResamplerTest, OutputLengthMatchesRatio) {
+    const std::vector<std::pair<int, int>> rates = {
+        {44100, 48000}, {48000, 44100}, {176400, 48000}, {88200, 96000}, {44100, 192000}};
+    for (const auto& rate : rates) {
+        std::vector<float> input = makeSine(12345, 2, 440.0, 0.5, rate.first);
+        std::vector<float> output = resampleAll(input, rate.first, rate.second, 2, 4096);
+        uint64_t expected = (12345ULL * rate.second + rate.first - 1) / rate.first;
+        EXPECT_EQ(output.size() / 2, expected) << rate.first << " -> " << rate.second;
+    }
+}
+
+TEST(PolyphaseResamplerTest, ChunkingDoesNotChangeOutput) {
+    std::vector<float> input = makeSine(50000, 2, 1000.0, 0.5, 176400);
+    std::vector<float> whole = resampleAll(input, 176400, 48000, 2, input.size());
+    std::vector<float> chunked = resampleAll(input, 176400, 48000, 2, 333);
+    ASSERT_EQ(whole.size(), chunked.size());
+    for (size_t i = 0; i < whole.size(); ++i) {
+        ASSERT_EQ(whole[i], chunked[i]) << "sample " << i;
+    }
+}
+
+TEST(PolyphaseResamplerTest, PreservesSineWithoutDelay) {
+    const int in_rate = 44100;
+    const int out_rate = 48000;
+    std::vector<float> input = makeSine(in_rate, 1, 1000.0, 0.5, in_rate);
+    std::vector<float> output = resampleAll(input, in_rate, out_rate, 1, 1024);
+
+    // Compare against the ideal sine away from the edges
+    double error = 0.0;
+    size_t count = 0;
+    for (size_t i = output.size() / 10; i < output.size() * 9 / 10; ++i) {
+        double expected = 0.5 * std::sin(2.0 * PI * 1000.0 * i / out_rate);
+        error += (output[i] - expected) * (output[i] - expected);
+        ++count;
+    }
+    double snr_db = 10.0 * std::log10(0.125 / (error / count));
+    EXPECT_GT(snr_db, 90.0);
+}
+
+TEST(PolyphaseResamplerTest, AttenuatesAboveNewNyquist) {
+    // 30 kHz at 96 kHz must not alias into the 48 kHz output
+    std::vector<float> input = makeSine(96000, 1, 30000.0, 0.5, 96000);
+    std::vector<float> output = resampleAll(input, 96000, 48000, 1, 4096);
+
+    double energy = 0.0;
+    for (size_t i = output.size() / 10; i < output.size() * 9 / 10; ++i) {
+        energy += output[i] * output[i];
+    }
+    double rms = std::sqrt(energy / (output.size() * 8 / 10));
+    EXPECT_LT(20.0 * std::log10(rms / (0.5 / std::sqrt(2.0))), -80.0);
+}
+
+TEST(PolyphaseResamplerTest, QualityNames) {
+    ResamplerQuality quality = ResamplerQuality::Medium;
+    EXPECT_TRUE(PolyphaseResampler::qualityFromString("fast", quality));
+    EXPECT_EQ(quality, ResamplerQuality::Fast);
+    EXPECT_TRUE(PolyphaseResampler::qualityFromString("best", quality));
+    EXPECT_EQ(quality, ResamplerQuality::Best);
+    EXPECT_FALSE(PolyphaseResampler::qualityFromString("linear", quality));
+    EXPECT_FALSE(PolyphaseResampler::qualityFromString(nullptr, quality));
+}
+
+TEST(PolyphaseResamplerTest, PresetsTradeTapsForAttenuation) {
+    // 26 kHz at 96 kHz lies in every preset's stopband for a 48 kHz output
+    std::vector<float> input = makeSine(96000, 1, 26000.0, 0.5, 96000);
+    const std::pair<ResamplerQuality, double> presets[] = {
+        {ResamplerQuality::Fast, -95.0}, {ResamplerQuality::Medium, -120.0},
+        {ResamplerQuality::Best, -135.0}};
+
+    size_t previous_taps = 0;
+    for (const auto& preset : presets) {
+        PolyphaseResampler resampler;
+        ASSERT_EQ(resampler.init(96000, 48000, 1, preset.first), ErrorCode::Success);
+        EXPECT_GT(resampler.getTapsPerPhase(), previous_taps);
+        EXPECT_EQ(resampler.getTapsPerPhase() % 8, 0u);
+        previous_taps = resampler.getTapsPerPhase();
+
+        std::vector<float> output = resampleAll(input, 96000, 48000, 1, 4096, preset.first);
+        double energy = 0.0;
+        for (size_t i = output.size() / 10; i < output.size() * 9 / 10; ++i) {
+            energy += output[i] * output[i];
+        }
+        double rms = std::sqrt(energy / (output.size() * 8 / 10));
+        EXPECT_LT(20.0 * std::log10(rms / (0.5 / std::sqrt(2.0))), preset.second)
+            << "preset " << static_cast<int>(preset.first);
+    }
+}
+
+TEST(PolyphaseResamplerTest, SIMDLevelsMatchScalar) {
+    std::vector<float> input = makeSine(20000, 2, 997.0, 0.7, 44100);
+    std::vector<float> scalar = resampleAll(input, 44100, 48000, 2, 1000,
+                                            ResamplerQuality::Medium, SIMDLevel::Scalar);
+    std::vector<float> simd = resampleAll(input, 44100, 48000, 2, 1000,
+                                          ResamplerQuality::Medium, detectSIMDLevel());
+    ASSERT_EQ(scalar.size(), simd.size());
+    for (size_t i = 0; i < scalar.size(); ++i) {
+        ASSERT_NEAR(scalar[i], simd[i], 1e-6f) << "sample " << i;
+    }
+}
+
+TEST(PolyphaseResamplerTest, SegmentsSpliceBitIdenticalToSerial) {
+    // Noise rather than a sine, so a misplaced window cannot go unnoticed
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> noise(-0.9f, 0.9f);
+    std::vector<float> input(30011 * 2);
+    for (float& sample : input) {
+        sample = noise(rng);
+    }
+    const size_t frames = input.size() / 2;
+
+    const std::pair<int, int> rates[] = {{44100, 48000}, {176400, 48000}, {44100, 192000}};
+    for (const auto& rate : rates) {
+        std::vector<float> serial = resampleAll(input, rate.first, rate.second, 2, 4096,
+                                                ResamplerQuality::Medium);
+
+        PolyphaseResampler resampler;
+        ASSERT_EQ(resampler.init(rate.first, rate.second, 2, ResamplerQuality::Medium), ErrorCode::Success);
+        const uint64_t total = resampler.getOutputFrames(frames);
+        ASSERT_EQ(total * 2, serial.size());
+
+        // Uneven segments, including a single frame and windows past both ends of the input
+        const uint64_t cuts[] = {0, 1, 2, 997, total / 3, total / 2, total - 5, total};
+        std::vector<std::vector<float>> segments(sizeof(cuts) / sizeof(cuts[0]) - 1);
+        std::vector<std::thread> threads;
+        for (size_t i = 0; i < segments.size(); ++i) {
+            threads.emplace_back([&, i] {
+                EXPECT_EQ(resampler.resampleSegment(input.data(), frames, cuts[i], cuts[i + 1] - cuts[i],
+                                                    segments[i]),
+                          ErrorCode::Success);
+            });
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+
+        std::vector<float> spliced;
+        for (const auto& segment : segments) {
+            spliced.insert(spliced.end(), segment.begin(), segment.end());
+        }
+        ASSERT_EQ(spliced.size(), serial.size());
+        EXPECT_EQ(std::memcmp(spliced.data(), serial.data(), serial.size() * sizeof(float)), 0)
+            << rate.first << " -> " << rate.second;
+    }
+}
+
+TEST(PolyphaseResamplerTest, SegmentPastEndIsRejected) {
+    std::vector<float> input(1000, 0.25f);
+    std::vector<float> output;
+    PolyphaseResampler resampler;
+    EXPECT_EQ(resampler.resampleSegment(input.data(), 1000, 0, 10, output), ErrorCode::InvalidOperation);
+
+    ASSERT_EQ(resampler.init(44100, 48000, 1), ErrorCode::Success);
+    const uint64_t total = resampler.getOutputFrames(1000);
+    EXPECT_EQ(total, 1089u);
+    EXPECT_EQ(resampler.resampleSegment(input.data(), 1000, total - 10, 11, output), ErrorCode::InvalidArgument);
+    EXPECT_EQ(resampler.resampleSegment(input.data(), 1000, total - 10, 10, output), ErrorCode::Success);
+    EXPECT_EQ(output.size(), 10u);
+}
+
+TEST(PolyphaseResamplerTest, BoundedWindowsMatchSerial) {
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<float> noise(-0.9f, 0.9f);
+    std::vector<float> input(30011 * 2);
+    for (float& sample : input) {
+        sample = noise(rng);
+    }
+    const size_t frames = input.size() / 2;
+
+    const std::pair<int, int> rates[] = {{44100, 48000}, {176400, 48000}, {44100, 192000}};
+    for (const auto& rate : rates) {
+        std::vector<float> serial = resampleAll(input, rate.first, rate.second, 2, 4096,
+                                                ResamplerQuality::Medium);
+
+        PolyphaseResampler resampler;
+        ASSERT_EQ(resampler.init(rate.first, rate.second, 2, ResamplerQuality::Medium), ErrorCode::Success);
+
+        // Feed chunks into a window that only keeps what the next output reads,
+        // resampling whatever is ready after each chunk
+        std::vector<float> window;
+        uint64_t window_start = 0;
+        uint64_t received = 0;
+        uint64_t produced = 0;
+        std::vector<float> windowed;
+        std::vector<float> part;
+        auto drain = [&](uint64_t last) {
+            ASSERT_EQ(resampler.resampleSegment(window.data(), window.size() / 2, window_start, produced,
+                                                static_cast<size_t>(last - produced), part),
+                      ErrorCode::Success);
+            windowed.insert(windowed.end(), part.begin(), part.end());
+            produced = last;
+            const int64_t keep = std::min<int64_t>(resampler.getFirstInputFrame(produced),
+                                                   static_cast<int64_t>(received));
+            if (keep > static_cast<int64_t>(window_start)) {
+                window.erase(window.begin(), window.begin() + (keep - static_cast<int64_t>(window_start)) * 2);
+                window_start = static_cast<uint64_t>(keep);
+            }
+        };
+        for (size_t i = 0; i < frames; i += 3001) {
+            const size_t n = std::min<size_t>(3001, frames - i);
+            window.insert(window.end(), input.begin() + i * 2, input.begin() + (i + n) * 2);
+            received += n;
+            drain(resampler.getReadyOutputFrames(received));
+            EXPECT_LE(window.size() / 2, 3001 + resampler.getTapsPerPhase() + 1);
+        }
+        drain(resampler.getOutputFrames(received));
+
+        ASSERT_EQ(windowed.size(), serial.size());
+        EXPECT_EQ(std::memcmp(windowed.data(), serial.data(), serial.size() * sizeof(float)), 0)
+            << rate.first << " -> " << rate.second;
+    }
+}
+
+TEST(PolyphaseResamplerTest, ReadyFramesMatchProcess) {
+    std::vector<float> input(5000, 0.5f);
+    std::vector<float> output;
+    PolyphaseResampler resampler;
+    ASSERT_EQ(resampler.init(44100, 48000, 1, ResamplerQuality::Medium), ErrorCode::Success);
+    uint64_t produced = 0;
+    for (size_t received = 1000; received <= 5000; received += 1000) {
+        ASSERT_EQ(resampler.process(input.data(), 1000, output), ErrorCode::Success);
+        produced += output.size();
+        EXPECT_EQ(resampler.getReadyOutputFrames(received), produced);
+    }
+}
@@ -0,0 +1,111 @@
+/**
+ * @file test_ReadAhead.cpp
+ * @brief Unit tests for the background read-ahead
+ */
+
+#include <gtest/gtest.h>
+#include "../../src/lib/utils/ReadAhead.h"
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace xpu;
+using namespace xpu::utils;
+
+namespace {
+
+constexpr size_t MB = 1024 * 1024;
+
+ReadAheadConfig makeConfig(size_t window_bytes, int threads) {
+    ReadAheadConfig config;
+    config.window_bytes = window_bytes;
+    config.threads = threads;
+    config.block_bytes = 256 * 1024;
+    return config;
+}
+
+} // anonymous namespace
+
+class ReadAheadTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        path_ = ::testing::TempDir() + "xpu_read_ahead_test.bin";
+        std::vector<char> data(8 * MB + 123, 'x');
+        std::ofstream out(path_, std::ios::binary);
+        out.write(data.data(), data.size());
+        size_ = data.size();
+    }
+
+    void TearDown() override {
+        std::remove(path_.c_str());
+    }
+
+    std::string path_;
+    uint64_t size_ = 0;
+};
+
+TEST_F(ReadAheadTest, LoadsWindowAheadOfPosition) {
+    ReadAhead read_ahead(makeConfig(2 * MB, 2));
+    ASSERT_EQ(read_ahead.open(path_), ErrorCode::Success);
+    ASSERT_TRUE(read_ahead.isOpen());
+
+    read_ahead.waitIdle();
+    EXPECT_EQ(read_ahead.bytesLoaded(), 2 * MB);
+
+    read_ahead.advance(1 * MB);
+    read_ahead.waitIdle();
+    EXPECT_EQ(read_ahead.bytesLoaded(), 3 * MB);
+}
+
+TEST_F(ReadAheadTest, StopsAtEndOfRange) {
+    ReadAhead read_ahead(makeConfig(4 * MB, 3));
+    ASSERT_EQ(read_ahead.open(path_, 1 * MB, 2 * MB), ErrorCode::Success);
+    read_ahead.advance(2 * MB);
+    read_ahead.waitIdle();
+    EXPECT_EQ(read_ahead.bytesLoaded(), 2 * MB);
+
+    ReadAhead to_end(makeConfig(64 * MB, 2));
+    ASSERT_EQ(to_end.open(path_), ErrorCode::Success);
+    to_end.waitIdle();
+    EXPECT_EQ(to_end.bytesLoaded(), size_);
+}
+
+TEST_F(ReadAheadTest, JumpRestartsWindow) {
+    ReadAhead read_ahead(makeConfig(1 * MB, 2));
+    ASSERT_EQ(read_ahead.open(path_), ErrorCode::Success);
+    read_ahead.waitIdle();
+
+    read_ahead.advance(6 * MB);
+    read_ahead.waitIdle();
+    EXPECT_EQ(read_ahead.bytesLoaded(), 2 * MB);
+
+    // Backwards: the window is loaded again from the new position
+    read_ahead.advance(0);
+    read_ahead.waitIdle();
+    EXPECT_EQ(read_ahead.bytesLoaded(), 3 * MB);
+}
+
+TEST_F(ReadAheadTest, MissingFile) {
+    ReadAhead read_ahead(makeConfig(1 * MB, 1));
+    EXPECT_EQ(read_ahead.open(path_ + ".missing"), ErrorCode::FileNotFound);
+    EXPECT_FALSE(read_ahead.isOpen());
+    read_ahead.advance(1 * MB);
+    read_ahead.close();
+}
+
+TEST(ReadAheadConfigTest, FromConfig) {
+    std::map<std::string, ConfigValue> config;
+    EXPECT_FALSE(ReadAheadConfig::fromConfig(config).enabled());
+
+    config["io.readahead_mb"] = ConfigValue(16);
+    config["io.readahead_threads"] = ConfigValue(4);
+    config["io.readahead_block_kb"] = ConfigValue(512);
+    config["io.fadvise"] = ConfigValue(false);
+    ReadAheadConfig result = ReadAheadConfig::fromConfig(config);
+    EXPECT_TRUE(result.enabled());
+    EXPECT_EQ(result.window_bytes, 16 * MB);
+    EXPECT_EQ(result.threads, 4);
+    EXPECT_EQ(result.block_bytes, 512u * 1024);
+    EXPECT_FALSE(result.fadvise);
+}
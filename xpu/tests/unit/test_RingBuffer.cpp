@@ -0,0 +1,105 @@
+/**
+ * @file test_RingBuffer.cpp
+ * @brief Unit tests for the single-producer / single-consumer ring buffer
+ */
+
+#include <gtest/gtest.h>
+#include "../../src/lib/utils/RingBuffer.h"
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+using namespace xpu::utils;
+
+TEST(RingBufferTest, RoundsCapacityToPowerOfTwo) {
+    EXPECT_EQ(RingBuffer(1000).capacity(), 1024u);
+    EXPECT_EQ(RingBuffer(4096).capacity(), 4096u);
+    EXPECT_EQ(RingBuffer(0).capacity(), 1u);
+}
+
+TEST(RingBufferTest, PeekReturnsContiguousSpansAcrossWrap) {
+    RingBuffer ring(16);
+    std::vector<uint8_t> data(12);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<uint8_t>(i);
+    }
+    ASSERT_EQ(ring.write(data.data(), 12), 12u);
+    uint8_t out[12];
+    ASSERT_EQ(ring.read(out, 10), 10u);
+
+    // 2 bytes left at offset 10; the next 12 wrap around the end
+    ASSERT_EQ(ring.write(data.data(), 12), 12u);
+    EXPECT_EQ(ring.size(), 14u);
+
+    const uint8_t* span = nullptr;
+    ASSERT_EQ(ring.peek(span), 6u);  // Offsets 10..15
+    EXPECT_EQ(span[0], 10);
+    EXPECT_EQ(span[2], 0);
+    ring.consume(6);
+    ASSERT_EQ(ring.peek(span), 8u);  // Wrapped part
+    EXPECT_EQ(span[0], 4);
+    EXPECT_EQ(span[7], 11);
+}
+
+TEST(RingBufferTest, CloseDrainsThenEnds) {
+    RingBuffer ring(64);
+    const uint8_t data[5] = {1, 2, 3, 4, 5};
+    ring.write(data, 5);
+    ring.close();
+
+    EXPECT_EQ(ring.write(data, 5), 0u);
+    uint8_t out[8];
+    EXPECT_EQ(ring.read(out, 8), 5u);
+    EXPECT_EQ(out[4], 5);
+    EXPECT_EQ(ring.read(out, 8), 0u);
+}
+
+TEST(RingBufferTest, ConsumerCloseUnblocksWriter) {
+    RingBuffer ring(16);
+    std::vector<uint8_t> data(64, 0xAB);
+    size_t written = 0;
+    std::thread producer([&] { written = ring.write(data.data(), data.size()); });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    ring.close();
+    producer.join();
+    EXPECT_EQ(written, 16u);
+}
+
+TEST(RingBufferTest, StreamsInOrderBetweenThreads) {
+    RingBuffer ring(4096);
+    const size_t total = 8 * 1024 * 1024;
+
+    std::thread producer([&] {
+        std::vector<uint8_t> block;
+        size_t sent = 0;
+        size_t size = 1;
+        while (sent < total) {
+            // Odd block sizes so writes straddle the wrap point
+            size = std::min(total - sent, (size * 7 + 13) % 10000 + 1);
+            block.resize(size);
+            for (size_t i = 0; i < size; ++i) {
+                block[i] = static_cast<uint8_t>((sent + i) * 131);
+            }
+            ASSERT_EQ(ring.write(block.data(), size), size);
+            sent += size;
+        }
+        ring.close();
+    });
+
+    size_t received = 0;
+    bool in_order = true;
+    const uint8_t* span = nullptr;
+    while (size_t n = ring.peek(span)) {
+        for (size_t i = 0; i < n && in_order; ++i) {
+            in_order = span[i] == static_cast<uint8_t>((received + i) * 131);
+        }
+        received += n;
+        ring.consume(n);
+    }
+    producer.join();
+
+    EXPECT_TRUE(in_order);
+    EXPECT_EQ(received, total);
+}
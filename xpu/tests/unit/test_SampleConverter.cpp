@@ -0,0 +1,205 @@
+/**
+ * @file test_SampleConverter.cpp
+ * @brief Unit tests for integer PCM -> float conversion
+ */
+
+#include <gtest/gtest.h>
+#include "../../src/lib/audio/SampleConverter.h"
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+using namespace xpu::audio;
+
+TEST(SampleConverterTest, Int16FullScale) {
+    const int16_t in[] = {0, 1, -1, 32767, -32768, 16384};
+    float out[6];
+    ASSERT_TRUE(SampleConverter::toFloat(reinterpret_cast<const uint8_t*>(in), SampleFormat::Int16, 6, out));
+    EXPECT_EQ(out[0], 0.0f);
+    EXPECT_EQ(out[1], 1.0f / 32768.0f);
+    EXPECT_EQ(out[2], -1.0f / 32768.0f);
+    EXPECT_EQ(out[3], 32767.0f / 32768.0f);
+    EXPECT_EQ(out[4], -1.0f);
+    EXPECT_EQ(out[5], 0.5f);
+}
+
+TEST(SampleConverterTest, Int24PackedSignExtends) {
+    // 0x7FFFFF, 0x800000 (most negative), -1, 0x000001 as packed little-endian triplets
+    const uint8_t in[] = {
+        0xFF, 0xFF, 0x7F,
+        0x00, 0x00, 0x80,
+        0xFF, 0xFF, 0xFF,
+        0x01, 0x00, 0x00,
+    };
+    float out[4];
+    ASSERT_TRUE(SampleConverter::toFloat(in, SampleFormat::Int24, 4, out));
+    EXPECT_EQ(out[0], 8388607.0f / 8388608.0f);
+    EXPECT_EQ(out[1], -1.0f);
+    EXPECT_EQ(out[2], -1.0f / 8388608.0f);
+    EXPECT_EQ(out[3], 1.0f / 8388608.0f);
+}
+
+TEST(SampleConverterTest, Int24ValuesAreExact) {
+    // Every 24-bit value survives the trip to float and back
+    std::vector<uint8_t> in;
+    std::vector<int32_t> values;
+    for (int32_t v = -8388608; v < 8388608; v += 4093) {
+        values.push_back(v);
+        in.push_back(static_cast<uint8_t>(v & 0xFF));
+        in.push_back(static_cast<uint8_t>((v >> 8) & 0xFF));
+        in.push_back(static_cast<uint8_t>((v >> 16) & 0xFF));
+    }
+    std::vector<float> out(values.size());
+    ASSERT_TRUE(SampleConverter::toFloat(in.data(), SampleFormat::Int24, values.size(), out.data()));
+    for (size_t i = 0; i < values.size(); ++i) {
+        EXPECT_EQ(static_cast<int32_t>(std::lround(out[i] * 8388608.0)), values[i]) << "sample " << i;
+    }
+}
+
+TEST(SampleConverterTest, Int32AndUInt8) {
+    const int32_t in32[] = {INT32_MIN, 0, 1 << 30};
+    float out[3];
+    ASSERT_TRUE(SampleConverter::toFloat(reinterpret_cast<const uint8_t*>(in32), SampleFormat::Int32, 3, out));
+    EXPECT_EQ(out[0], -1.0f);
+    EXPECT_EQ(out[1], 0.0f);
+    EXPECT_EQ(out[2], 0.5f);
+
+    const uint8_t in8[] = {0, 128, 192};
+    ASSERT_TRUE(SampleConverter::toFloat(in8, SampleFormat::UInt8, 3, out));
+    EXPECT_EQ(out[0], -1.0f);
+    EXPECT_EQ(out[1], 0.0f);
+    EXPECT_EQ(out[2], 0.5f);
+}
+
+TEST(SampleConverterTest, UnalignedInput) {
+    // Chunks read from a pipe need not be aligned to the sample size
+    const int16_t values[] = {1000, -2000, 3000};
+    std::vector<uint8_t> buffer(1 + sizeof(values));
+    std::memcpy(buffer.data() + 1, values, sizeof(values));
+    float out[3];
+    ASSERT_TRUE(SampleConverter::toFloat(buffer.data() + 1, SampleFormat::Int16, 3, out));
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_EQ(out[i], values[i] / 32768.0f);
+    }
+}
+
+TEST(SampleConverterTest, FormatSupport) {
+    EXPECT_TRUE(SampleConverter::isInteger(SampleFormat::Int24));
+    EXPECT_FALSE(SampleConverter::isInteger(SampleFormat::Float32));
+    EXPECT_TRUE(SampleConverter::isSupported(SampleFormat::Float32));
+    EXPECT_FALSE(SampleConverter::isSupported(SampleFormat::Float64));
+
+    float out[1];
+    const uint8_t in[8] = {};
+    EXPECT_FALSE(SampleConverter::toFloat(in, SampleFormat::DSD1, 1, out));
+    EXPECT_EQ(AudioFormatUtils::sampleFormatFromString("Int24"), SampleFormat::Int24);
+    EXPECT_EQ(AudioFormatUtils::sampleFormatFromString("pcm"), SampleFormat::Unknown);
+}
+
+TEST(SampleConverterTest, FromFloatRoundTrip) {
+    // Integer samples converted to float come back unchanged without dither
+    std::vector<int16_t> in16;
+    for (int32_t v = -32768; v < 32768; v += 7) {
+        in16.push_back(static_cast<int16_t>(v));
+    }
+    std::vector<float> samples(in16.size());
+    ASSERT_TRUE(SampleConverter::toFloat(reinterpret_cast<const uint8_t*>(in16.data()), SampleFormat::Int16,
+                                         in16.size(), samples.data()));
+    std::vector<int16_t> out16(in16.size());
+    ASSERT_TRUE(SampleConverter::fromFloat(samples.data(), samples.size(), SampleFormat::Int16,
+                                           reinterpret_cast<uint8_t*>(out16.data())));
+    EXPECT_EQ(out16, in16);
+
+    std::vector<uint8_t> in24;
+    for (int32_t v = -8388608; v < 8388608; v += 4093) {
+        in24.push_back(static_cast<uint8_t>(v & 0xFF));
+        in24.push_back(static_cast<uint8_t>((v >> 8) & 0xFF));
+        in24.push_back(static_cast<uint8_t>((v >> 16) & 0xFF));
+    }
+    samples.resize(in24.size() / 3);
+    ASSERT_TRUE(SampleConverter::toFloat(in24.data(), SampleFormat::Int24, samples.size(), samples.data()));
+    std::vector<uint8_t> out24(in24.size());
+    ASSERT_TRUE(SampleConverter::fromFloat(samples.data(), samples.size(), SampleFormat::Int24, out24.data()));
+    EXPECT_EQ(out24, in24);
+}
+
+TEST(SampleConverterTest, FromFloatClipsAndRounds) {
+    const float in[] = {2.0f, -2.0f, 1.0f, -1.0f, 0.4f / 32768.0f, 0.6f / 32768.0f, -0.6f / 32768.0f, NAN};
+    int16_t out16[8];
+    ASSERT_TRUE(SampleConverter::fromFloat(in, 8, SampleFormat::Int16, reinterpret_cast<uint8_t*>(out16)));
+    EXPECT_EQ(out16[0], 32767);
+    EXPECT_EQ(out16[1], -32768);
+    EXPECT_EQ(out16[2], 32767);
+    EXPECT_EQ(out16[3], -32768);
+    EXPECT_EQ(out16[4], 0);
+    EXPECT_EQ(out16[5], 1);
+    EXPECT_EQ(out16[6], -1);
+    EXPECT_EQ(out16[7], -32768);
+
+    int32_t out32[4];
+    ASSERT_TRUE(SampleConverter::fromFloat(in, 4, SampleFormat::Int32, reinterpret_cast<uint8_t*>(out32)));
+    EXPECT_EQ(out32[0], 2147483520);
+    EXPECT_EQ(out32[1], INT32_MIN);
+    EXPECT_EQ(out32[3], INT32_MIN);
+
+    uint8_t out8[1];
+    EXPECT_FALSE(SampleConverter::fromFloat(in, 1, SampleFormat::UInt8, out8));
+}
+
+TEST(SampleConverterTest, FromFloatSIMDLevelsMatch) {
+    // Odd length and unaligned output exercise the vector bodies and the tails
+    std::vector<float> in(1003);
+    for (size_t i = 0; i < in.size(); ++i) {
+        in[i] = 1.2f * std::sin(0.013f * static_cast<float>(i)) + 1e-6f * static_cast<float>(i % 7);
+    }
+    const SIMDLevel levels[] = {SIMDLevel::SSE41, SIMDLevel::AVX2, SIMDLevel::NEON};
+    for (SampleFormat format : {SampleFormat::Int16, SampleFormat::Int24, SampleFormat::Int32}) {
+        const size_t bytes = in.size() * AudioFormatUtils::getBytesPerSample(format);
+        std::vector<uint8_t> expected(bytes + 1);
+        DitherState reference(1234);
+        ASSERT_TRUE(SampleConverter::fromFloat(in.data(), in.size(), format, expected.data() + 1,
+                                               &reference, SIMDLevel::Scalar));
+        for (SIMDLevel level : levels) {
+            std::vector<uint8_t> out(bytes + 1);
+            DitherState dither(1234);
+            ASSERT_TRUE(SampleConverter::fromFloat(in.data(), in.size(), format, out.data() + 1, &dither, level));
+            EXPECT_EQ(out, expected) << simdLevelName(level) << " " << AudioFormatUtils::sampleFormatToString(format);
+            EXPECT_EQ(dither.position, reference.position);
+        }
+    }
+}
+
+TEST(SampleConverterTest, DitherIsTriangularAndContinuous) {
+    // Silence dithers to -1, 0 or +1 LSB with a triangular distribution
+    std::vector<float> silence(65536, 0.0f);
+    std::vector<int16_t> out(silence.size());
+    DitherState dither;
+    ASSERT_TRUE(SampleConverter::fromFloat(silence.data(), silence.size(), SampleFormat::Int16,
+                                           reinterpret_cast<uint8_t*>(out.data()), &dither));
+    int counts[3] = {0, 0, 0};
+    double sum = 0.0;
+    for (int16_t v : out) {
+        ASSERT_GE(v, -1);
+        ASSERT_LE(v, 1);
+        counts[v + 1]++;
+        sum += v;
+    }
+    // P(|noise| > 0.5 LSB) = 1/4, split evenly between the two signs
+    EXPECT_NEAR(counts[0] / 65536.0, 0.125, 0.01);
+    EXPECT_NEAR(counts[2] / 65536.0, 0.125, 0.01);
+    EXPECT_NEAR(sum / 65536.0, 0.0, 0.01);
+    EXPECT_EQ(dither.position, 65536u);
+
+    // Converting in chunks gives the same noise as one call
+    std::vector<int16_t> chunked(silence.size());
+    DitherState chunked_dither;
+    size_t done = 0;
+    for (size_t chunk : {size_t(1), size_t(13), size_t(1000), size_t(64522)}) {
+        ASSERT_TRUE(SampleConverter::fromFloat(silence.data() + done, chunk, SampleFormat::Int16,
+                                               reinterpret_cast<uint8_t*>(chunked.data() + done), &chunked_dither));
+        done += chunk;
+    }
+    ASSERT_EQ(done, silence.size());
+    EXPECT_EQ(chunked, out);
+}
@@ -0,0 +1,132 @@
+/**
+ * @file test_WAVWriter.cpp
+ * @brief Unit tests for the streaming RIFF/RF64 WAV writer
+ */
+
+#include <gtest/gtest.h>
+#include "../../src/lib/audio/WAVWriter.h"
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+using namespace xpu;
+using namespace xpu::audio;
+
+class WAVWriterTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        path_ = ::testing::TempDir() + "xpu_wav_writer_test.wav";
+    }
+
+    void TearDown() override {
+        std::remove(path_.c_str());
+    }
+
+    std::vector<uint8_t> readFile() const {
+        std::ifstream in(path_, std::ios::binary);
+        return std::vector<uint8_t>(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+
+    static std::string tag(const std::vector<uint8_t>& file, size_t offset) {
+        return std::string(reinterpret_cast<const char*>(file.data() + offset), 4);
+    }
+
+    static uint32_t u32(const std::vector<uint8_t>& file, size_t offset) {
+        uint32_t value = 0;
+        for (int i = 3; i >= 0; --i) {
+            value = (value << 8) | file[offset + i];
+        }
+        return value;
+    }
+
+    static uint64_t u64(const std::vector<uint8_t>& file, size_t offset) {
+        return u32(file, offset) | (static_cast<uint64_t>(u32(file, offset + 4)) << 32);
+    }
+
+    std::string path_;
+};
+
+TEST_F(WAVWriterTest, WritesRIFFWithPatchedSizes) {
+    std::vector<uint8_t> samples(4000);
+    for (size_t i = 0; i < samples.size(); ++i) {
+        samples[i] = static_cast<uint8_t>(i * 7);
+    }
+
+    WAVWriter writer;
+    ASSERT_EQ(writer.open(path_, 44100, 2, 16, false), ErrorCode::Success);
+    // Frames split across writes
+    ASSERT_EQ(writer.write(samples.data(), 1001), ErrorCode::Success);
+    ASSERT_EQ(writer.write(samples.data() + 1001, samples.size() - 1001), ErrorCode::Success);
+    EXPECT_FALSE(writer.isRF64());
+    ASSERT_EQ(writer.close(), ErrorCode::Success);
+
+    const std::vector<uint8_t> file = readFile();
+    ASSERT_EQ(file.size(), WAVWriter::HEADER_SIZE + samples.size());
+    EXPECT_EQ(tag(file, 0), "RIFF");
+    EXPECT_EQ(u32(file, 4), file.size() - 8);
+    EXPECT_EQ(tag(file, 8), "WAVE");
+    EXPECT_EQ(tag(file, 12), "JUNK");
+    EXPECT_EQ(u32(file, 16), 28u);
+    EXPECT_EQ(tag(file, 48), "fmt ");
+    EXPECT_EQ(u32(file, 52), 16u);
+    EXPECT_EQ(file[56], 1);                   // PCM
+    EXPECT_EQ(file[58], 2);                   // channels
+    EXPECT_EQ(u32(file, 60), 44100u);
+    EXPECT_EQ(u32(file, 64), 44100u * 4);     // byte rate
+    EXPECT_EQ(file[68], 4);                   // block align
+    EXPECT_EQ(file[70], 16);
+    EXPECT_EQ(tag(file, 72), "data");
+    EXPECT_EQ(u32(file, 76), samples.size());
+    EXPECT_EQ(std::memcmp(file.data() + WAVWriter::HEADER_SIZE, samples.data(), samples.size()), 0);
+}
+
+TEST_F(WAVWriterTest, PadsOddDataChunk) {
+    const uint8_t frame[3] = {1, 2, 3};  // one 24-bit mono frame
+
+    WAVWriter writer;
+    ASSERT_EQ(writer.open(path_, 48000, 1, 24, false), ErrorCode::Success);
+    ASSERT_EQ(writer.write(frame, sizeof(frame)), ErrorCode::Success);
+    ASSERT_EQ(writer.close(), ErrorCode::Success);
+
+    const std::vector<uint8_t> file = readFile();
+    ASSERT_EQ(file.size(), WAVWriter::HEADER_SIZE + 4);
+    EXPECT_EQ(u32(file, 76), 3u);
+    EXPECT_EQ(u32(file, 4), file.size() - 8);
+    EXPECT_EQ(file.back(), 0);
+}
+
+TEST_F(WAVWriterTest, RF64LayoutCarriesSizesInDS64) {
+    const std::vector<uint8_t> samples(48 * 8 * 4, 0x5A);  // 48 float frames, 8 channels
+
+    WAVWriter writer;
+    ASSERT_EQ(writer.open(path_, 192000, 8, 32, true, true), ErrorCode::Success);
+    ASSERT_EQ(writer.write(samples.data(), samples.size()), ErrorCode::Success);
+    EXPECT_TRUE(writer.isRF64());
+    ASSERT_EQ(writer.close(), ErrorCode::Success);
+
+    const std::vector<uint8_t> file = readFile();
+    ASSERT_EQ(file.size(), WAVWriter::HEADER_SIZE + samples.size());
+    EXPECT_EQ(tag(file, 0), "RF64");
+    EXPECT_EQ(u32(file, 4), 0xFFFFFFFFu);
+    EXPECT_EQ(tag(file, 12), "ds64");
+    EXPECT_EQ(u64(file, 20), file.size() - 8);
+    EXPECT_EQ(u64(file, 28), samples.size());
+    EXPECT_EQ(u64(file, 36), 48u);
+    EXPECT_EQ(u32(file, 44), 0u);
+    EXPECT_EQ(file[56], 3);                   // IEEE float
+    EXPECT_EQ(u32(file, 76), 0xFFFFFFFFu);
+}
+
+TEST_F(WAVWriterTest, RejectsUnsupportedFormats) {
+    WAVWriter writer;
+    EXPECT_EQ(writer.open(path_, 44100, 2, 8, false), ErrorCode::InvalidArgument);
+    EXPECT_EQ(writer.open(path_, 44100, 2, 16, true), ErrorCode::InvalidArgument);
+    EXPECT_EQ(writer.open(path_, 0, 2, 16, false), ErrorCode::InvalidArgument);
+    EXPECT_EQ(writer.open(path_, 44100, 0, 16, false), ErrorCode::InvalidArgument);
+    EXPECT_FALSE(writer.isOpen());
+    EXPECT_EQ(writer.write(nullptr, 0), ErrorCode::InvalidOperation);
+}